@@ -0,0 +1,381 @@
+/*
+ * compile_automaton_set.c
+ *
+ * Stand alone program which compiles an automaton set into the file format
+ * described in automaton_binary_file.h.
+ *
+ *   compile_automaton_set <xml file> <output file>
+ *
+ * The set is loaded from its xml, csv and lua files in exactly the way the
+ * game loads it, so every name, link and lua function is checked, and then
+ * written out with the lua compiled to bytecode. Point O_AUTOMATON or
+ * D_AUTOMATON in config.txt at the output to have the game load it instead of
+ * the xml.
+ *
+ * Run it from the game's directory as the xml refers to the csv and lua files
+ * relative to there. Once written the file is loaded back and compared with
+ * the set loaded from xml. Any difference is written to stderr and the program
+ * exits with 1. Problems with the set itself are written to the game's log
+ * files in the current directory, as they are when the game loads it.
+ *
+ * The file holds the states and events that it was compiled against and the
+ * game refuses to load it if they have changed, so the sets must be compiled
+ * again whenever a state or event is added.
+ *
+ * This is not part of the game build. Build it from the top directory with
+ *
+ *   make compile_automaton_set
+ *
+ * using the make file generated by Tools/create_make_file.py.
+ *
+ *  Created on: 16 Oct 2026
+ *      Author: David Tyler
+ */
+#include "dt_logger.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "automaton_handler.h"
+#include "automaton/data_structures/automaton.h"
+#include "automaton/data_structures/automaton_state.h"
+#include "automaton/data_structures/automaton_transition.h"
+#include "automaton/file_handling/automaton_binary_file.h"
+#include "impl_automatons/generic_o_d_files/init_automaton_events.h"
+#include "impl_automatons/o_automaton/o_automaton_states.h"
+
+/*
+ * game_exit
+ *
+ * The shared code calls this on fatal errors. There is no game to exit here.
+ *
+ * Parameters: message - Why we are exiting.
+ */
+void game_exit(char *message)
+{
+  fprintf(stderr, "%s\n", message);
+  exit(1);
+}
+
+/*
+ * same_link
+ *
+ * Parameters: from_xml, from_binary - Two links to compare, each from the set
+ *                                     that the other is being compared with.
+ *                                     Either can be NULL.
+ *             xml_id, binary_id - Identify what is linked to within its set.
+ *
+ * Returns: True if both are NULL or both link to the same thing.
+ */
+bool same_link(void *from_xml,
+               void *from_binary,
+               int xml_id,
+               int binary_id)
+{
+  if ((NULL == from_xml) || (NULL == from_binary))
+  {
+    return(from_xml == from_binary);
+  }
+
+  return(xml_id == binary_id);
+}
+
+/*
+ * automaton_index
+ *
+ * Parameters: set - The set.
+ *             automaton - An automaton in the set or NULL.
+ *
+ * Returns: The index of the automaton in the set or -1.
+ */
+int automaton_index(AUTOMATON_SET *set, AUTOMATON *automaton)
+{
+  /*
+   * Local Variables.
+   */
+  int ii;
+
+  for (ii = 0; ii < set->num_automatons; ii++)
+  {
+    if (set->automaton_array[ii] == automaton)
+    {
+      return(ii);
+    }
+  }
+
+  return(-1);
+}
+
+/*
+ * state_index
+ *
+ * Parameters: automaton - The automaton that owns the state.
+ *             state - A state or NULL.
+ *
+ * Returns: The index of the state in the automaton or -1.
+ */
+int state_index(AUTOMATON *automaton, AUTOMATON_STATE *state)
+{
+  /*
+   * Local Variables.
+   */
+  int ii;
+
+  for (ii = 0; ii < automaton->num_states; ii++)
+  {
+    if (automaton->states[ii] == state)
+    {
+      return(ii);
+    }
+  }
+
+  return(-1);
+}
+
+/*
+ * transition_id
+ *
+ * Parameters: transition - A transition or NULL.
+ *
+ * Returns: The id of the transition or -1.
+ */
+int transition_id(AUTOMATON_TRANSITION *transition)
+{
+  return((NULL == transition) ? -1 : transition->id);
+}
+
+/*
+ * same_transition
+ *
+ * Compares a transition loaded from xml with the same transition loaded from
+ * the compiled file.
+ *
+ * Parameters: xml_set, binary_set - The two sets.
+ *             xml_owner, binary_owner - The automatons owning the transitions.
+ *             xml, binary - The transitions.
+ *
+ * Returns: True if they are the same.
+ */
+bool same_transition(AUTOMATON_SET *xml_set,
+                     AUTOMATON_SET *binary_set,
+                     AUTOMATON *xml_owner,
+                     AUTOMATON *binary_owner,
+                     AUTOMATON_TRANSITION *xml,
+                     AUTOMATON_TRANSITION *binary)
+{
+  /*
+   * Local Variables.
+   */
+  AUTOMATON *xml_true_owner;
+  AUTOMATON *xml_false_owner;
+  AUTOMATON *binary_true_owner;
+  AUTOMATON *binary_false_owner;
+
+  xml_true_owner = (NULL == xml->true_automaton) ? xml_owner :
+                                                   xml->true_automaton;
+  xml_false_owner = (NULL == xml->false_automaton) ? xml_owner :
+                                                     xml->false_automaton;
+  binary_true_owner = (NULL == binary->true_automaton) ?
+                                          binary_owner : binary->true_automaton;
+  binary_false_owner = (NULL == binary->false_automaton) ?
+                                         binary_owner : binary->false_automaton;
+
+  return((0 == strcmp(xml->name, binary->name)) &&
+         (0 == strcmp(xml->lua_function_name, binary->lua_function_name)) &&
+         same_link(xml->true_automaton,
+                   binary->true_automaton,
+                   automaton_index(xml_set, xml->true_automaton),
+                   automaton_index(binary_set, binary->true_automaton)) &&
+         same_link(xml->false_automaton,
+                   binary->false_automaton,
+                   automaton_index(xml_set, xml->false_automaton),
+                   automaton_index(binary_set, binary->false_automaton)) &&
+         same_link(xml->true_state,
+                   binary->true_state,
+                   state_index(xml_true_owner, xml->true_state),
+                   state_index(binary_true_owner, binary->true_state)) &&
+         same_link(xml->false_state,
+                   binary->false_state,
+                   state_index(xml_false_owner, xml->false_state),
+                   state_index(binary_false_owner, binary->false_state)) &&
+         same_link(xml->true_transition,
+                   binary->true_transition,
+                   transition_id(xml->true_transition),
+                   transition_id(binary->true_transition)) &&
+         same_link(xml->false_transition,
+                   binary->false_transition,
+                   transition_id(xml->false_transition),
+                   transition_id(binary->false_transition)));
+}
+
+/*
+ * compare_sets
+ *
+ * Checks that the set loaded back from the compiled file matches the set it
+ * was compiled from.
+ *
+ * Parameters: xml_set - The set loaded from xml.
+ *             binary_set - The set loaded from the compiled file.
+ *
+ * Returns: The number of differences, each of which is written to stderr.
+ */
+int compare_sets(AUTOMATON_SET *xml_set, AUTOMATON_SET *binary_set)
+{
+  /*
+   * Local Variables.
+   */
+  AUTOMATON *xml;
+  AUTOMATON *binary;
+  AUTOMATON_TRANSITION *xml_transition;
+  AUTOMATON_TRANSITION *binary_transition;
+  int num_differences = 0;
+  int ii;
+  int jj;
+  int kk;
+
+  if ((xml_set->num_automatons != binary_set->num_automatons) ||
+      (automaton_index(xml_set, xml_set->start_automaton) !=
+       automaton_index(binary_set, binary_set->start_automaton)))
+  {
+    fprintf(stderr, "The sets have different automatons\n");
+    return(1);
+  }
+
+  for (ii = 0; ii < xml_set->num_automatons; ii++)
+  {
+    xml = xml_set->automaton_array[ii];
+    binary = binary_set->automaton_array[ii];
+    if ((0 != strcmp(xml->name, binary->name)) ||
+        (state_index(xml, xml->start_state) !=
+         state_index(binary, binary->start_state)) ||
+        (xml->num_transitions != binary->num_transitions))
+    {
+      fprintf(stderr, "Automaton %s differs\n", xml->name);
+      num_differences++;
+      continue;
+    }
+
+    for (jj = 0; jj < xml->num_transitions; jj++)
+    {
+      if (!same_transition(xml_set,
+                           binary_set,
+                           xml,
+                           binary,
+                           xml->transitions[jj],
+                           binary->transitions[jj]))
+      {
+        fprintf(stderr, "Automaton %s transition %s differs\n",
+                xml->name,
+                xml->transitions[jj]->name);
+        num_differences++;
+      }
+    }
+
+    for (jj = 0; jj < xml->num_states; jj++)
+    {
+      for (kk = 0; kk < xml->num_events; kk++)
+      {
+        xml_transition = xml->states[jj]->transitions[kk];
+        binary_transition = binary->states[jj]->transitions[kk];
+        if (!same_link(xml_transition,
+                       binary_transition,
+                       transition_id(xml_transition),
+                       transition_id(binary_transition)))
+        {
+          fprintf(stderr, "Automaton %s state %s event %i differs\n",
+                  xml->name,
+                  xml->states[jj]->name,
+                  kk);
+          num_differences++;
+        }
+      }
+    }
+  }
+
+  return(num_differences);
+}
+
+int main(int argc, char *argv[])
+{
+  /*
+   * Local Variables.
+   */
+  AUTOMATON_SET *xml_set = NULL;
+  AUTOMATON_SET *binary_set = NULL;
+  int num_differences;
+  int ret_code = 1;
+  int rc;
+
+  if (3 != argc)
+  {
+    fprintf(stderr, "Usage: %s <xml file> <output file>\n", argv[0]);
+    return(1);
+  }
+
+  /*
+   * Whatever is wrong with a set is written to the log as it is loaded.
+   */
+  DT_INIT_LOG;
+
+  /*
+   * There is no match so the lua callbacks are registered without one. They
+   * are never called here.
+   */
+  xml_set = create_automaton_set(argv[1],
+                                 create_o_automaton_states,
+                                 create_automaton_events,
+                                 NULL);
+  if (NULL == xml_set)
+  {
+    fprintf(stderr, "Could not load automaton set %s, see %s\n",
+            argv[1],
+            LOG_FILENAME);
+    goto EXIT_LABEL;
+  }
+
+  rc = save_automaton_set_binary_file(xml_set, argv[2]);
+  if (AUTOMATON_BINARY_FILE_OK != rc)
+  {
+    fprintf(stderr, "Could not compile automaton set (%i), see %s\n",
+            rc,
+            LOG_FILENAME);
+    goto EXIT_LABEL;
+  }
+
+  binary_set = create_automaton_set(argv[2],
+                                    create_o_automaton_states,
+                                    create_automaton_events,
+                                    NULL);
+  if (NULL == binary_set)
+  {
+    fprintf(stderr, "Could not load the compiled set back from %s, see %s\n",
+            argv[2],
+            LOG_FILENAME);
+    goto EXIT_LABEL;
+  }
+
+  num_differences = compare_sets(xml_set, binary_set);
+  printf("Compiled %i automatons from %s to %s with %i differences\n",
+         xml_set->num_automatons,
+         argv[1],
+         argv[2],
+         num_differences);
+  if (0 == num_differences)
+  {
+    ret_code = 0;
+  }
+
+EXIT_LABEL:
+
+  if (NULL != binary_set)
+  {
+    destroy_automaton_set(binary_set);
+  }
+  if (NULL != xml_set)
+  {
+    destroy_automaton_set(xml_set);
+  }
+  DT_KILL_LOG;
+
+  return(ret_code);
+}
@@ -0,0 +1,371 @@
+/*
+ * automaton_set_test.c
+ *
+ * Stand alone program which checks that the automaton sets shipped with the
+ * game still work once compiled (see automaton_binary_file.h). Each set is
+ * loaded from its xml, compiled, loaded back from the compiled file and then
+ * every transition of every automaton is called for each player, in the same
+ * way as move_to_next_state calls it.
+ *
+ *   automaton_set_test [xml file ...]
+ *
+ * With no arguments the offensive and defensive sets in resources/automaton
+ * are checked. Run it from the game's directory as the xml refers to the csv
+ * and lua files relative to there.
+ *
+ * There is no match, so before any transition is called each lua callback is
+ * replaced by the stand in of the same name from CALLBACK_DOUBLES_FILENAME.
+ * The stand ins return tables shaped like the real callbacks return and fail
+ * if they are passed the wrong parameters. A callback registered by the game
+ * without a stand in fails the test, so the file must be kept up to date as
+ * callbacks are added.
+ *
+ * Each problem found is written to stdout as
+ *
+ *   FAILED <xml file> <automaton> <transition> (<team>:<player>): <why>
+ *
+ * followed at the end by the number of problems. The program exits with 1 if
+ * there were any. The compiled files are written to the current directory and
+ * removed again afterwards.
+ *
+ * This is not part of the game build. Build it from the top directory with
+ *
+ *   make automaton_set_test
+ *
+ * using the make file generated by Tools/create_make_file.py.
+ *
+ *  Created on: 16 Oct 2026
+ *      Author: David Tyler
+ */
+#include "dt_logger.h"
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "lua5.1/lua.h"
+#include "lua5.1/lauxlib.h"
+#include "automaton_handler.h"
+#include "automaton/data_structures/automaton.h"
+#include "automaton/data_structures/automaton_transition.h"
+#include "automaton/file_handling/automaton_binary_file.h"
+#include "impl_automatons/generic_o_d_files/init_automaton_events.h"
+#include "impl_automatons/o_automaton/o_automaton_states.h"
+
+/*
+ * The stand ins for the lua callbacks, relative to the game's directory.
+ */
+#define CALLBACK_DOUBLES_FILENAME \
+                      "Tools/automaton_set_test/automaton_set_test_doubles.lua"
+
+/*
+ * Where each set is compiled to.
+ */
+#define TEST_BINARY_FILENAME "automaton_set_test.bin"
+
+/*
+ * The players that every transition is called for. These must match the
+ * match described in CALLBACK_DOUBLES_FILENAME.
+ */
+#define TEST_NUM_TEAMS 2
+#define TEST_PLAYERS_PER_TEAM 7
+
+/*
+ * Only the lua globals starting with this are callbacks.
+ */
+#define CALLBACK_PREFIX "callback_"
+
+/*
+ * The sets checked when none are given.
+ */
+char *g_shipped_sets[] = {"resources/automaton/o_automaton.xml",
+                          "resources/automaton/d_automaton.xml"};
+
+/*
+ * game_exit
+ *
+ * The shared code calls this on fatal errors. There is no game to exit here.
+ *
+ * Parameters: message - Why we are exiting.
+ */
+void game_exit(char *message)
+{
+  fprintf(stderr, "%s\n", message);
+  exit(1);
+}
+
+/*
+ * replace_callbacks
+ *
+ * Replaces every lua callback registered with an automaton by its stand in.
+ *
+ * Parameters: xml_filename - The set that the automaton is from.
+ *             automaton - The automaton.
+ *
+ * Returns: The number of problems found, each of which is written out.
+ */
+int replace_callbacks(char *xml_filename, AUTOMATON *automaton)
+{
+  /*
+   * Local Variables.
+   */
+  lua_State *lua_state = automaton->lua_state;
+  int num_problems = 0;
+  int rc;
+
+  /*
+   * The callbacks are the C functions in the globals. Remember them so that
+   * any left over once the stand ins are loaded can be found.
+   */
+  lua_newtable(lua_state);
+  lua_pushnil(lua_state);
+  while (0 != lua_next(lua_state, LUA_GLOBALSINDEX))
+  {
+    if ((lua_iscfunction(lua_state, -1)) &&
+        (LUA_TSTRING == lua_type(lua_state, -2)) &&
+        (0 == strncmp(lua_tostring(lua_state, -2),
+                      CALLBACK_PREFIX,
+                      strlen(CALLBACK_PREFIX))))
+    {
+      lua_pushvalue(lua_state, -2);
+      lua_pushboolean(lua_state, true);
+      lua_settable(lua_state, -5);
+    }
+    lua_pop(lua_state, 1);
+  }
+
+  rc = luaL_dofile(lua_state, CALLBACK_DOUBLES_FILENAME);
+  if (0 != rc)
+  {
+    printf("FAILED %s %s: Could not load %s: %s\n",
+           xml_filename,
+           automaton->name,
+           CALLBACK_DOUBLES_FILENAME,
+           lua_tostring(lua_state, -1));
+    lua_pop(lua_state, 2);
+    return(1);
+  }
+
+  lua_pushnil(lua_state);
+  while (0 != lua_next(lua_state, -2))
+  {
+    lua_pop(lua_state, 1);
+    lua_pushvalue(lua_state, -1);
+    lua_gettable(lua_state, LUA_GLOBALSINDEX);
+    if (lua_iscfunction(lua_state, -1))
+    {
+      printf("FAILED %s %s: No stand in for %s\n",
+             xml_filename,
+             automaton->name,
+             lua_tostring(lua_state, -2));
+      num_problems++;
+    }
+    lua_pop(lua_state, 1);
+  }
+  lua_pop(lua_state, 1);
+
+  return(num_problems);
+}
+
+/*
+ * call_transition
+ *
+ * Calls the lua function of a transition for one player.
+ *
+ * Parameters: xml_filename - The set that the automaton is from.
+ *             automaton - The automaton owning the transition.
+ *             transition - The transition.
+ *             team_id, player_id - The player.
+ *
+ * Returns: True if the function returned a number as move_to_next_state
+ *          expects. If not then why is written out.
+ */
+bool call_transition(char *xml_filename,
+                     AUTOMATON *automaton,
+                     AUTOMATON_TRANSITION *transition,
+                     int team_id,
+                     int player_id)
+{
+  /*
+   * Local Variables.
+   */
+  lua_State *lua_state = automaton->lua_state;
+  bool ok = true;
+  int rc;
+
+  /*
+   * The stand ins answer for this player, as the real callbacks answer for
+   * the player set by set_lua_player.
+   */
+  lua_pushinteger(lua_state, team_id);
+  lua_setglobal(lua_state, "double_team_id");
+  lua_pushinteger(lua_state, player_id);
+  lua_setglobal(lua_state, "double_player_id");
+
+  lua_rawgeti(lua_state, LUA_REGISTRYINDEX, transition->lua_function_ref);
+  lua_pushinteger(lua_state, team_id);
+  lua_pushinteger(lua_state, player_id);
+  rc = lua_pcall(lua_state, 2, 1, 0);
+  if (0 != rc)
+  {
+    printf("FAILED %s %s %s (%i:%i): %s\n",
+           xml_filename,
+           automaton->name,
+           transition->name,
+           team_id,
+           player_id,
+           lua_tostring(lua_state, -1));
+    ok = false;
+  }
+  else if (!lua_isnumber(lua_state, -1))
+  {
+    printf("FAILED %s %s %s (%i:%i): %s returned %s, not a number\n",
+           xml_filename,
+           automaton->name,
+           transition->name,
+           team_id,
+           player_id,
+           transition->lua_function_name,
+           lua_typename(lua_state, lua_type(lua_state, -1)));
+    ok = false;
+  }
+  lua_pop(lua_state, 1);
+
+  return(ok);
+}
+
+/*
+ * test_automaton_set
+ *
+ * Compiles a set, loads it back and calls every transition in it.
+ *
+ * Parameters: xml_filename - The set.
+ *
+ * Returns: The number of problems found, each of which is written out.
+ */
+int test_automaton_set(char *xml_filename)
+{
+  /*
+   * Local Variables.
+   */
+  AUTOMATON_SET *xml_set = NULL;
+  AUTOMATON_SET *binary_set = NULL;
+  AUTOMATON *automaton;
+  int num_problems = 0;
+  int num_calls = 0;
+  int rc;
+  int ii;
+  int jj;
+  int team_id;
+  int player_id;
+
+  xml_set = create_automaton_set(xml_filename,
+                                 create_o_automaton_states,
+                                 create_automaton_events,
+                                 NULL);
+  if (NULL == xml_set)
+  {
+    printf("FAILED %s: Could not load the set, see %s\n",
+           xml_filename,
+           LOG_FILENAME);
+    return(1);
+  }
+
+  rc = save_automaton_set_binary_file(xml_set, TEST_BINARY_FILENAME);
+  destroy_automaton_set(xml_set);
+  if (AUTOMATON_BINARY_FILE_OK != rc)
+  {
+    printf("FAILED %s: Could not compile the set (%i), see %s\n",
+           xml_filename,
+           rc,
+           LOG_FILENAME);
+    remove(TEST_BINARY_FILENAME);
+    return(1);
+  }
+
+  binary_set = create_automaton_set(TEST_BINARY_FILENAME,
+                                    create_o_automaton_states,
+                                    create_automaton_events,
+                                    NULL);
+  remove(TEST_BINARY_FILENAME);
+  if (NULL == binary_set)
+  {
+    printf("FAILED %s: Could not load the compiled set, see %s\n",
+           xml_filename,
+           LOG_FILENAME);
+    return(1);
+  }
+
+  for (ii = 0; ii < binary_set->num_automatons; ii++)
+  {
+    automaton = binary_set->automaton_array[ii];
+    rc = replace_callbacks(xml_filename, automaton);
+    if (0 != rc)
+    {
+      num_problems += rc;
+      continue;
+    }
+
+    for (jj = 0; jj < automaton->num_transitions; jj++)
+    {
+      for (team_id = 0; team_id < TEST_NUM_TEAMS; team_id++)
+      {
+        for (player_id = 0; player_id < TEST_PLAYERS_PER_TEAM; player_id++)
+        {
+          num_calls++;
+          if (!call_transition(xml_filename,
+                               automaton,
+                               automaton->transitions[jj],
+                               team_id,
+                               player_id))
+          {
+            num_problems++;
+          }
+        }
+      }
+    }
+  }
+
+  printf("%s: %i automatons, %i transition calls, %i problems\n",
+         xml_filename,
+         binary_set->num_automatons,
+         num_calls,
+         num_problems);
+
+  destroy_automaton_set(binary_set);
+
+  return(num_problems);
+}
+
+int main(int argc, char *argv[])
+{
+  /*
+   * Local Variables.
+   */
+  char **xml_filenames = g_shipped_sets;
+  int num_sets = sizeof(g_shipped_sets) / sizeof(g_shipped_sets[0]);
+  int num_problems = 0;
+  int ii;
+
+  if (1 < argc)
+  {
+    xml_filenames = &(argv[1]);
+    num_sets = argc - 1;
+  }
+
+  /*
+   * Whatever is wrong with a set is written to the log as it is loaded.
+   */
+  DT_INIT_LOG;
+
+  for (ii = 0; ii < num_sets; ii++)
+  {
+    num_problems += test_automaton_set(xml_filenames[ii]);
+  }
+
+  printf("%i problems\n", num_problems);
+
+  DT_KILL_LOG;
+
+  return((0 == num_problems) ? 0 : 1);
+}
@@ -0,0 +1,157 @@
+--
+-- automaton_set_test_doubles.lua
+--
+-- Stand ins for the lua callbacks registered by the game (see
+-- lua_call_back_functions.c), loaded by automaton_set_test over the real ones
+-- so that the transitions can be called without a match. Each returns what
+-- the real callback returns, in the same shape, for a fixed match of two
+-- teams of seven with the disc in the air. Anything passed the wrong
+-- parameters fails, where the real callback would only log it.
+--
+-- double_team_id and double_player_id are set by automaton_set_test to the
+-- player whose transition is being called.
+--
+--  Created on: 16 Oct 2026
+--      Author: David Tyler
+--
+
+DOUBLE_NUM_TEAMS = 2
+DOUBLE_PLAYERS_PER_TEAM = 7
+
+double_team_id = 0
+double_player_id = 0
+
+--
+-- check_numbers
+--
+-- Fails unless the parameters passed to a callback are all numbers and there
+-- are between min_params and max_params of them.
+--
+function check_numbers(name, min_params, max_params, ...)
+    local num_params = select("#", ...)
+    if num_params < min_params or num_params > max_params then
+        error(name .. " called with " .. num_params .. " parameters", 3)
+    end
+    for ii = 1, num_params do
+        if type(select(ii, ...)) ~= "number" then
+            error(name .. " called with a " .. type(select(ii, ...)) ..
+                  " for parameter " .. ii, 3)
+        end
+    end
+end
+
+--
+-- double_player_position
+--
+-- Where each player is stood. The teams face each other across the middle of
+-- the pitch.
+--
+function double_player_position(team_id, player_id)
+    return {["x"] = 40 + 20 * team_id, ["y"] = 5 + 4 * player_id, ["z"] = 0}
+end
+
+function callback_get_pitch_dimensions(...)
+    check_numbers("callback_get_pitch_dimensions", 0, 0, ...)
+    return {["length"] = 100, ["width"] = 37, ["endzone_depth"] = 18}
+end
+
+function callback_set_player_desired_pos(...)
+    check_numbers("callback_set_player_desired_pos", 2, 2, ...)
+end
+
+function callback_set_player_speed(...)
+    check_numbers("callback_set_player_speed", 1, 1, ...)
+end
+
+function callback_get_disc_final_pos(...)
+    check_numbers("callback_get_disc_final_pos", 0, 0, ...)
+    return {["x"] = 70, ["y"] = 20, ["is_final"] = true}
+end
+
+function callback_get_disc_pos(...)
+    check_numbers("callback_get_disc_pos", 0, 0, ...)
+    return {["x"] = 30, ["y"] = 18, ["z"] = 2}
+end
+
+function callback_get_team_positions(...)
+    check_numbers("callback_get_team_positions", 0, 0, ...)
+    local positions = {}
+    for ii = 0, DOUBLE_PLAYERS_PER_TEAM - 1 do
+        local position = double_player_position(double_team_id, ii)
+        positions[ii] = {["x"] = position["x"], ["y"] = position["y"]}
+    end
+    return positions
+end
+
+function callback_get_team_desired_positions(...)
+    check_numbers("callback_get_team_desired_positions", 0, 0, ...)
+    local positions = {}
+    for ii = 0, DOUBLE_PLAYERS_PER_TEAM - 1 do
+        local position = double_player_position(double_team_id, ii)
+        positions[ii] = {["x"] = position["x"] + 5, ["y"] = position["y"]}
+    end
+    return positions
+end
+
+--
+-- Only every other player can reach the disc, and the path has been
+-- calculated all the way to the ground.
+--
+function callback_calculate_all_intercept_times(...)
+    check_numbers("callback_calculate_all_intercept_times", 0, 0, ...)
+    local intercepts = {}
+    for jj = 0, DOUBLE_NUM_TEAMS - 1 do
+        for ii = 0, DOUBLE_PLAYERS_PER_TEAM - 1, 2 do
+            intercepts[ii + DOUBLE_PLAYERS_PER_TEAM * jj] =
+                {["player_index"] = ii,
+                 ["team_index"] = jj,
+                 ["time_to_intercept"] = 1 + 0.5 * ii + 0.25 * jj,
+                 ["x"] = 50 + ii,
+                 ["y"] = 19}
+        end
+    end
+    return intercepts, true
+end
+
+function callback_get_all_team_marks(...)
+    check_numbers("callback_get_all_team_marks", 0, 0, ...)
+    local marks = {}
+    for ii = 0, DOUBLE_PLAYERS_PER_TEAM - 1 do
+        marks[ii + DOUBLE_PLAYERS_PER_TEAM * double_team_id] =
+            {["player_index"] = ii,
+             ["team_index"] = double_team_id,
+             ["mark_player_index"] = ii,
+             ["mark_team_index"] = (double_team_id + 1) % DOUBLE_NUM_TEAMS}
+    end
+    return marks
+end
+
+function callback_set_desired_mark(...)
+    check_numbers("callback_set_desired_mark", 1, 1, ...)
+    local mark_index = ...
+    if mark_index < 0 or mark_index >= DOUBLE_PLAYERS_PER_TEAM then
+        error("callback_set_desired_mark called with " .. mark_index, 2)
+    end
+end
+
+function callback_get_current_position(...)
+    check_numbers("callback_get_current_position", 0, 0, ...)
+    return double_player_position(double_team_id, double_player_id)
+end
+
+function callback_stop_running(...)
+    check_numbers("callback_stop_running", 0, 0, ...)
+end
+
+function callback_is_attacking_left_to_right(...)
+    check_numbers("callback_is_attacking_left_to_right", 0, 0, ...)
+    return (0 == double_team_id) and 1 or 0
+end
+
+--
+-- Nobody is holding the disc, so it is never thrown.
+--
+function callback_throw_disc(...)
+    check_numbers("callback_throw_disc", 2, 3, ...)
+    return false
+end
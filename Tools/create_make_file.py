@@ -3,26 +3,174 @@
 #                                                                              #
 # Creates make files for use with gcc and this project. Done to avoid having   #
 # to ever have to update the make file. The only thing that will require       #
-# updating here is the list of excluded directories/files.                     #
+# updating here is the list of excluded directories/files and the list of      #
+# tools.                                                                       #
 #                                                                              #
 # It is assumed that this file is run from the Tools directory in the project. #
+#                                                                              #
+# The make file has a target for the game (make game) and one for each of the  #
+# stand alone programs in TOOLS (make tools builds them all). make test builds #
+# and runs every tool marked as a test and fails if any of them fail. make     #
+# game also generates the flight condition table that the game maps in, with   #
+# the generate_flight_lu_table tool.                                           #
+#                                                                              #
+# The libraries are make variables so that they can be given on the command   #
+# line where they are installed under different names.                         #
 ################################################################################
 import os
 
-EXCLUDED_DIRS = ['.settings', '.svn', 'Debug', 'Release', 'resources', 'Tools', 'ezxml']
+EXCLUDED_DIRS = ['.git', '.settings', '.svn', 'Debug', 'Release', 'resources', 'Tools', 'ezxml']
 EXCLUDED_FILES = []
 
+################################################################################
+# The stand alone programs under Tools. Each entry is                          #
+#                                                                              #
+#   (target, main file, extra flags, sources, libraries, is a test)            #
+#                                                                              #
+# The main file is relative to Tools and the sources are relative to src. A    #
+# source list of None means every game source apart from main.c.              #
+################################################################################
+FLIGHT_SOURCES = ['flight_mechanics/disc_flight.c',
+                  'flight_mechanics/disc_flight_batch.c',
+                  'flight_mechanics/disc_forces.c',
+                  'data_structures/vector.c',
+                  'mem_alloc_handler.c']
+HEADLESS_FLAGS = '-DDT_HEADLESS -DDT_NO_DEBUG_LOG'
+
+# The flight condition table (FLIGHT_LU_TABLE in config.txt) and the tool that
+# generates it.
+FLIGHT_LU_TABLE = 'resources/flight_lu_table.bin'
+FLIGHT_LU_TABLE_TOOL = 'Tools/flight_lu_table/generate_flight_lu_table'
+
+TOOLS = [
+    ('compile_automaton_set',
+     'automaton_compiler/compile_automaton_set.c',
+     '',
+     None,
+     '$(GAME_LIBS)',
+     False),
+    ('integrator_benchmark',
+     'flight_benchmark/integrator_benchmark.c',
+     '-DDT_NO_DEBUG_LOG',
+     FLIGHT_SOURCES,
+     '-lm',
+     False),
+    ('generate_flight_lu_table',
+     'flight_lu_table/generate_flight_lu_table.c',
+     '-DDT_NO_DEBUG_LOG',
+     ['flight_condition_lu_table.c'] + FLIGHT_SOURCES,
+     '$(SDL_LIBS) -lm',
+     False),
+    ('flight_sim',
+     'flight_sim/flight_sim.c',
+     HEADLESS_FLAGS,
+     ['physics.c', 'disc.c'] + FLIGHT_SOURCES,
+     '$(SDL_LIBS) -lm',
+     False),
+    ('intercept_benchmark',
+     'intercept_benchmark/intercept_benchmark.c',
+     HEADLESS_FLAGS,
+     ['disc_path.c',
+      'collisions/intercept.c',
+      'physics.c',
+      'disc.c',
+      'player.c',
+      'player_kinematics.c',
+      'data_structures/event_queue.c'] + FLIGHT_SOURCES,
+     '$(SDL_LIBS) -lm',
+     True),
+    ('event_queue_test',
+     'event_queue_test/event_queue_test.c',
+     HEADLESS_FLAGS,
+     ['data_structures/event_queue.c',
+      'mem_alloc_handler.c'],
+     '',
+     True),
+    ('throw_solver_test',
+     'throw_solver_test/throw_solver_test.c',
+     HEADLESS_FLAGS,
+     ['throw_solver.c',
+      'flight_condition_lu_table.c',
+      'physics.c',
+      'disc.c'] + FLIGHT_SOURCES,
+     '$(SDL_LIBS) -lm',
+     True),
+    ('automaton_set_test',
+     'automaton_set_test/automaton_set_test.c',
+     '',
+     None,
+     '$(GAME_LIBS)',
+     True),
+]
+
 h_files = []
 c_files = []
 
 for root, dirs, files in os.walk(".."):
+    dirs[:] = [dir for dir in dirs if dir not in EXCLUDED_DIRS]
     for file in files:
+        if file in EXCLUDED_FILES:
+            continue
+        path = os.path.relpath(os.path.join(root, file), "..").replace("\\", "/")
         if file.endswith(".c"):
-            c_files.append(os.path.join(root,file))
+            c_files.append(path)
         elif file.endswith(".h"):
-            h_files.append(os.path.join(root,file))
+            h_files.append(path)
+
+c_files.sort()
+h_files.sort()
+library_c_files = [file for file in c_files if file != "src/main.c"]
 
 # Create the make file, overwriting if it already exists.
 make_file = open(os.path.join("..", "makefile"), "w")
 
-make_file.write(
\ No newline at end of file
+make_file.write("# Generated by Tools/create_make_file.py. Do not edit.\n\n")
+make_file.write("CC = gcc\n")
+# -O3 turns on gcc's loop vectoriser, which the batched loops (see
+# disc_flight_batch.h) are written for. It will only vectorise sqrtf without
+# -fno-math-errno, and only choose between float values with ?: without
+# -fno-trapping-math. Nothing in the game reads errno from the maths library or
+# traps floating point exceptions.
+make_file.write("CFLAGS = -std=gnu99 -O3 -fno-math-errno -fno-trapping-math -fcommon -I src -I dep/include\n")
+make_file.write("SDL_LIBS = -lSDL -lpthread\n")
+make_file.write("GAME_LIBS = -llua5.1 $(SDL_LIBS) -lSDL_image -lSDL_ttf -lGL -lopenal -lvorbis -logg -lm\n\n")
+make_file.write("GAME_SOURCES = " + " \\\n\t".join(c_files) + "\n\n")
+make_file.write("LIBRARY_SOURCES = " + " \\\n\t".join(library_c_files) + "\n\n")
+make_file.write("HEADERS = " + " \\\n\t".join(h_files) + "\n\n")
+
+tool_binaries = []
+test_binaries = []
+for (target, main_file, flags, sources, libraries, is_test) in TOOLS:
+    binary = "Tools/" + os.path.dirname(main_file) + "/" + target
+    tool_binaries.append(binary)
+    if is_test:
+        test_binaries.append(binary)
+
+make_file.write(".PHONY: all game tools test clean " + " ".join([tool[0] for tool in TOOLS]) + "\n\n")
+make_file.write("all: game tools\n\n")
+make_file.write("game: FrisbeeGame " + FLIGHT_LU_TABLE + "\n\n")
+make_file.write("FrisbeeGame: $(GAME_SOURCES) $(HEADERS)\n")
+make_file.write("\t$(CC) $(CFLAGS) -o $@ $(GAME_SOURCES) $(GAME_LIBS)\n\n")
+make_file.write("tools: " + " ".join(tool_binaries) + "\n\n")
+make_file.write(FLIGHT_LU_TABLE + ": " + FLIGHT_LU_TABLE_TOOL + "\n")
+make_file.write("\t./" + FLIGHT_LU_TABLE_TOOL + " $@\n\n")
+
+for (target, main_file, flags, sources, libraries, is_test) in TOOLS:
+    binary = "Tools/" + os.path.dirname(main_file) + "/" + target
+    if sources is None:
+        source_list = "Tools/" + main_file + " $(LIBRARY_SOURCES)"
+    else:
+        source_list = " ".join(["Tools/" + main_file] + ["src/" + source for source in sources])
+    make_file.write(target + ": " + binary + "\n\n")
+    make_file.write(binary + ": " + source_list + " $(HEADERS)\n")
+    make_file.write("\t$(CC) $(CFLAGS) " + flags + " -o $@ " + source_list + " " + libraries + "\n\n")
+
+make_file.write("test: " + " ".join(test_binaries) + "\n")
+for binary in test_binaries:
+    make_file.write("\t./" + binary + "\n")
+make_file.write("\n")
+
+make_file.write("clean:\n")
+make_file.write("\trm -f FrisbeeGame " + FLIGHT_LU_TABLE + " " + " ".join(tool_binaries) + "\n")
+
+make_file.close()
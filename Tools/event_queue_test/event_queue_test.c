@@ -0,0 +1,377 @@
+/*
+ * event_queue_test.c
+ *
+ * Stand alone program which checks the players' event queue (see
+ * event_queue.h): the order events come off the queue in, what happens when
+ * it is full under each overflow policy, coalescing and the counts wrapping
+ * round past the largest unsigned int.
+ *
+ *   event_queue_test
+ *
+ * Each check that fails is written to stdout as
+ *
+ *   FAILED <check>
+ *
+ * followed at the end by the number of checks that failed. The program exits
+ * with 1 if any did, so it can be run as a check after changing
+ * event_queue.c.
+ *
+ * This is not part of the game build. Build it from the top directory with
+ *
+ *   make event_queue_test
+ *
+ * using the make file generated by Tools/create_make_file.py.
+ *
+ *  Created on: 16 Oct 2026
+ *      Author: David Tyler
+ */
+#include "dt_logger.h"
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "automaton/data_structures/automaton_event.h"
+#include "data_structures/event_queue.h"
+
+/*
+ * The size of the queues tested and the number of different events used.
+ */
+#define TEST_QUEUE_CAPACITY 4
+#define NUM_TEST_EVENTS 8
+
+/*
+ * Where the counts are started for the wrap round checks, so that they pass
+ * the largest unsigned int part way through.
+ */
+#define WRAP_START_COUNT 0xFFFFFFFEu
+
+/*
+ * The events added to the queues. Event ii has id ii.
+ */
+AUTOMATON_EVENT g_events[NUM_TEST_EVENTS];
+
+/*
+ * The number of checks that have failed.
+ */
+int g_num_failed = 0;
+
+/*
+ * The main loop needs a game_exit function as the logging code calls it.
+ */
+void game_exit(char *msg)
+{
+  fprintf(stderr, "%s\n", msg);
+  exit(1);
+}
+
+/*
+ * check
+ *
+ * Records the result of a check.
+ *
+ * Parameters: passed - Whether the check passed.
+ *             name - Written out if it didn't.
+ */
+void check(bool passed, char *name)
+{
+  if (!passed)
+  {
+    printf("FAILED %s\n", name);
+    g_num_failed++;
+  }
+}
+
+/*
+ * add_events
+ *
+ * Adds a list of events to a queue.
+ *
+ * Parameters: queue - The queue.
+ *             ids - The ids of the events to add, in order.
+ *             num_ids - The number of ids.
+ *             rcs - Filled in with the return code of each add. May be NULL.
+ */
+void add_events(EVENT_QUEUE *queue, int *ids, int num_ids, int *rcs)
+{
+  /*
+   * Local Variables.
+   */
+  int rc;
+  int ii;
+
+  for (ii = 0; ii < num_ids; ii++)
+  {
+    rc = add_event_to_queue(&(g_events[ids[ii]]), queue);
+    if (NULL != rcs)
+    {
+      rcs[ii] = rc;
+    }
+  }
+}
+
+/*
+ * queue_holds
+ *
+ * Empties a queue, checking that exactly the given events come off it in
+ * order.
+ *
+ * Parameters: queue - The queue.
+ *             ids - The ids of the events expected, oldest first.
+ *             num_ids - The number of ids.
+ *
+ * Returns: true if the queue held exactly those events, false otherwise.
+ */
+bool queue_holds(EVENT_QUEUE *queue, int *ids, int num_ids)
+{
+  /*
+   * Local Variables.
+   */
+  AUTOMATON_EVENT *event;
+  bool matched = true;
+  int ii;
+
+  for (ii = 0; ii < num_ids; ii++)
+  {
+    if ((!get_event_from_queue(queue, &event)) || (event->id != ids[ii]))
+    {
+      matched = false;
+    }
+  }
+
+  if (get_event_from_queue(queue, &event) || (NULL != event))
+  {
+    matched = false;
+  }
+
+  return(matched);
+}
+
+/*
+ * test_order
+ *
+ * Events come off the queue in the order they went on, and an empty queue
+ * gives nothing back.
+ */
+void test_order(void)
+{
+  /*
+   * Local Variables.
+   */
+  EVENT_QUEUE *queue;
+  AUTOMATON_EVENT *event = &(g_events[0]);
+  int ids[] = {1, 2, 3};
+
+  queue = create_event_queue(TEST_QUEUE_CAPACITY,
+                             EVENT_QUEUE_DROP_NEWEST,
+                             false);
+
+  check(!get_event_from_queue(queue, &event) && (NULL == event),
+        "order: empty queue");
+
+  add_events(queue, ids, 3, NULL);
+  check(queue_holds(queue, ids, 3), "order: first in first out");
+
+  add_events(queue, ids, 3, NULL);
+  check(queue_holds(queue, ids, 3), "order: queue reused once emptied");
+  check(3 == queue->high_water_mark, "order: high water mark");
+
+  destroy_event_queue(queue);
+}
+
+/*
+ * test_wrap_round
+ *
+ * The counts can wrap round past the largest unsigned int while events are
+ * on the queue, with the queue both part full and full.
+ */
+void test_wrap_round(void)
+{
+  /*
+   * Local Variables.
+   */
+  EVENT_QUEUE *queue;
+  int ids[] = {1, 2, 3, 4};
+  int more_ids[] = {5, 6};
+  int after_ids[] = {3, 4, 5, 6};
+  int rcs[TEST_QUEUE_CAPACITY];
+
+  queue = create_event_queue(TEST_QUEUE_CAPACITY,
+                             EVENT_QUEUE_DROP_OLDEST,
+                             false);
+  queue->head = WRAP_START_COUNT;
+  queue->tail = WRAP_START_COUNT;
+
+  add_events(queue, ids, 3, rcs);
+  check((EVENT_QUEUE_ADDED == rcs[0]) &&
+        (EVENT_QUEUE_ADDED == rcs[1]) &&
+        (EVENT_QUEUE_ADDED == rcs[2]),
+        "wrap round: added across the wrap");
+  check(3 == queue->tail - queue->head, "wrap round: count across the wrap");
+  check(queue_holds(queue, ids, 3), "wrap round: order across the wrap");
+
+  /*
+   * Fill the queue across the wrap and then push the oldest two off it.
+   */
+  queue->head = WRAP_START_COUNT;
+  queue->tail = WRAP_START_COUNT;
+  add_events(queue, ids, 4, NULL);
+  check(TEST_QUEUE_CAPACITY == queue->tail - queue->head,
+        "wrap round: full across the wrap");
+  add_events(queue, more_ids, 2, rcs);
+  check((EVENT_QUEUE_OVERFLOW == rcs[0]) && (EVENT_QUEUE_OVERFLOW == rcs[1]),
+        "wrap round: overflow across the wrap");
+  check(queue_holds(queue, after_ids, 4),
+        "wrap round: oldest dropped across the wrap");
+
+  destroy_event_queue(queue);
+}
+
+/*
+ * test_drop_newest
+ *
+ * A full queue that drops its newest event refuses the new event and keeps
+ * the ones already waiting.
+ */
+void test_drop_newest(void)
+{
+  /*
+   * Local Variables.
+   */
+  EVENT_QUEUE *queue;
+  int ids[] = {1, 2, 3, 4};
+  int rc;
+
+  queue = create_event_queue(TEST_QUEUE_CAPACITY,
+                             EVENT_QUEUE_DROP_NEWEST,
+                             false);
+
+  add_events(queue, ids, 4, NULL);
+  rc = add_event_to_queue(&(g_events[5]), queue);
+  check(EVENT_QUEUE_OVERFLOW == rc, "drop newest: overflow returned");
+  check(1 == queue->num_dropped, "drop newest: drop counted");
+  check(TEST_QUEUE_CAPACITY == queue->high_water_mark,
+        "drop newest: high water mark");
+  check(queue_holds(queue, ids, 4), "drop newest: waiting events kept");
+
+  destroy_event_queue(queue);
+}
+
+/*
+ * test_drop_oldest
+ *
+ * A full queue that drops its oldest event takes the new event in its place.
+ */
+void test_drop_oldest(void)
+{
+  /*
+   * Local Variables.
+   */
+  EVENT_QUEUE *queue;
+  int ids[] = {1, 2, 3, 4};
+  int after_ids[] = {2, 3, 4, 5};
+  int rc;
+
+  queue = create_event_queue(TEST_QUEUE_CAPACITY,
+                             EVENT_QUEUE_DROP_OLDEST,
+                             false);
+
+  add_events(queue, ids, 4, NULL);
+  rc = add_event_to_queue(&(g_events[5]), queue);
+  check(EVENT_QUEUE_OVERFLOW == rc, "drop oldest: overflow returned");
+  check(1 == queue->num_dropped, "drop oldest: drop counted");
+  check(queue_holds(queue, after_ids, 4), "drop oldest: oldest event dropped");
+
+  destroy_event_queue(queue);
+}
+
+/*
+ * test_coalesce
+ *
+ * A coalescing queue only drops an event that is the same as the last one
+ * waiting, so the order of different events is kept. A queue that doesn't
+ * coalesce keeps every event.
+ */
+void test_coalesce(void)
+{
+  /*
+   * Local Variables.
+   */
+  EVENT_QUEUE *queue;
+  int repeated_ids[] = {1, 1, 1};
+  int interleaved_ids[] = {1, 2, 1};
+  int mixed_ids[] = {1, 1, 2, 2, 1};
+  int mixed_after_ids[] = {1, 2, 1};
+  int rcs[5];
+
+  queue = create_event_queue(TEST_QUEUE_CAPACITY,
+                             EVENT_QUEUE_DROP_NEWEST,
+                             true);
+
+  add_events(queue, repeated_ids, 3, rcs);
+  check((EVENT_QUEUE_ADDED == rcs[0]) &&
+        (EVENT_QUEUE_COALESCED == rcs[1]) &&
+        (EVENT_QUEUE_COALESCED == rcs[2]),
+        "coalesce: repeated event coalesced");
+  check(2 == queue->num_coalesced, "coalesce: coalesced events counted");
+  check(queue_holds(queue, repeated_ids, 1), "coalesce: repeated event once");
+
+  add_events(queue, interleaved_ids, 3, rcs);
+  check((EVENT_QUEUE_ADDED == rcs[0]) &&
+        (EVENT_QUEUE_ADDED == rcs[1]) &&
+        (EVENT_QUEUE_ADDED == rcs[2]),
+        "coalesce: interleaved events added");
+  check(queue_holds(queue, interleaved_ids, 3),
+        "coalesce: interleaved events kept in order");
+
+  add_events(queue, mixed_ids, 5, NULL);
+  check(queue_holds(queue, mixed_after_ids, 3),
+        "coalesce: runs of events coalesced in order");
+
+  /*
+   * Once the event has been taken off the queue it can go on again.
+   */
+  add_events(queue, repeated_ids, 1, NULL);
+  check(queue_holds(queue, repeated_ids, 1), "coalesce: taken event");
+  add_events(queue, repeated_ids, 1, rcs);
+  check(EVENT_QUEUE_ADDED == rcs[0], "coalesce: taken event added again");
+  check(queue_holds(queue, repeated_ids, 1), "coalesce: taken event again");
+
+  destroy_event_queue(queue);
+
+  queue = create_event_queue(TEST_QUEUE_CAPACITY,
+                             EVENT_QUEUE_DROP_NEWEST,
+                             false);
+
+  add_events(queue, repeated_ids, 3, NULL);
+  check(0 == queue->num_coalesced, "no coalesce: nothing coalesced");
+  check(queue_holds(queue, repeated_ids, 3), "no coalesce: every event kept");
+
+  destroy_event_queue(queue);
+}
+
+/*
+ * main
+ */
+int main(void)
+{
+  /*
+   * Local Variables.
+   */
+  int ii;
+
+  for (ii = 0; ii < NUM_TEST_EVENTS; ii++)
+  {
+    g_events[ii].id = ii;
+    sprintf(g_events[ii].name, "EVENT_%d", ii);
+  }
+
+  test_order();
+  test_wrap_round();
+  test_drop_newest();
+  test_drop_oldest();
+  test_coalesce();
+
+  printf("%d checks failed\n", g_num_failed);
+
+  return((0 == g_num_failed) ? 0 : 1);
+}
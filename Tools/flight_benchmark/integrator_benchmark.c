@@ -0,0 +1,560 @@
+/*
+ * integrator_benchmark.c
+ *
+ * Stand alone program which compares the disc integrators (see DISC_INTEGRATOR
+ * in physics.h). Each integrator flies a set of standard throws at a range of
+ * step sizes and the result is compared against a reference flight calculated
+ * using RK4 with a very small step.
+ *
+ *   integrator_benchmark [timing repeats]
+ *
+ * For each integrator and step size one line is written to stdout:
+ *
+ *   integrator,step_s,force_evals,us_per_flight,max_error_m,landing_error_m
+ *
+ * force_evals and us_per_flight are the cost of a single flight (averaged
+ * over the throws). max_error_m is the largest distance from the reference
+ * flight at any of the sample times and landing_error_m is the distance
+ * between the landing points. Plotting error against cost gives the curve for
+ * each integrator.
+ *
+ * The adaptive integrator is also run at a range of tolerances, in which case
+ * the step_s column holds the tolerance (m). Its positions at the sample times
+ * and its landing point are found in the same way as for disc paths. Its
+ * force_evals assumes no step was rejected so is a slight underestimate.
+ *
+ * Finally the batched flight model (disc_flight_batch.c) is run with every
+ * entry in the batch in use, cycling through the standard throws. Its
+ * us_per_flight is the time for a whole batch divided by the batch size.
+ *
+ * This is not part of the game build. Build it from the top directory with
+ *
+ *   make integrator_benchmark
+ *
+ * using the make file generated by Tools/create_make_file.py.
+ *
+ *  Created on: 16 Oct 2026
+ *      Author: David Tyler
+ */
+#include "dt_logger.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "disc.h"
+#include "physics.h"
+#include "data_structures/vector.h"
+#include "flight_mechanics/disc_flight.h"
+#include "flight_mechanics/disc_flight_batch.h"
+
+/*
+ * Positions are compared every SAMPLE_INTERVAL_S. Every step size tested must
+ * divide into this exactly.
+ */
+#define SAMPLE_INTERVAL_S 0.040f
+#define MAX_SAMPLES 1000
+
+/*
+ * The reference flight is RK4 with this step.
+ */
+#define REFERENCE_STEP_S 0.0002f
+
+/*
+ * Each flight is repeated this many times when timing it unless a number is
+ * given on the command line.
+ */
+#define DEFAULT_TIMING_REPEATS 20
+
+#define NUM_THROWS 3
+#define NUM_STEP_SIZES 6
+#define NUM_INTEGRATORS 3
+#define NUM_TOLERANCES 5
+
+/*
+ * Matches the first step used for disc paths.
+ */
+#define ADAPTIVE_FIRST_STEP_S 0.010f
+#define ADAPTIVE_EVALS_PER_STEP 7
+
+/*
+ * FLIGHT_RECORD
+ *
+ * The result of flying one throw.
+ *
+ * samples - The position every SAMPLE_INTERVAL_S from the release.
+ * num_samples - The number of valid samples.
+ * landing - Where the disc crossed z = 0.
+ * force_evals - The number of times the forces on the disc were calculated.
+ */
+typedef struct flight_record
+{
+  VECTOR3 samples[MAX_SAMPLES];
+  int num_samples;
+  VECTOR3 landing;
+  long force_evals;
+} FLIGHT_RECORD;
+
+/*
+ * game_exit
+ *
+ * The shared code calls this on fatal errors. There is no game to exit here.
+ *
+ * Parameters: message - Why we are exiting.
+ */
+void game_exit(char *message)
+{
+  fprintf(stderr, "%s\n", message);
+  exit(1);
+}
+
+/*
+ * init_throw
+ *
+ * Sets the disc to one of the standard throws. The spin and orientation match
+ * set_init_disc_conditions in disc.c.
+ *
+ * Parameters: disc - The disc to set up.
+ *             throw_index - 0 to NUM_THROWS - 1.
+ */
+void init_throw(DISC *disc, int throw_index)
+{
+  /*
+   * Local Variables.
+   */
+  static const float velocities[NUM_THROWS][3] = {{14.0f, 0.0f, 0.0f},
+                                                   {12.0f, 3.0f, 2.0f},
+                                                   {18.0f, -2.0f, 1.0f}};
+
+  vector_set_values(&(disc->position), 0.0f, 0.0f, 1.5f);
+  vector_set_values(&(disc->velocity),
+                    velocities[throw_index][0],
+                    velocities[throw_index][1],
+                    velocities[throw_index][2]);
+  vector_set_values(&(disc->angular_velocity), -13.94f, -1.48f, -54.25f);
+  vector_set_values(&(disc->d3), 0.0f, 0.0f, 1.0f);
+}
+
+/*
+ * fly_throw
+ *
+ * Flies one of the standard throws until it hits the floor.
+ *
+ * Parameters: throw_index - Which throw.
+ *             integrator - The integrator to use.
+ *             step_s - The step size to use.
+ *             record - Filled in with the flight.
+ */
+void fly_throw(int throw_index,
+               DISC_INTEGRATOR integrator,
+               float step_s,
+               FLIGHT_RECORD *record)
+{
+  /*
+   * Local Variables.
+   */
+  DISC disc;
+  VECTOR3 last_position;
+  int steps_per_sample = (int) (SAMPLE_INTERVAL_S / step_s + 0.5f);
+  int evals_per_step = (disc_integrator_rk4 == integrator) ? 4 : 1;
+  long step = 0;
+  float fraction;
+
+  init_throw(&disc, throw_index);
+  record->num_samples = 0;
+  record->force_evals = 0;
+
+  while (disc.position.z > 0.0f)
+  {
+    if (0 == step % steps_per_sample && record->num_samples < MAX_SAMPLES)
+    {
+      record->samples[record->num_samples] = disc.position;
+      record->num_samples++;
+    }
+
+    last_position = disc.position;
+    integrate_disc_flight(&disc, &(disc.position), step_s, integrator);
+    record->force_evals += evals_per_step;
+    step++;
+  }
+
+  /*
+   * Find where the straight line between the last two positions crosses the
+   * floor.
+   */
+  fraction = last_position.z / (last_position.z - disc.position.z);
+  record->landing = vector_interpolate(&last_position,
+                                       &(disc.position),
+                                       fraction);
+}
+
+/*
+ * fly_throw_adaptive
+ *
+ * As fly_throw but using the adaptive integrator.
+ *
+ * Parameters: throw_index - Which throw.
+ *             tolerance_m - The error allowed per step.
+ *             record - Filled in with the flight.
+ */
+void fly_throw_adaptive(int throw_index,
+                        float tolerance_m,
+                        FLIGHT_RECORD *record)
+{
+  /*
+   * Local Variables.
+   */
+  DISC disc;
+  VECTOR3 start_pos;
+  VECTOR3 start_vel;
+  float step_start_t = 0.0f;
+  float step_s = ADAPTIVE_FIRST_STEP_S;
+  float taken_step_s;
+  float sample_t;
+  bool landed = false;
+
+  init_throw(&disc, throw_index);
+  record->samples[0] = disc.position;
+  record->num_samples = 1;
+  record->force_evals = 0;
+
+  while (!landed)
+  {
+    start_pos = disc.position;
+    start_vel = disc.velocity;
+    taken_step_s = integrate_disc_flight_adaptive(&disc,
+                                                  &(disc.position),
+                                                  step_s,
+                                                  tolerance_m,
+                                                  &step_s);
+    record->force_evals += ADAPTIVE_EVALS_PER_STEP;
+
+    /*
+     * Fill in any samples covered by this step.
+     */
+    sample_t = ((float) record->num_samples) * SAMPLE_INTERVAL_S;
+    while (sample_t <= step_start_t + taken_step_s &&
+           record->num_samples < MAX_SAMPLES)
+    {
+      interpolate_disc_flight_step(&start_pos,
+                                   &start_vel,
+                                   &(disc.position),
+                                   &(disc.velocity),
+                                   taken_step_s,
+                                   (sample_t - step_start_t) / taken_step_s,
+                                   &(record->samples[record->num_samples]));
+      if (record->samples[record->num_samples].z <= 0.0f)
+      {
+        break;
+      }
+      record->num_samples++;
+      sample_t = ((float) record->num_samples) * SAMPLE_INTERVAL_S;
+    }
+
+    if (disc.position.z <= 0.0f)
+    {
+      find_disc_flight_landing(&start_pos,
+                               &start_vel,
+                               &(disc.position),
+                               &(disc.velocity),
+                               taken_step_s,
+                               &(record->landing));
+      landed = true;
+    }
+    step_start_t += taken_step_s;
+  }
+}
+
+/*
+ * fly_throw_batch
+ *
+ * As fly_throw but flies a whole batch of throws at once using the batched
+ * flight model. Entry ii of the batch is standard throw ii % NUM_THROWS.
+ *
+ * Parameters: integrator - The integrator to use.
+ *             step_s - The step size to use.
+ *             records - Filled in with the flight of each entry.
+ */
+void fly_throw_batch(DISC_INTEGRATOR integrator,
+                     float step_s,
+                     FLIGHT_RECORD *records)
+{
+  /*
+   * Local Variables.
+   */
+  DISC disc;
+  DISC_BATCH batch;
+  VECTOR3 last_position[DISC_BATCH_SIZE];
+  VECTOR3 position;
+  int steps_per_sample = (int) (SAMPLE_INTERVAL_S / step_s + 0.5f);
+  int evals_per_step = (disc_integrator_rk4 == integrator) ? 4 : 1;
+  int num_in_air = DISC_BATCH_SIZE;
+  long step = 0;
+  float fraction;
+  int ii;
+
+  clear_disc_batch(&batch);
+  for (ii = 0; ii < DISC_BATCH_SIZE; ii++)
+  {
+    init_throw(&disc, ii % NUM_THROWS);
+    set_disc_batch_entry(&batch, ii, &disc);
+    records[ii].num_samples = 0;
+    records[ii].force_evals = 0;
+  }
+
+  while (num_in_air > 0)
+  {
+    for (ii = 0; ii < DISC_BATCH_SIZE; ii++)
+    {
+      vector_set_values(&(last_position[ii]),
+                        batch.pos_x[ii],
+                        batch.pos_y[ii],
+                        batch.pos_z[ii]);
+      if (last_position[ii].z > 0.0f)
+      {
+        records[ii].force_evals += evals_per_step;
+        if (0 == step % steps_per_sample &&
+            records[ii].num_samples < MAX_SAMPLES)
+        {
+          records[ii].samples[records[ii].num_samples] = last_position[ii];
+          records[ii].num_samples++;
+        }
+      }
+    }
+
+    num_in_air = step_disc_batch(&batch, step_s, integrator);
+    step++;
+
+    /*
+     * Find the landing point of any disc that has just hit the floor.
+     */
+    for (ii = 0; ii < DISC_BATCH_SIZE; ii++)
+    {
+      if (last_position[ii].z > 0.0f && batch.pos_z[ii] <= 0.0f)
+      {
+        vector_set_values(&position,
+                          batch.pos_x[ii],
+                          batch.pos_y[ii],
+                          batch.pos_z[ii]);
+        fraction = last_position[ii].z / (last_position[ii].z - position.z);
+        records[ii].landing = vector_interpolate(&(last_position[ii]),
+                                                 &position,
+                                                 fraction);
+      }
+    }
+  }
+}
+
+/*
+ * compare_flights
+ *
+ * Finds the largest distance between a flight and the reference flight at
+ * any sample time and the distance between the landing points.
+ *
+ * Parameters: result - The flight to check.
+ *             reference - The reference flight for the same throw.
+ *             max_error - Increased to the largest sample error if larger.
+ *             landing_error - Increased to the landing error if larger.
+ */
+void compare_flights(FLIGHT_RECORD *result,
+                     FLIGHT_RECORD *reference,
+                     float *max_error,
+                     float *landing_error)
+{
+  /*
+   * Local Variables.
+   */
+  VECTOR3 difference;
+  float error;
+  int num_samples;
+  int ss;
+
+  num_samples = result->num_samples;
+  if (reference->num_samples < num_samples)
+  {
+    num_samples = reference->num_samples;
+  }
+  for (ss = 0; ss < num_samples; ss++)
+  {
+    difference = vector_minus(&(result->samples[ss]),
+                              &(reference->samples[ss]));
+    error = vector_length(&difference);
+    if (error > *max_error)
+    {
+      *max_error = error;
+    }
+  }
+
+  difference = vector_minus(&(result->landing), &(reference->landing));
+  error = vector_length(&difference);
+  if (error > *landing_error)
+  {
+    *landing_error = error;
+  }
+}
+
+/*
+ * main
+ *
+ * Runs every integrator at every step size and prints the results.
+ */
+int main(int argc, char *argv[])
+{
+  /*
+   * Local Variables.
+   */
+  static const char *integrator_names[NUM_INTEGRATORS] = {"euler",
+                                                          "semi_implicit",
+                                                          "rk4"};
+  static const DISC_INTEGRATOR integrators[NUM_INTEGRATORS] = {
+                                        disc_integrator_euler,
+                                        disc_integrator_semi_implicit_euler,
+                                        disc_integrator_rk4};
+  static const float step_sizes[NUM_STEP_SIZES] = {0.001f, 0.002f, 0.005f,
+                                                   0.010f, 0.020f, 0.040f};
+  static FLIGHT_RECORD reference[NUM_THROWS];
+  static const float tolerances[NUM_TOLERANCES] = {0.01f, 0.001f, 0.0001f,
+                                                   0.00001f, 0.000001f};
+  static FLIGHT_RECORD result;
+  static FLIGHT_RECORD batch_results[DISC_BATCH_SIZE];
+  float max_error;
+  float landing_error;
+  long force_evals;
+  clock_t start;
+  double us_per_flight;
+  int timing_repeats = DEFAULT_TIMING_REPEATS;
+  int ii;
+  int jj;
+  int kk;
+  int rr;
+
+  if (argc > 1)
+  {
+    timing_repeats = atoi(argv[1]);
+    if (timing_repeats < 1)
+    {
+      game_exit("The number of timing repeats must be positive.");
+    }
+  }
+
+  for (kk = 0; kk < NUM_THROWS; kk++)
+  {
+    fly_throw(kk, disc_integrator_rk4, REFERENCE_STEP_S, &(reference[kk]));
+  }
+
+  printf("integrator,step_s,force_evals,us_per_flight,max_error_m," \
+         "landing_error_m\n");
+
+  for (ii = 0; ii < NUM_INTEGRATORS; ii++)
+  {
+    for (jj = 0; jj < NUM_STEP_SIZES; jj++)
+    {
+      max_error = 0.0f;
+      landing_error = 0.0f;
+      force_evals = 0;
+
+      /*
+       * Accuracy.
+       */
+      for (kk = 0; kk < NUM_THROWS; kk++)
+      {
+        fly_throw(kk, integrators[ii], step_sizes[jj], &result);
+        force_evals += result.force_evals;
+        compare_flights(&result, &(reference[kk]), &max_error, &landing_error);
+      }
+
+      /*
+       * Cost.
+       */
+      start = clock();
+      for (rr = 0; rr < timing_repeats; rr++)
+      {
+        for (kk = 0; kk < NUM_THROWS; kk++)
+        {
+          fly_throw(kk, integrators[ii], step_sizes[jj], &result);
+        }
+      }
+      us_per_flight = ((double) (clock() - start)) * 1000000.0 /
+                      ((double) CLOCKS_PER_SEC * timing_repeats * NUM_THROWS);
+
+      printf("%s,%.3f,%ld,%.1f,%.5f,%.5f\n",
+             integrator_names[ii],
+             step_sizes[jj],
+             force_evals / NUM_THROWS,
+             us_per_flight,
+             max_error,
+             landing_error);
+    }
+  }
+
+  for (jj = 0; jj < NUM_TOLERANCES; jj++)
+  {
+    max_error = 0.0f;
+    landing_error = 0.0f;
+    force_evals = 0;
+
+    for (kk = 0; kk < NUM_THROWS; kk++)
+    {
+      fly_throw_adaptive(kk, tolerances[jj], &result);
+      force_evals += result.force_evals;
+      compare_flights(&result, &(reference[kk]), &max_error, &landing_error);
+    }
+
+    start = clock();
+    for (rr = 0; rr < timing_repeats; rr++)
+    {
+      for (kk = 0; kk < NUM_THROWS; kk++)
+      {
+        fly_throw_adaptive(kk, tolerances[jj], &result);
+      }
+    }
+    us_per_flight = ((double) (clock() - start)) * 1000000.0 /
+                    ((double) CLOCKS_PER_SEC * timing_repeats * NUM_THROWS);
+
+    printf("adaptive,%g,%ld,%.1f,%.5f,%.5f\n",
+           tolerances[jj],
+           force_evals / NUM_THROWS,
+           us_per_flight,
+           max_error,
+           landing_error);
+  }
+
+  for (ii = 0; ii < NUM_INTEGRATORS; ii++)
+  {
+    for (jj = 0; jj < NUM_STEP_SIZES; jj++)
+    {
+      max_error = 0.0f;
+      landing_error = 0.0f;
+      force_evals = 0;
+
+      fly_throw_batch(integrators[ii], step_sizes[jj], batch_results);
+      for (kk = 0; kk < DISC_BATCH_SIZE; kk++)
+      {
+        force_evals += batch_results[kk].force_evals;
+        compare_flights(&(batch_results[kk]),
+                        &(reference[kk % NUM_THROWS]),
+                        &max_error,
+                        &landing_error);
+      }
+
+      start = clock();
+      for (rr = 0; rr < timing_repeats; rr++)
+      {
+        fly_throw_batch(integrators[ii], step_sizes[jj], batch_results);
+      }
+      us_per_flight = ((double) (clock() - start)) * 1000000.0 /
+                      ((double) CLOCKS_PER_SEC * timing_repeats *
+                       DISC_BATCH_SIZE);
+
+      printf("batch_%s,%.3f,%ld,%.1f,%.5f,%.5f\n",
+             integrator_names[ii],
+             step_sizes[jj],
+             force_evals / DISC_BATCH_SIZE,
+             us_per_flight,
+             max_error,
+             landing_error);
+    }
+  }
+
+  return(0);
+}
@@ -0,0 +1,601 @@
+/*
+ * generate_flight_lu_table.c
+ *
+ * Stand alone program which fills in a FLIGHT_CONDITION_LU_TABLE (see
+ * flight_condition_lu_table.h) using the flight model and writes it to the
+ * file that the game maps in at startup (FLIGHT_LU_TABLE in config.txt).
+ *
+ *   generate_flight_lu_table <output file> [num threads]
+ *
+ * By default there is one thread per core.
+ *
+ * Each entry of the table is a flat throw with the entry's roll that lands at
+ * the entry's distance along the +x axis. The speed is found by a
+ * multisection search: every round flies a whole batch of discs
+ * (disc_flight_batch.c) at speeds spread evenly across the current bracket
+ * and keeps the pair of neighbouring speeds whose landing distances are either
+ * side of the target. The throw is then flown once as the match flies it and
+ * turned so that it lands on the +x axis. The rows of the table are shared
+ * out between worker threads so the table is generated on all cores.
+ *
+ * Distances which can't be reached within MIN_DISC_SPEED to MAX_DISC_SPEED are
+ * given the nearest speed and counted in the summary.
+ *
+ * Once written the file is loaded back through load_flight_condition_lu_table
+ * and the conditions at every entry and at the centre of every cell are flown
+ * with a DISC_FLIGHT, as the match flies the disc. The worst and mean misses
+ * are written to stdout.
+ *
+ * This is not part of the game build, but the make file generated by
+ * Tools/create_make_file.py builds and runs it to make the game's table as
+ * part of make game. Build it on its own from the top directory with
+ *
+ *   make generate_flight_lu_table
+ *
+ *  Created on: 16 Oct 2026
+ *      Author: David Tyler
+ */
+#include "dt_logger.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+#include "SDL/SDL.h"
+#include "SDL/SDL_thread.h"
+#include "disc.h"
+#include "flight_condition_lu_table.h"
+#include "physics.h"
+#include "throw_constants.h"
+#include "throw_init_condition.h"
+#include "data_structures/vector.h"
+#include "flight_mechanics/disc_flight.h"
+#include "flight_mechanics/disc_flight_batch.h"
+
+/*
+ * The grid of the generated table. Interpolating across roll is what limits
+ * the accuracy of a throw from the table, so the roll spacing is chosen to
+ * keep the error at the centre of each cell under THROW_SOLVER_TOLERANCE_M.
+ */
+#define TABLE_MIN_DISTANCE_M 5.0f
+#define TABLE_MAX_DISTANCE_M 50.0f
+#define TABLE_DISTANCE_DELTA_M 0.5f
+#define TABLE_MIN_ROLL_RAD -0.3f
+#define TABLE_MAX_ROLL_RAD 0.3f
+#define TABLE_ROLL_DELTA_RAD 0.025f
+
+/*
+ * Flights are integrated with RK4 at this step.
+ */
+#define FLIGHT_STEP_S 0.005f
+#define MAX_FLIGHT_STEPS 4000
+
+/*
+ * The longest flight followed with a DISC_FLIGHT.
+ */
+#define MAX_MATCH_FLIGHT_TIME_S 20.0f
+
+/*
+ * Each round of the search narrows the bracket by DISC_BATCH_SIZE - 1 so with
+ * the default batch size this gives a bracket of under 1mm/s.
+ */
+#define NUM_SEARCH_ROUNDS 6
+
+#define MAX_NUM_THREADS 64
+
+/*
+ * GENERATOR_STATE
+ *
+ * Shared between the worker threads.
+ *
+ * table - The table being filled in.
+ * lock - Protects next_row and num_unreachable.
+ * next_row - The next row of the table that no worker has taken.
+ * num_unreachable - Entries which could not be reached at any allowed speed.
+ */
+typedef struct generator_state
+{
+  FLIGHT_CONDITION_LU_TABLE *table;
+  SDL_mutex *lock;
+  int next_row;
+  int num_unreachable;
+} GENERATOR_STATE;
+
+/*
+ * game_exit
+ *
+ * The shared code calls this on fatal errors. There is no game to exit here.
+ *
+ * Parameters: message - Why we are exiting.
+ */
+void game_exit(char *message)
+{
+  fprintf(stderr, "%s\n", message);
+  exit(1);
+}
+
+/*
+ * count_cores
+ *
+ * Returns: The number of cores the machine has online, between 1 and
+ *          MAX_NUM_THREADS.
+ */
+int count_cores()
+{
+  /*
+   * Local Variables.
+   */
+  long num_cores;
+#ifdef _WIN32
+  SYSTEM_INFO system_info;
+
+  GetSystemInfo(&system_info);
+  num_cores = (long) system_info.dwNumberOfProcessors;
+#else
+  num_cores = sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+
+  if (num_cores < 1)
+  {
+    num_cores = 1;
+  }
+  else if (num_cores > MAX_NUM_THREADS)
+  {
+    num_cores = MAX_NUM_THREADS;
+  }
+
+  return((int) num_cores);
+}
+
+/*
+ * fly_batch_of_throws
+ *
+ * Flies up to DISC_BATCH_SIZE throws from the table's release point and works
+ * out how far along the ground each one travels.
+ *
+ * Parameters: velocities - The initial velocity of each throw.
+ *             ups - The initial up vector of each throw.
+ *             num_throws - The number of throws (at most DISC_BATCH_SIZE).
+ *             distances - Filled in with the distance from the release point
+ *                         to the landing point of each throw.
+ */
+void fly_batch_of_throws(VECTOR3 *velocities,
+                         VECTOR3 *ups,
+                         int num_throws,
+                         float *distances)
+{
+  /*
+   * Local Variables.
+   */
+  DISC_BATCH batch;
+  DISC_BATCH_LANDING landing;
+  DISC disc;
+  int ii;
+
+  clear_disc_batch(&batch);
+  vector_set_values(&(disc.position), 0.0f, 0.0f, DISC_THROW_RELEASE_HEIGHT_M);
+  vector_set_values(&(disc.angular_velocity),
+                    DISC_THROW_ANGULAR_VELOCITY_X,
+                    DISC_THROW_ANGULAR_VELOCITY_Y,
+                    DISC_THROW_ANGULAR_VELOCITY_Z);
+  for (ii = 0; ii < num_throws; ii++)
+  {
+    vector_copy_values(&(disc.velocity), &(velocities[ii]));
+    vector_copy_values(&(disc.d3), &(ups[ii]));
+    set_disc_batch_entry(&batch, ii, &disc);
+  }
+
+  fly_disc_batch_to_ground(&batch,
+                           FLIGHT_STEP_S,
+                           disc_integrator_rk4,
+                           MAX_FLIGHT_STEPS,
+                           &landing);
+
+  for (ii = 0; ii < num_throws; ii++)
+  {
+    distances[ii] = sqrtf(landing.x[ii] * landing.x[ii] +
+                          landing.y[ii] * landing.y[ii]);
+  }
+}
+
+/*
+ * fly_throw_as_match
+ *
+ * Flies a throw from the table's release point with a DISC_FLIGHT, as the
+ * match flies the disc.
+ *
+ * Parameters: condition - The throw.
+ *             landing - Filled in with where the disc landed.
+ *
+ * Returns: false if the disc hadn't landed after MAX_MATCH_FLIGHT_TIME_S,
+ *          true otherwise.
+ */
+bool fly_throw_as_match(THROW_INIT_CONDITION *condition, VECTOR3 *landing)
+{
+  /*
+   * Local Variables.
+   */
+  DISC disc;
+  DISC_FLIGHT flight;
+  VECTOR3 position;
+
+  vector_set_values(&(disc.position), 0.0f, 0.0f, DISC_THROW_RELEASE_HEIGHT_M);
+  vector_copy_values(&(disc.velocity), &(condition->velocity));
+  vector_copy_values(&(disc.d3), &(condition->up));
+  vector_set_values(&(disc.angular_velocity),
+                    DISC_THROW_ANGULAR_VELOCITY_X,
+                    DISC_THROW_ANGULAR_VELOCITY_Y,
+                    DISC_THROW_ANGULAR_VELOCITY_Z);
+  start_disc_flight(&flight, &disc);
+
+  fly_disc_flight(&flight, MAX_MATCH_FLIGHT_TIME_S, &position, NULL);
+  if (!flight.landed)
+  {
+    return(false);
+  }
+
+  vector_copy_values(landing, &(flight.landing));
+
+  return(true);
+}
+
+/*
+ * turn_throw_init_condition
+ *
+ * Turns a throw about the vertical. The flight is the same but for the turn.
+ *
+ * Parameters: condition - The throw to turn.
+ *             angle - The angle to turn it by, anticlockwise from above.
+ */
+void turn_throw_init_condition(THROW_INIT_CONDITION *condition, float angle)
+{
+  /*
+   * Local Variables.
+   */
+  VECTOR3 velocity = condition->velocity;
+  VECTOR3 up = condition->up;
+  float cos_angle = cosf(angle);
+  float sin_angle = sinf(angle);
+
+  vector_set_values(&(condition->velocity),
+                    velocity.x * cos_angle - velocity.y * sin_angle,
+                    velocity.x * sin_angle + velocity.y * cos_angle,
+                    velocity.z);
+  vector_set_values(&(condition->up),
+                    up.x * cos_angle - up.y * sin_angle,
+                    up.x * sin_angle + up.y * cos_angle,
+                    up.z);
+}
+
+/*
+ * solve_throw_init_condition
+ *
+ * Finds the speed at which a throw with the condition's roll lands at the
+ * condition's distance and fills in the velocity and up vector, turned so
+ * that the throw lands on the +x axis.
+ *
+ * Parameters: condition - The entry to fill in. The distance and roll must
+ *                         already be set.
+ *
+ * Returns: true if the distance can be reached, false if the condition was
+ *          given the nearest speed instead.
+ */
+bool solve_throw_init_condition(THROW_INIT_CONDITION *condition)
+{
+  /*
+   * Local Variables.
+   */
+  VECTOR3 velocities[DISC_BATCH_SIZE];
+  VECTOR3 ups[DISC_BATCH_SIZE];
+  VECTOR3 landing;
+  float speeds[DISC_BATCH_SIZE];
+  float distances[DISC_BATCH_SIZE];
+  float low_speed = MIN_DISC_SPEED;
+  float high_speed = MAX_DISC_SPEED;
+  float low_distance = 0.0f;
+  float high_distance = 0.0f;
+  float speed;
+  bool reachable = true;
+  int round;
+  int ii;
+
+  for (ii = 0; ii < DISC_BATCH_SIZE; ii++)
+  {
+    vector_set_values(&(ups[ii]),
+                      0.0f,
+                      -sinf(condition->roll),
+                      cosf(condition->roll));
+  }
+
+  for (round = 0; round < NUM_SEARCH_ROUNDS; round++)
+  {
+    for (ii = 0; ii < DISC_BATCH_SIZE; ii++)
+    {
+      speeds[ii] = low_speed +
+                   (high_speed - low_speed) * ii / (DISC_BATCH_SIZE - 1);
+      vector_set_values(&(velocities[ii]), speeds[ii], 0.0f, 0.0f);
+    }
+    fly_batch_of_throws(velocities, ups, DISC_BATCH_SIZE, distances);
+
+    if (0 == round)
+    {
+      if (condition->distance <= distances[0])
+      {
+        speed = speeds[0];
+        reachable = (condition->distance == distances[0]);
+        goto EXIT_LABEL;
+      }
+      if (condition->distance > distances[DISC_BATCH_SIZE - 1])
+      {
+        speed = speeds[DISC_BATCH_SIZE - 1];
+        reachable = false;
+        goto EXIT_LABEL;
+      }
+    }
+
+    /*
+     * Keep the first pair of speeds either side of the target. The bracket
+     * always contains the target so one such pair exists.
+     */
+    for (ii = 1; ii < DISC_BATCH_SIZE - 1; ii++)
+    {
+      if (distances[ii] >= condition->distance)
+      {
+        break;
+      }
+    }
+    low_speed = speeds[ii - 1];
+    high_speed = speeds[ii];
+    low_distance = distances[ii - 1];
+    high_distance = distances[ii];
+  }
+
+  /*
+   * Finish with a straight line between the ends of the final bracket.
+   */
+  speed = low_speed;
+  if (high_distance > low_distance)
+  {
+    speed += (high_speed - low_speed) *
+             (condition->distance - low_distance) /
+             (high_distance - low_distance);
+  }
+
+EXIT_LABEL:
+
+  vector_set_values(&(condition->velocity), speed, 0.0f, 0.0f);
+  vector_copy_values(&(condition->up), &(ups[0]));
+
+  /*
+   * Roll curves the throw off to one side, so turn it to land on the +x axis.
+   * The match's own flight is used for this so that a throw taken from the
+   * table lands where it is aimed in a match.
+   */
+  if (fly_throw_as_match(condition, &landing))
+  {
+    turn_throw_init_condition(condition, -atan2f(landing.y, landing.x));
+  }
+
+  return(reachable);
+}
+
+/*
+ * generator_worker
+ *
+ * Thread function which takes rows of the table and fills them in until there
+ * are none left.
+ *
+ * Parameters: data - The GENERATOR_STATE.
+ *
+ * Returns: 0.
+ */
+int generator_worker(void *data)
+{
+  /*
+   * Local Variables.
+   */
+  GENERATOR_STATE *state = (GENERATOR_STATE *) data;
+  FLIGHT_CONDITION_LU_TABLE *table = state->table;
+  int row;
+  int num_unreachable;
+  int jj;
+
+  while (true)
+  {
+    SDL_LockMutex(state->lock);
+    row = state->next_row++;
+    SDL_UnlockMutex(state->lock);
+
+    if (row >= table->num_distances)
+    {
+      break;
+    }
+
+    num_unreachable = 0;
+    for (jj = 0; jj < table->num_rolls; jj++)
+    {
+      if (!solve_throw_init_condition(get_flight_condition_lu_entry(table,
+                                                                    row,
+                                                                    jj)))
+      {
+        num_unreachable++;
+      }
+    }
+
+    SDL_LockMutex(state->lock);
+    state->num_unreachable += num_unreachable;
+    SDL_UnlockMutex(state->lock);
+  }
+
+  return(0);
+}
+
+/*
+ * check_table
+ *
+ * Flies conditions looked up in a table with fly_throw_as_match and writes
+ * how far they land from (distance, 0) to stdout. These are the misses of a
+ * throw taken from the table in a match. At the entries themselves they are the
+ * difference between the batch flights used to fill the table in and the
+ * match's own. At the centre of each cell they also include the error of
+ * interpolating between entries.
+ *
+ * Parameters: table - The table to check.
+ *             offset - 0 to check at every entry, 0.5 to check at the centre
+ *                      of every cell.
+ *             description - What is being checked, for the output.
+ */
+void check_table(FLIGHT_CONDITION_LU_TABLE *table,
+                 float offset,
+                 char *description)
+{
+  /*
+   * Local Variables.
+   */
+  THROW_INIT_CONDITION condition;
+  VECTOR3 landing;
+  float error;
+  float max_error = 0.0f;
+  double total_error = 0.0;
+  int num_checked = 0;
+  int num_not_landed = 0;
+  int num_skipped = (offset > 0.0f) ? 1 : 0;
+  int ii;
+  int jj;
+
+  /*
+   * There is one cell fewer than entries each way.
+   */
+  for (ii = 0; ii < table->num_distances - num_skipped; ii++)
+  {
+    for (jj = 0; jj < table->num_rolls - num_skipped; jj++)
+    {
+      get_throw_init_condition(table,
+                               table->min_distance +
+                               (ii + offset) * table->distance_delta,
+                               table->min_roll +
+                               (jj + offset) * table->roll_delta,
+                               &condition);
+      if (!fly_throw_as_match(&condition, &landing))
+      {
+        num_not_landed++;
+        continue;
+      }
+      error = sqrtf((landing.x - condition.distance) *
+                    (landing.x - condition.distance) +
+                    landing.y * landing.y);
+      max_error = (error > max_error) ? error : max_error;
+      total_error += error;
+      num_checked++;
+    }
+  }
+
+  if (num_checked > 0)
+  {
+    printf("Checked %i %s: max miss %.4fm, mean miss %.4fm\n",
+           num_checked,
+           description,
+           max_error,
+           total_error / num_checked);
+  }
+  if (num_not_landed > 0)
+  {
+    printf("%i %s did not land\n", num_not_landed, description);
+  }
+}
+
+int main(int argc, char *argv[])
+{
+  /*
+   * Local Variables.
+   */
+  GENERATOR_STATE state;
+  FLIGHT_CONDITION_LU_TABLE *loaded_table;
+  SDL_Thread *threads[MAX_NUM_THREADS];
+  int num_threads = count_cores();
+  int rc;
+  int ii;
+
+  if ((argc < 2) || (argc > 3))
+  {
+    fprintf(stderr, "Usage: %s <output file> [num threads]\n", argv[0]);
+    return(1);
+  }
+  if (3 == argc)
+  {
+    num_threads = atoi(argv[2]);
+    if ((num_threads < 1) || (num_threads > MAX_NUM_THREADS))
+    {
+      fprintf(stderr, "Number of threads must be 1 to %i\n", MAX_NUM_THREADS);
+      return(1);
+    }
+  }
+
+  state.table = create_flight_condition_lu_table();
+  rc = init_flight_condition_lu_table(state.table,
+                                      TABLE_MIN_DISTANCE_M,
+                                      TABLE_MAX_DISTANCE_M,
+                                      TABLE_DISTANCE_DELTA_M,
+                                      TABLE_MIN_ROLL_RAD,
+                                      TABLE_MAX_ROLL_RAD,
+                                      TABLE_ROLL_DELTA_RAD);
+  if (FLIGHT_LU_TABLE_OK != rc)
+  {
+    game_exit("Table grid is not valid.");
+  }
+  state.lock = SDL_CreateMutex();
+  state.next_row = 0;
+  state.num_unreachable = 0;
+
+  /*
+   * Fill the table in on all the threads. If a thread can't be started its
+   * share of the rows is picked up by the others.
+   */
+  for (ii = 0; ii < num_threads; ii++)
+  {
+    threads[ii] = SDL_CreateThread(generator_worker, &state);
+  }
+  for (ii = 0; ii < num_threads; ii++)
+  {
+    if (NULL != threads[ii])
+    {
+      SDL_WaitThread(threads[ii], NULL);
+    }
+  }
+  if (state.next_row < state.table->num_distances)
+  {
+    generator_worker(&state);
+  }
+  SDL_DestroyMutex(state.lock);
+
+  printf("Generated %i x %i table, %i entries out of range\n",
+         state.table->num_distances,
+         state.table->num_rolls,
+         state.num_unreachable);
+
+  rc = save_flight_condition_lu_table(state.table, argv[1]);
+  destroy_flight_condition_lu_table(state.table);
+  if (FLIGHT_LU_TABLE_OK != rc)
+  {
+    game_exit("Could not write the table.");
+  }
+
+  /*
+   * Check the file by loading it the same way the game does.
+   */
+  loaded_table = create_flight_condition_lu_table();
+  rc = load_flight_condition_lu_table(loaded_table, argv[1]);
+  if (FLIGHT_LU_TABLE_OK != rc)
+  {
+    game_exit("Could not load the table back.");
+  }
+  check_table(loaded_table, 0.0f, "entries");
+  check_table(loaded_table, 0.5f, "cell centres");
+  destroy_flight_condition_lu_table(loaded_table);
+
+  return(0);
+}
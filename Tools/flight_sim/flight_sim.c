@@ -0,0 +1,785 @@
+/*
+ * flight_sim.c
+ *
+ * Stand alone program which flies a file of discs through the game's flight
+ * model without the rest of the game (no video, GL, TTF or match). Used to see
+ * the effect of changes to the CONST_* coefficients in disc_flight_constants.h
+ * without running the game.
+ *
+ *   flight_sim [options] <input file>
+ *
+ *   -o <file>    Write the output here rather than to stdout.
+ *   -m <mode>    summary (default) or trajectory.
+ *   -f <format>  csv (default) or binary.
+ *   -i <name>    Integrator: adaptive (the default, as used in the match),
+ *                euler, semi_implicit_euler or rk4.
+ *   -s <s>       Integration step (default 0.01s, the match step). The
+ *                adaptive integrator chooses its own steps and the disc is
+ *                read from it at this step instead, as in the match.
+ *   -d <s>       Trajectory sample interval (default every step). Rounded to
+ *                a whole number of steps.
+ *   -t <s>       Give up on flights longer than this (default 20s).
+ *   -j <n>       Number of threads (default 4).
+ *
+ * Each line of the input file is one disc, as 12 numbers separated by commas
+ * or spaces:
+ *
+ *   px py pz vx vy vz wx wy wz ux uy uz
+ *
+ * being the position, velocity, angular velocity and up vector (d3) at the
+ * start of the flight. A line with only the first 6 numbers is given the spin
+ * and orientation of a standard throw (see disc.h). Blank lines and lines
+ * starting with # are ignored.
+ *
+ * The discs are shared out between the threads. With the adaptive integrator
+ * every disc is flown with a DISC_FLIGHT exactly as in the match. The other
+ * integrators move it with calculate_disc_position. The landing point is
+ * found within the final step as for disc paths. Output is always in input
+ * order.
+ *
+ * Summary output has one record per disc:
+ *
+ *   disc,landed,landing_x,landing_y,landing_time_s,apex_z,distance_m
+ *
+ * Trajectory output has one record per sample, the last sample of a landed
+ * disc being the landing point:
+ *
+ *   disc,t_s,x,y,z,vx,vy,vz
+ *
+ * In binary format the records are written one after another with no header,
+ * in the byte order of the machine, as FLIGHT_SIM_SUMMARY_RECORD or
+ * FLIGHT_SIM_TRAJECTORY_RECORD below (all fields 4 bytes, no padding).
+ *
+ * This is not part of the game build. Build it from the top directory with
+ *
+ *   make flight_sim
+ *
+ * using the make file generated by Tools/create_make_file.py.
+ *
+ * Only SDL threads are used from SDL.
+ *
+ *  Created on: 16 Oct 2026
+ *      Author: David Tyler
+ */
+#include "dt_logger.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "SDL/SDL.h"
+#include "SDL/SDL_thread.h"
+#include "disc.h"
+#include "physics.h"
+#include "data_structures/vector.h"
+#include "flight_mechanics/disc_flight.h"
+
+#define MAX_INPUT_LINE_LEN 1024
+#define INPUT_VALUES_FULL 12
+#define INPUT_VALUES_SHORT 6
+
+#define DEFAULT_STEP_S 0.01f
+#define DEFAULT_MAX_FLIGHT_S 20.0f
+#define DEFAULT_NUM_THREADS 4
+#define MAX_NUM_THREADS 64
+
+/*
+ * Discs are handed to the threads this many at a time.
+ */
+#define DISCS_PER_CHUNK 16
+
+/*
+ * FLIGHT_SIM_SAMPLE
+ *
+ * The state of a disc at one point in a trajectory.
+ */
+typedef struct flight_sim_sample
+{
+  float time_s;
+  VECTOR3 position;
+  VECTOR3 velocity;
+} FLIGHT_SIM_SAMPLE;
+
+/*
+ * FLIGHT_SIM_RESULT
+ *
+ * The result of flying one disc.
+ *
+ * landed - Whether the disc reached the ground within the time allowed.
+ * landing - Where the disc landed, or its last position if it didn't.
+ * landing_time_s - When the disc landed, or the last time if it didn't.
+ * apex_z - The highest point of the flight.
+ * samples - The trajectory. NULL in summary mode.
+ * num_samples - The number of samples in the trajectory.
+ */
+typedef struct flight_sim_result
+{
+  bool landed;
+  VECTOR3 landing;
+  float landing_time_s;
+  float apex_z;
+  FLIGHT_SIM_SAMPLE *samples;
+  int num_samples;
+} FLIGHT_SIM_RESULT;
+
+/*
+ * The binary output records.
+ */
+typedef struct flight_sim_summary_record
+{
+  unsigned int disc;
+  unsigned int landed;
+  float landing_x;
+  float landing_y;
+  float landing_time_s;
+  float apex_z;
+  float distance_m;
+} FLIGHT_SIM_SUMMARY_RECORD;
+
+typedef struct flight_sim_trajectory_record
+{
+  unsigned int disc;
+  float time_s;
+  float x;
+  float y;
+  float z;
+  float vx;
+  float vy;
+  float vz;
+} FLIGHT_SIM_TRAJECTORY_RECORD;
+
+/*
+ * FLIGHT_SIM
+ *
+ * Everything shared between the worker threads.
+ *
+ * discs - The starting state of every disc read from the input file.
+ * results - The result for each disc.
+ * num_discs - The number of discs.
+ * adaptive - Whether to fly the discs as in the match rather than with
+ *            integrator.
+ * integrator - The integrator to use if not adaptive.
+ * step_s - The integration step.
+ * steps_per_sample - Record a trajectory sample every this many steps, or 0
+ *                    for summary mode.
+ * max_steps - The most steps any flight is given.
+ * lock - Protects next_disc.
+ * next_disc - The first disc not yet taken by a thread.
+ */
+typedef struct flight_sim
+{
+  DISC *discs;
+  FLIGHT_SIM_RESULT *results;
+  int num_discs;
+  bool adaptive;
+  DISC_INTEGRATOR integrator;
+  float step_s;
+  int steps_per_sample;
+  int max_steps;
+  SDL_mutex *lock;
+  int next_disc;
+} FLIGHT_SIM;
+
+/*
+ * game_exit
+ *
+ * The shared code calls this on fatal errors. There is no game to exit here.
+ *
+ * Parameters: message - Why we are exiting.
+ */
+void game_exit(char *message)
+{
+  fprintf(stderr, "%s\n", message);
+  exit(1);
+}
+
+/*
+ * parse_disc_line
+ *
+ * Reads a disc from one line of the input file.
+ *
+ * Parameters: line - The line. Modified.
+ *             disc - Filled in with the starting state.
+ *
+ * Returns: 1 if a disc was read, 0 if the line is blank or a comment and -1 if
+ *          the line can't be read.
+ */
+int parse_disc_line(char *line, DISC *disc)
+{
+  /*
+   * Local Variables.
+   */
+  float values[INPUT_VALUES_FULL];
+  char *token;
+  char *end;
+  int num_values = 0;
+
+  token = strtok(line, " ,\t\r\n");
+  if ((NULL == token) || ('#' == token[0]))
+  {
+    return(0);
+  }
+
+  while (NULL != token)
+  {
+    if (num_values == INPUT_VALUES_FULL)
+    {
+      return(-1);
+    }
+    values[num_values] = strtof(token, &end);
+    if ((end == token) || ('\0' != *end))
+    {
+      return(-1);
+    }
+    num_values++;
+    token = strtok(NULL, " ,\t\r\n");
+  }
+
+  if (INPUT_VALUES_SHORT == num_values)
+  {
+    values[6] = DISC_THROW_ANGULAR_VELOCITY_X;
+    values[7] = DISC_THROW_ANGULAR_VELOCITY_Y;
+    values[8] = DISC_THROW_ANGULAR_VELOCITY_Z;
+    values[9] = 0.0f;
+    values[10] = 0.0f;
+    values[11] = 1.0f;
+  }
+  else if (INPUT_VALUES_FULL != num_values)
+  {
+    return(-1);
+  }
+
+  vector_set_values(&(disc->position), values[0], values[1], values[2]);
+  vector_set_values(&(disc->velocity), values[3], values[4], values[5]);
+  vector_set_values(&(disc->angular_velocity), values[6], values[7], values[8]);
+  vector_set_values(&(disc->d3), values[9], values[10], values[11]);
+
+  return(1);
+}
+
+/*
+ * read_discs
+ *
+ * Reads every disc in the input file.
+ *
+ * Parameters: filename - The input file.
+ *             discs - Filled in with an array of the discs. Free with DT_FREE.
+ *
+ * Returns: The number of discs read. Exits on a bad file.
+ */
+int read_discs(char *filename, DISC **discs)
+{
+  /*
+   * Local Variables.
+   */
+  FILE *file;
+  char line[MAX_INPUT_LINE_LEN];
+  DISC disc;
+  int num_discs = 0;
+  int line_number = 0;
+  int rc;
+
+  file = fopen(filename, "r");
+  if (NULL == file)
+  {
+    game_exit("Could not open the input file.");
+  }
+
+  /*
+   * Count the discs first so that the array can be allocated in one go.
+   */
+  while (NULL != fgets(line, MAX_INPUT_LINE_LEN, file))
+  {
+    line_number++;
+    rc = parse_disc_line(line, &disc);
+    if (rc < 0)
+    {
+      fprintf(stderr, "Bad disc on line %i\n", line_number);
+      game_exit("Could not read the input file.");
+    }
+    num_discs += rc;
+  }
+
+  *discs = (DISC *) DT_MALLOC(sizeof(DISC) * (num_discs > 0 ? num_discs : 1));
+  rewind(file);
+  num_discs = 0;
+  while (NULL != fgets(line, MAX_INPUT_LINE_LEN, file))
+  {
+    num_discs += parse_disc_line(line, &((*discs)[num_discs]));
+  }
+  fclose(file);
+
+  return(num_discs);
+}
+
+/*
+ * add_trajectory_sample
+ *
+ * Parameters: result - The result to add to. Must have room.
+ *             time_s - The time of the sample.
+ *             position, velocity - The disc state.
+ */
+void add_trajectory_sample(FLIGHT_SIM_RESULT *result,
+                           float time_s,
+                           VECTOR3 *position,
+                           VECTOR3 *velocity)
+{
+  result->samples[result->num_samples].time_s = time_s;
+  vector_copy_values(&(result->samples[result->num_samples].position),
+                     position);
+  vector_copy_values(&(result->samples[result->num_samples].velocity),
+                     velocity);
+  result->num_samples++;
+}
+
+/*
+ * fly_disc
+ *
+ * Flies one disc until it lands or runs out of time.
+ *
+ * Parameters: sim - The simulation settings.
+ *             disc - A working disc object to fly with.
+ *             start - The starting state of the disc.
+ *             result - Filled in with the result.
+ */
+void fly_disc(FLIGHT_SIM *sim,
+              DISC *disc,
+              DISC *start,
+              FLIGHT_SIM_RESULT *result)
+{
+  /*
+   * Local Variables.
+   */
+  DISC_FLIGHT flight;
+  VECTOR3 prev_position;
+  VECTOR3 prev_velocity;
+  float fraction;
+  bool in_air;
+  int step;
+
+  vector_copy_values(&(disc->position), &(start->position));
+  vector_copy_values(&(disc->velocity), &(start->velocity));
+  vector_copy_values(&(disc->angular_velocity), &(start->angular_velocity));
+  vector_copy_values(&(disc->d3), &(start->d3));
+  disc->disc_state = disc_in_air;
+
+  result->landed = false;
+  result->apex_z = disc->position.z;
+  result->num_samples = 0;
+  result->samples = NULL;
+  if (sim->steps_per_sample > 0)
+  {
+    result->samples = (FLIGHT_SIM_SAMPLE *) DT_MALLOC(
+                  sizeof(FLIGHT_SIM_SAMPLE) *
+                  (sim->max_steps / sim->steps_per_sample + 2));
+    add_trajectory_sample(result, 0.0f, &(disc->position), &(disc->velocity));
+  }
+
+  if (sim->adaptive)
+  {
+    start_disc_flight(&flight, disc);
+  }
+
+  for (step = 1; step <= sim->max_steps; step++)
+  {
+    vector_copy_values(&prev_position, &(disc->position));
+    vector_copy_values(&prev_velocity, &(disc->velocity));
+
+    if (sim->adaptive)
+    {
+      in_air = fly_disc_flight(&flight,
+                               step * sim->step_s,
+                               &(disc->position),
+                               &(disc->velocity));
+    }
+    else
+    {
+      calculate_disc_position(disc, sim->step_s, false, sim->integrator);
+      in_air = (disc->position.z > 0.0f);
+    }
+
+    if (disc->position.z > result->apex_z)
+    {
+      result->apex_z = disc->position.z;
+    }
+
+    if (!in_air)
+    {
+      if (sim->adaptive)
+      {
+        vector_copy_values(&(result->landing), &(flight.landing));
+        result->landing_time_s = flight.landing_t;
+      }
+      else
+      {
+        fraction = find_disc_flight_landing(&prev_position,
+                                            &prev_velocity,
+                                            &(disc->position),
+                                            &(disc->velocity),
+                                            sim->step_s,
+                                            &(result->landing));
+        result->landing_time_s = (step - 1 + fraction) * sim->step_s;
+      }
+      result->landed = true;
+      break;
+    }
+
+    if ((sim->steps_per_sample > 0) && (0 == step % sim->steps_per_sample))
+    {
+      add_trajectory_sample(result,
+                            step * sim->step_s,
+                            &(disc->position),
+                            &(disc->velocity));
+    }
+  }
+
+  if (!result->landed)
+  {
+    vector_copy_values(&(result->landing), &(disc->position));
+    result->landing_time_s = sim->max_steps * sim->step_s;
+  }
+  else if (sim->steps_per_sample > 0)
+  {
+    add_trajectory_sample(result,
+                          result->landing_time_s,
+                          &(result->landing),
+                          &(disc->velocity));
+  }
+}
+
+/*
+ * flight_sim_worker
+ *
+ * Thread function which takes chunks of discs and flies them until there are
+ * none left.
+ *
+ * Parameters: data - The FLIGHT_SIM.
+ *
+ * Returns: 0.
+ */
+int flight_sim_worker(void *data)
+{
+  /*
+   * Local Variables.
+   */
+  FLIGHT_SIM *sim = (FLIGHT_SIM *) data;
+  DISC *disc;
+  int first_disc;
+  int ii;
+
+  disc = create_disc(NULL);
+
+  while (true)
+  {
+    SDL_LockMutex(sim->lock);
+    first_disc = sim->next_disc;
+    sim->next_disc += DISCS_PER_CHUNK;
+    SDL_UnlockMutex(sim->lock);
+
+    if (first_disc >= sim->num_discs)
+    {
+      break;
+    }
+
+    for (ii = first_disc;
+         (ii < first_disc + DISCS_PER_CHUNK) && (ii < sim->num_discs);
+         ii++)
+    {
+      fly_disc(sim, disc, &(sim->discs[ii]), &(sim->results[ii]));
+    }
+  }
+
+  destroy_disc(disc);
+
+  return(0);
+}
+
+/*
+ * write_results
+ *
+ * Writes the results of every disc in input order.
+ *
+ * Parameters: sim - The finished simulation.
+ *             binary - Whether to write binary records rather than CSV.
+ *             file - Where to write.
+ */
+void write_results(FLIGHT_SIM *sim, bool binary, FILE *file)
+{
+  /*
+   * Local Variables.
+   */
+  FLIGHT_SIM_RESULT *result;
+  FLIGHT_SIM_SAMPLE *sample;
+  FLIGHT_SIM_SUMMARY_RECORD summary;
+  FLIGHT_SIM_TRAJECTORY_RECORD point;
+  float x_diff;
+  float y_diff;
+  int ii;
+  int jj;
+
+  if (!binary)
+  {
+    fprintf(file,
+            (sim->steps_per_sample > 0) ?
+            "disc,t_s,x,y,z,vx,vy,vz\n" :
+            "disc,landed,landing_x,landing_y,landing_time_s,apex_z," \
+            "distance_m\n");
+  }
+
+  for (ii = 0; ii < sim->num_discs; ii++)
+  {
+    result = &(sim->results[ii]);
+
+    if (sim->steps_per_sample > 0)
+    {
+      for (jj = 0; jj < result->num_samples; jj++)
+      {
+        sample = &(result->samples[jj]);
+        if (binary)
+        {
+          point.disc = (unsigned int) ii;
+          point.time_s = sample->time_s;
+          point.x = sample->position.x;
+          point.y = sample->position.y;
+          point.z = sample->position.z;
+          point.vx = sample->velocity.x;
+          point.vy = sample->velocity.y;
+          point.vz = sample->velocity.z;
+          fwrite(&point, sizeof(point), 1, file);
+        }
+        else
+        {
+          fprintf(file,
+                  "%i,%.4f,%.4f,%.4f,%.4f,%.4f,%.4f,%.4f\n",
+                  ii,
+                  sample->time_s,
+                  sample->position.x,
+                  sample->position.y,
+                  sample->position.z,
+                  sample->velocity.x,
+                  sample->velocity.y,
+                  sample->velocity.z);
+        }
+      }
+    }
+    else
+    {
+      x_diff = result->landing.x - sim->discs[ii].position.x;
+      y_diff = result->landing.y - sim->discs[ii].position.y;
+      if (binary)
+      {
+        summary.disc = (unsigned int) ii;
+        summary.landed = result->landed ? 1 : 0;
+        summary.landing_x = result->landing.x;
+        summary.landing_y = result->landing.y;
+        summary.landing_time_s = result->landing_time_s;
+        summary.apex_z = result->apex_z;
+        summary.distance_m = sqrtf(x_diff * x_diff + y_diff * y_diff);
+        fwrite(&summary, sizeof(summary), 1, file);
+      }
+      else
+      {
+        fprintf(file,
+                "%i,%i,%.4f,%.4f,%.4f,%.4f,%.4f\n",
+                ii,
+                result->landed ? 1 : 0,
+                result->landing.x,
+                result->landing.y,
+                result->landing_time_s,
+                result->apex_z,
+                sqrtf(x_diff * x_diff + y_diff * y_diff));
+      }
+    }
+  }
+}
+
+/*
+ * print_usage
+ *
+ * Parameters: program - The name of the program.
+ */
+void print_usage(char *program)
+{
+  fprintf(stderr,
+          "Usage: %s [-o output] [-m summary|trajectory] [-f csv|binary]\n"
+          "       [-i adaptive|euler|semi_implicit_euler|rk4] [-s step_s]\n"
+          "       [-d sample_s] [-t max_flight_s] [-j threads] <input file>\n",
+          program);
+}
+
+int main(int argc, char *argv[])
+{
+  /*
+   * Local Variables.
+   */
+  FLIGHT_SIM sim;
+  SDL_Thread *threads[MAX_NUM_THREADS];
+  FILE *output = stdout;
+  char *output_filename = NULL;
+  char *input_filename = NULL;
+  bool trajectory = false;
+  bool binary = false;
+  float sample_s = 0.0f;
+  float max_flight_s = DEFAULT_MAX_FLIGHT_S;
+  int num_threads = DEFAULT_NUM_THREADS;
+  int ii;
+
+  sim.adaptive = true;
+  sim.integrator = disc_integrator_rk4;
+  sim.step_s = DEFAULT_STEP_S;
+
+  for (ii = 1; ii < argc; ii++)
+  {
+    if (('-' != argv[ii][0]) && (NULL == input_filename) && (ii == argc - 1))
+    {
+      input_filename = argv[ii];
+    }
+    else if ((ii + 1 < argc) && (0 == strcmp(argv[ii], "-o")))
+    {
+      output_filename = argv[++ii];
+    }
+    else if ((ii + 1 < argc) && (0 == strcmp(argv[ii], "-m")))
+    {
+      ii++;
+      trajectory = (0 == strcmp(argv[ii], "trajectory"));
+      if ((!trajectory) && (0 != strcmp(argv[ii], "summary")))
+      {
+        print_usage(argv[0]);
+        return(1);
+      }
+    }
+    else if ((ii + 1 < argc) && (0 == strcmp(argv[ii], "-f")))
+    {
+      ii++;
+      binary = (0 == strcmp(argv[ii], "binary"));
+      if ((!binary) && (0 != strcmp(argv[ii], "csv")))
+      {
+        print_usage(argv[0]);
+        return(1);
+      }
+    }
+    else if ((ii + 1 < argc) && (0 == strcmp(argv[ii], "-i")))
+    {
+      ii++;
+      sim.adaptive = false;
+      if (0 == strcmp(argv[ii], "adaptive"))
+      {
+        sim.adaptive = true;
+      }
+      else if (0 == strcmp(argv[ii], "euler"))
+      {
+        sim.integrator = disc_integrator_euler;
+      }
+      else if (0 == strcmp(argv[ii], "semi_implicit_euler"))
+      {
+        sim.integrator = disc_integrator_semi_implicit_euler;
+      }
+      else if (0 == strcmp(argv[ii], "rk4"))
+      {
+        sim.integrator = disc_integrator_rk4;
+      }
+      else
+      {
+        print_usage(argv[0]);
+        return(1);
+      }
+    }
+    else if ((ii + 1 < argc) && (0 == strcmp(argv[ii], "-s")))
+    {
+      sim.step_s = (float) atof(argv[++ii]);
+    }
+    else if ((ii + 1 < argc) && (0 == strcmp(argv[ii], "-d")))
+    {
+      sample_s = (float) atof(argv[++ii]);
+    }
+    else if ((ii + 1 < argc) && (0 == strcmp(argv[ii], "-t")))
+    {
+      max_flight_s = (float) atof(argv[++ii]);
+    }
+    else if ((ii + 1 < argc) && (0 == strcmp(argv[ii], "-j")))
+    {
+      num_threads = atoi(argv[++ii]);
+    }
+    else
+    {
+      print_usage(argv[0]);
+      return(1);
+    }
+  }
+
+  if ((NULL == input_filename) ||
+      (sim.step_s <= 0.0f) ||
+      (max_flight_s <= 0.0f) ||
+      (sample_s < 0.0f) ||
+      (num_threads < 1) ||
+      (num_threads > MAX_NUM_THREADS))
+  {
+    print_usage(argv[0]);
+    return(1);
+  }
+
+  sim.max_steps = (int) ceilf(max_flight_s / sim.step_s);
+  sim.steps_per_sample = 0;
+  if (trajectory)
+  {
+    sim.steps_per_sample = (int) floorf(sample_s / sim.step_s + 0.5f);
+    if (sim.steps_per_sample < 1)
+    {
+      sim.steps_per_sample = 1;
+    }
+  }
+
+  sim.num_discs = read_discs(input_filename, &(sim.discs));
+  sim.results = (FLIGHT_SIM_RESULT *) DT_MALLOC(
+                        sizeof(FLIGHT_SIM_RESULT) *
+                        (sim.num_discs > 0 ? sim.num_discs : 1));
+  sim.lock = SDL_CreateMutex();
+  sim.next_disc = 0;
+
+  /*
+   * Fly the discs on all the threads. If a thread can't be started its share
+   * of the discs is picked up by the others.
+   */
+  for (ii = 0; ii < num_threads; ii++)
+  {
+    threads[ii] = SDL_CreateThread(flight_sim_worker, &sim);
+  }
+  for (ii = 0; ii < num_threads; ii++)
+  {
+    if (NULL != threads[ii])
+    {
+      SDL_WaitThread(threads[ii], NULL);
+    }
+  }
+  if (sim.next_disc < sim.num_discs)
+  {
+    flight_sim_worker(&sim);
+  }
+  SDL_DestroyMutex(sim.lock);
+
+  if (NULL != output_filename)
+  {
+    output = fopen(output_filename, binary ? "wb" : "w");
+    if (NULL == output)
+    {
+      game_exit("Could not open the output file.");
+    }
+  }
+  write_results(&sim, binary, output);
+  if (NULL != output_filename)
+  {
+    fclose(output);
+  }
+
+  for (ii = 0; ii < sim.num_discs; ii++)
+  {
+    if (NULL != sim.results[ii].samples)
+    {
+      DT_FREE(sim.results[ii].samples);
+    }
+  }
+  DT_FREE(sim.results);
+  DT_FREE(sim.discs);
+
+  return(0);
+}
@@ -0,0 +1,422 @@
+/*
+ * intercept_benchmark.c
+ *
+ * Stand alone program which checks that the two ways of searching a disc path
+ * for a player's intercept (see INTERCEPT_SEARCH in intercept.h) give exactly
+ * the same result, both one player at a time and for a batch of players, and
+ * times them.
+ *
+ *   intercept_benchmark [number of throws] [seed]
+ *
+ * A disc path is calculated at DISC_PATH_INTERVAL_MIN for each of a number of
+ * random throws. Each path is then searched at a number of random times
+ * during the flight for players at random positions, speeds, heights and disc
+ * reading skills, once with each search for each player and once with each
+ * search for batches of players (calculate_players_disc_path_intercepts, as
+ * used by the intercept table). All four searches are given exactly the same
+ * time. Any difference at all from the linear search of each player in the
+ * return code or intercept is written to stdout as
+ *
+ *   MISMATCH throw,time_s,skill,x,y,speed,height,linear_rc,bracket_rc,
+ *            batch_linear_rc,batch_bracket_rc
+ *
+ * followed at the end by the number of searches, the number of mismatches and
+ * the average time in us per player of each search:
+ *
+ *   searches,mismatches,linear_us,bracket_us,batch_linear_us,batch_bracket_us
+ *
+ * The program exits with 1 if there were any mismatches, so it can be run as
+ * a check after changing intercept.c.
+ *
+ * This is not part of the game build. Build it from the top directory with
+ *
+ *   make intercept_benchmark
+ *
+ * using the make file generated by Tools/create_make_file.py.
+ *
+ *  Created on: 16 Oct 2026
+ *      Author: David Tyler
+ */
+#include "dt_logger.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "SDL/SDL.h"
+#include "conversion_constants.h"
+#include "disc.h"
+#include "disc_path.h"
+#include "player.h"
+#include "player_kinematics.h"
+#include "throw_init_condition.h"
+#include "collisions/intercept.h"
+#include "data_structures/vector.h"
+
+/*
+ * The number of times each path is searched at and the number of players
+ * searched for each time.
+ */
+#define DEFAULT_NUM_THROWS 50
+#define TIMES_PER_THROW 20
+#define PLAYERS_PER_TIME 50
+
+/*
+ * The ranges that the random throws and players are picked from.
+ */
+#define MIN_THROW_SPEED 8.0f
+#define MAX_THROW_SPEED 28.0f
+#define MAX_THROW_TILT 0.3f
+#define MIN_PLAYER_SPEED 3.0f
+#define MAX_PLAYER_SPEED 10.0f
+#define MIN_PLAYER_HEIGHT 1.2f
+#define MAX_PLAYER_HEIGHT 3.0f
+#define PLAYER_AREA_M 60.0f
+
+/*
+ * The main loop needs a game_exit function as the logging code calls it.
+ */
+void game_exit(char *msg)
+{
+  fprintf(stderr, "%s\n", msg);
+  exit(1);
+}
+
+/*
+ * random_float
+ *
+ * Returns: A random number between min and max.
+ */
+float random_float(float min, float max)
+{
+  return(min + (max - min) * ((float) rand()) / ((float) RAND_MAX));
+}
+
+/*
+ * throw_random_disc
+ *
+ * Sets the disc up for a throw from the origin in a random direction with a
+ * random speed and tilt.
+ *
+ * Parameters: disc - The disc to throw.
+ */
+void throw_random_disc(DISC *disc)
+{
+  /*
+   * Local Variables.
+   */
+  THROW_INIT_CONDITION condition;
+  float speed = random_float(MIN_THROW_SPEED, MAX_THROW_SPEED);
+  float heading = random_float(0.0f, 2.0f * (float) M_PI);
+  float elevation = random_float(0.0f, MAX_THROW_TILT);
+  float roll = random_float(-MAX_THROW_TILT, MAX_THROW_TILT);
+  VECTOR3 up;
+
+  vector_set_values(&(condition.velocity),
+                    speed * cosf(elevation) * cosf(heading),
+                    speed * cosf(elevation) * sinf(heading),
+                    speed * sinf(elevation));
+
+  /*
+   * Pitch the disc up with the throw and roll it about the direction of the
+   * throw.
+   */
+  vector_set_values(&up,
+                    -sinf(elevation) * cosf(heading) - sinf(roll) *
+                                                       sinf(heading),
+                    -sinf(elevation) * sinf(heading) + sinf(roll) *
+                                                       cosf(heading),
+                    1.0f);
+  condition.up = unit_vector(&up);
+
+  vector_set_values(&(disc->position), 0.0f, 0.0f, 0.0f);
+  set_init_disc_conditions_from_throw(disc, &condition);
+}
+
+/*
+ * random_player
+ *
+ * Parameters: player - Filled in with the fields used by the intercept
+ *                      search.
+ *             kinematics - The store holding the player's position.
+ */
+void random_player(PLAYER *player, PLAYER_KINEMATICS *kinematics)
+{
+  memset(player, 0, sizeof(PLAYER));
+  player->kinematics = kinematics;
+  player->kinematics_index = add_player_kinematics(kinematics, player);
+  place_player(player,
+               random_float(-PLAYER_AREA_M, PLAYER_AREA_M),
+               random_float(-PLAYER_AREA_M, PLAYER_AREA_M));
+  player->max_speed = random_float(MIN_PLAYER_SPEED, MAX_PLAYER_SPEED);
+  player->height = random_float(MIN_PLAYER_HEIGHT, MAX_PLAYER_HEIGHT);
+  player->disc_reading_skill = rand() % DISC_PATH_NUM_SKILL_LEVELS;
+}
+
+/*
+ * intercepts_equal
+ *
+ * Returns: true if the two searches gave exactly the same result.
+ */
+bool intercepts_equal(int linear_rc,
+                      INTERCEPT *linear,
+                      int bracket_rc,
+                      INTERCEPT *bracket)
+{
+  if (linear_rc != bracket_rc)
+  {
+    return(false);
+  }
+
+  if (INTERCEPT_CALC_FOUND != linear_rc)
+  {
+    return(true);
+  }
+
+  return((linear->object_b == bracket->object_b) &&
+         (0 == memcmp(&(linear->intercept),
+                      &(bracket->intercept),
+                      sizeof(VECTOR3))) &&
+         (linear->t == bracket->t));
+}
+
+/*
+ * search_one_at_a_time
+ *
+ * Searches the path for each player in turn with
+ * calculate_player_disc_path_intercept, using the view for their skill.
+ *
+ * Parameters: players - PLAYERS_PER_TIME players.
+ *             disc_path - The path.
+ *             now - The time to search at, on the path's clock.
+ *             search - The search to use.
+ *             intercepts, ret_codes - Filled in for each player.
+ *
+ * Returns: The time in s taken by the searches.
+ */
+double search_one_at_a_time(PLAYER *players,
+                            DISC_PATH *disc_path,
+                            Uint32 now,
+                            INTERCEPT_SEARCH search,
+                            INTERCEPT *intercepts,
+                            int *ret_codes)
+{
+  /*
+   * Local Variables.
+   */
+  DISC_PATH_VIEW *view;
+  clock_t start;
+  double taken_s = 0.0;
+  int ii;
+
+  for (ii = 0; ii < PLAYERS_PER_TIME; ii++)
+  {
+    view = get_disc_path_view(disc_path, players[ii].disc_reading_skill);
+
+    start = clock();
+    ret_codes[ii] = calculate_player_disc_path_intercept(&(players[ii]),
+                                                         view,
+                                                         now,
+                                                         search,
+                                                         &(intercepts[ii]));
+    taken_s += (double) (clock() - start) / CLOCKS_PER_SEC;
+  }
+
+  return(taken_s);
+}
+
+/*
+ * search_together
+ *
+ * Searches the path for the players INTERCEPT_BATCH_SIZE at a time with
+ * calculate_players_disc_path_intercepts.
+ *
+ * Parameters: As search_one_at_a_time except that players is a list of
+ *             pointers to the players.
+ *
+ * Returns: The time in s taken by the searches.
+ */
+double search_together(PLAYER **players,
+                       DISC_PATH *disc_path,
+                       Uint32 now,
+                       INTERCEPT_SEARCH search,
+                       INTERCEPT *intercepts,
+                       int *ret_codes)
+{
+  /*
+   * Local Variables.
+   */
+  clock_t start;
+  double taken_s = 0.0;
+  int batch_size;
+  int ii;
+
+  for (ii = 0; ii < PLAYERS_PER_TIME; ii += INTERCEPT_BATCH_SIZE)
+  {
+    batch_size = PLAYERS_PER_TIME - ii;
+    if (batch_size > INTERCEPT_BATCH_SIZE)
+    {
+      batch_size = INTERCEPT_BATCH_SIZE;
+    }
+
+    start = clock();
+    calculate_players_disc_path_intercepts(&(players[ii]),
+                                           batch_size,
+                                           disc_path,
+                                           now,
+                                           search,
+                                           &(intercepts[ii]),
+                                           &(ret_codes[ii]));
+    taken_s += (double) (clock() - start) / CLOCKS_PER_SEC;
+  }
+
+  return(taken_s);
+}
+
+/*
+ * main
+ */
+int main(int argc, char **argv)
+{
+  /*
+   * Local Variables.
+   */
+  DISC *disc;
+  DISC_PATH *disc_path;
+  PLAYER_KINEMATICS *kinematics;
+  PLAYER players[PLAYERS_PER_TIME];
+  PLAYER *player_list[PLAYERS_PER_TIME];
+  VECTOR3 position;
+  INTERCEPT linear[PLAYERS_PER_TIME];
+  INTERCEPT bracket[PLAYERS_PER_TIME];
+  INTERCEPT batch_linear[PLAYERS_PER_TIME];
+  INTERCEPT batch_bracket[PLAYERS_PER_TIME];
+  int linear_rc[PLAYERS_PER_TIME];
+  int bracket_rc[PLAYERS_PER_TIME];
+  int batch_linear_rc[PLAYERS_PER_TIME];
+  int batch_bracket_rc[PLAYERS_PER_TIME];
+  int num_throws = DEFAULT_NUM_THROWS;
+  unsigned int seed = 1;
+  Uint32 now;
+  Uint32 flight_ms;
+  double linear_s = 0.0;
+  double bracket_s = 0.0;
+  double batch_linear_s = 0.0;
+  double batch_bracket_s = 0.0;
+  long num_searches = 0;
+  long num_mismatches = 0;
+  int throw_index;
+  int time_index;
+  int ii;
+
+  if (argc > 1)
+  {
+    num_throws = atoi(argv[1]);
+  }
+  if (argc > 2)
+  {
+    seed = (unsigned int) atoi(argv[2]);
+  }
+  srand(seed);
+
+  disc = create_disc(NULL);
+  disc_path = create_disc_path();
+  kinematics = create_player_kinematics(PLAYERS_PER_TIME);
+
+  for (throw_index = 0; throw_index < num_throws; throw_index++)
+  {
+    throw_random_disc(disc);
+    init_disc_path(disc, disc_path, DISC_PATH_INTERVAL_MIN, 0);
+    flight_ms = (Uint32) (disc_path->landing_position.t *
+                          MILLISECONDS_PER_SECOND);
+
+    for (time_index = 0; time_index < TIMES_PER_THROW; time_index++)
+    {
+      kinematics->num_players = 0;
+      for (ii = 0; ii < PLAYERS_PER_TIME; ii++)
+      {
+        random_player(&(players[ii]), kinematics);
+        player_list[ii] = &(players[ii]);
+      }
+
+      /*
+       * Search at a random time during the flight. The path was started at 0.
+       */
+      now = (Uint32) (rand() % (flight_ms + 1));
+      linear_s += search_one_at_a_time(players,
+                                       disc_path,
+                                       now,
+                                       intercept_search_linear,
+                                       linear,
+                                       linear_rc);
+      bracket_s += search_one_at_a_time(players,
+                                        disc_path,
+                                        now,
+                                        intercept_search_bracket,
+                                        bracket,
+                                        bracket_rc);
+      batch_linear_s += search_together(player_list,
+                                        disc_path,
+                                        now,
+                                        intercept_search_linear,
+                                        batch_linear,
+                                        batch_linear_rc);
+      batch_bracket_s += search_together(player_list,
+                                         disc_path,
+                                         now,
+                                         intercept_search_bracket,
+                                         batch_bracket,
+                                         batch_bracket_rc);
+      num_searches += PLAYERS_PER_TIME;
+
+      for (ii = 0; ii < PLAYERS_PER_TIME; ii++)
+      {
+        if (!intercepts_equal(linear_rc[ii],
+                              &(linear[ii]),
+                              bracket_rc[ii],
+                              &(bracket[ii])) ||
+            !intercepts_equal(linear_rc[ii],
+                              &(linear[ii]),
+                              batch_linear_rc[ii],
+                              &(batch_linear[ii])) ||
+            !intercepts_equal(linear_rc[ii],
+                              &(linear[ii]),
+                              batch_bracket_rc[ii],
+                              &(batch_bracket[ii])))
+        {
+          position = get_player_position(&(players[ii]));
+          printf("MISMATCH %d,%f,%d,%f,%f,%f,%f,%d,%d,%d,%d\n",
+                 throw_index,
+                 ((float) now) / MILLISECONDS_PER_SECOND,
+                 players[ii].disc_reading_skill,
+                 position.x,
+                 position.y,
+                 players[ii].max_speed,
+                 players[ii].height,
+                 linear_rc[ii],
+                 bracket_rc[ii],
+                 batch_linear_rc[ii],
+                 batch_bracket_rc[ii]);
+          num_mismatches++;
+        }
+      }
+    }
+  }
+
+  printf("searches,mismatches,linear_us,bracket_us,batch_linear_us,"
+         "batch_bracket_us\n");
+  printf("%ld,%ld,%.3f,%.3f,%.3f,%.3f\n",
+         num_searches,
+         num_mismatches,
+         linear_s * 1.0e6 / num_searches,
+         bracket_s * 1.0e6 / num_searches,
+         batch_linear_s * 1.0e6 / num_searches,
+         batch_bracket_s * 1.0e6 / num_searches);
+
+  destroy_player_kinematics(kinematics);
+  destroy_disc_path(disc_path);
+  destroy_disc(disc);
+
+  return((0 == num_mismatches) ? 0 : 1);
+}
@@ -0,0 +1,251 @@
+/*
+ * throw_solver_test.c
+ *
+ * Stand alone program which checks that the throws worked out by the throw
+ * solver land where they were asked to when they are flown as the match flies
+ * the disc.
+ *
+ *   throw_solver_test
+ *
+ * Each target in TARGETS is solved for from a release point away from the
+ * origin, flat and with a flight time. The throw is then put on a disc with
+ * set_init_disc_conditions_from_throw and flown to the ground with a
+ * DISC_FLIGHT. Every target is solved for a second time to check that the
+ * solver's cache gets it straight away. One line is written per solve:
+ *
+ *   target_x,target_y,flight_time,rc,iterations,landing_x,landing_y,miss_m,
+ *   landing_t
+ *
+ * The program exits with 1 if any solve fails, misses its target by more than
+ * THROW_SOLVER_TOLERANCE_M, lands more than THROW_SOLVER_TIME_TOLERANCE_S from
+ * the flight time asked for or isn't quicker the second time, so it can be
+ * run as a check after changing the solver or the flight model. The solver
+ * checks its throws with a DISC_FLIGHT too, so there is no allowance for a
+ * difference between its flights and the match's.
+ *
+ * This is not part of the game build. Build it from the top directory with
+ *
+ *   make throw_solver_test
+ *
+ * using the make file generated by Tools/create_make_file.py.
+ *
+ *  Created on: 16 Oct 2026
+ *      Author: David Tyler
+ */
+#include "dt_logger.h"
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "disc.h"
+#include "throw_init_condition.h"
+#include "throw_solver.h"
+#include "data_structures/vector.h"
+#include "flight_mechanics/disc_flight.h"
+
+/*
+ * Where the disc is thrown from and the targets thrown at, relative to it,
+ * each with the flight time asked for when there is one.
+ */
+#define RELEASE_X 10.0f
+#define RELEASE_Y -5.0f
+#define NUM_TARGETS 6
+#define TARGET_X 0
+#define TARGET_Y 1
+#define TARGET_FLIGHT_TIME 2
+static const float TARGETS[NUM_TARGETS][3] = {{15.0f, 0.0f, 1.5f},
+                                              {25.0f, 10.0f, 2.0f},
+                                              {-20.0f, 5.0f, 1.8f},
+                                              {0.0f, -35.0f, 2.5f},
+                                              {40.0f, -20.0f, 3.0f},
+                                              {-10.0f, -10.0f, 1.2f}};
+
+/*
+ * The most iterations a repeated solve may take.
+ */
+#define MAX_REPEAT_ITERATIONS 1
+
+/*
+ * The longest flight that is followed.
+ */
+#define MAX_FLIGHT_TIME_S 20.0f
+
+/*
+ * The main loop needs a game_exit function as the logging code calls it.
+ */
+void game_exit(char *msg)
+{
+  fprintf(stderr, "%s\n", msg);
+  exit(1);
+}
+
+/*
+ * fly_throw
+ *
+ * Flies a throw from the release point to the ground as the match would.
+ *
+ * Parameters: disc - Used to fly the throw.
+ *             condition - The throw.
+ *             landing - Filled in with where the disc landed.
+ *             landing_t - Filled in with how long the disc was in the air.
+ *
+ * Returns: false if the disc didn't land, true otherwise.
+ */
+bool fly_throw(DISC *disc,
+               THROW_INIT_CONDITION *condition,
+               VECTOR3 *landing,
+               float *landing_t)
+{
+  /*
+   * Local Variables.
+   */
+  VECTOR3 position;
+
+  vector_set_values(&(disc->position), RELEASE_X, RELEASE_Y, 0.0f);
+  set_init_disc_conditions_from_throw(disc, condition);
+
+  fly_disc_flight(disc->flight, MAX_FLIGHT_TIME_S, &position, NULL);
+  if (!disc->flight->landed)
+  {
+    return(false);
+  }
+
+  vector_copy_values(landing, &(disc->flight->landing));
+  *landing_t = disc->flight->landing_t;
+
+  return(true);
+}
+
+/*
+ * check_throw
+ *
+ * Solves for a throw at one target, flies it and writes out the result.
+ *
+ * Parameters: solver - The solver to use.
+ *             disc - Used to fly the throw.
+ *             target_index - The entry in TARGETS.
+ *             constraint - throw_constraint_none or
+ *                          throw_constraint_flight_time.
+ *             repeat - Whether this target has been solved for already.
+ *
+ * Returns: false if the check failed, true otherwise.
+ */
+bool check_throw(THROW_SOLVER *solver,
+                 DISC *disc,
+                 int target_index,
+                 THROW_CONSTRAINT constraint,
+                 bool repeat)
+{
+  /*
+   * Local Variables.
+   */
+  THROW_INIT_CONDITION condition;
+  VECTOR3 release;
+  VECTOR3 target;
+  VECTOR3 landing;
+  float flight_time = 0.0f;
+  float landing_t = 0.0f;
+  float miss = -1.0f;
+  int rc;
+  bool passed;
+
+  vector_set_values(&release, RELEASE_X, RELEASE_Y, 0.0f);
+  vector_set_values(&target,
+                    RELEASE_X + TARGETS[target_index][TARGET_X],
+                    RELEASE_Y + TARGETS[target_index][TARGET_Y],
+                    0.0f);
+  if (throw_constraint_flight_time == constraint)
+  {
+    flight_time = TARGETS[target_index][TARGET_FLIGHT_TIME];
+  }
+
+  rc = solve_throw(solver,
+                   &release,
+                   &target,
+                   0.0f,
+                   constraint,
+                   flight_time,
+                   &condition);
+  vector_set_values(&landing, 0.0f, 0.0f, 0.0f);
+  if ((THROW_SOLVER_OK == rc) &&
+      fly_throw(disc, &condition, &landing, &landing_t))
+  {
+    miss = sqrtf((landing.x - target.x) * (landing.x - target.x) +
+                 (landing.y - target.y) * (landing.y - target.y));
+  }
+
+  passed = (miss >= 0.0f) &&
+           (miss <= THROW_SOLVER_TOLERANCE_M) &&
+           ((throw_constraint_flight_time != constraint) ||
+            (fabsf(landing_t - flight_time) <=
+                                           THROW_SOLVER_TIME_TOLERANCE_S)) &&
+           ((!repeat) ||
+            (solver->last_num_iterations <= MAX_REPEAT_ITERATIONS));
+
+  printf("%f,%f,%f,%d,%d,%f,%f,%f,%f%s\n",
+         target.x,
+         target.y,
+         flight_time,
+         rc,
+         solver->last_num_iterations,
+         landing.x,
+         landing.y,
+         miss,
+         landing_t,
+         passed ? "" : " FAILED");
+
+  return(passed);
+}
+
+/*
+ * main
+ */
+int main(void)
+{
+  /*
+   * Local Variables.
+   */
+  THROW_SOLVER *solver;
+  DISC *disc;
+  THROW_CONSTRAINT constraints[2] = {throw_constraint_none,
+                                     throw_constraint_flight_time};
+  int num_failed = 0;
+  int constraint_index;
+  int repeat;
+  int ii;
+
+  /*
+   * There is no flight condition table so the first solves start from the
+   * solver's own guess.
+   */
+  solver = create_throw_solver(NULL);
+  disc = create_disc(NULL);
+
+  printf("target_x,target_y,flight_time,rc,iterations,landing_x,landing_y,"
+         "miss_m,landing_t\n");
+  for (constraint_index = 0; constraint_index < 2; constraint_index++)
+  {
+    for (repeat = 0; repeat < 2; repeat++)
+    {
+      for (ii = 0; ii < NUM_TARGETS; ii++)
+      {
+        if (!check_throw(solver,
+                         disc,
+                         ii,
+                         constraints[constraint_index],
+                         (1 == repeat)))
+        {
+          num_failed++;
+        }
+      }
+    }
+  }
+
+  printf("%d of %d checks failed\n", num_failed, 4 * NUM_TARGETS);
+
+  destroy_disc(disc);
+  destroy_throw_solver(solver);
+
+  return((0 == num_failed) ? 0 : 1);
+}
@@ -16,16 +16,16 @@ function GetEarliestDiscIntercept()
     -- expensive as it is done on a pre computed disc path.
     intercept_table = callback_calculate_all_intercept_times()
     
-    -- If there are no intercepts in the table then return 0.
+    -- If there are no intercepts in the table then return 0. Nothing at all
+    -- comes back if the disc is not in the air.
     -- Otherwise return the element in the table that corresponds to the
-    -- intercept which is going to occur soonest.
-    if #(table) == 0 then
-        return 0
-    else
-        min_time = -1
-        min_data = 0
-        for index, data in ipairs(intercept_table) do
-            new_time = data["intercept_time"]
+    -- intercept which is going to occur soonest. Note that we cannot use
+    -- ipairs on this table because it ignores the zeroth element.
+    min_time = -1
+    min_data = 0
+    if intercept_table then
+        for index, data in pairs(intercept_table) do
+            new_time = data["time_to_intercept"]
             
             -- Just keep track of the minimum time so far.
             if new_time < min_time or min_time == -1 then
@@ -33,9 +33,9 @@ function GetEarliestDiscIntercept()
                 min_time = new_time
             end
         end
-        
-        return min_data
     end
+    
+    return min_data
 end
 
 --
@@ -48,11 +48,12 @@ end
 --
 function process_ShouldIChase(team_id, player_id)
     -- Find the earliest intercept time.
-    earliest_intercept = GetEarlierDiscIntercept()
+    earliest_intercept = GetEarliestDiscIntercept()
     
     -- We don't need to set the desired location of the player as the intercept
     -- disc state will handle that for us.
-    if earliest_intercept["player_index"] == player_id and 
+    if earliest_intercept ~= 0 and
+       earliest_intercept["player_index"] == player_id and 
        earliest_intercept["team_index"] == team_id then
         return 1
     else
@@ -68,10 +69,11 @@ end
 --
 function process_WillWeCatch(team_id, player_id)
     -- Find the earliest intercept time.
-    earliest_intercept = GetEarlierDiscIntercept()
+    earliest_intercept = GetEarliestDiscIntercept()
     
     -- Check the team index of the most likely player to intercept the disc.
-    if earliest_intercept["team_index"] == team_id then
+    if earliest_intercept ~= 0 and
+       earliest_intercept["team_index"] == team_id then
         return 1
     else
         return 0
@@ -86,7 +88,7 @@ end
 --
 function process_DecideWhoToMark(team_id, player_id)
     -- Retrieve all the player marks.
-    marks = callback_get_all_taem_marks()
+    marks = callback_get_all_team_marks()
     
     -- Create an array of all the marking options.
     possible_marks = {}
@@ -94,8 +96,9 @@ function process_DecideWhoToMark(team_id, player_id)
         possible_marks[ii] = false
     end
     
-    -- Fill in the players who are already being marked.
-    for index, data in ipairs(marks) do
+    -- Fill in the players who are already being marked. Note that we cannot
+    -- use ipairs on this table because it ignores the zeroth element.
+    for index, data in pairs(marks) do
         possible_marks[data["mark_player_index"]] = true
     end
     
@@ -151,24 +154,26 @@ function process_DecideWhereToWait(team_id, player_id)
     -- Work out the next free space in front of the disc. Note that we cannot
     -- use ipairs on this table because it ignored the zeroth element.
     for player_index, position in pairs(player_desired_positions) do
-        if position["y"] == disc_end_position["y"] then
-            for index, pos_tf_table in ipairs(stack_positions) do
-                if pos_tf_table[1] == position["x"] then
-                    stack_positions[index] = {pos, true}
+        if position["y"] == final_pos["y"] then
+            for ii = 0,6 do
+                if stack_positions[ii][1] == position["x"] then
+                    stack_positions[ii][2] = true
                 end
             end
         end
     end
     
-    -- The first free space is the first true value in the stack positions table.
-    for index, pos_tf_table in ipairs(stack_positions) do
-        if not pos_tf_table[2] then
+    -- The first free space is the first false value in the stack positions table.
+    for ii = 0,6 do
+        if not stack_positions[ii][2] then
             -- Set the desired location and inform the player to run at 50%.
-            callback_set_player_desired_pos(pos_tf_table[1], disc_end_position["y"])
+            callback_set_player_desired_pos(stack_positions[ii][1], final_pos["y"])
             callback_set_player_speed(50)
             return 1
         end
-    end    
+    end
+
+    return 0
 end
     
 --
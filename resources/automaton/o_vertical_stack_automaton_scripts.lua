@@ -33,19 +33,19 @@ function process_DecideWhereToWait(team_id, player_id)
     -- use ipairs on this table because it ignored the zeroth element.
     for player_index, position in pairs(player_desired_positions) do
         if position["y"] == disc_end_position["y"] then
-            for index, pos_tf_table in ipairs(stack_positions) do
-                if pos_tf_table[1] == position["x"] then
-                    stack_positions[index] = {pos, true}
+            for ii = 0,6 do
+                if stack_positions[ii][1] == position["x"] then
+                    stack_positions[ii][2] = true
                 end
             end
         end
     end
     
-    -- The first free space is the first true value in the stack positions table.
-    for index, pos_tf_table in ipairs(stack_positions) do
-        if not pos_tf_table[2] then
+    -- The first free space is the first false value in the stack positions table.
+    for ii = 0,6 do
+        if not stack_positions[ii][2] then
             -- Set the desired location and inform the player to run at 50%.
-            callback_set_player_desired_pos(pos_tf_table[1], disc_end_position["y"])
+            callback_set_player_desired_pos(stack_positions[ii][1], disc_end_position["y"])
             callback_set_player_speed(50)
             return 1
         end
@@ -64,13 +64,13 @@ end
 --
 function process_ChangeCut(team_id, player_id)
     -- Retrieves the current location of the disc.
-    disc_position = callback_get_disc_position()
+    disc_position = callback_get_disc_pos()
 
     -- Get the players current position.
     current_position = callback_get_current_position()
     
     -- Pre calculate the distance from the disc.
-    dist_from_disc = abs(disc_position["x"] - current_position["x"])
+    dist_from_disc = math.abs(disc_position["x"] - current_position["x"])
     
     -- Decides which direction we are attacking. If 1 then attack is from left 
     -- to right (or positive coordinates)
@@ -91,7 +91,7 @@ function process_ChangeCut(team_id, player_id)
         -- trying to cut into it.
         bottom_free = true
         top_free = true
-        for player_index, position in ipairs(desired_positions) do
+        for player_index, position in pairs(desired_positions) do
             if position["y"] > disc_position["y"] + 2 then
                 bottom_free = false
             elseif position["y"] < disc_position["y"] - 2 then
@@ -104,9 +104,9 @@ function process_ChangeCut(team_id, player_id)
         -- then stop cutting.
         if bottom_free or top_free then
             if bottom_free and top_free then
-                randomseed(time())
-                factor = (random(1,2) == 1) and -1 or 1
-            elseif botom_free then
+                math.randomseed(os.time())
+                factor = (math.random(1,2) == 1) and -1 or 1
+            elseif bottom_free then
                 factor = 1
             else
                 factor = -1
@@ -115,10 +115,10 @@ function process_ChangeCut(team_id, player_id)
             -- Based on whether we are attacking left or right create a cut 
             -- that goes to the correct side of the stack.
             if attack_left_to_right then
-                callback_set_desired_position(disc_position["x"] + HANDLER_SPACE_DEPTH,
+                callback_set_player_desired_pos(disc_position["x"] + HANDLER_SPACE_DEPTH,
                                               current_position["y"] - 10 * factor)
             else
-                callback_set_desired_position(disc_position["x"] - HANDLER_SPACE_DEPTH,
+                callback_set_player_desired_pos(disc_position["x"] - HANDLER_SPACE_DEPTH,
                                               current_position["y"] - 10 * factor)
             end
         else
@@ -129,6 +129,8 @@ function process_ChangeCut(team_id, player_id)
     else
         -- The player is fine with their current cut. Continue going.
     end
+
+    return 0
 end
 
 --
@@ -150,20 +152,20 @@ end
 --
 function process_AmIInStack(team_id, player_id)
     -- Retrieves the current location of the disc.
-    disc_position = callback_get_disc_position()
+    disc_position = callback_get_disc_pos()
 
     -- Get the players current position.
     current_position = callback_get_current_position()
     
     -- The player can only be in the stack if they have roughly the same y
     -- coordinate as the disc.
-    if abs(current_position["y"] - disc_position["y"]) < 2 then
+    if math.abs(current_position["y"] - disc_position["y"]) < 2 then
         for ii = 0,6 do
             x = disc_position["x"] + STACK_MIN_DISTANCE + (ii * STACK_SEPERATION)
             
             -- The player is in the stack if they are within a small distance
             -- of the position calculated above.
-            if abs(x - current_position["x"]) < 2 then
+            if math.abs(x - current_position["x"]) < 2 then
                 return 1
             end
         end 
@@ -195,13 +197,13 @@ function process_ShouldICut(team_id, player_id)
     attack_left_to_right = callback_is_attacking_left_to_right()
 
     -- Retrieves the current location of the disc.
-    disc_position = callback_get_disc_position()
+    disc_position = callback_get_disc_pos()
     
     -- Get the players current position.
     current_position = callback_get_current_position()
     
     -- Pre calculate the distance from the disc.
-    dist_from_disc = abs(disc_position["x"] - current_position["x"])
+    dist_from_disc = math.abs(disc_position["x"] - current_position["x"])
 
    -- Get the desired positions of all the other players on this team.
     -- This is returned as a table with one value for each player and each value
@@ -213,10 +215,10 @@ function process_ShouldICut(team_id, player_id)
     
     -- I am allowed to cut if I am the deepest of the stationary players.
     am_deepest = true
-    for player_index, position in ipairs(player_positions) do
+    for player_index, position in pairs(player_positions) do
         if position["x"] == player_desired_positions[player_index]["x"] and
            position["y"] == player_desired_positions[player_index]["y"] then
-            if abs(position["x"] - disc_position["x"]) > dist_from_disc then
+            if math.abs(position["x"] - disc_position["x"]) > dist_from_disc then
                 am_deepest = false
             end
         end
@@ -225,13 +227,13 @@ function process_ShouldICut(team_id, player_id)
     -- Check whether there is already a cutter running towards the deep space.
     -- If there is then we don't want to cut there.
     deep_cutter_exists = false
-    for player_index, position in ipairs(player_desired_positions) do
+    for player_index, position in pairs(player_desired_positions) do
         if attack_left_to_right == 1 then
-            if position["x"] > BACK_STACK + disc_position["x"] then
+            if position["x"] > STACK_BACK + disc_position["x"] then
                 deep_cutter_exists = true
             end
         else
-            if position["x"] < disc_position["x"] - BACK_STACK then
+            if position["x"] < disc_position["x"] - STACK_BACK then
                 deep_cutter_exists = true
             end
         end
@@ -244,9 +246,9 @@ function process_ShouldICut(team_id, player_id)
         -- absolute pitch coordinates and so do not map nicely to have offense
         -- switching ends.
         if (callback_is_attacking_left_to_right() == 1) then
-            callback_set_desired_position(position["x"] + 10 ,position["y"])
+            callback_set_player_desired_pos(current_position["x"] + 10, current_position["y"])
         else
-            callback_set_desired_position(position["x"] - 10 ,position["y"])
+            callback_set_player_desired_pos(current_position["x"] - 10, current_position["y"])
         end
         
         return 1
@@ -24,11 +24,35 @@
  */
 void throw_single_player_ai_event(PLAYER *player, AUTOMATON_EVENT *event)
 {
-  DT_AI_LOG("(%i:%i) Event %s placed on queue\n",
-            player->team_id,
-            player->player_id,
-            event->name);
-  add_event_to_queue(event, player->event_queue);
+  /*
+   * Local Variables.
+   */
+  int rc;
+
+  rc = add_event_to_queue(event, player->event_queue);
+  if (EVENT_QUEUE_ADDED == rc)
+  {
+    DT_AI_LOG("(%i:%i) Event %s placed on queue\n",
+              player->team_id,
+              player->player_id,
+              event->name);
+  }
+  else if (EVENT_QUEUE_COALESCED == rc)
+  {
+    DT_AI_LOG("(%i:%i) Event %s already last on queue\n",
+              player->team_id,
+              player->player_id,
+              event->name);
+  }
+  else
+  {
+    DT_AI_LOG("(%i:%i) Event queue full, dropped %s event\n",
+              player->team_id,
+              player->player_id,
+              (EVENT_QUEUE_DROP_NEWEST ==
+               player->event_queue->overflow_policy) ? event->name :
+                                                       "oldest");
+  }
 }
 
 /*
@@ -64,26 +88,44 @@ void throw_single_player_ai_event_by_name(PLAYER *player,
   }
   else
   {
-    DT_AI_LOG("(%i:%i) Event %s placed on queue\n",
-              player->team_id,
-              player->player_id,
-              event->name);
-    add_event_to_queue(event, player->event_queue);
+    throw_single_player_ai_event(player, event);
   }
 }
 
+/*
+ * throw_single_player_ai_event_by_id
+ *
+ * As throw_single_player_ai_event_by_name but with the event's id, which
+ * indexes the automaton's events directly so nothing is searched for. This
+ * is the one to use for events thrown every update.
+ *
+ * Parameters: player - The player to throw an event to.
+ *             automaton - Used to find which event this refers to.
+ *             event_id - The id of the event (see event_names.h).
+ */
+void throw_single_player_ai_event_by_id(PLAYER *player,
+                                        AUTOMATON *automaton,
+                                        int event_id)
+{
+  DT_ASSERT(event_id >= 0 && event_id < automaton->num_events);
+
+  throw_single_player_ai_event(player, automaton->events[event_id]);
+}
+
 /*
  * throw_multi_player_ai_event
  *
- * Throws an AI event to all the players in both teams. If the event does not
+ * Throws an AI event to all the players in every team. If the event does not
  * exist then it fails silently.
  *
- * Parameters: teams - Both teams with links to all players.
+ * Parameters: teams - Every team with links to all players.
+ *             num_teams - The number of teams.
  *             players_per_team - Number of players in each team.
  *             automaton - Used to find the automaton event.
  *             event - The event to throw.
  */
 void throw_multi_player_ai_event(TEAM **teams,
+                                 int num_teams,
                                  int players_per_team,
                                  AUTOMATON_EVENT *event)
 {
@@ -93,15 +135,11 @@ void throw_multi_player_ai_event(TEAM **teams,
   int ii;
   int jj;
 
-  for (ii = 0; ii < players_per_team; ii++)
+  for (jj = 0; jj < num_teams; jj++)
   {
-    for (jj = 0; jj < 2; jj++)
+    for (ii = 0; ii < players_per_team; ii++)
     {
-      DT_AI_LOG("(%i:%i) Event %s placed on queue\n",
-                teams[jj]->players[ii]->team_id,
-                teams[jj]->players[ii]->player_id,
-                event->name);
-      add_event_to_queue(event, teams[jj]->players[ii]->event_queue);
+      throw_single_player_ai_event(teams[jj]->players[ii], event);
     }
   }
 }
@@ -109,15 +147,17 @@ void throw_multi_player_ai_event(TEAM **teams,
 /*
  * throw_multi_player_ai_event
  *
- * Throws an AI event to all the players in both teams. If the event does not
+ * Throws an AI event to all the players in every team. If the event does not
  * exist then it fails silently.
  *
- * Parameters: teams - Both teams with links to all players.
+ * Parameters: teams - Every team with links to all players.
+ *             num_teams - The number of teams.
  *             players_per_team - Number of players in each team.
  *             automaton - Used to find the automaton event.
  *             event - The event to throw.
  */
 void throw_multi_player_ai_event_by_name(TEAM **teams,
+                                         int num_teams,
                                          int players_per_team,
                                          AUTOMATON *automaton,
                                          char *event_name)
@@ -141,16 +181,38 @@ void throw_multi_player_ai_event_by_name(TEAM **teams,
   }
   else
   {
-    for (ii = 0; ii < players_per_team; ii++)
+    for (jj = 0; jj < num_teams; jj++)
     {
-      for (jj = 0; jj < 2; jj++)
+      for (ii = 0; ii < players_per_team; ii++)
       {
-        DT_AI_LOG("(%i:%i) Event %s placed on queue\n",
-                  teams[jj]->players[ii]->team_id,
-                  teams[jj]->players[ii]->player_id,
-                  event->name);
-        add_event_to_queue(event, teams[jj]->players[ii]->event_queue);
+        throw_single_player_ai_event(teams[jj]->players[ii], event);
       }
     }
   }
 }
+
+/*
+ * throw_multi_player_ai_event_by_id
+ *
+ * As throw_multi_player_ai_event_by_name but with the event's id, which
+ * indexes the automaton's events directly so nothing is searched for.
+ *
+ * Parameters: teams - Every team with links to all players.
+ *             num_teams - The number of teams.
+ *             players_per_team - Number of players in each team.
+ *             automaton - Used to find the automaton event.
+ *             event_id - The id of the event (see event_names.h).
+ */
+void throw_multi_player_ai_event_by_id(TEAM **teams,
+                                       int num_teams,
+                                       int players_per_team,
+                                       AUTOMATON *automaton,
+                                       int event_id)
+{
+  DT_ASSERT(event_id >= 0 && event_id < automaton->num_events);
+
+  throw_multi_player_ai_event(teams,
+                              num_teams,
+                              players_per_team,
+                              automaton->events[event_id]);
+}
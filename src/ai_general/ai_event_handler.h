@@ -17,12 +17,22 @@ void throw_single_player_ai_event(struct player *, struct automaton_event *);
 void throw_single_player_ai_event_by_name(struct player *,
                                           struct automaton *,
                                           char *);
+void throw_single_player_ai_event_by_id(struct player *,
+                                        struct automaton *,
+                                        int);
 void throw_multi_player_ai_event(struct team **,
+                                 int,
                                  int,
                                  struct automaton_event *);
 void throw_multi_player_ai_event_by_name(struct team **,
+                                         int,
                                          int,
                                          struct automaton *,
                                          char *);
+void throw_multi_player_ai_event_by_id(struct team **,
+                                       int,
+                                       int,
+                                       struct automaton *,
+                                       int);
 
 #endif /* AI_EVENT_HANDLER_H_ */
@@ -65,10 +65,14 @@ void process_player_ai(PLAYER *player, Uint32 dt)
  * that player.
  *
  * Parameters: teams - Contains links to all players.
+ *             num_teams - The number of teams.
  *             players_per_team - The size of the players array in each team.
  *             dt - The number of ms since last ai update.
  */
-void process_all_player_ai(TEAM **teams, int players_per_team, Uint32 dt)
+void process_all_player_ai(TEAM **teams,
+                           int num_teams,
+                           int players_per_team,
+                           Uint32 dt)
 {
   /*
    * Local Variables.
@@ -76,9 +80,9 @@ void process_all_player_ai(TEAM **teams, int players_per_team, Uint32 dt)
   int ii;
   int jj;
 
-  for (ii = 0; ii < players_per_team; ii++)
+  for (jj = 0; jj < num_teams; jj++)
   {
-    for (jj = 0; jj < 2; jj++)
+    for (ii = 0; ii < players_per_team; ii++)
     {
       if (teams[jj]->players[ii]->is_ai_managed)
       {
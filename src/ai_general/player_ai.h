@@ -12,6 +12,6 @@
 
 struct team;
 
-void process_all_player_ai(struct team **, int, Uint32);
+void process_all_player_ai(struct team **, int, int, Uint32);
 
 #endif /* PLAYER_AI_H_ */
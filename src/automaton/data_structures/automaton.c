@@ -17,12 +17,66 @@
 #include "automaton_event.h"
 #include "automaton_state.h"
 #include "automaton_transition.h"
+#include "../../data_structures/name_table.h"
 #include "../file_handling/automaton_csv_file_loader.h"
 #include "../file_handling/automaton_transition_file_loader.h"
 #include "../../automaton_handler.h"
+#include "../../impl_automatons/generic_o_d_files/event_names.h"
 #include "../../impl_automatons/lua_callbacks/lua_call_back_functions.h"
 #include "../../match_state.h"
 
+/*
+ * check_automaton_event_ids
+ *
+ * INTERNAL: Code throws the built in events by their fixed ids (see
+ * event_names.h) rather than by name, so every automaton must have each of
+ * those events at its id. Checks that it does using the event name table.
+ *
+ * Parameters: automaton - The automaton, with its event name table built.
+ *
+ * Returns: true if every built in event is at its fixed id, false otherwise.
+ */
+bool check_automaton_event_ids(AUTOMATON *automaton)
+{
+  /*
+   * Local Variables.
+   */
+  int ids[NUM_AUTOMATON_EVENTS] = {AUTOMATON_EVENT_ID_PULL_THROWN,
+                                   AUTOMATON_EVENT_ID_PULL_DROPPED,
+                                   AUTOMATON_EVENT_ID_PULL_CAUGHT,
+                                   AUTOMATON_EVENT_ID_DISC_PICKED_UP,
+                                   AUTOMATON_EVENT_ID_ARRIVED_AT_LOCATION,
+                                   AUTOMATON_EVENT_ID_DISC_HIT_FLOOR,
+                                   AUTOMATON_EVENT_ID_DISC_RELEASED,
+                                   AUTOMATON_EVENT_ID_DISC_CAUGHT};
+  const char *names[NUM_AUTOMATON_EVENTS] = {
+                                         AUTOMATON_EVENT_PULL_THROWN,
+                                         AUTOMATON_EVENT_PULL_DROPPED,
+                                         AUTOMATON_EVENT_PULL_CAUGHT,
+                                         AUTOMATON_EVENT_DISC_PICKED_UP,
+                                         AUTOMATON_EVENT_ARRIVED_AT_LOCATION,
+                                         AUTOMATON_EVENT_DISC_HIT_FLOOR,
+                                         AUTOMATON_EVENT_DISC_RELEASED,
+                                         AUTOMATON_EVENT_DISC_CAUGHT};
+  bool ok = true;
+  int ii;
+
+  for (ii = 0; ii < NUM_AUTOMATON_EVENTS; ii++)
+  {
+    if ((ids[ii] >= automaton->num_events) ||
+        (automaton->events[ids[ii]]->id != ids[ii]) ||
+        (find_name_in_table(automaton->event_names, names[ii]) != ids[ii]))
+    {
+      DT_DEBUG_LOG("Automaton event %s is not at its fixed id %i\n",
+                   names[ii],
+                   ids[ii]);
+      ok = false;
+    }
+  }
+
+  return(ok);
+}
+
 /*
  * create_automaton
  *
@@ -41,7 +95,9 @@
  *                              will create all the event objects and fill them
  *                              in.
  *
- * Returns: A pointer to the newly created memory or NULL on failure.
+ * Returns: A pointer to the newly created memory or NULL on failure, which is
+ *          when two states or two events have the same name or a built in
+ *          event is not at its fixed id.
  */
 AUTOMATON *create_automaton(int (*state_callback)(AUTOMATON_STATE ***, int),
                             int (*event_callback)(AUTOMATON_EVENT ***))
@@ -50,6 +106,8 @@ AUTOMATON *create_automaton(int (*state_callback)(AUTOMATON_STATE ***, int),
    * Local Variables
    */
   AUTOMATON *automaton;
+  bool ok = true;
+  int ii;
 
   /*
    * Allocate the required memory. Forcing everything to 0 means that we can
@@ -70,6 +128,45 @@ AUTOMATON *create_automaton(int (*state_callback)(AUTOMATON_STATE ***, int),
   automaton->num_states = state_callback(&(automaton->states),
                                          automaton->num_events);
 
+  /*
+   * The states and events are looked up by name while the files are loaded
+   * so index them now.
+   */
+  automaton->event_names = create_name_table(automaton->num_events);
+  for (ii = 0; ii < automaton->num_events; ii++)
+  {
+    if (!add_name_to_table(automaton->event_names,
+                           automaton->events[ii]->name,
+                           ii))
+    {
+      DT_DEBUG_LOG("Duplicate automaton event: %s\n",
+                   automaton->events[ii]->name);
+      ok = false;
+    }
+  }
+  automaton->state_names = create_name_table(automaton->num_states);
+  for (ii = 0; ii < automaton->num_states; ii++)
+  {
+    if (!add_name_to_table(automaton->state_names,
+                           automaton->states[ii]->name,
+                           ii))
+    {
+      DT_DEBUG_LOG("Duplicate automaton state: %s\n",
+                   automaton->states[ii]->name);
+      ok = false;
+    }
+  }
+
+  /*
+   * Either of these means that events would be handled by the wrong
+   * transitions, so the automaton can't be used.
+   */
+  if ((!ok) || (!check_automaton_event_ids(automaton)))
+  {
+    destroy_automaton(automaton);
+    automaton = NULL;
+  }
+
   return(automaton);
 }
 
@@ -87,6 +184,23 @@ void destroy_automaton(AUTOMATON *automaton)
    */
   int ii;
 
+  /*
+   * The name tables refer to the names in the states, events and transitions
+   * so are freed first.
+   */
+  if (NULL != automaton->transition_names)
+  {
+    destroy_name_table(automaton->transition_names);
+  }
+  if (NULL != automaton->event_names)
+  {
+    destroy_name_table(automaton->event_names);
+  }
+  if (NULL != automaton->state_names)
+  {
+    destroy_name_table(automaton->state_names);
+  }
+
   /*
    * The states, events and transitions were allocated in the create function
    * so we free them in the destroy function.
@@ -138,11 +252,109 @@ void destroy_automaton(AUTOMATON *automaton)
   DT_FREE(automaton);
 }
 
+/*
+ * resolve_automaton_lua_functions
+ *
+ * INTERNAL: Looks up the lua function of every transition in the automaton
+ * and keeps a reference to it in the lua registry, so that calling it later
+ * doesn't need to find it by name.
+ *
+ * Parameters: automaton - Must have the transitions and lua state set up.
+ *
+ * Returns: False if any transition refers to a function that isn't in the
+ *          lua file. Every missing function is logged.
+ */
+bool resolve_automaton_lua_functions(AUTOMATON *automaton)
+{
+  /*
+   * Local Variables.
+   */
+  AUTOMATON_TRANSITION *transition;
+  bool ok = true;
+  int ii;
+
+  for (ii = 0; ii < automaton->num_transitions; ii++)
+  {
+    transition = automaton->transitions[ii];
+    lua_getglobal(automaton->lua_state, transition->lua_function_name);
+    if (!lua_isfunction(automaton->lua_state, -1))
+    {
+      DT_DEBUG_LOG("Automaton (%s) transition (%s) refers to missing lua " \
+                   "function (%s)\n",
+                   automaton->name,
+                   transition->name,
+                   transition->lua_function_name);
+      lua_pop(automaton->lua_state, 1);
+      ok = false;
+    }
+    else
+    {
+      /*
+       * luaL_ref pops the function off the stack.
+       */
+      transition->lua_function_ref = luaL_ref(automaton->lua_state,
+                                              LUA_REGISTRYINDEX);
+    }
+  }
+
+  return(ok);
+}
+
+/*
+ * open_automaton_lua_state
+ *
+ * INTERNAL: Opens the lua state of an automaton and loads the base libraries
+ * into it, ready for the transition functions to be loaded.
+ *
+ * Parameters: automaton - Must be in the process of being created.
+ */
+void open_automaton_lua_state(AUTOMATON *automaton)
+{
+  automaton->lua_state = lua_open();
+  luaL_openlibs(automaton->lua_state);
+}
+
+/*
+ * complete_automaton_lua_state
+ *
+ * INTERNAL: Once the transition functions are loaded into the lua state this
+ * sets up the callbacks that they use and looks up the function of every
+ * transition.
+ *
+ * Parameters: automaton - Must have the transitions and lua state set up.
+ *             match_state - The match state is required here so that we can set
+ *                           up the global variables required by the lua call
+ *                           back functions.
+ *
+ * Returns: False if a transition refers to a function that isn't loaded.
+ */
+bool complete_automaton_lua_state(AUTOMATON *automaton,
+                                  MATCH_STATE *match_state)
+{
+  /*
+   * Set up the lua call backs. These are independent of automaton.
+   */
+  set_up_lua_callback_globals(match_state);
+
+  /*
+   * Registering the callback functions with lua means that we are able to call
+   * them from the lua files.
+   */
+  register_lua_callback_functions(automaton->lua_state);
+
+  /*
+   * Any transition whose function is missing is found now rather than when
+   * the transition is first used.
+   */
+  return(resolve_automaton_lua_functions(automaton));
+}
+
 /*
  * init_automaton_lua_state
  *
  * Private function to the automaton object. Sets up the lua state and loads the
- * passed in lua filename so that functions from it can be called.
+ * passed in lua filename so that functions from it can be called. The function
+ * of every transition is looked up here.
  *
  * Parameters: automaton - Must be in the process of beign created.
  *             lua_filename - The location of the file containing the transition
@@ -150,21 +362,21 @@ void destroy_automaton(AUTOMATON *automaton)
  *             match_state - The match state is required here so that we can set
  *                           up the global variables required by the lua call
  *                           back functions.
+ *
+ * Returns: False if the lua file couldn't be loaded or is missing a function
+ *          that a transition refers to.
  */
-void init_automaton_lua_state(AUTOMATON *automaton,
+bool init_automaton_lua_state(AUTOMATON *automaton,
                               char *lua_filename,
                               MATCH_STATE *match_state)
 {
   /*
    * Local Variables
    */
+  bool ok = true;
   int rc;
 
-  /*
-   * Open the lua state and load up the base libraries.
-   */
-  automaton->lua_state = lua_open();
-  luaL_openlibs(automaton->lua_state);
+  open_automaton_lua_state(automaton);
 
   /*
    * Load the passed in lua file into the state. We will use it later and close
@@ -176,18 +388,75 @@ void init_automaton_lua_state(AUTOMATON *automaton,
     DT_DEBUG_LOG("Error loading lua file %s: %s\n",
                  lua_filename,
                  lua_tostring(automaton->lua_state, -1));
+    lua_pop(automaton->lua_state, 1);
+    ok = false;
+  }
+
+  if (!complete_automaton_lua_state(automaton, match_state))
+  {
+    ok = false;
   }
 
+  return(ok);
+}
+
+/*
+ * init_automaton_lua_chunk
+ *
+ * As init_automaton_lua_state but the transition functions are loaded from a
+ * chunk of precompiled lua rather than from the lua file, so nothing is
+ * parsed. Used when the automaton is loaded from a compiled automaton file.
+ *
+ * Parameters: automaton - Must be in the process of being created, with the
+ *                         transitions and lua_filename filled in. The filename
+ *                         is only used to name the chunk in lua errors.
+ *             chunk - The output of lua_dump for the lua file.
+ *             chunk_size - The number of bytes in chunk.
+ *             match_state - Required for setting up lua globals.
+ *
+ * Returns: False if the chunk couldn't be loaded or is missing a function
+ *          that a transition refers to.
+ */
+bool init_automaton_lua_chunk(AUTOMATON *automaton,
+                              const char *chunk,
+                              size_t chunk_size,
+                              MATCH_STATE *match_state)
+{
   /*
-   * Set up the lua call backs. These are independent of automaton.
+   * Local Variables
    */
-  set_up_lua_callback_globals(match_state);
+  bool ok = true;
+  int rc;
+
+  open_automaton_lua_state(automaton);
 
   /*
-   * Registering the callback functions with lua means that we are able to call
-   * them from the lua files.
+   * Running the chunk defines the transition functions exactly as running
+   * the file would.
    */
-  register_lua_callback_functions(automaton->lua_state);
+  rc = luaL_loadbuffer(automaton->lua_state,
+                       chunk,
+                       chunk_size,
+                       automaton->lua_filename);
+  if (0 == rc)
+  {
+    rc = lua_pcall(automaton->lua_state, 0, LUA_MULTRET, 0);
+  }
+  if (0 != rc)
+  {
+    DT_DEBUG_LOG("Error loading compiled lua for %s: %s\n",
+                 automaton->lua_filename,
+                 lua_tostring(automaton->lua_state, -1));
+    lua_pop(automaton->lua_state, 1);
+    ok = false;
+  }
+
+  if (!complete_automaton_lua_state(automaton, match_state))
+  {
+    ok = false;
+  }
+
+  return(ok);
 }
 
 /*
@@ -248,17 +517,58 @@ int init_automaton_links(AUTOMATON *automaton,
   }
 
   /*
-   * TODO: Should this have error checking? Don't understand lua api :(
-   *
    * Initialise the lua state that is associated with this automaton object.
+   * The filename is kept so that the automaton can be compiled.
    */
-  init_automaton_lua_state(automaton, lua_filename, match_state);
+  strncpy(automaton->lua_filename, lua_filename, MAX_AUTOMATON_FILENAME_LEN);
+  automaton->lua_filename[MAX_AUTOMATON_FILENAME_LEN] = '\0';
+  if (!init_automaton_lua_state(automaton, lua_filename, match_state))
+  {
+    DT_DEBUG_LOG("Could not load lua functions from %s\n", lua_filename);
+    ret_code = INIT_AUTOMATON_LINKS_LUA_FILE_FAIL;
+    goto EXIT_LABEL;
+  }
 
 EXIT_LABEL:
 
   return(ret_code);
 }
 
+/*
+ * index_automaton_transitions
+ *
+ * Once the transitions have been created and named this indexes them by name
+ * so that they can refer to each other.
+ *
+ * Parameters: automaton - The automaton.
+ *
+ * Returns: False if two transitions have the same name.
+ */
+bool index_automaton_transitions(AUTOMATON *automaton)
+{
+  /*
+   * Local Variables.
+   */
+  bool ok = true;
+  int ii;
+
+  automaton->transition_names = create_name_table(automaton->num_transitions);
+  for (ii = 0; ii < automaton->num_transitions; ii++)
+  {
+    if (!add_name_to_table(automaton->transition_names,
+                           automaton->transitions[ii]->name,
+                           ii))
+    {
+      DT_DEBUG_LOG("Automaton (%s) has duplicate transition (%s)\n",
+                   automaton->name,
+                   automaton->transitions[ii]->name);
+      ok = false;
+    }
+  }
+
+  return(ok);
+}
+
 /*
  * find_automaton_state_by_name
  *
@@ -275,25 +585,9 @@ AUTOMATON_STATE *find_automaton_state_by_name(AUTOMATON *automaton,
   /*
    * Local Variables.
    */
-  int ii;
-
-  /*
-   * Loop through the automaton states comparing the name with each in the
-   * array.
-   *
-   * @@DAT - If this at any point gets moved so that the automaton loading
-   * is speed dependent then we should change this so that we are searching a
-   * binary tree instead.
-   */
-  for (ii = 0; ii < automaton->num_states; ii++)
-  {
-    if (0 == strcmp(automaton->states[ii]->name, state))
-    {
-      return(automaton->states[ii]);
-    }
-  }
+  int id = find_name_in_table(automaton->state_names, state);
 
-  return(NULL);
+  return((NAME_TABLE_NOT_FOUND == id) ? NULL : automaton->states[id]);
 }
 
 /*
@@ -301,6 +595,9 @@ AUTOMATON_STATE *find_automaton_state_by_name(AUTOMATON *automaton,
  *
  * Takes a string and finds the matching state in the automaton event table.
  *
+ * Events which are thrown from code should be thrown by id instead, which
+ * needs no search at all (see event_names.h).
+ *
  * Parameters: automaton - Automaton to find the event in.
  *             event - The name of the event.
  *
@@ -312,25 +609,9 @@ AUTOMATON_EVENT *find_automaton_event_by_name(AUTOMATON *automaton,
   /*
    * Local Variables.
    */
-  int ii;
+  int id = find_name_in_table(automaton->event_names, event);
 
-  /*
-   * Loop through the automaton events comparing the name with each in the
-   * array.
-   *
-   * @@DAT - If this at any point gets moved so that the automaton loading
-   * is speed dependent then we should change this so that we are searching a
-   * binary tree instead.
-   */
-  for (ii = 0; ii < automaton->num_events; ii++)
-  {
-    if (0 == strcmp(automaton->events[ii]->name, event))
-    {
-      return(automaton->events[ii]);
-    }
-  }
-
-  return(NULL);
+  return((NAME_TABLE_NOT_FOUND == id) ? NULL : automaton->events[id]);
 }
 
 /*
@@ -339,7 +620,7 @@ AUTOMATON_EVENT *find_automaton_event_by_name(AUTOMATON *automaton,
  * Takes a string and finds the matching transition in the automaton state
  * table.
  *
- * Parameters: automaton
+ * Parameters: automaton - Must have had index_automaton_transitions called.
  *             transition
  *
  * Returns: NULL if no transition was found by that name.
@@ -350,23 +631,7 @@ AUTOMATON_TRANSITION *find_automaton_transition_by_name(AUTOMATON *automaton,
   /*
    * Local Variables.
    */
-  int ii;
-
-  /*
-   * Loop through the automaton transitions comparing the name with each in the
-   * array.
-   *
-   * @@DAT - If this at any point gets moved so that the automaton loading
-   * is speed dependent then we should change this so that we are searching a
-   * binary tree instead.
-   */
-  for (ii = 0; ii < automaton->num_transitions; ii++)
-  {
-    if (0 == strcmp(automaton->transitions[ii]->name, transition))
-    {
-      return(automaton->transitions[ii]);
-    }
-  }
+  int id = find_name_in_table(automaton->transition_names, transition);
 
-  return(NULL);
+  return((NAME_TABLE_NOT_FOUND == id) ? NULL : automaton->transitions[id]);
 }
@@ -8,6 +8,7 @@
 #ifndef AUTOMATON_H_
 #define AUTOMATON_H_
 
+#include <stdbool.h>
 #include "lua5.1/lua.h"
 #include "ezxml/ezxml.h"
 
@@ -15,13 +16,20 @@ struct automaton_set;
 struct automaton_state;
 struct automaton_event;
 struct automaton_transition;
+struct automaton_decision_node;
 struct match_state;
+struct name_table;
 
 /*
  * The maximum length for the length of an automaton name.
  */
 #define MAX_AUTOMATON_NAME_LEN 100
 
+/*
+ * The maximum length of the name of the lua file used by an automaton.
+ */
+#define MAX_AUTOMATON_FILENAME_LEN 1024
+
 /*
  * INIT_AUTOMATON_LINK_RET_CODES
  *
@@ -30,6 +38,7 @@ struct match_state;
 #define INIT_AUTOMATON_LINKS_OK 0
 #define INIT_AUTOMATON_LINKS_TRANSITION_FILE_FAIL 1
 #define INIT_AUTOMATON_LINKS_CSV_FILE_FAIL 2
+#define INIT_AUTOMATON_LINKS_LUA_FILE_FAIL 3
 
 /*
  * AUTOMATON
@@ -38,6 +47,8 @@ struct match_state;
  * functions.
  *
  * lua_state - This is the lua state that we use to load the functions.
+ * lua_filename - The file that the lua functions were loaded from. Kept so
+ *                that the automaton can be compiled (automaton_binary_file.h).
  * start_state - Must be one of the states and is the entrance point for this
  *               automaton.
  * states - An array of the states in the automaton. Indexed by state id.
@@ -47,11 +58,18 @@ struct match_state;
  * num_states - Stored to save calculating this from the size of the array.
  * num_events
  * num_transitions
+ * state_names - Finds the id of a state from its name.
+ * event_names - Finds the id of an event from its name.
+ * transition_names - Finds the id of a transition from its name. NULL until
+ *                    the transitions have been read from file.
+ * decision_nodes - The decision node of each transition indexed by id (see
+ *                  automaton_decision_dag.h). Owned by the set.
  */
 typedef struct automaton
 {
   char name[MAX_AUTOMATON_NAME_LEN + 1];
   lua_State *lua_state;
+  char lua_filename[MAX_AUTOMATON_FILENAME_LEN + 1];
   struct automaton_state *start_state;
   struct automaton_state **states;
   struct automaton_event **events;
@@ -59,6 +77,10 @@ typedef struct automaton
   int num_states;
   int num_events;
   int num_transitions;
+  struct name_table *state_names;
+  struct name_table *event_names;
+  struct name_table *transition_names;
+  struct automaton_decision_node *decision_nodes;
 } AUTOMATON;
 
 int init_automaton_links(AUTOMATON *,
@@ -68,6 +90,11 @@ int init_automaton_links(AUTOMATON *,
 AUTOMATON *create_automaton(int (*)(struct automaton_state ***, int),
                             int (*)(struct automaton_event ***));
 void destroy_automaton(AUTOMATON *);
+bool index_automaton_transitions(AUTOMATON *);
+bool init_automaton_lua_chunk(AUTOMATON *,
+                              const char *,
+                              size_t,
+                              struct match_state *);
 struct automaton_state *find_automaton_state_by_name(AUTOMATON *, char *);
 struct automaton_event *find_automaton_event_by_name(AUTOMATON *, char *);
 struct automaton_transition *find_automaton_transition_by_name(AUTOMATON *,
@@ -191,6 +191,7 @@ void process_timed_event_node(AUTOMATON_TIMED_EVENT_QUEUE_NODE *node,
   if (node->all_players)
   {
     throw_multi_player_ai_event(match_state->teams,
+                                match_state->num_teams,
                                 match_state->players_per_team,
                                 node->event);
   }
@@ -210,7 +211,7 @@ void process_timed_event_node(AUTOMATON_TIMED_EVENT_QUEUE_NODE *node,
  * ai processing.
  *
  * Parameters: queue - The queue to retrieve elements from. Can be empty.
- *             t - The current time in ms.
+ *             t - The current simulation time in ms.
  *             match_state - Used to retrieve player information.
  */
 void pop_all_timed_events(AUTOMATON_TIMED_EVENT_QUEUE *queue,
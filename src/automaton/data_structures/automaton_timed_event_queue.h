@@ -40,7 +40,7 @@ typedef struct automaton_timed_event_queue
  * next - Set to NULL if this is the end of the queue.
  * event - The event to which this corresponds.
  * length - The length of time this event should remain on the queue.
- * start - The time at which the event was added to the queue.
+ * start - The simulation time at which the event was added to the queue.
  * player_id - The player for whom this event will be thrown. Only valid if
  *             all_players == false.
  * team_id - The team that the player belongs to.
@@ -6,6 +6,8 @@
  */
 #include "../../dt_logger.h"
 
+#include <lua5.1/lua.h>
+#include <lua5.1/lauxlib.h>
 #include "automaton_transition.h"
 
 /*
@@ -26,6 +28,7 @@ AUTOMATON_TRANSITION *create_automaton_transition()
    * Allocate the required memory
    */
   automaton_transition = (AUTOMATON_TRANSITION *) DT_MALLOC(sizeof(AUTOMATON_TRANSITION));
+  automaton_transition->lua_function_ref = LUA_NOREF;
 
   return(automaton_transition);
 }
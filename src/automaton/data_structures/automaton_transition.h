@@ -45,8 +45,12 @@ struct automaton;
  *                  automaton when the lua function returns true.
  * false_automaton - If this is set then this transition takes us to a new
  *                   automaton when the lua function returns false.
- * lua_function_name - We call lua functions by name so this is the exact name
- *                     of the function in the lua transitions file.
+ * lua_function_name - The exact name of the function in the lua transitions
+ *                     file.
+ * lua_function_ref - The function, as a reference into the lua registry of
+ *                    the automaton that owns the transition. Looked up once
+ *                    when the lua file is loaded so that calling it doesn't
+ *                    search the globals by name. LUA_NOREF until then.
  */
 typedef struct automaton_transition
 {
@@ -59,6 +63,7 @@ typedef struct automaton_transition
   struct automaton *true_automaton;
   struct automaton *false_automaton;
   char lua_function_name[MAX_LUA_FUNCTION_NAME_LEN];
+  int lua_function_ref;
 } AUTOMATON_TRANSITION;
 
 AUTOMATON_TRANSITION *create_automaton_transition();
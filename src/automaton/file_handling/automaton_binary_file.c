@@ -0,0 +1,1202 @@
+/*
+ * automaton_binary_file.c
+ *
+ *  Created on: 16 Oct 2026
+ *      Author: David Tyler
+ */
+
+#include "../../dt_logger.h"
+
+#include <limits.h>
+#include <stdio.h>
+#include <string.h>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+#include <lua5.1/lua.h>
+#include <lua5.1/lauxlib.h>
+
+#include "automaton_binary_file.h"
+#include "../data_structures/automaton.h"
+#include "../data_structures/automaton_event.h"
+#include "../data_structures/automaton_state.h"
+#include "../data_structures/automaton_transition.h"
+#include "../../automaton_handler.h"
+#include "../../data_structures/name_table.h"
+#include "../../match_state.h"
+
+/*
+ * align_binary_offset
+ *
+ * INTERNAL: Rounds an offset in the file up so that ints can be read from it.
+ *
+ * Parameters: offset - The offset.
+ *
+ * Returns: The first multiple of 4 at or after offset.
+ */
+unsigned int align_binary_offset(unsigned int offset)
+{
+  return((offset + 3) & ~3u);
+}
+
+/*
+ * add_binary_string
+ *
+ * INTERNAL: Adds a string to the string pool of a file being written. Each
+ * string is only stored once.
+ *
+ * Parameters: pool - The string pool. Must have room for the string.
+ *             pool_size - The number of bytes used in the pool. Updated.
+ *             offsets - Finds the offset of a string already in the pool.
+ *             string - The string to add.
+ *
+ * Returns: The offset of the string in the pool.
+ */
+unsigned int add_binary_string(char *pool,
+                               unsigned int *pool_size,
+                               NAME_TABLE *offsets,
+                               const char *string)
+{
+  /*
+   * Local Variables.
+   */
+  int offset;
+
+  offset = find_name_in_table(offsets, string);
+  if (NAME_TABLE_NOT_FOUND == offset)
+  {
+    offset = (int) *pool_size;
+    strcpy(pool + offset, string);
+    add_name_to_table(offsets, pool + offset, offset);
+    *pool_size += (unsigned int) strlen(string) + 1;
+  }
+
+  return((unsigned int) offset);
+}
+
+/*
+ * add_lua_chunk_to_buffer
+ *
+ * INTERNAL: lua_Writer used to collect the output of lua_dump in a lua
+ * buffer, as string.dump does.
+ *
+ * Parameters: lua_state - Not needed, but part of the lua_Writer type.
+ *             data - The next piece of the chunk.
+ *             size - The size of the piece.
+ *             buffer - The luaL_Buffer to add to.
+ *
+ * Returns: 0, meaning carry on.
+ */
+int add_lua_chunk_to_buffer(lua_State *lua_state,
+                            const void *data,
+                            size_t size,
+                            void *buffer)
+{
+  (void) lua_state;
+
+  luaL_addlstring((luaL_Buffer *) buffer, (const char *) data, size);
+
+  return(0);
+}
+
+/*
+ * find_binary_state_index
+ *
+ * INTERNAL: Parameters: automaton - The automaton that owns the state.
+ *                       state - The state.
+ *
+ * Returns: The index of the state in the automaton or AUTOMATON_BINARY_NONE
+ *          if it isn't one of the automaton's states.
+ */
+int find_binary_state_index(AUTOMATON *automaton, AUTOMATON_STATE *state)
+{
+  /*
+   * Local Variables.
+   */
+  int ii;
+
+  for (ii = 0; ii < automaton->num_states; ii++)
+  {
+    if (automaton->states[ii] == state)
+    {
+      return(ii);
+    }
+  }
+
+  return(AUTOMATON_BINARY_NONE);
+}
+
+/*
+ * find_binary_transition_index
+ *
+ * INTERNAL: Parameters: automaton - The automaton that owns the transition.
+ *                       transition - The transition.
+ *
+ * Returns: The index of the transition in the automaton or
+ *          AUTOMATON_BINARY_NONE if it isn't one of the automaton's
+ *          transitions.
+ */
+int find_binary_transition_index(AUTOMATON *automaton,
+                                 AUTOMATON_TRANSITION *transition)
+{
+  if ((transition->id >= 0) &&
+      (transition->id < automaton->num_transitions) &&
+      (automaton->transitions[transition->id] == transition))
+  {
+    return(transition->id);
+  }
+
+  return(AUTOMATON_BINARY_NONE);
+}
+
+/*
+ * find_binary_automaton_index
+ *
+ * INTERNAL: Parameters: automaton_set - The set.
+ *                       automaton - The automaton.
+ *
+ * Returns: The index of the automaton in the set or AUTOMATON_BINARY_NONE if
+ *          it isn't in the set.
+ */
+int find_binary_automaton_index(AUTOMATON_SET *automaton_set,
+                                AUTOMATON *automaton)
+{
+  /*
+   * Local Variables.
+   */
+  int ii;
+
+  for (ii = 0; ii < automaton_set->num_automatons; ii++)
+  {
+    if (automaton_set->automaton_array[ii] == automaton)
+    {
+      return(ii);
+    }
+  }
+
+  return(AUTOMATON_BINARY_NONE);
+}
+
+/*
+ * fill_binary_target
+ *
+ * INTERNAL: Turns one result of a transition into indexes.
+ *
+ * Parameters: automaton_set - The set being written.
+ *             owner - The automaton that owns the transition.
+ *             automaton, state, transition - The links for the result. Any
+ *                                            can be NULL.
+ *             target - Filled in with the indexes.
+ *
+ * Returns: False if any of the links isn't in the set.
+ */
+bool fill_binary_target(AUTOMATON_SET *automaton_set,
+                        AUTOMATON *owner,
+                        AUTOMATON *automaton,
+                        AUTOMATON_STATE *state,
+                        AUTOMATON_TRANSITION *transition,
+                        AUTOMATON_BINARY_TARGET *target)
+{
+  target->automaton = AUTOMATON_BINARY_NONE;
+  target->state = AUTOMATON_BINARY_NONE;
+  target->transition = AUTOMATON_BINARY_NONE;
+
+  /*
+   * The state and transition are in the automaton being moved to if there is
+   * one, as they are in the xml.
+   */
+  if (NULL != automaton)
+  {
+    target->automaton = find_binary_automaton_index(automaton_set, automaton);
+    if (AUTOMATON_BINARY_NONE == target->automaton)
+    {
+      return(false);
+    }
+    owner = automaton;
+  }
+  if (NULL != state)
+  {
+    target->state = find_binary_state_index(owner, state);
+    if (AUTOMATON_BINARY_NONE == target->state)
+    {
+      return(false);
+    }
+  }
+  if (NULL != transition)
+  {
+    target->transition = find_binary_transition_index(owner, transition);
+    if (AUTOMATON_BINARY_NONE == target->transition)
+    {
+      return(false);
+    }
+  }
+
+  return(true);
+}
+
+/*
+ * is_automaton_binary_file
+ *
+ * Parameters: filename - The file to check.
+ *
+ * Returns: True if the file starts with AUTOMATON_BINARY_FILE_MAGIC, in which
+ *          case it should be loaded with load_automaton_set_binary_file
+ *          rather than as xml.
+ */
+bool is_automaton_binary_file(char *filename)
+{
+  /*
+   * Local Variables.
+   */
+  FILE *file;
+  unsigned int magic = 0;
+
+  file = fopen(filename, "rb");
+  if (NULL == file)
+  {
+    return(false);
+  }
+  if (1 != fread(&magic, sizeof(magic), 1, file))
+  {
+    magic = 0;
+  }
+  fclose(file);
+
+  return(AUTOMATON_BINARY_FILE_MAGIC == magic);
+}
+
+/*
+ * save_automaton_set_binary_file
+ *
+ * Compiles a loaded automaton set into the format read by
+ * load_automaton_set_binary_file. See AUTOMATON_BINARY_HEADER.
+ *
+ * The lua file of each automaton is compiled again from lua_filename rather
+ * than dumped from the automaton's lua state, so that the chunk only defines
+ * the transition functions and doesn't carry the callbacks with it.
+ *
+ * Parameters: automaton_set - A set loaded from xml. Every link must be to
+ *                             something in the set.
+ *             filename - The file to write. Overwritten if it exists.
+ *
+ * Returns: One of the AUTOMATON_BINARY_FILE return codes.
+ */
+int save_automaton_set_binary_file(AUTOMATON_SET *automaton_set,
+                                   char *filename)
+{
+  /*
+   * Local Variables.
+   */
+  AUTOMATON_BINARY_HEADER *header;
+  AUTOMATON_BINARY_AUTOMATON *binary_automatons;
+  AUTOMATON_BINARY_TRANSITION *binary_transitions;
+  AUTOMATON *automaton;
+  AUTOMATON *first;
+  AUTOMATON_TRANSITION *transition;
+  NAME_TABLE *string_offsets = NULL;
+  lua_State **lua_states = NULL;
+  luaL_Buffer lua_buffer;
+  const char *lua_chunk;
+  size_t lua_chunk_size;
+  char *data = NULL;
+  char *pool;
+  unsigned int *names;
+  unsigned int max_pool_size;
+  unsigned int pool_size = 0;
+  unsigned int file_size;
+  unsigned int offset;
+  int *transition_table;
+  int index;
+  int max_strings;
+  int ret_code = AUTOMATON_BINARY_FILE_OK;
+  int rc;
+  int ii;
+  int jj;
+  int kk;
+  FILE *file;
+
+  first = automaton_set->automaton_array[0];
+
+  /*
+   * Count the strings and the room they could take so that the pool can be
+   * built in the output directly. Every automaton in a set was created by
+   * the same callbacks so the state and event names are stored once.
+   */
+  max_strings = first->num_states + first->num_events;
+  max_pool_size = 0;
+  for (ii = 0; ii < first->num_states; ii++)
+  {
+    max_pool_size += (unsigned int) strlen(first->states[ii]->name) + 1;
+  }
+  for (ii = 0; ii < first->num_events; ii++)
+  {
+    max_pool_size += (unsigned int) strlen(first->events[ii]->name) + 1;
+  }
+  for (ii = 0; ii < automaton_set->num_automatons; ii++)
+  {
+    automaton = automaton_set->automaton_array[ii];
+    if ((automaton->num_states != first->num_states) ||
+        (automaton->num_events != first->num_events))
+    {
+      DT_DEBUG_LOG("Automaton (%s) has different states or events to (%s)\n",
+                   automaton->name,
+                   first->name);
+      ret_code = AUTOMATON_BINARY_FILE_BAD_SET;
+      goto EXIT_LABEL;
+    }
+
+    max_strings += 2 + 2 * automaton->num_transitions;
+    max_pool_size += (unsigned int) strlen(automaton->name) + 1;
+    max_pool_size += (unsigned int) strlen(automaton->lua_filename) + 1;
+    for (jj = 0; jj < automaton->num_transitions; jj++)
+    {
+      transition = automaton->transitions[jj];
+      max_pool_size += (unsigned int) strlen(transition->name) + 1;
+      max_pool_size +=
+                     (unsigned int) strlen(transition->lua_function_name) + 1;
+    }
+  }
+
+  /*
+   * Compile the lua file of each automaton. The chunk is left on the top of
+   * the stack of its lua state until it has been copied into the output.
+   */
+  lua_states = (lua_State **) DT_MALLOC(sizeof(lua_State *) *
+                                        automaton_set->num_automatons);
+  memset(lua_states, '\0', sizeof(lua_State *) * automaton_set->num_automatons);
+  for (ii = 0; ii < automaton_set->num_automatons; ii++)
+  {
+    automaton = automaton_set->automaton_array[ii];
+    lua_states[ii] = lua_open();
+    rc = luaL_loadfile(lua_states[ii], automaton->lua_filename);
+    if (0 != rc)
+    {
+      DT_DEBUG_LOG("Error compiling lua file %s: %s\n",
+                   automaton->lua_filename,
+                   lua_tostring(lua_states[ii], -1));
+      ret_code = AUTOMATON_BINARY_FILE_LUA_FAIL;
+      goto EXIT_LABEL;
+    }
+    luaL_buffinit(lua_states[ii], &lua_buffer);
+    lua_dump(lua_states[ii], add_lua_chunk_to_buffer, &lua_buffer);
+    luaL_pushresult(&lua_buffer);
+  }
+
+  /*
+   * Work out the size of everything before the string pool, which goes last
+   * because its size isn't known until it has been built.
+   */
+  offset = sizeof(AUTOMATON_BINARY_HEADER);
+  offset += sizeof(unsigned int) * (first->num_states + first->num_events);
+  offset += sizeof(AUTOMATON_BINARY_AUTOMATON) * automaton_set->num_automatons;
+  for (ii = 0; ii < automaton_set->num_automatons; ii++)
+  {
+    automaton = automaton_set->automaton_array[ii];
+    offset += sizeof(AUTOMATON_BINARY_TRANSITION) * automaton->num_transitions;
+    offset += sizeof(int) * first->num_states * first->num_events;
+  }
+  for (ii = 0; ii < automaton_set->num_automatons; ii++)
+  {
+    lua_tolstring(lua_states[ii], -1, &lua_chunk_size);
+    offset = align_binary_offset(offset + (unsigned int) lua_chunk_size);
+  }
+  data = (char *) DT_MALLOC(offset + max_pool_size);
+  memset(data, '\0', offset + max_pool_size);
+  pool = data + offset;
+  string_offsets = create_name_table(max_strings);
+
+  /*
+   * Fill in the header and names of the states and events.
+   */
+  header = (AUTOMATON_BINARY_HEADER *) data;
+  header->magic = AUTOMATON_BINARY_FILE_MAGIC;
+  header->version = AUTOMATON_BINARY_FILE_VERSION;
+  header->num_automatons = automaton_set->num_automatons;
+  header->start_automaton = find_binary_automaton_index(
+                                               automaton_set,
+                                               automaton_set->start_automaton);
+  header->num_states = first->num_states;
+  header->num_events = first->num_events;
+  header->strings = offset;
+  if (AUTOMATON_BINARY_NONE == header->start_automaton)
+  {
+    DT_DEBUG_LOG("The start automaton is not in the set\n");
+    ret_code = AUTOMATON_BINARY_FILE_BAD_SET;
+    goto EXIT_LABEL;
+  }
+
+  offset = sizeof(AUTOMATON_BINARY_HEADER);
+  header->state_names = offset;
+  names = (unsigned int *) (data + offset);
+  for (ii = 0; ii < first->num_states; ii++)
+  {
+    names[ii] = add_binary_string(pool,
+                                  &pool_size,
+                                  string_offsets,
+                                  first->states[ii]->name);
+  }
+  offset += sizeof(unsigned int) * first->num_states;
+  header->event_names = offset;
+  names = (unsigned int *) (data + offset);
+  for (ii = 0; ii < first->num_events; ii++)
+  {
+    names[ii] = add_binary_string(pool,
+                                  &pool_size,
+                                  string_offsets,
+                                  first->events[ii]->name);
+  }
+  offset += sizeof(unsigned int) * first->num_events;
+  header->automatons = offset;
+  binary_automatons = (AUTOMATON_BINARY_AUTOMATON *) (data + offset);
+  offset += sizeof(AUTOMATON_BINARY_AUTOMATON) * automaton_set->num_automatons;
+
+  /*
+   * Fill in each automaton with its transitions and transition table.
+   */
+  for (ii = 0; ii < automaton_set->num_automatons; ii++)
+  {
+    automaton = automaton_set->automaton_array[ii];
+    binary_automatons[ii].name = add_binary_string(pool,
+                                                   &pool_size,
+                                                   string_offsets,
+                                                   automaton->name);
+    binary_automatons[ii].lua_filename = add_binary_string(
+                                                      pool,
+                                                      &pool_size,
+                                                      string_offsets,
+                                                      automaton->lua_filename);
+    binary_automatons[ii].start_state = find_binary_state_index(
+                                                       automaton,
+                                                       automaton->start_state);
+    if (AUTOMATON_BINARY_NONE == binary_automatons[ii].start_state)
+    {
+      DT_DEBUG_LOG("Automaton (%s) has no start state\n", automaton->name);
+      ret_code = AUTOMATON_BINARY_FILE_BAD_SET;
+      goto EXIT_LABEL;
+    }
+    binary_automatons[ii].num_transitions = automaton->num_transitions;
+
+    binary_automatons[ii].transitions = offset;
+    binary_transitions = (AUTOMATON_BINARY_TRANSITION *) (data + offset);
+    for (jj = 0; jj < automaton->num_transitions; jj++)
+    {
+      transition = automaton->transitions[jj];
+      binary_transitions[jj].name = add_binary_string(pool,
+                                                      &pool_size,
+                                                      string_offsets,
+                                                      transition->name);
+      binary_transitions[jj].lua_function_name = add_binary_string(
+                                                 pool,
+                                                 &pool_size,
+                                                 string_offsets,
+                                                 transition->lua_function_name);
+      if ((!fill_binary_target(automaton_set,
+                               automaton,
+                               transition->true_automaton,
+                               transition->true_state,
+                               transition->true_transition,
+                               &(binary_transitions[jj].true_target))) ||
+          (!fill_binary_target(automaton_set,
+                               automaton,
+                               transition->false_automaton,
+                               transition->false_state,
+                               transition->false_transition,
+                               &(binary_transitions[jj].false_target))))
+      {
+        DT_DEBUG_LOG("Automaton (%s) transition (%s) links outside the set\n",
+                     automaton->name,
+                     transition->name);
+        ret_code = AUTOMATON_BINARY_FILE_BAD_SET;
+        goto EXIT_LABEL;
+      }
+    }
+    offset += sizeof(AUTOMATON_BINARY_TRANSITION) * automaton->num_transitions;
+
+    binary_automatons[ii].transition_table = offset;
+    transition_table = (int *) (data + offset);
+    for (jj = 0; jj < automaton->num_states; jj++)
+    {
+      for (kk = 0; kk < automaton->num_events; kk++)
+      {
+        transition = automaton->states[jj]->transitions[kk];
+        index = AUTOMATON_BINARY_NONE;
+        if (NULL != transition)
+        {
+          index = find_binary_transition_index(automaton, transition);
+        }
+        transition_table[jj * automaton->num_events + kk] = index;
+        if ((NULL != transition) && (AUTOMATON_BINARY_NONE == index))
+        {
+          DT_DEBUG_LOG("Automaton (%s) state (%s) uses another automaton's " \
+                       "transition (%s)\n",
+                       automaton->name,
+                       automaton->states[jj]->name,
+                       transition->name);
+          ret_code = AUTOMATON_BINARY_FILE_BAD_SET;
+          goto EXIT_LABEL;
+        }
+      }
+    }
+    offset += sizeof(int) * automaton->num_states * automaton->num_events;
+  }
+
+  /*
+   * Then the compiled lua.
+   */
+  for (ii = 0; ii < automaton_set->num_automatons; ii++)
+  {
+    lua_chunk = lua_tolstring(lua_states[ii], -1, &lua_chunk_size);
+    binary_automatons[ii].lua_chunk = offset;
+    binary_automatons[ii].lua_chunk_size = (unsigned int) lua_chunk_size;
+    memcpy(data + offset, lua_chunk, lua_chunk_size);
+    offset = align_binary_offset(offset + (unsigned int) lua_chunk_size);
+  }
+
+  /*
+   * The string pool is already in place.
+   */
+  header->strings_size = pool_size;
+  file_size = header->strings + pool_size;
+  header->file_size = file_size;
+
+  file = fopen(filename, "wb");
+  if (NULL == file)
+  {
+    DT_DEBUG_LOG("Could not open automaton file %s for writing\n", filename);
+    ret_code = AUTOMATON_BINARY_FILE_FILE_ERROR;
+    goto EXIT_LABEL;
+  }
+  if (file_size != fwrite(data, 1, file_size, file))
+  {
+    DT_DEBUG_LOG("Failed writing automaton file %s\n", filename);
+    ret_code = AUTOMATON_BINARY_FILE_FILE_ERROR;
+  }
+  if (0 != fclose(file))
+  {
+    ret_code = AUTOMATON_BINARY_FILE_FILE_ERROR;
+  }
+
+EXIT_LABEL:
+
+  if (NULL != string_offsets)
+  {
+    destroy_name_table(string_offsets);
+  }
+  if (NULL != data)
+  {
+    DT_FREE(data);
+  }
+  if (NULL != lua_states)
+  {
+    for (ii = 0; ii < automaton_set->num_automatons; ii++)
+    {
+      if (NULL != lua_states[ii])
+      {
+        lua_close(lua_states[ii]);
+      }
+    }
+    DT_FREE(lua_states);
+  }
+
+  return(ret_code);
+}
+
+/*
+ * map_automaton_binary_file
+ *
+ * INTERNAL: Maps a whole file into memory read only.
+ *
+ * The file (and on Windows the file mapping object) is closed once the view
+ * of it is mapped, as the view keeps the mapping alive until it is unmapped.
+ *
+ * Parameters: filename - The file to map.
+ *             mapped_size - Filled in with the size of the mapping.
+ *
+ * Returns: The start of the mapping or NULL if the file couldn't be mapped or
+ *          is too small to hold a header.
+ */
+void *map_automaton_binary_file(char *filename, size_t *mapped_size)
+{
+  /*
+   * Local Variables.
+   */
+  void *mapped_data;
+#ifdef _WIN32
+  HANDLE file;
+  HANDLE mapping;
+  LARGE_INTEGER file_size;
+#else
+  int fd;
+  struct stat file_stat;
+#endif
+
+#ifdef _WIN32
+  file = CreateFileA(filename,
+                     GENERIC_READ,
+                     FILE_SHARE_READ,
+                     NULL,
+                     OPEN_EXISTING,
+                     FILE_ATTRIBUTE_NORMAL,
+                     NULL);
+  if (INVALID_HANDLE_VALUE == file)
+  {
+    return(NULL);
+  }
+  if ((!GetFileSizeEx(file, &file_size)) ||
+      (file_size.QuadPart < (LONGLONG) sizeof(AUTOMATON_BINARY_HEADER)))
+  {
+    CloseHandle(file);
+    return(NULL);
+  }
+  *mapped_size = (size_t) file_size.QuadPart;
+  mapping = CreateFileMapping(file, NULL, PAGE_READONLY, 0, 0, NULL);
+  CloseHandle(file);
+  if (NULL == mapping)
+  {
+    return(NULL);
+  }
+  mapped_data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+  CloseHandle(mapping);
+  if (NULL == mapped_data)
+  {
+    return(NULL);
+  }
+#else
+  fd = open(filename, O_RDONLY);
+  if (-1 == fd)
+  {
+    return(NULL);
+  }
+  if ((0 != fstat(fd, &file_stat)) ||
+      (file_stat.st_size < (off_t) sizeof(AUTOMATON_BINARY_HEADER)))
+  {
+    close(fd);
+    return(NULL);
+  }
+  *mapped_size = (size_t) file_stat.st_size;
+  mapped_data = mmap(NULL, *mapped_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (MAP_FAILED == mapped_data)
+  {
+    return(NULL);
+  }
+#endif
+
+  return(mapped_data);
+}
+
+/*
+ * unmap_automaton_binary_file
+ *
+ * INTERNAL: Undoes map_automaton_binary_file.
+ *
+ * Parameters: mapped_data, mapped_size - As returned by
+ *             map_automaton_binary_file.
+ */
+void unmap_automaton_binary_file(void *mapped_data, size_t mapped_size)
+{
+#ifdef _WIN32
+  (void) mapped_size;
+  UnmapViewOfFile(mapped_data);
+#else
+  munmap(mapped_data, mapped_size);
+#endif
+}
+
+/*
+ * binary_range_ok
+ *
+ * INTERNAL: Parameters: file_size - The size of the file.
+ *                       offset - The offset of an array in the file.
+ *                       count - The number of elements in the array.
+ *                       element_size - The size of each element. Arrays of
+ *                                      anything but bytes must be aligned.
+ *
+ * Returns: True if the array lies within the file.
+ */
+bool binary_range_ok(size_t file_size,
+                     unsigned int offset,
+                     unsigned long long count,
+                     size_t element_size)
+{
+  if ((element_size > 1) && (0 != (offset & 3)))
+  {
+    return(false);
+  }
+
+  return((unsigned long long) offset + count * element_size <=
+                                                (unsigned long long) file_size);
+}
+
+/*
+ * binary_string_ok
+ *
+ * INTERNAL: Parameters: data - The start of the file.
+ *                       header - The header of the file. The string pool must
+ *                                have been checked.
+ *                       string - The offset of a string in the pool.
+ *                       max_len - The longest the string may be.
+ *
+ * Returns: True if the string is in the pool and short enough.
+ */
+bool binary_string_ok(const char *data,
+                      AUTOMATON_BINARY_HEADER *header,
+                      unsigned int string,
+                      size_t max_len)
+{
+  return((string < header->strings_size) &&
+         (strlen(data + header->strings + string) <= max_len));
+}
+
+/*
+ * binary_target_ok
+ *
+ * INTERNAL: Parameters: header - The header of the file.
+ *                       binary_automatons - The automatons in the file.
+ *                       owner - The index of the automaton that owns the
+ *                               transition that the target is for.
+ *                       target - The target to check.
+ *
+ * Returns: True if every index in the target refers to something.
+ */
+bool binary_target_ok(AUTOMATON_BINARY_HEADER *header,
+                      AUTOMATON_BINARY_AUTOMATON *binary_automatons,
+                      int owner,
+                      AUTOMATON_BINARY_TARGET *target)
+{
+  if ((target->automaton < AUTOMATON_BINARY_NONE) ||
+      (target->automaton >= header->num_automatons))
+  {
+    return(false);
+  }
+  if (AUTOMATON_BINARY_NONE != target->automaton)
+  {
+    owner = target->automaton;
+  }
+
+  return((target->state >= AUTOMATON_BINARY_NONE) &&
+         (target->state < header->num_states) &&
+         (target->transition >= AUTOMATON_BINARY_NONE) &&
+         (target->transition < binary_automatons[owner].num_transitions));
+}
+
+/*
+ * check_automaton_binary_file
+ *
+ * INTERNAL: Checks that every offset and index in a mapped file is in range
+ * so that the set can be built from it without any further checks.
+ *
+ * Parameters: data - The start of the file.
+ *             size - The size of the file. At least the size of the header.
+ *
+ * Returns: True if the file is valid.
+ */
+bool check_automaton_binary_file(const char *data, size_t size)
+{
+  /*
+   * Local Variables.
+   */
+  AUTOMATON_BINARY_HEADER *header;
+  AUTOMATON_BINARY_AUTOMATON *binary_automatons;
+  AUTOMATON_BINARY_TRANSITION *binary_transitions;
+  unsigned int *names;
+  int *transition_table;
+  int num_cells;
+  int ii;
+  int jj;
+
+  header = (AUTOMATON_BINARY_HEADER *) data;
+  if ((AUTOMATON_BINARY_FILE_MAGIC != header->magic) ||
+      (AUTOMATON_BINARY_FILE_VERSION != header->version) ||
+      (size != header->file_size) ||
+      (header->num_automatons <= 0) ||
+      (header->start_automaton < 0) ||
+      (header->start_automaton >= header->num_automatons) ||
+      (header->num_states <= 0) ||
+      (header->num_events <= 0) ||
+      (header->num_states > INT_MAX / header->num_events) ||
+      (!binary_range_ok(size,
+                        header->state_names,
+                        header->num_states,
+                        sizeof(unsigned int))) ||
+      (!binary_range_ok(size,
+                        header->event_names,
+                        header->num_events,
+                        sizeof(unsigned int))) ||
+      (!binary_range_ok(size,
+                        header->automatons,
+                        header->num_automatons,
+                        sizeof(AUTOMATON_BINARY_AUTOMATON))) ||
+      (0 == header->strings_size) ||
+      (!binary_range_ok(size, header->strings, header->strings_size, 1)) ||
+      ('\0' != data[header->strings + header->strings_size - 1]))
+  {
+    return(false);
+  }
+
+  /*
+   * The pool ends in a NUL so every offset within it is a string.
+   */
+  names = (unsigned int *) (data + header->state_names);
+  for (ii = 0; ii < header->num_states; ii++)
+  {
+    if (names[ii] >= header->strings_size)
+    {
+      return(false);
+    }
+  }
+  names = (unsigned int *) (data + header->event_names);
+  for (ii = 0; ii < header->num_events; ii++)
+  {
+    if (names[ii] >= header->strings_size)
+    {
+      return(false);
+    }
+  }
+
+  /*
+   * The sizes of the transition arrays are needed to check the targets so
+   * check all the automatons first.
+   */
+  num_cells = header->num_states * header->num_events;
+  binary_automatons = (AUTOMATON_BINARY_AUTOMATON *)
+                                                 (data + header->automatons);
+  for (ii = 0; ii < header->num_automatons; ii++)
+  {
+    if ((!binary_string_ok(data,
+                           header,
+                           binary_automatons[ii].name,
+                           MAX_AUTOMATON_NAME_LEN)) ||
+        (!binary_string_ok(data,
+                           header,
+                           binary_automatons[ii].lua_filename,
+                           MAX_AUTOMATON_FILENAME_LEN)) ||
+        (binary_automatons[ii].start_state < 0) ||
+        (binary_automatons[ii].start_state >= header->num_states) ||
+        (binary_automatons[ii].num_transitions < 0) ||
+        (!binary_range_ok(size,
+                          binary_automatons[ii].transitions,
+                          binary_automatons[ii].num_transitions,
+                          sizeof(AUTOMATON_BINARY_TRANSITION))) ||
+        (!binary_range_ok(size,
+                          binary_automatons[ii].transition_table,
+                          num_cells,
+                          sizeof(int))) ||
+        (!binary_range_ok(size,
+                          binary_automatons[ii].lua_chunk,
+                          binary_automatons[ii].lua_chunk_size,
+                          1)))
+    {
+      return(false);
+    }
+  }
+
+  for (ii = 0; ii < header->num_automatons; ii++)
+  {
+    binary_transitions = (AUTOMATON_BINARY_TRANSITION *)
+                                     (data + binary_automatons[ii].transitions);
+    for (jj = 0; jj < binary_automatons[ii].num_transitions; jj++)
+    {
+      if ((!binary_string_ok(data,
+                             header,
+                             binary_transitions[jj].name,
+                             MAX_TRANSITION_NAME_LEN - 1)) ||
+          (!binary_string_ok(data,
+                             header,
+                             binary_transitions[jj].lua_function_name,
+                             MAX_LUA_FUNCTION_NAME_LEN - 1)) ||
+          (!binary_target_ok(header,
+                             binary_automatons,
+                             ii,
+                             &(binary_transitions[jj].true_target))) ||
+          (!binary_target_ok(header,
+                             binary_automatons,
+                             ii,
+                             &(binary_transitions[jj].false_target))))
+      {
+        return(false);
+      }
+    }
+
+    transition_table = (int *) (data + binary_automatons[ii].transition_table);
+    for (jj = 0; jj < num_cells; jj++)
+    {
+      if ((transition_table[jj] < AUTOMATON_BINARY_NONE) ||
+          (transition_table[jj] >= binary_automatons[ii].num_transitions))
+      {
+        return(false);
+      }
+    }
+  }
+
+  return(true);
+}
+
+/*
+ * binary_names_match
+ *
+ * INTERNAL: Checks that the states and events created by the code are the
+ * ones that the file was compiled against, as the file refers to them by
+ * index.
+ *
+ * Parameters: data - The start of the file. Must have been checked.
+ *             automaton - A newly created automaton.
+ *
+ * Returns: True if they match.
+ */
+bool binary_names_match(const char *data, AUTOMATON *automaton)
+{
+  /*
+   * Local Variables.
+   */
+  AUTOMATON_BINARY_HEADER *header;
+  const char *strings;
+  unsigned int *names;
+  int ii;
+
+  header = (AUTOMATON_BINARY_HEADER *) data;
+  strings = data + header->strings;
+  if ((automaton->num_states != header->num_states) ||
+      (automaton->num_events != header->num_events))
+  {
+    return(false);
+  }
+
+  names = (unsigned int *) (data + header->state_names);
+  for (ii = 0; ii < header->num_states; ii++)
+  {
+    if (0 != strcmp(automaton->states[ii]->name, strings + names[ii]))
+    {
+      return(false);
+    }
+  }
+  names = (unsigned int *) (data + header->event_names);
+  for (ii = 0; ii < header->num_events; ii++)
+  {
+    if (0 != strcmp(automaton->events[ii]->name, strings + names[ii]))
+    {
+      return(false);
+    }
+  }
+
+  return(true);
+}
+
+/*
+ * link_binary_target
+ *
+ * INTERNAL: Turns one result of a transition from indexes back into links.
+ *
+ * Parameters: automaton_set - The set being loaded. Every automaton must have
+ *                             its transitions created.
+ *             owner - The automaton that owns the transition.
+ *             target - The indexes. Must have been checked.
+ *             automaton, state, transition - Filled in with the links.
+ */
+void link_binary_target(AUTOMATON_SET *automaton_set,
+                        AUTOMATON *owner,
+                        AUTOMATON_BINARY_TARGET *target,
+                        AUTOMATON **automaton,
+                        AUTOMATON_STATE **state,
+                        AUTOMATON_TRANSITION **transition)
+{
+  *automaton = NULL;
+  if (AUTOMATON_BINARY_NONE != target->automaton)
+  {
+    *automaton = automaton_set->automaton_array[target->automaton];
+    owner = *automaton;
+  }
+  *state = (AUTOMATON_BINARY_NONE == target->state) ? NULL :
+                                                owner->states[target->state];
+  *transition = (AUTOMATON_BINARY_NONE == target->transition) ? NULL :
+                                      owner->transitions[target->transition];
+}
+
+/*
+ * load_automaton_set_binary_file
+ *
+ * Builds an automaton set from a file written by
+ * save_automaton_set_binary_file. The file is mapped in, checked, and each
+ * automaton is created and linked up from it without searching for anything
+ * by name. The mapping is released before returning.
+ *
+ * Parameters: filename - The file to load.
+ *             automaton_set - The set to fill in. Must be empty. On failure
+ *                             it may be partly filled in and should be
+ *                             destroyed.
+ *             state_callback - Callback to generate the states.
+ *             event_callback - Callback to generate the events.
+ *             match_state - Used to set up lua globals.
+ *
+ * Returns: One of the AUTOMATON_BINARY_FILE return codes.
+ */
+int load_automaton_set_binary_file(
+                                 char *filename,
+                                 AUTOMATON_SET *automaton_set,
+                                 int (*state_callback)(AUTOMATON_STATE ***,int),
+                                 int (*event_callback)(AUTOMATON_EVENT ***),
+                                 MATCH_STATE *match_state)
+{
+  /*
+   * Local Variables.
+   */
+  AUTOMATON_BINARY_HEADER *header;
+  AUTOMATON_BINARY_AUTOMATON *binary_automatons;
+  AUTOMATON_BINARY_TRANSITION *binary_transitions;
+  AUTOMATON *automaton;
+  AUTOMATON_TRANSITION *transition;
+  const char *data;
+  const char *strings;
+  int *transition_table;
+  void *mapped_data;
+  size_t mapped_size;
+  int ret_code = AUTOMATON_BINARY_FILE_OK;
+  int ii;
+  int jj;
+  int kk;
+
+  mapped_data = map_automaton_binary_file(filename, &mapped_size);
+  if (NULL == mapped_data)
+  {
+    DT_DEBUG_LOG("Could not map automaton file %s\n", filename);
+    return(AUTOMATON_BINARY_FILE_FILE_ERROR);
+  }
+
+  data = (const char *) mapped_data;
+  if (!check_automaton_binary_file(data, mapped_size))
+  {
+    DT_DEBUG_LOG("Automaton file %s is not a valid compiled set\n", filename);
+    ret_code = AUTOMATON_BINARY_FILE_BAD_FORMAT;
+    goto EXIT_LABEL;
+  }
+  header = (AUTOMATON_BINARY_HEADER *) data;
+  binary_automatons = (AUTOMATON_BINARY_AUTOMATON *)
+                                                 (data + header->automatons);
+  strings = data + header->strings;
+
+  /*
+   * Create every automaton with its transitions so that the links can refer
+   * to any of them.
+   */
+  automaton_set->num_automatons = header->num_automatons;
+  automaton_set->automaton_array = (AUTOMATON **)
+                     DT_MALLOC(sizeof(AUTOMATON *) * header->num_automatons);
+  memset(automaton_set->automaton_array,
+         '\0',
+         sizeof(AUTOMATON *) * header->num_automatons);
+  automaton_set->automaton_names = create_name_table(header->num_automatons);
+  for (ii = 0; ii < header->num_automatons; ii++)
+  {
+    automaton = create_automaton(state_callback, event_callback);
+    automaton_set->automaton_array[ii] = automaton;
+    if (NULL == automaton)
+    {
+      DT_DEBUG_LOG("Failed to create automaton %i for %s\n", ii, filename);
+      ret_code = AUTOMATON_BINARY_FILE_BAD_AUTOMATON;
+      goto EXIT_LABEL;
+    }
+    if (!binary_names_match(data, automaton))
+    {
+      DT_DEBUG_LOG("Automaton file %s was compiled against different states " \
+                   "or events and must be compiled again\n",
+                   filename);
+      ret_code = AUTOMATON_BINARY_FILE_MISMATCH;
+      goto EXIT_LABEL;
+    }
+
+    strcpy(automaton->name, strings + binary_automatons[ii].name);
+    strcpy(automaton->lua_filename,
+           strings + binary_automatons[ii].lua_filename);
+    if (!add_name_to_table(automaton_set->automaton_names, automaton->name, ii))
+    {
+      DT_DEBUG_LOG("Duplicate automaton name: %s\n", automaton->name);
+      ret_code = AUTOMATON_BINARY_FILE_BAD_FORMAT;
+      goto EXIT_LABEL;
+    }
+    automaton->start_state =
+                       automaton->states[binary_automatons[ii].start_state];
+
+    binary_transitions = (AUTOMATON_BINARY_TRANSITION *)
+                                     (data + binary_automatons[ii].transitions);
+    automaton->num_transitions = binary_automatons[ii].num_transitions;
+    automaton->transitions = (AUTOMATON_TRANSITION **)
+         DT_MALLOC(sizeof(AUTOMATON_TRANSITION *) * automaton->num_transitions);
+    for (jj = 0; jj < automaton->num_transitions; jj++)
+    {
+      transition = create_automaton_transition();
+      transition->id = jj;
+      strcpy(transition->name, strings + binary_transitions[jj].name);
+      strcpy(transition->lua_function_name,
+             strings + binary_transitions[jj].lua_function_name);
+      automaton->transitions[jj] = transition;
+    }
+    if (!index_automaton_transitions(automaton))
+    {
+      ret_code = AUTOMATON_BINARY_FILE_BAD_FORMAT;
+      goto EXIT_LABEL;
+    }
+  }
+
+  /*
+   * Then put the links in and load the lua.
+   */
+  for (ii = 0; ii < header->num_automatons; ii++)
+  {
+    automaton = automaton_set->automaton_array[ii];
+    binary_transitions = (AUTOMATON_BINARY_TRANSITION *)
+                                     (data + binary_automatons[ii].transitions);
+    for (jj = 0; jj < automaton->num_transitions; jj++)
+    {
+      transition = automaton->transitions[jj];
+      link_binary_target(automaton_set,
+                         automaton,
+                         &(binary_transitions[jj].true_target),
+                         &(transition->true_automaton),
+                         &(transition->true_state),
+                         &(transition->true_transition));
+      link_binary_target(automaton_set,
+                         automaton,
+                         &(binary_transitions[jj].false_target),
+                         &(transition->false_automaton),
+                         &(transition->false_state),
+                         &(transition->false_transition));
+    }
+
+    transition_table = (int *) (data + binary_automatons[ii].transition_table);
+    for (jj = 0; jj < automaton->num_states; jj++)
+    {
+      for (kk = 0; kk < automaton->num_events; kk++)
+      {
+        automaton->states[jj]->transitions[kk] =
+         (AUTOMATON_BINARY_NONE == transition_table[kk]) ? NULL :
+                                  automaton->transitions[transition_table[kk]];
+      }
+      transition_table += automaton->num_events;
+    }
+
+    if (!init_automaton_lua_chunk(automaton,
+                                  data + binary_automatons[ii].lua_chunk,
+                                  binary_automatons[ii].lua_chunk_size,
+                                  match_state))
+    {
+      DT_DEBUG_LOG("Could not load lua functions for automaton %s\n",
+                   automaton->name);
+      ret_code = AUTOMATON_BINARY_FILE_LUA_FAIL;
+      goto EXIT_LABEL;
+    }
+  }
+
+  automaton_set->start_automaton =
+                      automaton_set->automaton_array[header->start_automaton];
+
+EXIT_LABEL:
+
+  unmap_automaton_binary_file(mapped_data, mapped_size);
+
+  return(ret_code);
+}
@@ -0,0 +1,171 @@
+/*
+ * automaton_binary_file.h
+ *
+ * A compiled automaton set. Reading a set from its xml, csv and lua files
+ * means parsing all three, which is most of the time taken to start a match.
+ * The offline compiler (Tools/automaton_compiler) loads a set the slow way,
+ * which checks it, and writes it out as a single file with everything already
+ * resolved to indexes and the lua already compiled to bytecode. The game maps
+ * that file in and builds the set from it in one pass.
+ *
+ *  Created on: 16 Oct 2026
+ *      Author: David Tyler
+ */
+
+#ifndef AUTOMATON_BINARY_FILE_H_
+#define AUTOMATON_BINARY_FILE_H_
+
+#include <stdbool.h>
+
+struct automaton_event;
+struct automaton_set;
+struct automaton_state;
+struct match_state;
+
+/*
+ * Return codes for loading and saving a compiled automaton set.
+ *
+ * AUTOMATON_BINARY_FILE_OK - Function successful.
+ * AUTOMATON_BINARY_FILE_FILE_ERROR - The file couldn't be opened, mapped or
+ *                                    written.
+ * AUTOMATON_BINARY_FILE_BAD_FORMAT - The file isn't a valid compiled set.
+ * AUTOMATON_BINARY_FILE_MISMATCH - The set was compiled against different
+ *                                  states or events to the ones in the code
+ *                                  and must be compiled again.
+ * AUTOMATON_BINARY_FILE_LUA_FAIL - The lua couldn't be compiled or loaded.
+ * AUTOMATON_BINARY_FILE_BAD_SET - The set to save links to something that
+ *                                 isn't in the set.
+ * AUTOMATON_BINARY_FILE_BAD_AUTOMATON - An automaton couldn't be created as
+ *                                       its states or events are wrong (see
+ *                                       create_automaton).
+ */
+#define AUTOMATON_BINARY_FILE_OK          0
+#define AUTOMATON_BINARY_FILE_FILE_ERROR  1
+#define AUTOMATON_BINARY_FILE_BAD_FORMAT  2
+#define AUTOMATON_BINARY_FILE_MISMATCH    3
+#define AUTOMATON_BINARY_FILE_LUA_FAIL    4
+#define AUTOMATON_BINARY_FILE_BAD_SET     5
+#define AUTOMATON_BINARY_FILE_BAD_AUTOMATON 6
+
+/*
+ * Identifies a compiled automaton set file ("AUTB" when read as bytes on a
+ * little endian machine) and the version of the layout below.
+ */
+#define AUTOMATON_BINARY_FILE_MAGIC 0x42545541
+#define AUTOMATON_BINARY_FILE_VERSION 1
+
+/*
+ * Used for an index in the file that doesn't refer to anything.
+ */
+#define AUTOMATON_BINARY_NONE -1
+
+/*
+ * AUTOMATON_BINARY_HEADER
+ *
+ * The start of a compiled automaton set file. Every offset is a number of
+ * bytes from the start of the file and every string is an offset into the
+ * string pool, in which each name appears once however many times it is used.
+ *
+ * The file is written in the byte order of the machine that compiled it, and
+ * the lua bytecode is only valid for the same build of lua. Either being
+ * wrong fails the load.
+ *
+ * magic - AUTOMATON_BINARY_FILE_MAGIC.
+ * version - AUTOMATON_BINARY_FILE_VERSION.
+ * file_size - The size of the whole file.
+ * num_automatons - The number of AUTOMATON_BINARY_AUTOMATONs.
+ * start_automaton - The index of the automaton that the set starts in.
+ * num_states - The number of states in every automaton.
+ * num_events - The number of events in every automaton.
+ * state_names - num_states strings, the names of the states that the set was
+ *               compiled against in id order.
+ * event_names - num_events strings, as state_names.
+ * automatons - The array of AUTOMATON_BINARY_AUTOMATONs.
+ * strings - The string pool.
+ * strings_size - The size of the string pool. It ends in a NUL.
+ */
+typedef struct automaton_binary_header
+{
+  unsigned int magic;
+  unsigned int version;
+  unsigned int file_size;
+  int num_automatons;
+  int start_automaton;
+  int num_states;
+  int num_events;
+  unsigned int state_names;
+  unsigned int event_names;
+  unsigned int automatons;
+  unsigned int strings;
+  unsigned int strings_size;
+} AUTOMATON_BINARY_HEADER;
+
+/*
+ * AUTOMATON_BINARY_AUTOMATON
+ *
+ * name - String. The name of the automaton.
+ * lua_filename - String. The lua file that the bytecode was compiled from.
+ * start_state - The index of the start state.
+ * num_transitions - The number of AUTOMATON_BINARY_TRANSITIONs.
+ * transitions - Offset of the array of AUTOMATON_BINARY_TRANSITIONs.
+ * transition_table - Offset of num_states * num_events ints. The transition
+ *                    taken by state ii on event jj is at
+ *                    ii * num_events + jj, AUTOMATON_BINARY_NONE if none.
+ * lua_chunk - Offset of the lua bytecode.
+ * lua_chunk_size - The size of the lua bytecode.
+ */
+typedef struct automaton_binary_automaton
+{
+  unsigned int name;
+  unsigned int lua_filename;
+  int start_state;
+  int num_transitions;
+  unsigned int transitions;
+  unsigned int transition_table;
+  unsigned int lua_chunk;
+  unsigned int lua_chunk_size;
+} AUTOMATON_BINARY_AUTOMATON;
+
+/*
+ * AUTOMATON_BINARY_TARGET
+ *
+ * Where a transition goes for one result of its lua function. Any of these
+ * can be AUTOMATON_BINARY_NONE.
+ *
+ * automaton - The index of the automaton to move to.
+ * state - The index of the state to move to in that automaton, or in the
+ *         automaton that owns the transition if there is no automaton.
+ * transition - As state but the index of the transition to call next.
+ */
+typedef struct automaton_binary_target
+{
+  int automaton;
+  int state;
+  int transition;
+} AUTOMATON_BINARY_TARGET;
+
+/*
+ * AUTOMATON_BINARY_TRANSITION
+ *
+ * name - String. The name of the transition.
+ * lua_function_name - String. The name of the transition's lua function.
+ * true_target - Where to go when the function returns true.
+ * false_target - Where to go when the function returns false.
+ */
+typedef struct automaton_binary_transition
+{
+  unsigned int name;
+  unsigned int lua_function_name;
+  AUTOMATON_BINARY_TARGET true_target;
+  AUTOMATON_BINARY_TARGET false_target;
+} AUTOMATON_BINARY_TRANSITION;
+
+bool is_automaton_binary_file(char *);
+int save_automaton_set_binary_file(struct automaton_set *, char *);
+int load_automaton_set_binary_file(char *,
+                                   struct automaton_set *,
+                                   int(*)(struct automaton_state ***, int),
+                                   int(*)(struct automaton_event ***),
+                                   struct match_state *);
+
+#endif /* AUTOMATON_BINARY_FILE_H_ */
@@ -28,6 +28,7 @@
 #include "../data_structures/automaton.h"
 #include "../data_structures/automaton_state.h"
 #include "../data_structures/automaton_event.h"
+#include "../../data_structures/name_table.h"
 #include "../data_structures/automaton_transition.h"
 #include "../../automaton_handler.h"
 #include "automaton_transition_file_loader.h"
@@ -340,8 +341,11 @@ EXIT_LABEL:
  *                              each of the automatons.
  *             event_callback - Callback function to generate the events for
  *                              each of the automatons.
+ *
+ * Returns: false if any of the automatons couldn't be created, true
+ *          otherwise.
  */
-void create_automatons_from_xml(ezxml_t *xml_file, 
+bool create_automatons_from_xml(ezxml_t *xml_file, 
                                 AUTOMATON_SET *automaton_set,
                                 int (*state_callback)(AUTOMATON_STATE ***,int),
                                 int (*event_callback)(AUTOMATON_EVENT ***))
@@ -371,6 +375,9 @@ void create_automatons_from_xml(ezxml_t *xml_file,
    */
   automaton_set->automaton_array =
                 (AUTOMATON **) DT_MALLOC(sizeof(AUTOMATON *) * num_automatons);
+  memset(automaton_set->automaton_array,
+         '\0',
+         sizeof(AUTOMATON *) * num_automatons);
 
   /*
    * Create each of the automatons individually.
@@ -385,8 +392,14 @@ void create_automatons_from_xml(ezxml_t *xml_file,
      */
     automaton_set->automaton_array[ii] = create_automaton(state_callback,
                                                           event_callback);
+    if (NULL == automaton_set->automaton_array[ii])
+    {
+      return(false);
+    }
     ii++;
   }
+
+  return(true);
 }
 
 /*
@@ -471,6 +484,15 @@ int parse_transition_names(ezxml_t *xml_automaton, AUTOMATON *automaton)
     ii++;
   }
 
+  /*
+   * Index the transitions by name so that they can refer to each other when
+   * the links are filled in.
+   */
+  if (!index_automaton_transitions(automaton))
+  {
+    ret_code = AUTOMATON_XML_FILE_LINKS_FAIL;
+  }
+
 EXIT_LABEL:
 
   return ret_code;
@@ -538,6 +560,24 @@ int parse_automaton_names(ezxml_t *xml_file, AUTOMATON_SET *automaton_set)
     ii++;
   }
 
+  /*
+   * Index the automatons by name so that the transitions can refer to them.
+   */
+  automaton_set->automaton_names =
+                            create_name_table(automaton_set->num_automatons);
+  for (ii = 0; ii < automaton_set->num_automatons; ii++)
+  {
+    if (!add_name_to_table(automaton_set->automaton_names,
+                           automaton_set->automaton_array[ii]->name,
+                           ii))
+    {
+      DT_DEBUG_LOG("Duplicate automaton name (%s) in xml file.\n",
+                   automaton_set->automaton_array[ii]->name);
+      ret_code = AUTOMATON_XML_FILE_LINKS_FAIL;
+      goto EXIT_LABEL;
+    }
+  }
+
 EXIT_LABEL:
 
   return ret_code;
@@ -594,10 +634,15 @@ int parse_automaton_set_xml_file(char *filename,
    * This allocates the memory required for the automaton array and creates 
    * the automaton structures. It does not fill in any information.
    */
-  create_automatons_from_xml(&xml_file, 
-                             automaton_set, 
-                             state_callback, 
-                             event_callback);
+  if (!create_automatons_from_xml(&xml_file,
+                                  automaton_set,
+                                  state_callback,
+                                  event_callback))
+  {
+    DT_DEBUG_LOG("Failed to create the automatons in %s\n", filename);
+    ret_code = AUTOMATON_XML_FILE_BAD_AUTOMATON;
+    goto EXIT_LABEL;
+  }
 
   /*
    * Fill in the names of the automatons and transitions from the file. This
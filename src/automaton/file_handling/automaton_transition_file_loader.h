@@ -62,11 +62,15 @@ struct automaton_set;
  *                                 automatons.
  * AUTOMATON_XML_FILE_START_AUTOMATON_BAD - The automaton set does not have a
  *                                          starting automaton.
+ * AUTOMATON_XML_FILE_BAD_AUTOMATON - An automaton couldn't be created as its
+ *                                    states or events are wrong (see
+ *                                    create_automaton).
  */
 #define AUTOMATON_XML_FILE_OK                  0
 #define AUTOMATON_XML_FILE_LOAD_FAIL           1
 #define AUTOMATON_XML_FILE_LINKS_FAIL          2
 #define AUTOMATON_XML_FILE_START_AUTOMATON_BAD 3
+#define AUTOMATON_XML_FILE_BAD_AUTOMATON       4
 
 int parse_single_automaton(ezxml_t,
                            struct automaton *,
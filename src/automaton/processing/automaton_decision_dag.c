@@ -0,0 +1,194 @@
+/*
+ * automaton_decision_dag.c
+ *
+ *  Created on: 16 Oct 2026
+ *      Author: David Tyler
+ */
+#include "../../dt_logger.h"
+
+#include <string.h>
+
+#include "automaton_decision_dag.h"
+#include "../data_structures/automaton.h"
+#include "../data_structures/automaton_state.h"
+#include "../data_structures/automaton_transition.h"
+#include "../../automaton_handler.h"
+
+/*
+ * Marks used while searching the nodes for loops.
+ */
+#define DECISION_NODE_UNVISITED 0
+#define DECISION_NODE_ON_PATH   1
+#define DECISION_NODE_DONE      2
+
+/*
+ * fill_decision_branch
+ *
+ * INTERNAL: Fills in one branch of a node from the links of its transition.
+ * As when the transition was followed directly, a state takes precedence
+ * over a transition.
+ *
+ * Parameters: owner - The automaton that owns the transition.
+ *             automaton, state, transition - The links for the result. Any
+ *                                            can be NULL.
+ *             branch - The branch to fill in.
+ */
+void fill_decision_branch(AUTOMATON *owner,
+                          AUTOMATON *automaton,
+                          AUTOMATON_STATE *state,
+                          AUTOMATON_TRANSITION *transition,
+                          AUTOMATON_DECISION_BRANCH *branch)
+{
+  branch->automaton = (NULL == automaton) ? owner : automaton;
+  branch->state = state;
+  branch->next = NULL;
+  if ((NULL == state) && (NULL != transition))
+  {
+    branch->next = &(branch->automaton->decision_nodes[transition->id]);
+  }
+}
+
+/*
+ * find_decision_loop
+ *
+ * INTERNAL: Depth first search from a node that fails if it comes back to a
+ * node on the current path. Nodes already searched are skipped so every node
+ * is searched once however many chains lead to it.
+ *
+ * The depth of the recursion is at most the number of nodes. This is only
+ * done at load.
+ *
+ * Parameters: nodes - The first node of the set.
+ *             marks - One of the DECISION_NODE marks for each node.
+ *             node - The node to search from.
+ *
+ * Returns: The transition of a node in a loop or NULL if there is none.
+ */
+AUTOMATON_TRANSITION *find_decision_loop(AUTOMATON_DECISION_NODE *nodes,
+                                         int *marks,
+                                         AUTOMATON_DECISION_NODE *node)
+{
+  /*
+   * Local Variables.
+   */
+  AUTOMATON_TRANSITION *loop = NULL;
+  AUTOMATON_DECISION_NODE *next;
+  int index = (int) (node - nodes);
+  int ii;
+
+  if (DECISION_NODE_ON_PATH == marks[index])
+  {
+    return(node->transition);
+  }
+  if (DECISION_NODE_DONE == marks[index])
+  {
+    return(NULL);
+  }
+
+  marks[index] = DECISION_NODE_ON_PATH;
+  for (ii = 0; (ii < 2) && (NULL == loop); ii++)
+  {
+    next = node->branches[ii].next;
+    if (NULL != next)
+    {
+      loop = find_decision_loop(nodes, marks, next);
+    }
+  }
+  marks[index] = DECISION_NODE_DONE;
+
+  return(loop);
+}
+
+/*
+ * build_automaton_decision_dag
+ *
+ * Creates the decision node of every transition in a set and checks that no
+ * chain of transitions leads back to itself. The nodes are held in one array
+ * owned by the set, and each automaton points to its own nodes.
+ *
+ * Parameters: automaton_set - A set with all its links and lua functions
+ *                             set up.
+ *
+ * Returns: False if there is a loop. The nodes are still created and are
+ *          freed with the set.
+ */
+bool build_automaton_decision_dag(AUTOMATON_SET *automaton_set)
+{
+  /*
+   * Local Variables.
+   */
+  AUTOMATON *automaton;
+  AUTOMATON_TRANSITION *transition;
+  AUTOMATON_TRANSITION *loop = NULL;
+  AUTOMATON_DECISION_NODE *node;
+  int *marks;
+  int num_nodes;
+  int ii;
+  int jj;
+
+  /*
+   * Share out the array between the automatons first so that a branch can
+   * point at a node in any of them.
+   */
+  num_nodes = 0;
+  for (ii = 0; ii < automaton_set->num_automatons; ii++)
+  {
+    num_nodes += automaton_set->automaton_array[ii]->num_transitions;
+  }
+  automaton_set->num_decision_nodes = num_nodes;
+  automaton_set->decision_nodes = (AUTOMATON_DECISION_NODE *)
+                         DT_MALLOC(sizeof(AUTOMATON_DECISION_NODE) * num_nodes);
+  num_nodes = 0;
+  for (ii = 0; ii < automaton_set->num_automatons; ii++)
+  {
+    automaton = automaton_set->automaton_array[ii];
+    automaton->decision_nodes = automaton_set->decision_nodes + num_nodes;
+    num_nodes += automaton->num_transitions;
+  }
+
+  for (ii = 0; ii < automaton_set->num_automatons; ii++)
+  {
+    automaton = automaton_set->automaton_array[ii];
+    for (jj = 0; jj < automaton->num_transitions; jj++)
+    {
+      transition = automaton->transitions[jj];
+      node = &(automaton->decision_nodes[jj]);
+      node->lua_state = automaton->lua_state;
+      node->lua_function_ref = transition->lua_function_ref;
+      node->transition = transition;
+      fill_decision_branch(automaton,
+                           transition->false_automaton,
+                           transition->false_state,
+                           transition->false_transition,
+                           &(node->branches[AUTOMATON_DECISION_FALSE]));
+      fill_decision_branch(automaton,
+                           transition->true_automaton,
+                           transition->true_state,
+                           transition->true_transition,
+                           &(node->branches[AUTOMATON_DECISION_TRUE]));
+    }
+  }
+
+  /*
+   * A loop would have the player calling lua functions forever so it is
+   * treated as a broken automaton.
+   */
+  marks = (int *) DT_MALLOC(sizeof(int) * (num_nodes + 1));
+  memset(marks, '\0', sizeof(int) * (num_nodes + 1));
+  for (ii = 0; (ii < num_nodes) && (NULL == loop); ii++)
+  {
+    loop = find_decision_loop(automaton_set->decision_nodes,
+                              marks,
+                              &(automaton_set->decision_nodes[ii]));
+  }
+  DT_FREE(marks);
+
+  if (NULL != loop)
+  {
+    DT_DEBUG_LOG("Transition (%s) is part of a loop of transitions\n",
+                 loop->name);
+    return(false);
+  }
+
+  return(true);
+}
@@ -0,0 +1,74 @@
+/*
+ * automaton_decision_dag.h
+ *
+ * A transition can lead straight on to another transition, possibly in
+ * another automaton, so handling an event can take a chain of lua calls
+ * before the new state is known. The chains of every automaton in a set are
+ * flattened into one array of decision nodes when the set is loaded, and
+ * checked for loops then, so that an event is handled by walking the nodes
+ * in a loop.
+ *
+ *  Created on: 16 Oct 2026
+ *      Author: David Tyler
+ */
+
+#ifndef AUTOMATON_DECISION_DAG_H_
+#define AUTOMATON_DECISION_DAG_H_
+
+#include <stdbool.h>
+#include "lua5.1/lua.h"
+
+struct automaton;
+struct automaton_set;
+struct automaton_state;
+struct automaton_transition;
+
+/*
+ * Index of the branch taken for each result of a node's lua function.
+ */
+#define AUTOMATON_DECISION_FALSE 0
+#define AUTOMATON_DECISION_TRUE  1
+
+/*
+ * AUTOMATON_DECISION_BRANCH
+ *
+ * One result of a decision node.
+ *
+ * automaton - The automaton that the player is in after this branch. Never
+ *             NULL, it is the automaton of the node if the transition doesn't
+ *             move to another one.
+ * state - The state to move to. If this is NULL and there is no next node
+ *         then the player moves to the state in automaton with the same id
+ *         as the state that they were in.
+ * next - The node to evaluate next, in automaton. NULL if the branch ends
+ *        the decision. Never set if state is.
+ */
+typedef struct automaton_decision_branch
+{
+  struct automaton *automaton;
+  struct automaton_state *state;
+  struct automaton_decision_node *next;
+} AUTOMATON_DECISION_BRANCH;
+
+/*
+ * AUTOMATON_DECISION_NODE
+ *
+ * A transition ready to be evaluated, with everything needed to call its lua
+ * function and follow the result held in the node.
+ *
+ * lua_state - The lua state of the automaton that owns the transition.
+ * lua_function_ref - The transition's function in that lua state's registry.
+ * transition - The transition. Only used for logging failures.
+ * branches - Indexed by AUTOMATON_DECISION_FALSE/TRUE.
+ */
+typedef struct automaton_decision_node
+{
+  lua_State *lua_state;
+  int lua_function_ref;
+  struct automaton_transition *transition;
+  AUTOMATON_DECISION_BRANCH branches[2];
+} AUTOMATON_DECISION_NODE;
+
+bool build_automaton_decision_dag(struct automaton_set *);
+
+#endif /* AUTOMATON_DECISION_DAG_H_ */
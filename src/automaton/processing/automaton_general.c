@@ -11,248 +11,89 @@
 #include "../data_structures/automaton_event.h"
 #include "../data_structures/automaton_state.h"
 #include "../data_structures/automaton_transition.h"
+#include "automaton_decision_dag.h"
 #include "../../player.h"
 
 /*
- * get_state_from_transition
+ * evaluate_decision_nodes
  *
- * Takes a transition and works out what state it should move to. This is a
- * recursive function and could easily get itself into an infinite loop if the
- * person writing the automaton is an idiot so we add in some extra error
- * checking code.
+ * Works out which state an event's transition leads to by walking its
+ * decision nodes (see automaton_decision_dag.h). Each node's lua function
+ * says which branch to take and the walk ends at the first branch without a
+ * next node. Loops were ruled out when the set was loaded so this always
+ * ends.
  *
- * The idea is that we are happy to bail on the program rather than overflow
- * the stack.
+ * The player only moves to another automaton once the whole decision has
+ * been made, so a failure part way leaves them where they were.
  *
- * Parameters: automaton - Used to give us access to the lua state.
- *             transition - The current transition.
- *             call_depth - The number of recursions. Forced to be lower than
- *                          some fixed number.
- *             player - The player to whom this event happened.
- * 
- * Returns: The state to move to OR null if the function failed.
+ * Parameters: node - The node of the event's transition.
+ *             curr_state - The state that the player is in.
+ *             player - The player to whom the event happened.
+ *
+ * Returns: The state to move to OR null if a lua function failed.
  */
-AUTOMATON_STATE *get_state_from_transition(AUTOMATON *automaton,
-                                           AUTOMATON_TRANSITION *transition,
-                                           int *call_depth,
-                                           PLAYER *player)
+AUTOMATON_STATE *evaluate_decision_nodes(AUTOMATON_DECISION_NODE *node,
+                                         AUTOMATON_STATE *curr_state,
+                                         PLAYER *player)
 {
   /*
    * Local Variables.
    */
-  AUTOMATON_STATE *new_state = NULL;
-  AUTOMATON *new_automaton = automaton;
+  AUTOMATON_DECISION_BRANCH *branch;
+  lua_State *lua_state;
   int rc;
 
-  DT_AI_LOG("(%i:%i) Finding next state/transition/automaton from transition %s\n",
-            player->team_id,
-            player->player_id,
-            transition->name);
-  
-  /*
-   * To avoid splatting the stack by the user defining an automaton with loops
-   * we bail out gracefully if the call depth is greater than MAX_CALL_DEPTH.
-   */
-  if (MAX_CALL_DEPTH <= *call_depth)
-  {
-    DT_AI_LOG("(%i:%i) Failed to find next state from transition due to exceeding " \
-              "maximum call depth: Suspected loop in automaton\n",
-              player->team_id,
-              player->player_id);
-    return(NULL);
-  }
-
-  /*
-   * NOTE: If we hit an exception of any sort whilst processing the lua
-   * function or attempting to move to the next state then we simply log it
-   * and remain at the current state.
-   */
-  lua_getglobal(automaton->lua_state, transition->lua_function_name);
-
-  /*
-   * Put any parameters the lua function expects onto the stack.
-   */
-  lua_pushinteger(automaton->lua_state, player->team_id);
-  lua_pushinteger(automaton->lua_state, player->player_id);
-
-  /*
-   * Call the lua function with the hard coded number of arguments as pushed
-   * onto the stack above.
-   */
-  rc = lua_pcall(automaton->lua_state, 2, 1, 0);
-  if (0 != rc)
-  {
-    DT_AI_LOG("(%i:%i) Lua function (%s) failed with message: %s\n",
-              player->team_id,
-              player->player_id,
-              transition->lua_function_name,
-              lua_tostring(automaton->lua_state, -1));
-    new_state = NULL;
-  }
-  else
+  do
   {
     /*
-     * The return value is either 0 (false) or 1 (true).
+     * Call the node's function with the player. The function was looked up
+     * when the automaton was loaded.
      */
-    if (lua_isnumber(automaton->lua_state, -1))
-    {
-      rc = (int) lua_tointeger(automaton->lua_state, -1);
-      lua_pop(automaton->lua_state, 1);
-      DT_AI_LOG("(%i:%i) Lua function %s returned %i\n", 
-                player->team_id,
-                player->player_id,
-                transition->lua_function_name,
-                rc);
-    }
-    else
+    lua_state = node->lua_state;
+    lua_rawgeti(lua_state, LUA_REGISTRYINDEX, node->lua_function_ref);
+    lua_pushinteger(lua_state, player->team_id);
+    lua_pushinteger(lua_state, player->player_id);
+    rc = lua_pcall(lua_state, 2, 1, 0);
+    if (0 != rc)
     {
-      DT_AI_LOG("(%i:%i) Lua failure: Return value from %s was not a number.\n",
+      DT_AI_LOG("(%i:%i) Lua function (%s) failed with message: %s\n",
                 player->team_id,
                 player->player_id,
-                transition->lua_function_name);
-      new_state = NULL;
-      goto EXIT_LABEL;
+                node->transition->lua_function_name,
+                lua_tostring(lua_state, -1));
+      lua_pop(lua_state, 1);
+      return(NULL);
     }
 
     /*
-     * If the return value is 1 then we move to the true state in the
-     * transition. If 0 then to the false state instead.
+     * The return value is either 0 (false) or 1 (true).
      */
-    if (0 == rc)
+    if (!lua_isnumber(lua_state, -1))
     {
-      /*
-       * If there is a new automaton to move into then do that first. This 
-       * means that any selection of states is then done on the new automaton.
-       */
-      if (NULL != transition->false_automaton)
-      {
-        DT_AI_LOG("(%i:%i) Moving to new automaton (%s)\n",
-                  player->team_id, 
-                  player->player_id,
-                  transition->false_automaton->name);
-        player->automaton = transition->false_automaton;
-        new_automaton = transition->false_automaton;
-      }
-
-      /*
-       * States take precedence over transitions so if there is a state we
-       * move to that. Otherwise we move to the transition.
-       */   
-      if (NULL == transition->false_state &&
-          NULL == transition->false_transition)
-      {
-        /*
-         * If there is no transition or state to move to but there is 
-         * an automaton then we assume that the player is moving to 
-         * the current state in the new automaton.
-         */
-        new_state = find_automaton_state_by_name(
-                                                new_automaton,
-                                                player->automaton_state->name);
-      }
-      else if (NULL == transition->false_state &&
-               NULL != transition->false_transition)
-      {
-        /*
-         * There is a transition to process for this transition. It may be on
-         * a new automaton but doesn't require it.
-         */
-        DT_AI_LOG("(%i:%i) Moving from transition %s to false transition %s\n", 
-                  player->team_id, 
-                  player->player_id,
-                  transition->name,
-                  transition->false_transition->name);
-        transition = transition->false_transition;
-        (*call_depth)++;
-        new_state = get_state_from_transition(new_automaton, 
-                                              transition, 
-                                              call_depth,
-                                              player);
-      }
-      else if (NULL != transition->false_state)
-      {
-        /*
-         * There is a state to move to. This can include a new automaton
-         * but doesn't require it.
-         */
-        new_state = transition->false_state;
-        DT_AI_LOG("(%i:%i) Moving to false state %s\n", 
-                  player->team_id, 
-                  player->player_id,
-                  new_state->name);
-      }
+      DT_AI_LOG("(%i:%i) Lua failure: Return value from %s was not a " \
+                "number.\n",
+                player->team_id,
+                player->player_id,
+                node->transition->lua_function_name);
+      lua_pop(lua_state, 1);
+      return(NULL);
     }
-    else
-    {
-      /*
-       * If there is a new automaton to move into then do that first. This 
-       * means that any selection of states is then done on the new automaton.
-       */
-      if (NULL != transition->true_automaton)
-      {
-        DT_AI_LOG("(%i:%i) Moving to new automaton (%s)\n",
-                  player->team_id, 
-                  player->player_id,
-                  transition->true_automaton->name);
-        player->automaton = transition->true_automaton;
-        new_automaton = transition->true_automaton;
-      }
+    rc = (int) lua_tointeger(lua_state, -1);
+    lua_pop(lua_state, 1);
 
-      /*
-       * States take precedence over transitions so if there is a state we
-       * move to that. Otherwise we move to the transition.
-       */   
-      if (NULL == transition->true_state &&
-          NULL == transition->true_transition)
-      {
-        /*
-         * If there is no transition or state to move to but there is 
-         * an automaton then we assume that the player is moving to 
-         * the current state in the new automaton.
-         */
-        new_state = find_automaton_state_by_name(
-                                                new_automaton,
-                                                player->automaton_state->name);
-      }
-      else if (NULL == transition->true_state &&
-               NULL != transition->true_transition)
-      {
-        /*
-         * There is a transition to process for this transition. It may be on
-         * a new automaton but doesn't require it.
-         */
-        DT_AI_LOG("(%i:%i) Moving from transition %s to true transition %s\n", 
-                  player->team_id, 
-                  player->player_id,
-                  transition->name,
-                  transition->true_transition->name);
-        transition = transition->true_transition;
-        (*call_depth)++;
-        new_state = get_state_from_transition(new_automaton, 
-                                              transition, 
-                                              call_depth,
-                                              player);
-      }
-      else if (NULL != transition->true_state)
-      {
-        /*
-         * There is a state to move to. This can include a new automaton
-         * but doesn't require it.
-         */
-        new_state = transition->true_state;
-        DT_AI_LOG("(%i:%i) Moving to true state %s\n", 
-                  player->team_id, 
-                  player->player_id,
-                  new_state->name);
-      }
-    }
-  }
-  
-EXIT_LABEL:
+    branch = &(node->branches[(0 == rc) ? AUTOMATON_DECISION_FALSE :
+                                          AUTOMATON_DECISION_TRUE]);
+    node = branch->next;
+  } while (NULL != node);
 
-  (*call_depth)--;
+  player->automaton = branch->automaton;
 
-  return(new_state);
+  /*
+   * A branch that only moves to another automaton keeps the player in the
+   * same state there.
+   */
+  return((NULL == branch->state) ? branch->automaton->states[curr_state->id] :
+                                   branch->state);
 }
 
 /*
@@ -264,7 +105,8 @@ EXIT_LABEL:
  * If there is no transition function then do not move anywhere.
  *
  * If one exists then call it. If it returns 0 then move to the false state
- * otherwise move to the true state.
+ * otherwise move to the true state, following on through any transitions
+ * that lead to other transitions.
  *
  * Any errors cause the object to remain at the current state.
  *
@@ -287,7 +129,6 @@ AUTOMATON_STATE *move_to_next_state(AUTOMATON_EVENT *event,
    */
   AUTOMATON_STATE *new_state;
   AUTOMATON_TRANSITION *transition;
-  int call_depth = 0;
 
   /*
    * Retrieve the transition from the array in the state. Recall that this is
@@ -320,10 +161,10 @@ AUTOMATON_STATE *move_to_next_state(AUTOMATON_EVENT *event,
     /*
      * Retrieve the next state. This can be null on failure.
      */
-    new_state = get_state_from_transition(automaton,
-                                          transition,
-                                          &call_depth,
-                                          player);
+    new_state = evaluate_decision_nodes(
+                                &(automaton->decision_nodes[transition->id]),
+                                curr_state,
+                                player);
     if (NULL == new_state)
     {
       DT_AI_LOG("(%i:%i) Staying at current state in automaton due to ill defined " \
@@ -13,13 +13,6 @@ struct automaton_state;
 struct automaton;
 struct player;
 
-/*
- * The maximum number of successive calls to transitions that the automaton
- * allows. This must be set to something small in order that we don't splat the
- * stack with an ill defined automaton.
- */
-#define MAX_CALL_DEPTH 5
-
 struct automaton_state *move_to_next_state(struct automaton_event *,
                                            struct automaton_state *,
                                            struct automaton *,
@@ -12,7 +12,10 @@
 #include "automaton/data_structures/automaton_state.h"
 #include "automaton/data_structures/automaton_event.h"
 #include "automaton/data_structures/automaton_timed_event_queue.h"
+#include "automaton/file_handling/automaton_binary_file.h"
 #include "automaton/file_handling/automaton_transition_file_loader.h"
+#include "automaton/processing/automaton_decision_dag.h"
+#include "data_structures/name_table.h"
 #include "match_state.h"
 
 /*
@@ -21,7 +24,11 @@
  * Creates the entire of the automaton structure including filling in the
  * starting automaton for the set.
  *
- * Parameters: xml_filename - The xml file describing the transition matrix.
+ * The file can either be the xml file for the set or the set compiled by
+ * Tools/automaton_compiler, which is much quicker to load.
+ *
+ * Parameters: xml_filename - The xml file describing the transition matrix,
+ *                            or the compiled set.
  *             state_callback - Callback used to create the automaton states.
  *             event_callback - Callback used to create the automaton events.
  *             match_state - The match state object gives access to the lua
@@ -46,19 +53,64 @@ AUTOMATON_SET *create_automaton_set(
    * Allocate the memory required for this object.
    */
   automaton_set = (AUTOMATON_SET *) DT_MALLOC(sizeof(AUTOMATON_SET));
+  automaton_set->automaton_array = NULL;
+  automaton_set->num_automatons = 0;
+  automaton_set->start_automaton = NULL;
+  automaton_set->automaton_names = NULL;
+  automaton_set->decision_nodes = NULL;
+  automaton_set->num_decision_nodes = 0;
+
+  /*
+   * A compiled set has already been checked so is built directly from the
+   * file.
+   */
+  if (is_automaton_binary_file(xml_filename))
+  {
+    rc = load_automaton_set_binary_file(xml_filename,
+                                        automaton_set,
+                                        state_callback,
+                                        event_callback,
+                                        match_state);
+    if (AUTOMATON_BINARY_FILE_OK != rc)
+    {
+      DT_DEBUG_LOG("Failed to load compiled automaton file %s (%i).\n",
+                   xml_filename,
+                   rc);
+      destroy_automaton_set(automaton_set);
+      automaton_set = NULL;
+      goto EXIT_LABEL;
+    }
+  }
+  else
+  {
+    /*
+     * Parse the file into the automaton set. If this fails for any reason
+     * then log an appropriate error and return NULL. No point letting it
+     * continue.
+     */
+    rc = parse_automaton_set_xml_file(xml_filename,
+                                      automaton_set,
+                                      state_callback,
+                                      event_callback,
+                                      match_state);
+    if (AUTOMATON_XML_FILE_OK != rc)
+    {
+      DT_DEBUG_LOG("Failed to parse xml automaton file %s into automaton " \
+                   "set.\n",
+                   xml_filename);
+      destroy_automaton_set(automaton_set);
+      automaton_set = NULL;
+      goto EXIT_LABEL;
+    }
+  }
 
   /*
-   * Parse the file into the automaton set. If this fails for any reason then
-   * log an appropriate error and return NULL. No point letting it continue.
+   * Flatten the chains of transitions so that events can be handled without
+   * following the links, checking that none of them loops.
    */
-  rc = parse_automaton_set_xml_file(xml_filename,
-                                    automaton_set,
-                                    state_callback,
-                                    event_callback,
-                                    match_state);
-  if (AUTOMATON_XML_FILE_OK != rc)
+  if (!build_automaton_decision_dag(automaton_set))
   {
-    DT_DEBUG_LOG("Failed to parse xml automaton file %s into automaton set.\n",
+    DT_DEBUG_LOG("Automaton file %s has a loop of transitions.\n",
                  xml_filename);
     destroy_automaton_set(automaton_set);
     automaton_set = NULL;
@@ -95,7 +147,18 @@ void destroy_automaton_set(AUTOMATON_SET *automaton_set)
       destroy_automaton(automaton_set->automaton_array[ii]);
     }
   }
-  DT_FREE(automaton_set->automaton_array);
+  if (NULL != automaton_set->automaton_array)
+  {
+    DT_FREE(automaton_set->automaton_array);
+  }
+  if (NULL != automaton_set->automaton_names)
+  {
+    destroy_name_table(automaton_set->automaton_names);
+  }
+  if (NULL != automaton_set->decision_nodes)
+  {
+    DT_FREE(automaton_set->decision_nodes);
+  }
 
   /*
    * Free the object.
@@ -199,11 +262,9 @@ void destroy_automaton_handler(AUTOMATON_HANDLER *automaton_handler)
 /*
  * get_automaton_by_name
  *
- * Retrieve an automaton by name from it's set. This uses a naive string name
- * search on the automaton array which would be grossly inefficient if there
- * were many hundreds of automatons. There aren't so it isn't.
+ * Retrieve an automaton by name from it's set.
  *
- * Parameters: set - The automaton set.
+ * Parameters: set - The automaton set. The names must have been read in.
  *             name - The name we are searching for.
  *
  * Returns: The automaton or NULL on failure.
@@ -213,23 +274,8 @@ AUTOMATON *get_automaton_by_name(AUTOMATON_SET *set, char *name)
   /*
    * Local Variables.
    */
-  int ii;
-  AUTOMATON *found_automaton = NULL;
-
-  /*
-   * Loop through the automaton array until we run out or find the automaton
-   * that we're looking for.
-   */
-  for (ii = 0; ii < set->num_automatons; ii++)
-  {
-    if (0 == strncmp(set->automaton_array[ii]->name, name, strlen(name)))
-    {
-      found_automaton = set->automaton_array[ii];
-      goto EXIT_LABEL;
-    }
-  }
-
-EXIT_LABEL:
+  int index = find_name_in_table(set->automaton_names, name);
 
-  return(found_automaton);
+  return((NAME_TABLE_NOT_FOUND == index) ? NULL :
+                                           set->automaton_array[index]);
 }
@@ -8,10 +8,12 @@
 #define AUTOMATON_HANDLER_H_
 
 struct automaton;
+struct automaton_decision_node;
 struct automaton_event;
 struct automaton_state;
 struct automaton_timed_event_queue;
 struct match_state;
+struct name_table;
 
 /*
  * AUTOMATON_SET
@@ -23,12 +25,20 @@ struct match_state;
  *                  array.
  * start_automaton - One of the automaton_array. The starting point for
  *                   players when they switch to this set.
+ * automaton_names - Finds the index of an automaton in automaton_array from
+ *                   its name. NULL until the names have been read from file.
+ * decision_nodes - The decision nodes of every transition in the set (see
+ *                  automaton_decision_dag.h). NULL until the set is loaded.
+ * num_decision_nodes - The size of decision_nodes.
  */
 typedef struct automaton_set
 {
   struct automaton **automaton_array;
   int num_automatons;
   struct automaton *start_automaton;
+  struct name_table *automaton_names;
+  struct automaton_decision_node *decision_nodes;
+  int num_decision_nodes;
 } AUTOMATON_SET;
 
 /*
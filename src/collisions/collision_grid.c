@@ -0,0 +1,346 @@
+/*
+ * collision_grid.c
+ *
+ *  Created on: 16 Oct 2026
+ *      Author: David Tyler
+ */
+
+#include "../dt_logger.h"
+
+#include <math.h>
+#include "collision_grid.h"
+#include "../data_structures/vector.h"
+
+/*
+ * create_collision_grid
+ *
+ * Allocates an empty grid covering a rectangle of the pitch.
+ *
+ * Parameters: min_x, min_y - The low corner of the area covered.
+ *             max_x, max_y - The high corner of the area covered.
+ *             cell_m - The size of each cell.
+ *             max_objects - The number of objects that the grid can hold.
+ *
+ * Returns: A pointer to the newly created memory.
+ */
+COLLISION_GRID *create_collision_grid(float min_x,
+                                      float min_y,
+                                      float max_x,
+                                      float max_y,
+                                      float cell_m,
+                                      int max_objects)
+{
+  /*
+   * Local Variables.
+   */
+  COLLISION_GRID *grid;
+  int ii;
+
+  grid = (COLLISION_GRID *) DT_MALLOC(sizeof(COLLISION_GRID));
+
+  grid->cell_m = cell_m;
+  grid->origin_x = min_x;
+  grid->origin_y = min_y;
+  grid->num_cells_x = (int) ceilf((max_x - min_x) / cell_m);
+  grid->num_cells_y = (int) ceilf((max_y - min_y) / cell_m);
+  if (grid->num_cells_x < 1)
+  {
+    grid->num_cells_x = 1;
+  }
+  if (grid->num_cells_y < 1)
+  {
+    grid->num_cells_y = 1;
+  }
+  grid->cell_heads = (int *) DT_MALLOC(sizeof(int) *
+                                       grid->num_cells_x * grid->num_cells_y);
+
+  grid->max_objects = max_objects;
+  grid->object_cells = (int *) DT_MALLOC(sizeof(int) * max_objects);
+  grid->next = (int *) DT_MALLOC(sizeof(int) * max_objects);
+  grid->prev = (int *) DT_MALLOC(sizeof(int) * max_objects);
+  grid->min_x = (float *) DT_MALLOC(sizeof(float) * max_objects);
+  grid->min_y = (float *) DT_MALLOC(sizeof(float) * max_objects);
+  grid->min_z = (float *) DT_MALLOC(sizeof(float) * max_objects);
+  grid->max_x = (float *) DT_MALLOC(sizeof(float) * max_objects);
+  grid->max_y = (float *) DT_MALLOC(sizeof(float) * max_objects);
+  grid->max_z = (float *) DT_MALLOC(sizeof(float) * max_objects);
+  grid->results = (int *) DT_MALLOC(sizeof(int) * max_objects);
+
+  /*
+   * Mark every object as not in the grid before clearing so that clearing
+   * doesn't try to unlink them.
+   */
+  for (ii = 0; ii < max_objects; ii++)
+  {
+    grid->object_cells[ii] = -1;
+  }
+  clear_collision_grid(grid);
+
+  return(grid);
+}
+
+/*
+ * destroy_collision_grid
+ *
+ * Frees the memory used by the passed in object.
+ *
+ * Parameters: grid - The object to be freed.
+ */
+void destroy_collision_grid(COLLISION_GRID *grid)
+{
+  DT_FREE(grid->results);
+  DT_FREE(grid->max_z);
+  DT_FREE(grid->max_y);
+  DT_FREE(grid->max_x);
+  DT_FREE(grid->min_z);
+  DT_FREE(grid->min_y);
+  DT_FREE(grid->min_x);
+  DT_FREE(grid->prev);
+  DT_FREE(grid->next);
+  DT_FREE(grid->object_cells);
+  DT_FREE(grid->cell_heads);
+  DT_FREE(grid);
+}
+
+/*
+ * clear_collision_grid
+ *
+ * Removes every object from the grid.
+ *
+ * Parameters: grid - The grid to empty.
+ */
+void clear_collision_grid(COLLISION_GRID *grid)
+{
+  /*
+   * Local Variables.
+   */
+  int ii;
+
+  for (ii = 0; ii < grid->num_cells_x * grid->num_cells_y; ii++)
+  {
+    grid->cell_heads[ii] = -1;
+  }
+  for (ii = 0; ii < grid->max_objects; ii++)
+  {
+    grid->object_cells[ii] = -1;
+    grid->next[ii] = -1;
+    grid->prev[ii] = -1;
+  }
+  grid->max_size = 0.0f;
+}
+
+/*
+ * collision_grid_column
+ *
+ * INTERNAL: Finds the column of cells containing an x coordinate. Anything off
+ * the grid is put in the nearest column.
+ */
+int collision_grid_column(COLLISION_GRID *grid, float x)
+{
+  /*
+   * Local Variables.
+   */
+  int column = (int) floorf((x - grid->origin_x) / grid->cell_m);
+
+  if (column < 0)
+  {
+    column = 0;
+  }
+  else if (column >= grid->num_cells_x)
+  {
+    column = grid->num_cells_x - 1;
+  }
+
+  return(column);
+}
+
+/*
+ * collision_grid_row
+ *
+ * INTERNAL: As collision_grid_column for the row containing a y coordinate.
+ */
+int collision_grid_row(COLLISION_GRID *grid, float y)
+{
+  /*
+   * Local Variables.
+   */
+  int row = (int) floorf((y - grid->origin_y) / grid->cell_m);
+
+  if (row < 0)
+  {
+    row = 0;
+  }
+  else if (row >= grid->num_cells_y)
+  {
+    row = grid->num_cells_y - 1;
+  }
+
+  return(row);
+}
+
+/*
+ * remove_collision_grid_object
+ *
+ * Takes an object out of the grid. Does nothing if it isn't in the grid.
+ *
+ * Parameters: grid - The grid.
+ *             object - The index of the object.
+ */
+void remove_collision_grid_object(COLLISION_GRID *grid, int object)
+{
+  /*
+   * Local Variables.
+   */
+  int cell = grid->object_cells[object];
+
+  if (-1 == cell)
+  {
+    return;
+  }
+
+  if (-1 == grid->prev[object])
+  {
+    grid->cell_heads[cell] = grid->next[object];
+  }
+  else
+  {
+    grid->next[grid->prev[object]] = grid->next[object];
+  }
+  if (-1 != grid->next[object])
+  {
+    grid->prev[grid->next[object]] = grid->prev[object];
+  }
+
+  grid->object_cells[object] = -1;
+  grid->next[object] = -1;
+  grid->prev[object] = -1;
+}
+
+/*
+ * set_collision_grid_object
+ *
+ * Adds an object to the grid or updates where it is. The object is only moved
+ * between cells if its low corner has moved into a different cell, which for
+ * players running around the pitch is rarely the case.
+ *
+ * Parameters: grid - The grid.
+ *             object - The index of the object.
+ *             corner - The low corner of the object's bounding box.
+ *             size_x, size_y, size_z - The size of the bounding box.
+ */
+void set_collision_grid_object(COLLISION_GRID *grid,
+                               int object,
+                               VECTOR3 *corner,
+                               float size_x,
+                               float size_y,
+                               float size_z)
+{
+  /*
+   * Local Variables.
+   */
+  int cell;
+
+  grid->min_x[object] = corner->x;
+  grid->min_y[object] = corner->y;
+  grid->min_z[object] = corner->z;
+  grid->max_x[object] = corner->x + size_x;
+  grid->max_y[object] = corner->y + size_y;
+  grid->max_z[object] = corner->z + size_z;
+  if (size_x > grid->max_size)
+  {
+    grid->max_size = size_x;
+  }
+  if (size_y > grid->max_size)
+  {
+    grid->max_size = size_y;
+  }
+
+  cell = collision_grid_column(grid, corner->x) +
+         collision_grid_row(grid, corner->y) * grid->num_cells_x;
+  if (cell == grid->object_cells[object])
+  {
+    return;
+  }
+
+  remove_collision_grid_object(grid, object);
+  grid->object_cells[object] = cell;
+  grid->prev[object] = -1;
+  grid->next[object] = grid->cell_heads[cell];
+  if (-1 != grid->next[object])
+  {
+    grid->prev[grid->next[object]] = object;
+  }
+  grid->cell_heads[cell] = object;
+}
+
+/*
+ * find_collision_grid_overlaps
+ *
+ * Finds every object in the grid whose bounding box intersects a box. Boxes
+ * which only touch count as intersecting.
+ *
+ * Any object that overlaps the box has its low corner no further than
+ * max_size below the low corner of the box, so only the cells from there to
+ * the high corner of the box need to be looked in.
+ *
+ * Parameters: grid - The grid.
+ *             corner_a - The low corner of the box.
+ *             corner_b - The high corner of the box.
+ *
+ * Returns: The number of objects found. Their indexes are in grid->results in
+ *          increasing order, so that callers handle collisions in the same
+ *          order wherever the objects are on the pitch.
+ */
+int find_collision_grid_overlaps(COLLISION_GRID *grid,
+                                 VECTOR3 *corner_a,
+                                 VECTOR3 *corner_b)
+{
+  /*
+   * Local Variables.
+   */
+  int first_column = collision_grid_column(grid,
+                                           corner_a->x - grid->max_size);
+  int last_column = collision_grid_column(grid, corner_b->x);
+  int first_row = collision_grid_row(grid, corner_a->y - grid->max_size);
+  int last_row = collision_grid_row(grid, corner_b->y);
+  int num_results = 0;
+  int object;
+  int column;
+  int row;
+  int ii;
+
+  for (row = first_row; row <= last_row; row++)
+  {
+    for (column = first_column; column <= last_column; column++)
+    {
+      for (object = grid->cell_heads[column + row * grid->num_cells_x];
+           -1 != object;
+           object = grid->next[object])
+      {
+        if ((grid->max_x[object] < corner_a->x) ||
+            (grid->min_x[object] > corner_b->x) ||
+            (grid->max_y[object] < corner_a->y) ||
+            (grid->min_y[object] > corner_b->y) ||
+            (grid->max_z[object] < corner_a->z) ||
+            (grid->min_z[object] > corner_b->z))
+        {
+          continue;
+        }
+
+        /*
+         * Insert in order. There are only ever a few results.
+         */
+        for (ii = num_results;
+             (ii > 0) && (grid->results[ii - 1] > object);
+             ii--)
+        {
+          grid->results[ii] = grid->results[ii - 1];
+        }
+        grid->results[ii] = object;
+        num_results++;
+      }
+    }
+  }
+
+  return(num_results);
+}
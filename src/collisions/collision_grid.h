@@ -0,0 +1,85 @@
+/*
+ * collision_grid.h
+ *
+ * A uniform grid over the pitch used as a broadphase for collision detection.
+ * Each object is kept in the cell containing the low corner of its bounding
+ * box so only the objects in the cells around a box need to be tested
+ * against it, however many objects there are on the pitch.
+ *
+ *  Created on: 16 Oct 2026
+ *      Author: David Tyler
+ */
+
+#ifndef COLLISION_GRID_H_
+#define COLLISION_GRID_H_
+
+#include "../data_structures/vector.h"
+
+/*
+ * The size of a grid cell (m). Should be at least as large as the objects in
+ * the grid, otherwise queries have to look through more cells.
+ */
+#define COLLISION_GRID_CELL_M 2.0f
+
+/*
+ * How far off the pitch the grid reaches (m). Objects further off the pitch
+ * than this are kept in the cells at the edge of the grid, which is always
+ * correct but slower if there are a lot of them.
+ */
+#define COLLISION_GRID_MARGIN_M 10.0f
+
+/*
+ * COLLISION_GRID
+ *
+ * Objects are identified by an index from 0 to max_objects - 1 chosen by the
+ * caller. The objects in each cell are held as a doubly linked list through
+ * the next and prev arrays so that an object can be moved between cells
+ * without searching.
+ *
+ * cell_m - The size of each cell.
+ * origin_x, origin_y - The low corner of the grid.
+ * num_cells_x, num_cells_y - The number of cells in each direction.
+ * cell_heads - The first object in each cell, -1 if the cell is empty.
+ * max_objects - The size of the per object arrays.
+ * object_cells - The cell each object is in, -1 if it isn't in the grid.
+ * next, prev - The next and previous objects in the same cell, -1 at the ends
+ *              of the list.
+ * min_x...max_z - The bounding box of each object.
+ * max_size - The largest x or y size of any object in the grid.
+ * results - Filled in by find_collision_grid_overlaps.
+ */
+typedef struct collision_grid
+{
+  float cell_m;
+  float origin_x;
+  float origin_y;
+  int num_cells_x;
+  int num_cells_y;
+  int *cell_heads;
+  int max_objects;
+  int *object_cells;
+  int *next;
+  int *prev;
+  float *min_x;
+  float *min_y;
+  float *min_z;
+  float *max_x;
+  float *max_y;
+  float *max_z;
+  float max_size;
+  int *results;
+} COLLISION_GRID;
+
+COLLISION_GRID *create_collision_grid(float, float, float, float, float, int);
+void destroy_collision_grid(COLLISION_GRID *);
+void clear_collision_grid(COLLISION_GRID *);
+void set_collision_grid_object(COLLISION_GRID *,
+                               int,
+                               VECTOR3 *,
+                               float,
+                               float,
+                               float);
+void remove_collision_grid_object(COLLISION_GRID *, int);
+int find_collision_grid_overlaps(COLLISION_GRID *, VECTOR3 *, VECTOR3 *);
+
+#endif /* COLLISION_GRID_H_ */
@@ -13,124 +13,345 @@
 
 #include "../dt_logger.h"
 
+#include <math.h>
 #include <stdbool.h>
 #include "../game_functions.h"
-#include "../team.h"
 #include "../disc.h"
 #include "../player.h"
+#include "../player_kinematics.h"
 #include "../data_structures/vector.h"
+#include "collision_grid.h"
 #include "collision_handler.h"
+#include "player_separation.h"
 
 /*
- * test_cube_collision
+ * update_collision_grid_players
  *
- * This is private utility function for this file to use in its collision
- * detection. It is the most simple and obvious way of performing a bounding
- * box test on two objects. If this returns true then the bounding boxes
- * intersect in some way.
+ * INTERNAL: Moves every player to their new position in the collision grid.
+ * Only the players that have moved into a different cell since the last
+ * update are moved between cells. Players are held in the grid at their
+ * index in the kinematics store.
  *
- * Parameters: x11,y11,z11 - The top left of object A.
- *             x12,y12,z12 - The opposite corner of object A.
- *             x21,y21,z21 - The top left of object B.
- *             x22,y22,z22 - The opposite corner of object B.
- *
- * Returns: True if the cubes intersect.
+ * Parameters: grid - The collision grid.
+ *             kinematics - Where all the players are moving to.
  */
-bool test_cube_collision(VECTOR3 *obj1_cornerA,
-                         VECTOR3 *obj1_cornerB,
-                         VECTOR3 *obj2_cornerA,
-                         VECTOR3 *obj2_cornerB)
+void update_collision_grid_players(COLLISION_GRID *grid,
+                                   PLAYER_KINEMATICS *kinematics)
 {
-  if (obj2_cornerB->x < obj1_cornerA->x ||
-      obj2_cornerA->x > obj1_cornerB->x) return false;
-  if (obj2_cornerB->y < obj1_cornerA->y ||
-      obj2_cornerA->y > obj1_cornerB->y) return false;
-  if (obj2_cornerB->z < obj1_cornerA->z ||
-      obj2_cornerA->z > obj1_cornerB->z) return false;
-
-  return true;
+  /*
+   * Local Variables.
+   */
+  PLAYER *player;
+  VECTOR3 corner;
+  int index;
+
+  DT_ASSERT(grid->max_objects >= kinematics->num_players);
+
+  for (index = 0; index < kinematics->num_players; index++)
+  {
+    player = kinematics->players[index];
+    vector_set_values(&corner,
+                      kinematics->new_x[index],
+                      kinematics->new_y[index],
+                      0.0f);
+    set_collision_grid_object(grid,
+                              index,
+                              &corner,
+                              player->width_x,
+                              player->width_y,
+                              player->height);
+  }
 }
 
 /*
- * handle_player_player_collision
- *
- * This function is called with a pair of players which have had their
- * bounding boxes collide.
+ * detect_player_player_collisions
  *
- * At present this is handled simply by putting them back to where they were
- * before the collision took place. This is a very simplistic way of dealing
- * with the problem but should be reasonably realistic for small update times.
+ * Finds every pair of players whose bounding boxes intersect and adds them to
+ * the separation solver. Rather than testing every player against every
+ * other, each player is only tested against those in the nearby cells of the
+ * collision grid.
  *
- * Parameters: player1, player2 - Ordering of players in parameters is
- *                                irrelevant to this function.
+ * Parameters: grid - The collision grid, already updated with the players'
+ *                    new positions.
+ *             separation - The separation solver to add the pairs to.
+ *             num_players - The number of players in the grid.
  */
-void handle_player_player_collision(PLAYER *player1, PLAYER *player2)
-{
-  //DT_DEBUG_LOG("Collision occurred between players (%i:%i) and (%i:%i)\n",
-  //             player1->team_id, player1->player_id,
-  //             player2->team_id, player2->player_id);
-  //revert_player_coords_update(player1);
-  //revert_player_coords_update(player2);
-}
-
-void detect_player_player_collisions(TEAM *teams[], int players_per_team)
+void detect_player_player_collisions(COLLISION_GRID *grid,
+                                     PLAYER_SEPARATION *separation,
+                                     int num_players)
 {
   /*
    * Local Variables.
    */
-  VECTOR3 player1_cornerA;
-  VECTOR3 player1_cornerB;
-  VECTOR3 player2_cornerA;
-  VECTOR3 player2_cornerB;
+  VECTOR3 player_cornerA;
+  VECTOR3 player_cornerB;
+  int num_overlaps;
+  int index;
   int ii;
-  int jj;
-  int kk;
-  int ll;
 
-  /*
-   * For each player loop through the REMAINING players detecting for possible
-   * collisions.
-   */
-  for (ii = 0; ii < players_per_team; ii++)
+  clear_player_separation_contacts(separation);
+
+  for (index = 0; index < num_players; index++)
   {
-    for (jj = 0; jj < 2; jj++)
+    player_cornerA.x = grid->min_x[index];
+    player_cornerA.y = grid->min_y[index];
+    player_cornerA.z = grid->min_z[index];
+    player_cornerB.x = grid->max_x[index];
+    player_cornerB.y = grid->max_y[index];
+    player_cornerB.z = grid->max_z[index];
+
+    /*
+     * The results are in increasing order and each pair is only added once,
+     * from the player with the lower index.
+     */
+    num_overlaps = find_collision_grid_overlaps(grid,
+                                                &player_cornerA,
+                                                &player_cornerB);
+    for (ii = 0; ii < num_overlaps; ii++)
     {
-      player1_cornerA.x = teams[jj]->players[ii]->new_position.x;
-      player1_cornerA.y = teams[jj]->players[ii]->new_position.y;
-      player1_cornerA.z = teams[jj]->players[ii]->new_position.z;
-      player1_cornerB.x = player1_cornerA.x + teams[jj]->players[ii]->width_x;
-      player1_cornerB.y = player1_cornerA.y + teams[jj]->players[ii]->width_y;
-      player1_cornerB.z = player1_cornerA.z + teams[jj]->players[ii]->height;
-
-      for (kk = ii + 1; kk < players_per_team; kk++)
+      if (grid->results[ii] > index)
       {
-        for (ll = 0; ll < 2; ll++)
-        {
-          player2_cornerA.x = teams[ll]->players[kk]->new_position.x;
-          player2_cornerA.y = teams[ll]->players[kk]->new_position.y;
-          player2_cornerA.z = teams[ll]->players[kk]->new_position.z;
-          player2_cornerB.x = player2_cornerA.x + teams[ll]->players[kk]->width_x;
-          player2_cornerB.y = player2_cornerA.y + teams[ll]->players[kk]->width_y;
-          player2_cornerB.z = player2_cornerA.z + teams[ll]->players[kk]->height;
-
-          /*
-           * Basic test is just a bounding box test around the cube that contains
-           * each player.
-           */
-          if (test_cube_collision(&player1_cornerA,
-                                  &player1_cornerB,
-                                  &player2_cornerA,
-                                  &player2_cornerB))
-          {
-            handle_player_player_collision(teams[jj]->players[ii],
-                                           teams[ll]->players[kk]);
-          }
-        }
+        add_player_separation_contact(separation, index, grid->results[ii]);
       }
     }
   }
 }
 
+/*
+ * handle_player_player_collisions
+ *
+ * INTERNAL: Pushes apart the players found to be overlapping by
+ * detect_player_player_collisions. Each player is treated as the largest
+ * circle that fits in their bounding box, so that players who only overlap
+ * at the corners of their boxes are left alone. Their new positions are
+ * moved and the collision grid updated to match.
+ *
+ * Parameters: grid - The collision grid.
+ *             separation - The separation solver holding the pairs.
+ *             kinematics - Where all the players are moving to.
+ */
+void handle_player_player_collisions(COLLISION_GRID *grid,
+                                     PLAYER_SEPARATION *separation,
+                                     PLAYER_KINEMATICS *kinematics)
+{
+  /*
+   * Local Variables.
+   */
+  PLAYER *player;
+  int index;
+
+  if (0 == separation->num_contacts)
+  {
+    return;
+  }
+
+  for (index = 0; index < kinematics->num_players; index++)
+  {
+    player = kinematics->players[index];
+    separation->x[index] = kinematics->new_x[index] + 0.5f * player->width_x;
+    separation->y[index] = kinematics->new_y[index] + 0.5f * player->width_y;
+    separation->radius[index] = 0.5f * fminf(player->width_x,
+                                             player->width_y);
+  }
+
+  solve_player_separation(separation, kinematics->num_players);
+
+  for (index = 0; index < kinematics->num_players; index++)
+  {
+    player = kinematics->players[index];
+    kinematics->new_x[index] = separation->x[index] - 0.5f * player->width_x;
+    kinematics->new_y[index] = separation->y[index] - 0.5f * player->width_y;
+  }
+
+  update_collision_grid_players(grid, kinematics);
+}
+
+/*
+ * calculate_swept_box_times_of_impact
+ *
+ * Finds when a box moving in a straight line first touches each of a set of
+ * fixed boxes. The moving box is shrunk to a point and each fixed box grown by
+ * its size, so this is a test of a line segment against a box one axis at a
+ * time.
+ *
+ * The fixed boxes are passed as a structure of arrays and the loop over them
+ * has no branches so that gcc can vectorise it, which it does with the flags
+ * in the generated make file. An axis along which the box doesn't move
+ * either always overlaps or never does.
+ *
+ * Parameters: start - The low corner of the moving box at the start of the
+ *                     move.
+ *             end - The low corner of the moving box at the end of the move.
+ *             size - The size of the moving box.
+ *             num_boxes - The number of fixed boxes.
+ *             low_x...high_z - The corners of the fixed boxes.
+ *             times_of_impact - Filled in with the fraction of the move at
+ *                               which the moving box first touches each fixed
+ *                               box. 0 if they were already touching at the
+ *                               start and COLLISION_NO_IMPACT if they never
+ *                               touch.
+ */
+void calculate_swept_box_times_of_impact(VECTOR3 *start,
+                                         VECTOR3 *end,
+                                         VECTOR3 *size,
+                                         int num_boxes,
+                                         float *low_x,
+                                         float *low_y,
+                                         float *low_z,
+                                         float *high_x,
+                                         float *high_y,
+                                         float *high_z,
+                                         float *times_of_impact)
+{
+  /*
+   * Local Variables.
+   */
+  float start_x = start->x;
+  float start_y = start->y;
+  float start_z = start->z;
+  float size_x = size->x;
+  float size_y = size->y;
+  float size_z = size->z;
+  float move_x = end->x - start_x;
+  float move_y = end->y - start_y;
+  float move_z = end->z - start_z;
+  float inv_move_x = 1.0f / move_x;
+  float inv_move_y = 1.0f / move_y;
+  float inv_move_z = 1.0f / move_z;
+  int moving_x = (0.0f != move_x);
+  int moving_y = (0.0f != move_y);
+  int moving_z = (0.0f != move_z);
+  float enter;
+  float leave;
+  float low;
+  float high;
+  float t_low;
+  float t_high;
+  float t_min;
+  float t_max;
+  int inside;
+  float still_min;
+  float still_max;
+  int ii;
+
+  for (ii = 0; ii < num_boxes; ii++)
+  {
+    enter = 0.0f;
+    leave = 1.0f;
+
+    low = low_x[ii] - size_x;
+    high = high_x[ii];
+    inside = (start_x >= low) & (start_x <= high);
+    t_low = (low - start_x) * inv_move_x;
+    t_high = (high - start_x) * inv_move_x;
+    t_min = (t_low < t_high) ? t_low : t_high;
+    t_max = (t_low < t_high) ? t_high : t_low;
+    still_min = inside ? 0.0f : COLLISION_NO_IMPACT;
+    still_max = inside ? 1.0f : -1.0f;
+    t_min = moving_x ? t_min : still_min;
+    t_max = moving_x ? t_max : still_max;
+    enter = (t_min > enter) ? t_min : enter;
+    leave = (t_max < leave) ? t_max : leave;
+
+    low = low_y[ii] - size_y;
+    high = high_y[ii];
+    inside = (start_y >= low) & (start_y <= high);
+    t_low = (low - start_y) * inv_move_y;
+    t_high = (high - start_y) * inv_move_y;
+    t_min = (t_low < t_high) ? t_low : t_high;
+    t_max = (t_low < t_high) ? t_high : t_low;
+    still_min = inside ? 0.0f : COLLISION_NO_IMPACT;
+    still_max = inside ? 1.0f : -1.0f;
+    t_min = moving_y ? t_min : still_min;
+    t_max = moving_y ? t_max : still_max;
+    enter = (t_min > enter) ? t_min : enter;
+    leave = (t_max < leave) ? t_max : leave;
+
+    low = low_z[ii] - size_z;
+    high = high_z[ii];
+    inside = (start_z >= low) & (start_z <= high);
+    t_low = (low - start_z) * inv_move_z;
+    t_high = (high - start_z) * inv_move_z;
+    t_min = (t_low < t_high) ? t_low : t_high;
+    t_max = (t_low < t_high) ? t_high : t_low;
+    still_min = inside ? 0.0f : COLLISION_NO_IMPACT;
+    still_max = inside ? 1.0f : -1.0f;
+    t_min = moving_z ? t_min : still_min;
+    t_max = moving_z ? t_max : still_max;
+    enter = (t_min > enter) ? t_min : enter;
+    leave = (t_max < leave) ? t_max : leave;
+
+    times_of_impact[ii] = (enter <= leave) ? enter : COLLISION_NO_IMPACT;
+  }
+}
+
+/*
+ * calculate_swept_box_time_of_impact
+ *
+ * As calculate_swept_box_times_of_impact for a single fixed box.
+ *
+ * Parameters: start - The low corner of the moving box at the start of the
+ *                     move.
+ *             end - The low corner of the moving box at the end of the move.
+ *             size - The size of the moving box.
+ *             box_low, box_high - The corners of the fixed box.
+ *             time_of_impact - Filled in with the fraction of the move at
+ *                              which the boxes first touch. 0 if they were
+ *                              already touching at the start.
+ *
+ * Returns: True if the boxes touch at any point during the move.
+ */
+bool calculate_swept_box_time_of_impact(VECTOR3 *start,
+                                        VECTOR3 *end,
+                                        VECTOR3 *size,
+                                        VECTOR3 *box_low,
+                                        VECTOR3 *box_high,
+                                        float *time_of_impact)
+{
+  calculate_swept_box_times_of_impact(start,
+                                      end,
+                                      size,
+                                      1,
+                                      &(box_low->x),
+                                      &(box_low->y),
+                                      &(box_low->z),
+                                      &(box_high->x),
+                                      &(box_high->y),
+                                      &(box_high->z),
+                                      time_of_impact);
+
+  return(*time_of_impact <= 1.0f);
+}
+
+/*
+ * calculate_disc_half_extents
+ *
+ * INTERNAL: Works out the smallest box around the disc, which is a cylinder
+ * centred on its position with its axis along d3. Along each world axis the
+ * cylinder reaches out by its radius times the sine of the angle between that
+ * axis and d3, plus half its thickness times the cosine. So a flat disc is
+ * only its thickness high and a disc on its edge only its thickness wide.
+ *
+ * Parameters: disc - The disc.
+ *             half_extents - Filled in with half the size of the box.
+ */
+void calculate_disc_half_extents(DISC *disc, VECTOR3 *half_extents)
+{
+  /*
+   * Local Variables.
+   */
+  VECTOR3 axis = unit_vector(&(disc->d3));
+  float radius = 0.5f * disc->diameter_m;
+  float half_thickness = 0.5f * disc->thickness_m;
+
+  half_extents->x = radius * sqrtf(fmaxf(0.0f, 1.0f - axis.x * axis.x)) +
+                    half_thickness * fabsf(axis.x);
+  half_extents->y = radius * sqrtf(fmaxf(0.0f, 1.0f - axis.y * axis.y)) +
+                    half_thickness * fabsf(axis.y);
+  half_extents->z = radius * sqrtf(fmaxf(0.0f, 1.0f - axis.z * axis.z)) +
+                    half_thickness * fabsf(axis.z);
+}
+
 /*
  * handle_player_disc_collisions
  *
@@ -138,83 +359,143 @@ void detect_player_player_collisions(TEAM *teams[], int players_per_team)
  * an event is thrown to the AI which will get added to the queue. It is up to
  * the player AI whether they catch it or it becomes a turnover.
  *
- * Parameters: teams - The team objects hold all the player objects in the game.
- *             players_per_team - Required to iterate over the array of players.
+ * The disc's bounding box, which allows for the way the disc is tilted, is
+ * swept from where it was at the start of the update to where it is moving
+ * to, so a fast disc can't jump through a player between updates however
+ * long the update is. The first player that the disc reaches gets it, and the
+ * disc is stopped where it reached them. Only the players in the cells of the
+ * collision grid along the sweep are tested.
+ *
+ * Parameters: grid - The collision grid, already updated with the players'
+ *                    new positions.
+ *             kinematics - Where all the players are moving to.
  *             disc - The disc object.
  */
-void handle_player_disc_collisions(TEAM **teams,
-                                   int players_per_team,
+void handle_player_disc_collisions(COLLISION_GRID *grid,
+                                   PLAYER_KINEMATICS *kinematics,
                                    DISC *disc)
 {
   /*
    * Local Variables.
    */
-  VECTOR3 player_cornerA;
-  VECTOR3 player_cornerB;
-  VECTOR3 disc_cornerA;
-  VECTOR3 disc_cornerB;
+  float low_x[COLLISION_BATCH_SIZE];
+  float low_y[COLLISION_BATCH_SIZE];
+  float low_z[COLLISION_BATCH_SIZE];
+  float high_x[COLLISION_BATCH_SIZE];
+  float high_y[COLLISION_BATCH_SIZE];
+  float high_z[COLLISION_BATCH_SIZE];
+  float times_of_impact[COLLISION_BATCH_SIZE];
+  int indexes[COLLISION_BATCH_SIZE];
+  PLAYER *first_player = NULL;
+  VECTOR3 half_extents;
+  VECTOR3 disc_size;
+  VECTOR3 start_corner;
+  VECTOR3 end_corner;
+  VECTOR3 sweep_cornerA;
+  VECTOR3 sweep_cornerB;
+  VECTOR3 disc_move;
+  float first_time_of_impact = COLLISION_NO_IMPACT;
+  int num_overlaps;
+  int num_boxes;
+  int index;
   int ii;
   int jj;
 
   /*
-   * Set up the corners of the discs bounding box.
+   * A player already holding the disc can't collide with it.
+   */
+  if (disc->disc_state == disc_with_player)
+  {
+    return;
+  }
+
+  /*
+   * The disc's box is the smallest one around the disc at its current
+   * orientation, moving from its position to its new position.
    */
-  vector_copy_values(&(disc_cornerA), &(disc->new_position));
-  disc_cornerB.x = disc_cornerA.x + disc->diameter_m;
-  disc_cornerB.y = disc_cornerA.y + disc->diameter_m;
-  disc_cornerB.z = disc_cornerA.z + disc->diameter_m;
+  calculate_disc_half_extents(disc, &half_extents);
+  disc_size = mult_vector_by_scalar(&half_extents, 2.0f);
+  start_corner = vector_minus(&(disc->position), &half_extents);
+  end_corner = vector_minus(&(disc->new_position), &half_extents);
 
-  for (ii = 0; ii < players_per_team; ii++)
+  /*
+   * The box around the whole sweep is used to find the players to test.
+   */
+  sweep_cornerA.x = fminf(start_corner.x, end_corner.x);
+  sweep_cornerA.y = fminf(start_corner.y, end_corner.y);
+  sweep_cornerA.z = fminf(start_corner.z, end_corner.z);
+  sweep_cornerB.x = fmaxf(start_corner.x, end_corner.x) + disc_size.x;
+  sweep_cornerB.y = fmaxf(start_corner.y, end_corner.y) + disc_size.y;
+  sweep_cornerB.z = fmaxf(start_corner.z, end_corner.z) + disc_size.z;
+  num_overlaps = find_collision_grid_overlaps(grid,
+                                              &sweep_cornerA,
+                                              &sweep_cornerB);
+
+  /*
+   * Find the player that the disc reaches first. If two are reached at the
+   * same moment the one added to the kinematics store first gets it.
+   * The players found are tested COLLISION_BATCH_SIZE at a time.
+   */
+  for (ii = 0; ii < num_overlaps; ii += num_boxes)
   {
-    for (jj = 0; jj < 2; jj++)
+    num_boxes = 0;
+    for (jj = ii;
+         (jj < num_overlaps) && (num_boxes < COLLISION_BATCH_SIZE);
+         jj++)
     {
-      /*
-       * Set up the corners of the players bounding box.
-       */
-      player_cornerA.x = teams[jj]->players[ii]->new_position.x;
-      player_cornerA.y = teams[jj]->players[ii]->new_position.y;
-      player_cornerA.z = teams[jj]->players[ii]->new_position.z;
-      player_cornerB.x = player_cornerA.x + teams[jj]->players[ii]->width_x;
-      player_cornerB.y = player_cornerA.y + teams[jj]->players[ii]->width_y;
-      player_cornerB.z = player_cornerA.z + teams[jj]->players[ii]->height;
-
-      if (ii == 1)
-      {
-        ii = 1;
-      }
+      index = grid->results[jj];
+      low_x[num_boxes] = grid->min_x[index];
+      low_y[num_boxes] = grid->min_y[index];
+      low_z[num_boxes] = grid->min_z[index];
+      high_x[num_boxes] = grid->max_x[index];
+      high_y[num_boxes] = grid->max_y[index];
+      high_z[num_boxes] = grid->max_z[index];
+      indexes[num_boxes] = index;
+      num_boxes++;
+    }
 
-      /*
-       * Test the bounding boxes of the player and the disc. If the bounding boxes
-       * intersect then we declare it a collision.
-       *
-       * Note that the bounding box around the disc is not done properly as the
-       * diameter is used as the height in the z direction. It would be better to
-       * use a bounding box oriented to the direction of the disc.
-       */
-      if (test_cube_collision(&player_cornerA,
-                              &player_cornerB,
-                              &disc_cornerA,
-                              &disc_cornerB))
+    calculate_swept_box_times_of_impact(&start_corner,
+                                        &end_corner,
+                                        &disc_size,
+                                        num_boxes,
+                                        low_x,
+                                        low_y,
+                                        low_z,
+                                        high_x,
+                                        high_y,
+                                        high_z,
+                                        times_of_impact);
+
+    for (jj = 0; jj < num_boxes; jj++)
+    {
+      if ((times_of_impact[jj] < first_time_of_impact) &&
+          (disc->thrower != kinematics->players[indexes[jj]]))
       {
-        /*
-         * On collision pass control of the player to the user providing that
-         * no other player is already holding the disc.
-         */
-        if ((disc->disc_state != disc_with_player) &&
-            (disc->thrower != teams[jj]->players[ii]))
-        {
-          DT_DEBUG_LOG("Player (%i:%i) has collided with the disc\n",
-                       teams[jj]->players[ii]->team_id,
-                       teams[jj]->players[ii]->player_id);
-
-          /*
-           * For now just let the player catch the disc.
-           */
-          catch_disc(teams[jj]->players[ii], disc);
-        }
+        first_player = kinematics->players[indexes[jj]];
+        first_time_of_impact = times_of_impact[jj];
       }
     }
   }
+
+  if (NULL != first_player)
+  {
+    DT_DEBUG_LOG("Player (%i:%i) has collided with the disc (toi %f)\n",
+                 first_player->team_id,
+                 first_player->player_id,
+                 first_time_of_impact);
+
+    /*
+     * The disc goes no further than the player.
+     */
+    disc_move = vector_minus(&(disc->new_position), &(disc->position));
+    disc_move = mult_vector_by_scalar(&disc_move, first_time_of_impact);
+    disc->new_position = vector_add(&(disc->position), &disc_move);
+
+    /*
+     * For now just let the player catch the disc.
+     */
+    catch_disc(first_player, disc);
+  }
 }
 
 /*
@@ -229,37 +510,40 @@ void handle_player_disc_collisions(TEAM **teams,
  * game is extremely minimal. See documentation for a full discussion of
  * potential problems.
  *
- * Parameters: teams - Contains all the players in the game.
- *             players_per_team - The number of players in each team.
+ * Parameters: grid - The collision grid for the players. Kept between calls
+ *                    so that only players changing cell are moved in it.
+ *             separation - The solver used to push overlapping players apart.
+ *             kinematics - Where all the players in the game are moving to.
  *             disc - The disc object in use during the game.
  */
-void detect_and_handle_collisions(TEAM **teams,
-                                  int players_per_team,
+void detect_and_handle_collisions(COLLISION_GRID *grid,
+                                  PLAYER_SEPARATION *separation,
+                                  PLAYER_KINEMATICS *kinematics,
                                   DISC *disc)
 {
   /*
-   * Local Variables.
+   * Put the players where they are moving to in the broadphase grid.
    */
-  int ii;
+  update_collision_grid_players(grid, kinematics);
 
   /*
    * Player player collisions detected and handled first.
    */
-  detect_player_player_collisions(teams, players_per_team);
+  detect_player_player_collisions(grid,
+                                  separation,
+                                  kinematics->num_players);
+  handle_player_player_collisions(grid, separation, kinematics);
 
   /*
    * Once player player collisions all resolved do disc player collisions.
    */
-  handle_player_disc_collisions(teams, players_per_team, disc);
+  handle_player_disc_collisions(grid, kinematics, disc);
 
   /*
    * Commit the new positions as they have now been resolved to avoid
    * conflicts.
    */
-  for (ii = 0; ii < players_per_team; ii++)
-  {
-    complete_player_coords_update(teams[0]->players[ii]);
-    complete_player_coords_update(teams[1]->players[ii]);
-  }
+  complete_player_kinematics_update(kinematics);
+  vector_copy_values(&(disc->previous_position), &(disc->position));
   vector_copy_values(&(disc->position), &(disc->new_position));
 }
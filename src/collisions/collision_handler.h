@@ -8,7 +8,12 @@
 #ifndef COLLISION_HANDLER_H_
 #define COLLISION_HANDLER_H_
 
-struct team;
+#include <stdbool.h>
+#include "../data_structures/vector.h"
+
+struct collision_grid;
+struct player_separation;
+struct player_kinematics;
 struct disc;
 
 /*
@@ -17,6 +22,38 @@ struct disc;
  */
 #define DISTANCE_TO_INTERACT 0.1
 
-void detect_and_handle_collisions(struct team **, int, struct disc *);
+/*
+ * The number of players tested against the disc together by
+ * calculate_swept_box_times_of_impact.
+ */
+#define COLLISION_BATCH_SIZE 16
+
+/*
+ * The time of impact given for boxes which never touch. Times of impact are
+ * fractions of a move so this is more than any real one.
+ */
+#define COLLISION_NO_IMPACT 2.0f
+
+void calculate_swept_box_times_of_impact(VECTOR3 *,
+                                         VECTOR3 *,
+                                         VECTOR3 *,
+                                         int,
+                                         float *,
+                                         float *,
+                                         float *,
+                                         float *,
+                                         float *,
+                                         float *,
+                                         float *);
+bool calculate_swept_box_time_of_impact(VECTOR3 *,
+                                        VECTOR3 *,
+                                        VECTOR3 *,
+                                        VECTOR3 *,
+                                        VECTOR3 *,
+                                        float *);
+void detect_and_handle_collisions(struct collision_grid *,
+                                  struct player_separation *,
+                                  struct player_kinematics *,
+                                  struct disc *);
 
 #endif /* COLLISION_HANDLER_H_ */
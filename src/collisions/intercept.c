@@ -7,12 +7,26 @@
 
 #include "../dt_logger.h"
 
+#include <math.h>
 #include "intercept.h"
 #include "../conversion_constants.h"
 #include "../data_structures/vector.h"
 #include "../disc_path.h"
 #include "../player.h"
 
+/*
+ * Returned by find_segment_intercept_time when there is no intercept. Path
+ * times are never negative.
+ */
+#define INTERCEPT_SEGMENT_NONE -1.0f
+
+/*
+ * The VS2010 C compiler only knows inline as __inline.
+ */
+#ifdef _MSC_VER
+#define inline __inline
+#endif
+
 /*
  * create_intercept
  *
@@ -57,92 +71,702 @@ void destroy_intercept(INTERCEPT *intercept)
   DT_FREE(intercept);
 }
 
+/*
+ * find_segment_intercept_time
+ *
+ * INTERNAL: Finds the earliest time at which a player can meet the disc on
+ * one segment of the disc path. The disc is taken to move in a straight line
+ * at a constant speed between the two ends of the segment, as for
+ * DISC_POS_CALC_INTERPOLATE, and the player can be anywhere within
+ * max_speed * (t - current_time) of where they are now at time t. So the
+ * player meets the disc at the first time u after the start of the segment
+ * for which
+ *
+ *   |start + w * u - player|^2 - max_speed^2 * (u + start_t - current_time)^2
+ *
+ * is <= 0, where w is the velocity of the disc along the segment. That is a
+ * quadratic in u and is solved exactly so the result doesn't depend on how
+ * far apart the ends of the segment are. u is limited to times after
+ * current_time and to the part of the segment below the player's height.
+ *
+ * There are no branches, only selects, and the segment is passed in as
+ * numbers rather than as DISC_POSITIONs, so that this can be vectorised once
+ * it is inlined into the loop over players in calculate_intercept_batch. The
+ * roots are found with the form of the quadratic formula which is stable when
+ * the disc and player speeds are the same (no u^2 term).
+ *
+ * Parameters: pos_x, pos_y - Where the player is.
+ *             max_speed - The player's top speed.
+ *             height - How high the player can reach.
+ *             current_time - The time along the path now.
+ *             start_x, start_y, start_z, start_t - The start of the segment.
+ *             end_x, end_y, end_z, end_t - The end of the segment.
+ *
+ * Returns: The time along the path of the intercept, or
+ *          INTERCEPT_SEGMENT_NONE if the player can't meet the disc on this
+ *          segment.
+ */
+static inline float find_segment_intercept_time(float pos_x,
+                                                float pos_y,
+                                                float max_speed,
+                                                float height,
+                                                float current_time,
+                                                float start_x,
+                                                float start_y,
+                                                float start_z,
+                                                float start_t,
+                                                float end_x,
+                                                float end_y,
+                                                float end_z,
+                                                float end_t)
+{
+  /*
+   * Local Variables.
+   */
+  float duration = end_t - start_t;
+  float w_x = (end_x - start_x) / duration;
+  float w_y = (end_y - start_y) / duration;
+  float w_z = (end_z - start_z) / duration;
+  float q_x = start_x - pos_x;
+  float q_y = start_y - pos_y;
+  float head_start = start_t - current_time;
+  float speed_sqrd = max_speed * max_speed;
+  float a = w_x * w_x + w_y * w_y - speed_sqrd;
+  float b = 2.0f * (q_x * w_x + q_y * w_y - speed_sqrd * head_start);
+  float c = q_x * q_x + q_y * q_y - speed_sqrd * head_start * head_start;
+  float u_min = (head_start < 0.0f) ? -head_start : 0.0f;
+  float u_max = duration;
+  float u_height = (height - start_z) / w_z;
+  float discriminant;
+  float root_term;
+  float q;
+  float root_1;
+  float root_2;
+  float root;
+  float f_at_min;
+  int hit;
+
+  /*
+   * Only the part of the segment below the player's height counts.
+   */
+  u_min = ((w_z < 0.0f) && (u_height > u_min)) ? u_height : u_min;
+  u_max = ((w_z > 0.0f) && (u_height < u_max)) ? u_height : u_max;
+  u_max = ((w_z == 0.0f) && (start_z > height)) ? -1.0f : u_max;
+
+  /*
+   * Either the player can already get to the disc at the start of the allowed
+   * part of the segment or they first get there at the smallest root after it.
+   */
+  f_at_min = (a * u_min + b) * u_min + c;
+  discriminant = b * b - 4.0f * a * c;
+  root_term = sqrtf((discriminant > 0.0f) ? discriminant : 0.0f);
+  q = -0.5f * (b + ((b < 0.0f) ? -root_term : root_term));
+  root_1 = q / a;
+  root_2 = c / q;
+  root = (root_1 < root_2) ? root_1 : root_2;
+  root = (root > u_min) ? root : ((root_1 < root_2) ? root_2 : root_1);
+
+  hit = (u_min <= u_max) &
+        ((f_at_min <= 0.0f) |
+         ((discriminant >= 0.0f) & (root > u_min) & (root <= u_max)));
+  root = (f_at_min <= 0.0f) ? u_min : root;
+
+  return(hit ? start_t + root : INTERCEPT_SEGMENT_NONE);
+}
+
+/*
+ * fill_player_intercept
+ *
+ * INTERNAL: Fills in an intercept once the time at which a player first
+ * meets the disc has been found.
+ *
+ * Parameters: intercept - The intercept to fill in.
+ *             player - The player.
+ *             start - The start of the path segment containing the intercept.
+ *             end - The end of the path segment containing the intercept.
+ *             intercept_time - The time along the path of the intercept.
+ */
+void fill_player_intercept(INTERCEPT *intercept,
+                           PLAYER *player,
+                           DISC_POSITION *start,
+                           DISC_POSITION *end,
+                           float intercept_time)
+{
+  /*
+   * Local Variables.
+   */
+  VECTOR3 position = get_player_position(player);
+  float x_diff;
+  float y_diff;
+
+  intercept->object_a = NULL;
+  intercept->object_b = &(end->position);
+  intercept->intercept = vector_interpolate(&(start->position),
+                                            &(end->position),
+                                            (intercept_time - start->t) /
+                                                          (end->t - start->t));
+  x_diff = intercept->intercept.x - position.x;
+  y_diff = intercept->intercept.y - position.y;
+  intercept->t = sqrtf(x_diff * x_diff + y_diff * y_diff) / player->max_speed;
+}
+
+/*
+ * find_first_view_position_after
+ *
+ * INTERNAL: Binary search for the first position in a view at or after a
+ * given time.
+ *
+ * Parameters: disc_path_view - The view to search.
+ *             first - The first index to consider.
+ *             last - One past the last index to consider.
+ *             t - The time along the path.
+ *
+ * Returns: The smallest index in [first, last) whose t is >= the time passed
+ *          in, or last if there isn't one.
+ */
+int find_first_view_position_after(DISC_PATH_VIEW *disc_path_view,
+                                   int first,
+                                   int last,
+                                   float t)
+{
+  /*
+   * Local Variables.
+   */
+  int middle;
+
+  while (first < last)
+  {
+    middle = first + (last - first) / 2;
+    if (get_disc_path_view_position(disc_path_view, middle)->t < t)
+    {
+      first = middle + 1;
+    }
+    else
+    {
+      last = middle;
+    }
+  }
+
+  return(first);
+}
+
+/*
+ * find_first_path_position_after
+ *
+ * INTERNAL: Binary search for the first position in a disc path at or after a
+ * given time.
+ *
+ * Parameters: positions - The positions of the path.
+ *             first - The first index to consider.
+ *             last - One past the last index to consider.
+ *             t - The time along the path.
+ *
+ * Returns: The smallest index in [first, last) whose t is >= the time passed
+ *          in, or last if there isn't one.
+ */
+int find_first_path_position_after(DISC_POSITION *positions,
+                                   int first,
+                                   int last,
+                                   float t)
+{
+  /*
+   * Local Variables.
+   */
+  int middle;
+
+  while (first < last)
+  {
+    middle = first + (last - first) / 2;
+    if (positions[middle].t < t)
+    {
+      first = middle + 1;
+    }
+    else
+    {
+      last = middle;
+    }
+  }
+
+  return(first);
+}
+
 /*
  * calculate_player_disc_path_intercept
  *
- * Takes a player and a disc path and calculates when the player can first
- * intercept the disc if they are running at 100% for the whole time.
+ * Takes a player and a view onto a disc path and calculates when the player
+ * can first intercept the disc if they are running at 100% for the whole time.
+ *
+ * The disc is taken to fly in a straight line between each position in the
+ * view and the earliest intercept on each of those segments is solved for
+ * exactly (see find_segment_intercept_time). So the intercept can be anywhere
+ * along the path, not just at one of its positions, and a coarse view gives
+ * as good an intercept as a fine one for a path that is close to straight.
  *
- * All times are done in seconds from the current time in this function.
+ * With intercept_search_bracket not every segment is solved. If the player
+ * is a gap g short of the disc at the end of a segment then, as the gap can
+ * close no faster than the player's speed plus the disc's fastest ground
+ * speed, no segment ending within g / (the sum of those) of it can be reached
+ * either. Height only ever rules segments out so it is ignored here. The
+ * segments which are skipped are exactly ones which the linear search would
+ * have found no intercept on, so the result is the same.
  *
  * Parameters: player
- *             disc_path
+ *             disc_path_view - Normally the view for the player's skill level.
+ *             now - The time now in ms, on the clock that the path was
+ *                   created on (see get_disc_path_elapsed_time). The same
+ *                   path, player and time always give the same intercept.
+ *             search - How to look for the intercept.
  *             intercept - Will be returned containing the intercept vectors.
- *                         Should already have been created.
+ *                         Should already have been created. object_b is the
+ *                         end of the path segment containing the intercept.
+ *
+ * The disc path may still be being calculated in which case only the part
+ * that has been published so far is searched.
  *
- * Returns: True if the player can intercept the disc at some point along the
- *          path and false otherwise.
+ * Returns: INTERCEPT_CALC_FOUND if the player can intercept the disc at some
+ *          point along the path, INTERCEPT_CALC_NONE if they can't and
+ *          INTERCEPT_CALC_PATH_INCOMPLETE if they can't intercept any of the
+ *          path known so far.
  */
-bool calculate_player_disc_path_intercept(PLAYER *player,
-                                          DISC_PATH *disc_path,
-                                          INTERCEPT *intercept)
+int calculate_player_disc_path_intercept(PLAYER *player,
+                                         DISC_PATH_VIEW *disc_path_view,
+                                         Uint32 now,
+                                         INTERCEPT_SEARCH search,
+                                         INTERCEPT *intercept)
 {
   /*
    * Local Variables.
    */
-  float landing_time = disc_path->end_position->t;
-  float max_player_travel_dist;
-  float current_time = SDL_GetTicks() / MILLISECONDS_PER_SECOND;
-  DISC_POSITION *disc_position;
-  float distance;
-  bool found_intercept = false;
-  float time_to_reach = 0.0;
+  VECTOR3 position = get_player_position(player);
+  float current_time;
+  float closing_speed;
+  DISC_POSITION *start = NULL;
+  DISC_POSITION *end = NULL;
+  float intercept_time = INTERCEPT_SEGMENT_NONE;
+  float x_diff;
+  float y_diff;
+  float gap;
+  int ret_code = INTERCEPT_CALC_NONE;
+  bool path_complete;
+  int num_positions;
+  int ii;
 
   /*
-   * Calculate the maximum distance that the player can travel between now and
-   * the time at which the disc lands.
+   * Take a snapshot of how much of the path can be read. Anything beyond this
+   * may still be being written by the disc path thread. The ground speed is
+   * read afterwards so that it covers at least this much of the path.
    */
-  max_player_travel_dist = player->max_speed * (landing_time - current_time);
+  path_complete = get_disc_path_view_progress(disc_path_view, &num_positions);
+  current_time = get_disc_path_elapsed_time(disc_path_view->master, now);
+  closing_speed = player->max_speed +
+                  get_disc_path_max_ground_speed(disc_path_view->master);
 
   /*
-   * For each point along the disc path decide whether it is inside that radius,
-   * whether the player can reach the disc at that point and whether they will
-   * arrive there in time to get it. The first along the path for which all
-   * these are true for is the first intercept point.
+   * The first segment on which the player can meet the disc holds the
+   * intercept. Segments which the disc has already flown past are skipped.
    */
-  disc_position = disc_path->start_position;
-  while(NULL != disc_position)
+  ii = 1;
+  if (intercept_search_bracket == search)
+  {
+    ii = find_first_view_position_after(disc_path_view,
+                                        ii,
+                                        num_positions,
+                                        current_time);
+  }
+
+  while (ii < num_positions)
   {
+    end = get_disc_path_view_position(disc_path_view, ii);
+    if (end->t < current_time)
+    {
+      ii++;
+      continue;
+    }
+    start = get_disc_path_view_position(disc_path_view, ii - 1);
+
+    intercept_time = find_segment_intercept_time(position.x,
+                                                 position.y,
+                                                 player->max_speed,
+                                                 player->height,
+                                                 current_time,
+                                                 start->position.x,
+                                                 start->position.y,
+                                                 start->position.z,
+                                                 start->t,
+                                                 end->position.x,
+                                                 end->position.y,
+                                                 end->position.z,
+                                                 end->t);
+    if (INTERCEPT_SEGMENT_NONE != intercept_time)
+    {
+      ret_code = INTERCEPT_CALC_FOUND;
+      break;
+    }
+
     /*
-     * Calculate the distance between the player position and the disc position
-     * as two vectors projected down onto R2.
+     * Work out how far out of reach the disc is at the end of this segment
+     * and jump past every segment ending before the gap could be closed.
      */
-    distance = dist_between_vectors_2d(&(player->position),
-                                       &(disc_position->position));
+    ii++;
+    if (intercept_search_bracket == search)
+    {
+      x_diff = end->position.x - position.x;
+      y_diff = end->position.y - position.y;
+      gap = sqrtf(x_diff * x_diff + y_diff * y_diff) -
+            player->max_speed * (end->t - current_time);
+      if (gap > 0.0f)
+      {
+        ii = find_first_view_position_after(disc_path_view,
+                                            ii,
+                                            num_positions,
+                                            end->t + INTERCEPT_BRACKET_SAFETY *
+                                                     gap / closing_speed);
+      }
+    }
+  }
+
+  /*
+   * There is no guarantee that we found an intercept point. If we did then
+   * fill it in here.
+   */
+  if (INTERCEPT_CALC_FOUND == ret_code)
+  {
+    fill_player_intercept(intercept, player, start, end, intercept_time);
+  }
+  else if (!path_complete)
+  {
+    ret_code = INTERCEPT_CALC_PATH_INCOMPLETE;
+  }
+
+  return(ret_code);
+}
+
+/*
+ * calculate_intercept_batch
+ *
+ * INTERNAL: Does calculate_players_disc_path_intercepts for up to
+ * INTERCEPT_BATCH_SIZE players.
+ *
+ * The players are held as a structure of arrays, including the start of the
+ * segment that each player is on, so that the end of that segment is the
+ * only thing read from the path for each position. The loop which solves for
+ * the intercepts and the one which moves each player on to their next
+ * segment have no branches and only select with ints and 0/1 weights, and
+ * gcc vectorises both of them with the flags in the generated make file. The
+ * set up and the jumps stay scalar. Every player is solved for at every
+ * position, and those whose segment doesn't end there ignore the result.
+ *
+ * Each player only looks at the positions in the view for their skill level:
+ * next_node holds the master position at the end of their next segment and
+ * steps on by their stride each time it is passed, and prev_node holds the
+ * start of that segment. As in the view, the last position of a complete path
+ * always ends a segment.
+ *
+ * With intercept_search_bracket each player also keeps the earliest time at
+ * which the disc could next be reached (reach_time), worked out from each
+ * segment they miss as in calculate_player_disc_path_intercept. Once every
+ * player still looking has missed a segment the pass jumps straight to the
+ * earliest of those times and each player picks up again from the segment of
+ * their view which ends there. Every segment skipped is one that no player
+ * still looking could reach, so the results are the same as without the
+ * jumps.
+ *
+ * Parameters: As calculate_players_disc_path_intercepts.
+ */
+void calculate_intercept_batch(PLAYER **players,
+                               int num_players,
+                               DISC_PATH *disc_path,
+                               Uint32 now,
+                               INTERCEPT_SEARCH search,
+                               INTERCEPT *intercepts,
+                               int *ret_codes)
+{
+  /*
+   * Local Variables.
+   */
+  float pos_x[INTERCEPT_BATCH_SIZE];
+  float pos_y[INTERCEPT_BATCH_SIZE];
+  float max_speed[INTERCEPT_BATCH_SIZE];
+  float height[INTERCEPT_BATCH_SIZE];
+  int stride[INTERCEPT_BATCH_SIZE];
+  int next_node[INTERCEPT_BATCH_SIZE];
+  int prev_node[INTERCEPT_BATCH_SIZE];
+  int found_start[INTERCEPT_BATCH_SIZE];
+  int found_node[INTERCEPT_BATCH_SIZE];
+  float found_time[INTERCEPT_BATCH_SIZE];
+  float reach_time[INTERCEPT_BATCH_SIZE];
+  int done[INTERCEPT_BATCH_SIZE];
+  float start_x[INTERCEPT_BATCH_SIZE];
+  float start_y[INTERCEPT_BATCH_SIZE];
+  float start_z[INTERCEPT_BATCH_SIZE];
+  float start_t[INTERCEPT_BATCH_SIZE];
+  DISC_POSITION *positions = disc_path->positions;
+  DISC_PATH_VIEW *view;
+  VECTOR3 position;
+  float current_time;
+  float ground_speed;
+  float intercept_time;
+  float x_diff;
+  float y_diff;
+  float gap;
+  float jump_time;
+  float end_x;
+  float end_y;
+  float end_z;
+  float end_t;
+  float weight;
+  int on_view;
+  int at_last_node;
+  int missed;
+  int jump_node;
+  int start_node;
+  int hit;
+  int num_done;
+  int num_positions;
+  int first_node;
+  int last_node;
+  bool path_complete;
+  int ii;
+  int node;
+
+  /*
+   * The ground speed is read after the progress so that it covers at least
+   * the part of the path that is searched.
+   */
+  path_complete = get_disc_path_progress(disc_path, &num_positions);
+  current_time = get_disc_path_elapsed_time(disc_path, now);
+  ground_speed = get_disc_path_max_ground_speed(disc_path);
+
+  /*
+   * Segments which end before now can't be intercepted so start from the
+   * first position the disc hasn't reached yet.
+   */
+  first_node = find_first_path_position_after(positions,
+                                              0,
+                                              num_positions,
+                                              current_time);
 
-    if (distance <= max_player_travel_dist)
+  /*
+   * Unused entries start off done so that they don't hold up the early exit.
+   * Each player's first segment is the one that ends at or after first_node.
+   */
+  for (ii = 0; ii < INTERCEPT_BATCH_SIZE; ii++)
+  {
+    if (ii < num_players)
     {
+      view = get_disc_path_view(disc_path, players[ii]->disc_reading_skill);
+      position = get_player_position(players[ii]);
+      pos_x[ii] = position.x;
+      pos_y[ii] = position.y;
+      max_speed[ii] = players[ii]->max_speed;
+      height[ii] = players[ii]->height;
+      stride[ii] = view->stride;
+      done[ii] = 0;
+    }
+    else
+    {
+      pos_x[ii] = 0.0f;
+      pos_y[ii] = 0.0f;
+      max_speed[ii] = 1.0f;
+      height[ii] = 0.0f;
+      stride[ii] = 1;
+      done[ii] = 1;
+    }
+    next_node[ii] = ((first_node + stride[ii] - 1) / stride[ii]) * stride[ii];
+    if (next_node[ii] < stride[ii])
+    {
+      next_node[ii] = stride[ii];
+    }
+    prev_node[ii] = next_node[ii] - stride[ii];
+    start_node = (prev_node[ii] < num_positions) ? prev_node[ii] : 0;
+    start_x[ii] = positions[start_node].position.x;
+    start_y[ii] = positions[start_node].position.y;
+    start_z[ii] = positions[start_node].position.z;
+    start_t[ii] = positions[start_node].t;
+    found_start[ii] = -1;
+    found_node[ii] = -1;
+    found_time[ii] = INTERCEPT_SEGMENT_NONE;
+    reach_time[ii] = current_time;
+  }
+
+  /*
+   * One pass along the path testing every player against the segment ending
+   * at each position. No player's first segment ends before first_node.
+   */
+  last_node = path_complete ? num_positions - 1 : -1;
+  num_done = INTERCEPT_BATCH_SIZE - num_players;
+  for (node = (first_node > 1) ? first_node : 1;
+       (node < num_positions) && (num_done < INTERCEPT_BATCH_SIZE);
+       node++)
+  {
+    num_done = 0;
+    end_x = positions[node].position.x;
+    end_y = positions[node].position.y;
+    end_z = positions[node].position.z;
+    end_t = positions[node].t;
+    at_last_node = (node == last_node) ? 1 : 0;
+
+    for (ii = 0; ii < INTERCEPT_BATCH_SIZE; ii++)
+    {
+      on_view = ((node == next_node[ii]) ? 1 : 0) | at_last_node;
+      intercept_time = find_segment_intercept_time(pos_x[ii],
+                                                   pos_y[ii],
+                                                   max_speed[ii],
+                                                   height[ii],
+                                                   current_time,
+                                                   start_x[ii],
+                                                   start_y[ii],
+                                                   start_z[ii],
+                                                   start_t[ii],
+                                                   end_x,
+                                                   end_y,
+                                                   end_z,
+                                                   end_t);
+      hit = on_view & (1 - done[ii]) &
+            ((INTERCEPT_SEGMENT_NONE != intercept_time) ? 1 : 0);
+      found_start[ii] = hit ? prev_node[ii] : found_start[ii];
+      found_node[ii] = hit ? node : found_node[ii];
+      found_time[ii] = hit ? intercept_time : found_time[ii];
+      done[ii] |= hit;
+
       /*
-       * Check that the player can reach the disc at that point.
+       * How far out of reach the disc is at the end of a segment that was
+       * missed, and so when it could next be reached.
        */
-      if (player->height >= disc_position->position.z)
+      x_diff = end_x - pos_x[ii];
+      y_diff = end_y - pos_y[ii];
+      gap = sqrtf(x_diff * x_diff + y_diff * y_diff) -
+            max_speed[ii] * (end_t - current_time);
+      gap = (gap > 0.0f) ? gap : 0.0f;
+      missed = on_view & (1 - done[ii]);
+      reach_time[ii] = missed ? end_t + INTERCEPT_BRACKET_SAFETY *
+                                gap / (max_speed[ii] + ground_speed) :
+                                reach_time[ii];
+    }
+
+    /*
+     * Players whose segment ended here start their next one here. A weight
+     * of 1 or 0 picks end or start exactly as neither is ever infinite.
+     */
+    for (ii = 0; ii < INTERCEPT_BATCH_SIZE; ii++)
+    {
+      num_done += done[ii];
+      on_view = ((node == next_node[ii]) ? 1 : 0) | at_last_node;
+      next_node[ii] += ((node == next_node[ii]) ? 1 : 0) * stride[ii];
+      prev_node[ii] += on_view * (node - prev_node[ii]);
+      weight = (float)on_view;
+      start_x[ii] = weight * end_x + (1.0f - weight) * start_x[ii];
+      start_y[ii] = weight * end_y + (1.0f - weight) * start_y[ii];
+      start_z[ii] = weight * end_z + (1.0f - weight) * start_z[ii];
+      start_t[ii] = weight * end_t + (1.0f - weight) * start_t[ii];
+    }
+
+    /*
+     * Jump to the earliest time that any player still looking could reach
+     * the disc and line every player up with the segment of their view
+     * ending there.
+     */
+    if (intercept_search_bracket == search)
+    {
+      jump_time = positions[num_positions - 1].t;
+      for (ii = 0; ii < INTERCEPT_BATCH_SIZE; ii++)
       {
-        /*
-         * Calculate when the player will reach that point. If it is before the
-         * disc then we have found an intercept point.
-         */
-        time_to_reach = distance / player->max_speed;
-        if (time_to_reach <= disc_position->t)
+        if ((!done[ii]) && (reach_time[ii] < jump_time))
         {
-          found_intercept = true;
-          break;
+          jump_time = reach_time[ii];
         }
       }
+      jump_node = find_first_path_position_after(positions,
+                                                 node + 1,
+                                                 num_positions,
+                                                 jump_time);
+      if (jump_node > node + 1)
+      {
+        for (ii = 0; ii < INTERCEPT_BATCH_SIZE; ii++)
+        {
+          next_node[ii] = ((jump_node + stride[ii] - 1) / stride[ii]) *
+                          stride[ii];
+          prev_node[ii] = next_node[ii] - stride[ii];
+          start_x[ii] = positions[prev_node[ii]].position.x;
+          start_y[ii] = positions[prev_node[ii]].position.y;
+          start_z[ii] = positions[prev_node[ii]].position.z;
+          start_t[ii] = positions[prev_node[ii]].t;
+        }
+        node = jump_node - 1;
+      }
     }
-
-    disc_position = disc_position->next;
   }
 
+  for (ii = 0; ii < num_players; ii++)
+  {
+    if (found_node[ii] >= 0)
+    {
+      fill_player_intercept(&(intercepts[ii]),
+                            players[ii],
+                            &(positions[found_start[ii]]),
+                            &(positions[found_node[ii]]),
+                            found_time[ii]);
+      ret_codes[ii] = INTERCEPT_CALC_FOUND;
+    }
+    else if (!path_complete)
+    {
+      ret_codes[ii] = INTERCEPT_CALC_PATH_INCOMPLETE;
+    }
+    else
+    {
+      ret_codes[ii] = INTERCEPT_CALC_NONE;
+    }
+  }
+}
+/*
+ * calculate_players_disc_path_intercepts
+ *
+ * Does calculate_player_disc_path_intercept for a set of players, each using
+ * the view of the path for their own skill level, and gives exactly the same
+ * results. Rather than walking the path once per player this walks it once
+ * for every INTERCEPT_BATCH_SIZE players, testing them all at each position,
+ * and stops as soon as they have all found an intercept. The cost therefore
+ * depends on how far along the path the last intercept is rather than on the
+ * number of players.
+ *
+ * Parameters: players - The players.
+ *             num_players - The number of players.
+ *             disc_path - The path.
+ *             now - As calculate_player_disc_path_intercept.
+ *             search - How to look for the intercepts.
+ *             intercepts - Array of num_players intercepts. Entry ii is filled
+ *                          in if players[ii] can intercept the disc.
+ *             ret_codes - Array of num_players. Entry ii is set to the return
+ *                         code of calculate_player_disc_path_intercept for
+ *                         players[ii].
+ */
+void calculate_players_disc_path_intercepts(PLAYER **players,
+                                            int num_players,
+                                            DISC_PATH *disc_path,
+                                            Uint32 now,
+                                            INTERCEPT_SEARCH search,
+                                            INTERCEPT *intercepts,
+                                            int *ret_codes)
+{
   /*
-   * There is no guarantee that we found an intercept point. If we did then
-   * fill it in here.
+   * Local Variables.
    */
-  if (found_intercept)
+  int batch_size;
+  int ii;
+
+  for (ii = 0; ii < num_players; ii += INTERCEPT_BATCH_SIZE)
   {
-    intercept->object_a = &(player->position);
-    intercept->object_b = &(disc_position->position);
-    intercept->t = time_to_reach;
+    batch_size = num_players - ii;
+    if (batch_size > INTERCEPT_BATCH_SIZE)
+    {
+      batch_size = INTERCEPT_BATCH_SIZE;
+    }
+    calculate_intercept_batch(&(players[ii]),
+                              batch_size,
+                              disc_path,
+                              now,
+                              search,
+                              &(intercepts[ii]),
+                              &(ret_codes[ii]));
   }
-
-  return(found_intercept);
 }
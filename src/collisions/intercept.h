@@ -8,21 +8,78 @@
 #ifndef INTERCEPT_H_
 #define INTERCEPT_H_
 
+#include "SDL/SDL.h"
 #include "../data_structures/vector.h"
 
 struct player;
 struct disc_path;
+struct disc_path_view;
+
+/*
+ * Return codes from calculate_player_disc_path_intercept.
+ *
+ * INTERCEPT_CALC_FOUND - The intercept has been filled in.
+ * INTERCEPT_CALC_NONE - The player cannot intercept the disc anywhere along
+ *                       the path.
+ * INTERCEPT_CALC_PATH_INCOMPLETE - The player cannot intercept the part of the
+ *                                  path calculated so far but the rest of the
+ *                                  path is still being worked out. Try again
+ *                                  later.
+ */
+#define INTERCEPT_CALC_FOUND 0
+#define INTERCEPT_CALC_NONE 1
+#define INTERCEPT_CALC_PATH_INCOMPLETE 2
+
+/*
+ * The number of players tested together by
+ * calculate_players_disc_path_intercepts. Larger numbers of players are done
+ * in groups of this size. Build with -DINTERCEPT_BATCH_SIZE=8 etc. to match
+ * the vector width of the target machine.
+ */
+#ifndef INTERCEPT_BATCH_SIZE
+#define INTERCEPT_BATCH_SIZE 16
+#endif
+
+/*
+ * INTERCEPT_SEARCH
+ *
+ * How calculate_player_disc_path_intercept and
+ * calculate_players_disc_path_intercepts find the first segment of the path
+ * on which the player can meet the disc. Both give exactly the same
+ * intercept.
+ *
+ * intercept_search_linear - Every segment from now onwards is solved in turn.
+ * intercept_search_bracket - After each segment that can't be reached the
+ *                            search jumps (by binary search) to the first
+ *                            segment that could possibly be reached, given
+ *                            how far out of reach the disc is and how fast
+ *                            the disc and player can close that gap. Much
+ *                            quicker when the intercept is far along the
+ *                            path.
+ */
+typedef enum intercept_search
+{
+  intercept_search_linear,
+  intercept_search_bracket
+} INTERCEPT_SEARCH;
+
+/*
+ * The jump made by intercept_search_bracket is shortened by this fraction so
+ * that rounding errors can't carry it past the first reachable segment.
+ */
+#define INTERCEPT_BRACKET_SAFETY 0.99f
 
 /*
  * INTERCEPT
  *
  * Contains information on the intercept of two objects.
  *
- * object_a - The first object's position.
+ * object_a - The first object's position. NULL where the first object is a
+ *            player, as their position is held in the kinematics store.
  * object_b - The second object's position.
  * intercept - The location of the intercept (one must exist for this to be
  *             created).
- * t - The time at which the intercept occurs in fractional s.
+ * t - The time from now at which the intercept occurs in fractional s.
  */
 typedef struct intercept
 {
@@ -34,8 +91,17 @@ typedef struct intercept
 
 INTERCEPT *create_intercept();
 void destroy_intercept(INTERCEPT *);
-bool calculate_player_disc_path_intercept(struct player *,
-                                          struct disc_path *,
-                                          INTERCEPT *);
+int calculate_player_disc_path_intercept(struct player *,
+                                         struct disc_path_view *,
+                                         Uint32,
+                                         INTERCEPT_SEARCH,
+                                         INTERCEPT *);
+void calculate_players_disc_path_intercepts(struct player **,
+                                            int,
+                                            struct disc_path *,
+                                            Uint32,
+                                            INTERCEPT_SEARCH,
+                                            INTERCEPT *,
+                                            int *);
 
 #endif /* INTERCEPT_H_ */
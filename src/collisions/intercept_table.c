@@ -0,0 +1,240 @@
+/*
+ * intercept_table.c
+ *
+ *  Created on: 16 Oct 2026
+ *      Author: David Tyler
+ */
+
+#include "../dt_logger.h"
+
+#include <math.h>
+#include "intercept_table.h"
+#include "intercept.h"
+#include "../disc_path.h"
+#include "../player.h"
+#include "../team.h"
+
+/*
+ * create_intercept_table
+ *
+ * Allocates an empty intercept table.
+ *
+ * Parameters: max_players - The number of players that the table can hold.
+ *
+ * Returns: A pointer to the newly created memory.
+ */
+INTERCEPT_TABLE *create_intercept_table(int max_players)
+{
+  /*
+   * Local Variables.
+   */
+  INTERCEPT_TABLE *table;
+
+  table = (INTERCEPT_TABLE *) DT_MALLOC(sizeof(INTERCEPT_TABLE));
+  table->max_players = max_players;
+  table->max_speeds = (float *) DT_MALLOC(sizeof(float) * max_players);
+  table->skills = (int *) DT_MALLOC(sizeof(int) * max_players);
+  table->intercepts = (INTERCEPT *) DT_MALLOC(sizeof(INTERCEPT) * max_players);
+  table->ret_codes = (int *) DT_MALLOC(sizeof(int) * max_players);
+  table->changed_players = (PLAYER **) DT_MALLOC(sizeof(PLAYER *) *
+                                                 max_players);
+  table->changed_indexes = (int *) DT_MALLOC(sizeof(int) * max_players);
+  table->changed_intercepts = (INTERCEPT *) DT_MALLOC(sizeof(INTERCEPT) *
+                                                      max_players);
+  table->changed_ret_codes = (int *) DT_MALLOC(sizeof(int) * max_players);
+  invalidate_intercept_table(table);
+
+  return(table);
+}
+
+/*
+ * destroy_intercept_table
+ *
+ * Frees the memory used by the passed in object.
+ *
+ * Parameters: table - The object to be freed.
+ */
+void destroy_intercept_table(INTERCEPT_TABLE *table)
+{
+  DT_FREE(table->changed_ret_codes);
+  DT_FREE(table->changed_intercepts);
+  DT_FREE(table->changed_indexes);
+  DT_FREE(table->changed_players);
+  DT_FREE(table->ret_codes);
+  DT_FREE(table->intercepts);
+  DT_FREE(table->skills);
+  DT_FREE(table->max_speeds);
+  DT_FREE(table);
+}
+
+/*
+ * invalidate_intercept_table
+ *
+ * Throws away every entry so that they are all calculated again on the next
+ * update.
+ *
+ * Parameters: table - The table to clear.
+ */
+void invalidate_intercept_table(INTERCEPT_TABLE *table)
+{
+  table->disc_path = NULL;
+  table->path_time_created = 0;
+  table->path_num_positions = 0;
+  table->path_complete = false;
+  table->num_players = 0;
+}
+
+/*
+ * update_intercept_table
+ *
+ * Brings the table up to date with the disc path and players. This is cheap
+ * when nothing has changed so may be called by every reader before it reads.
+ *
+ * If the path is a different throw or more of it has been calculated then
+ * every entry is calculated again. Otherwise only the players whose speed or
+ * disc reading skill has changed are. Either way all the players needing an
+ * update are done together by calculate_players_disc_path_intercepts.
+ *
+ * Parameters: table - The table to update.
+ *             teams - Every team.
+ *             num_teams - The number of teams.
+ *             players_per_team - The number of players on each team.
+ *             disc_path - The current disc path. May be NULL if there has not
+ *                         been a throw yet.
+ *             now - The time now, as for calculate_player_disc_path_intercept.
+ *                   Only used for the entries that are worked out again.
+ */
+void update_intercept_table(INTERCEPT_TABLE *table,
+                            TEAM **teams,
+                            int num_teams,
+                            int players_per_team,
+                            DISC_PATH *disc_path,
+                            Uint32 now)
+{
+  /*
+   * Local Variables.
+   */
+  PLAYER **players = table->changed_players;
+  int *indexes = table->changed_indexes;
+  INTERCEPT *intercepts = table->changed_intercepts;
+  int *ret_codes = table->changed_ret_codes;
+  PLAYER *player;
+  bool path_changed;
+  bool path_complete;
+  int num_positions;
+  int num_players = num_teams * players_per_team;
+  int num_changed = 0;
+  int index;
+  int ii;
+
+  DT_ASSERT(num_players <= table->max_players);
+
+  if (NULL == disc_path)
+  {
+    invalidate_intercept_table(table);
+    goto EXIT_LABEL;
+  }
+
+  path_complete = get_disc_path_progress(disc_path, &num_positions);
+  path_changed = (table->disc_path != disc_path) ||
+                 (table->path_time_created != disc_path->time_created) ||
+                 (table->path_num_positions != num_positions) ||
+                 (table->path_complete != path_complete) ||
+                 (table->num_players != num_players);
+
+  /*
+   * Find the players whose entries are out of date.
+   */
+  for (index = 0; index < num_players; index++)
+  {
+    player = teams[index / players_per_team]->players[index % players_per_team];
+    if (path_changed ||
+        (table->max_speeds[index] != player->max_speed) ||
+        (table->skills[index] != player->disc_reading_skill))
+    {
+      players[num_changed] = player;
+      indexes[num_changed] = index;
+      num_changed++;
+    }
+  }
+
+  if (0 == num_changed)
+  {
+    goto EXIT_LABEL;
+  }
+
+  calculate_players_disc_path_intercepts(players,
+                                         num_changed,
+                                         disc_path,
+                                         now,
+                                         intercept_search_bracket,
+                                         intercepts,
+                                         ret_codes);
+  for (ii = 0; ii < num_changed; ii++)
+  {
+    index = indexes[ii];
+    table->intercepts[index] = intercepts[ii];
+    table->ret_codes[index] = ret_codes[ii];
+    table->max_speeds[index] = players[ii]->max_speed;
+    table->skills[index] = players[ii]->disc_reading_skill;
+  }
+
+  table->disc_path = disc_path;
+  table->path_time_created = disc_path->time_created;
+  table->path_num_positions = num_positions;
+  table->path_complete = path_complete;
+  table->num_players = num_players;
+
+EXIT_LABEL:
+
+  return;
+}
+
+/*
+ * get_intercept_table_entry
+ *
+ * Reads a player's intercept from the table. The table must have been brought
+ * up to date with update_intercept_table.
+ *
+ * The intercept point is as calculated but the time to get there is worked
+ * out again from where the player is now.
+ *
+ * Parameters: table - The table to read.
+ *             player - The player whose intercept is wanted.
+ *             players_per_team - The number of players on each team.
+ *             intercept - Filled in with the player's intercept if there is
+ *                         one.
+ *
+ * Returns: As calculate_player_disc_path_intercept.
+ *          INTERCEPT_CALC_PATH_INCOMPLETE if the table has not been filled in.
+ */
+int get_intercept_table_entry(INTERCEPT_TABLE *table,
+                              PLAYER *player,
+                              int players_per_team,
+                              INTERCEPT *intercept)
+{
+  /*
+   * Local Variables.
+   */
+  int index = player->player_id + players_per_team * player->team_id;
+  VECTOR3 position;
+  float x_diff;
+  float y_diff;
+
+  if (index >= table->num_players)
+  {
+    return(INTERCEPT_CALC_PATH_INCOMPLETE);
+  }
+
+  if (INTERCEPT_CALC_FOUND == table->ret_codes[index])
+  {
+    *intercept = table->intercepts[index];
+    position = get_player_position(player);
+    x_diff = intercept->intercept.x - position.x;
+    y_diff = intercept->intercept.y - position.y;
+    intercept->t = sqrtf(x_diff * x_diff + y_diff * y_diff) /
+                   player->max_speed;
+  }
+
+  return(table->ret_codes[index]);
+}
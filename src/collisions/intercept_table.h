@@ -0,0 +1,86 @@
+/*
+ * intercept_table.h
+ *
+ * Holds where every player on the pitch can intercept the current disc path
+ * so that it is worked out once per throw rather than by every state function
+ * and lua callback that wants it on every frame.
+ *
+ *  Created on: 16 Oct 2026
+ *      Author: David Tyler
+ */
+
+#ifndef INTERCEPT_TABLE_H_
+#define INTERCEPT_TABLE_H_
+
+#include <stdbool.h>
+#include "SDL/SDL.h"
+#include "intercept.h"
+
+struct player;
+struct team;
+struct disc_path;
+
+/*
+ * INTERCEPT_TABLE
+ *
+ * The result of calculate_players_disc_path_intercepts for every player,
+ * indexed player_id + players_per_team * team_id.
+ *
+ * The entries are only recalculated when the path changes (a new throw or
+ * more of the path being published by the path thread) or when a player's
+ * speed or disc reading skill changes. In between a player is assumed to be
+ * running towards their intercept, in which case it doesn't move.
+ *
+ * disc_path - The path the entries were calculated for. NULL if none have
+ *             been.
+ * path_time_created - The time_created of the path when they were calculated.
+ *                     Tells one throw from the next as the path object is
+ *                     reused.
+ * path_num_positions - The number of positions in the path at the time.
+ * path_complete - Whether the path was complete at the time.
+ * max_players - The size of the per player arrays.
+ * num_players - The number of valid entries.
+ * max_speeds - The max_speed of each player when their entry was calculated.
+ * skills - The disc_reading_skill of each player when their entry was
+ *          calculated.
+ * intercepts - The intercept for each player. Only valid where the ret_code
+ *              is INTERCEPT_CALC_FOUND.
+ * ret_codes - The return code of calculate_player_disc_path_intercept for each
+ *             player.
+ * changed_players, changed_indexes, changed_intercepts, changed_ret_codes -
+ *   Working space for the players being recalculated in an update, so that
+ *   nothing sized by the number of players is on the stack.
+ */
+typedef struct intercept_table
+{
+  struct disc_path *disc_path;
+  Uint32 path_time_created;
+  int path_num_positions;
+  bool path_complete;
+  int max_players;
+  int num_players;
+  float *max_speeds;
+  int *skills;
+  INTERCEPT *intercepts;
+  int *ret_codes;
+  struct player **changed_players;
+  int *changed_indexes;
+  INTERCEPT *changed_intercepts;
+  int *changed_ret_codes;
+} INTERCEPT_TABLE;
+
+INTERCEPT_TABLE *create_intercept_table(int);
+void destroy_intercept_table(INTERCEPT_TABLE *);
+void invalidate_intercept_table(INTERCEPT_TABLE *);
+void update_intercept_table(INTERCEPT_TABLE *,
+                            struct team **,
+                            int,
+                            int,
+                            struct disc_path *,
+                            Uint32);
+int get_intercept_table_entry(INTERCEPT_TABLE *,
+                              struct player *,
+                              int,
+                              INTERCEPT *);
+
+#endif /* INTERCEPT_TABLE_H_ */
@@ -0,0 +1,305 @@
+/*
+ * player_separation.c
+ *
+ *  Created on: 16 Oct 2026
+ *      Author: David Tyler
+ */
+
+#include "../dt_logger.h"
+
+#include <math.h>
+#include <stdbool.h>
+#include "player_separation.h"
+
+/*
+ * create_player_separation
+ *
+ * Allocates a solver with room for every pair of a number of players to be
+ * in contact, up to PLAYER_SEPARATION_CONTACTS_PER_PLAYER for each player.
+ *
+ * Parameters: max_players - The number of players that the solver can hold.
+ *
+ * Returns: A pointer to the newly created memory.
+ */
+PLAYER_SEPARATION *create_player_separation(int max_players)
+{
+  /*
+   * Local Variables.
+   */
+  PLAYER_SEPARATION *separation;
+  int max_contacts;
+  int ii;
+
+  if (max_players - 1 <= 2 * PLAYER_SEPARATION_CONTACTS_PER_PLAYER)
+  {
+    max_contacts = (max_players * (max_players - 1)) / 2;
+  }
+  else
+  {
+    max_contacts = max_players * PLAYER_SEPARATION_CONTACTS_PER_PLAYER;
+  }
+  if (max_contacts < 1)
+  {
+    max_contacts = 1;
+  }
+
+  separation = (PLAYER_SEPARATION *) DT_MALLOC(sizeof(PLAYER_SEPARATION));
+
+  separation->max_players = max_players;
+  separation->x = (float *) DT_MALLOC(sizeof(float) * max_players);
+  separation->y = (float *) DT_MALLOC(sizeof(float) * max_players);
+  separation->radius = (float *) DT_MALLOC(sizeof(float) * max_players);
+  separation->push_x = (float *) DT_MALLOC(sizeof(float) * max_players);
+  separation->push_y = (float *) DT_MALLOC(sizeof(float) * max_players);
+  separation->num_pushes = (float *) DT_MALLOC(sizeof(float) * max_players);
+  for (ii = 0; ii < max_players; ii++)
+  {
+    separation->x[ii] = 0.0f;
+    separation->y[ii] = 0.0f;
+    separation->radius[ii] = 0.0f;
+    separation->push_x[ii] = 0.0f;
+    separation->push_y[ii] = 0.0f;
+    separation->num_pushes[ii] = 0.0f;
+  }
+
+  separation->max_contacts = max_contacts;
+  separation->contact_a = (int *) DT_MALLOC(sizeof(int) * max_contacts);
+  separation->contact_b = (int *) DT_MALLOC(sizeof(int) * max_contacts);
+  separation->diff_x = (float *) DT_MALLOC(sizeof(float) * max_contacts);
+  separation->diff_y = (float *) DT_MALLOC(sizeof(float) * max_contacts);
+  separation->radii = (float *) DT_MALLOC(sizeof(float) * max_contacts);
+  separation->contact_push_x = (float *) DT_MALLOC(sizeof(float) *
+                                                   max_contacts);
+  separation->contact_push_y = (float *) DT_MALLOC(sizeof(float) *
+                                                   max_contacts);
+  clear_player_separation_contacts(separation);
+
+  return(separation);
+}
+
+/*
+ * destroy_player_separation
+ *
+ * Frees the memory used by the passed in object.
+ *
+ * Parameters: separation - The object to be freed.
+ */
+void destroy_player_separation(PLAYER_SEPARATION *separation)
+{
+  DT_FREE(separation->contact_push_y);
+  DT_FREE(separation->contact_push_x);
+  DT_FREE(separation->radii);
+  DT_FREE(separation->diff_y);
+  DT_FREE(separation->diff_x);
+  DT_FREE(separation->contact_b);
+  DT_FREE(separation->contact_a);
+  DT_FREE(separation->num_pushes);
+  DT_FREE(separation->push_y);
+  DT_FREE(separation->push_x);
+  DT_FREE(separation->radius);
+  DT_FREE(separation->y);
+  DT_FREE(separation->x);
+  DT_FREE(separation);
+}
+
+/*
+ * clear_player_separation_contacts
+ *
+ * Removes every contact, ready for the next update.
+ *
+ * Parameters: separation - The solver.
+ */
+void clear_player_separation_contacts(PLAYER_SEPARATION *separation)
+{
+  separation->num_contacts = 0;
+}
+
+/*
+ * add_player_separation_contact
+ *
+ * Adds a pair of players which may be overlapping. A pair which turns out not
+ * to overlap costs a little time but is otherwise harmless, so every pair
+ * found by the broadphase can be added. Each pair should only be added once.
+ * Contacts beyond max_contacts are dropped.
+ *
+ * Parameters: separation - The solver.
+ *             player_a, player_b - The indexes of the two players.
+ */
+void add_player_separation_contact(PLAYER_SEPARATION *separation,
+                                   int player_a,
+                                   int player_b)
+{
+  DT_ASSERT(player_a < separation->max_players);
+  DT_ASSERT(player_b < separation->max_players);
+
+  if (separation->num_contacts >= separation->max_contacts)
+  {
+    return;
+  }
+
+  separation->contact_a[separation->num_contacts] = player_a;
+  separation->contact_b[separation->num_contacts] = player_b;
+  separation->num_contacts++;
+}
+
+/*
+ * calculate_contact_pushes
+ *
+ * INTERNAL: Works out how far the two players in each contact need to move
+ * apart. Each moves half of the overlap along the line between their
+ * centres, so a pair on their own are exactly touching afterwards.
+ *
+ * Parameters: separation - The solver, with the contact offsets gathered.
+ */
+void calculate_contact_pushes(PLAYER_SEPARATION *separation)
+{
+  /*
+   * Local Variables.
+   */
+  float *diff_x = separation->diff_x;
+  float *diff_y = separation->diff_y;
+  float *radii = separation->radii;
+  float *contact_push_x = separation->contact_push_x;
+  float *contact_push_y = separation->contact_push_y;
+  int num_contacts = separation->num_contacts;
+  float offset_x;
+  float offset_y;
+  float distance;
+  float divisor;
+  float normal_x;
+  float normal_y;
+  float push;
+  int coincident;
+  int ii;
+
+  for (ii = 0; ii < num_contacts; ii++)
+  {
+    offset_x = diff_x[ii];
+    offset_y = diff_y[ii];
+    distance = sqrtf(offset_x * offset_x + offset_y * offset_y);
+    coincident = (distance < PLAYER_SEPARATION_MIN_DISTANCE);
+    divisor = (distance > PLAYER_SEPARATION_MIN_DISTANCE) ?
+                                      distance : PLAYER_SEPARATION_MIN_DISTANCE;
+    offset_x = coincident ? PLAYER_SEPARATION_MIN_DISTANCE : offset_x;
+    offset_y = coincident ? 0.0f : offset_y;
+    normal_x = offset_x / divisor;
+    normal_y = offset_y / divisor;
+    push = 0.5f * (radii[ii] - distance);
+    push = (push > 0.0f) ? push : 0.0f;
+    contact_push_x[ii] = normal_x * push;
+    contact_push_y[ii] = normal_y * push;
+  }
+}
+
+/*
+ * apply_player_pushes
+ *
+ * INTERNAL: Moves each player by the average of the pushes on them and resets
+ * the pushes for the next iteration. Averaging stops a player in the middle
+ * of a crowd being pushed further than any one contact asks for, which would
+ * make the crowd shake rather than settle.
+ *
+ * Parameters: separation - The solver.
+ *             num_players - The number of players.
+ */
+void apply_player_pushes(PLAYER_SEPARATION *separation, int num_players)
+{
+  /*
+   * Local Variables.
+   */
+  float *x = separation->x;
+  float *y = separation->y;
+  float *push_x = separation->push_x;
+  float *push_y = separation->push_y;
+  float *num_pushes = separation->num_pushes;
+  float divisor;
+  int ii;
+
+  for (ii = 0; ii < num_players; ii++)
+  {
+    divisor = (num_pushes[ii] > 1.0f) ? num_pushes[ii] : 1.0f;
+    x[ii] += push_x[ii] / divisor;
+    y[ii] += push_y[ii] / divisor;
+    push_x[ii] = 0.0f;
+    push_y[ii] = 0.0f;
+    num_pushes[ii] = 0.0f;
+  }
+}
+
+/*
+ * solve_player_separation
+ *
+ * Pushes the players in each contact apart until none of them overlap or
+ * PLAYER_SEPARATION_ITERATIONS is reached.
+ *
+ * Every contact is worked out from the positions at the start of the
+ * iteration, and then every player is moved at once, so that the result
+ * doesn't depend on the order of the contacts. Only the contacts added are
+ * tested, so a player pushed into someone they weren't touching at the start
+ * is only pushed back out on the next update.
+ *
+ * Parameters: separation - The solver, with the position and radius of each
+ *                          player filled in. The positions are updated.
+ *             num_players - The number of players.
+ */
+void solve_player_separation(PLAYER_SEPARATION *separation, int num_players)
+{
+  /*
+   * Local Variables.
+   */
+  bool overlapping;
+  int iteration;
+  int player_a;
+  int player_b;
+  int ii;
+
+  DT_ASSERT(num_players <= separation->max_players);
+
+  for (ii = 0; ii < separation->num_contacts; ii++)
+  {
+    separation->radii[ii] = separation->radius[separation->contact_a[ii]] +
+                            separation->radius[separation->contact_b[ii]];
+  }
+
+  for (iteration = 0; iteration < PLAYER_SEPARATION_ITERATIONS; iteration++)
+  {
+    for (ii = 0; ii < separation->num_contacts; ii++)
+    {
+      player_a = separation->contact_a[ii];
+      player_b = separation->contact_b[ii];
+      separation->diff_x[ii] = separation->x[player_b] -
+                               separation->x[player_a];
+      separation->diff_y[ii] = separation->y[player_b] -
+                               separation->y[player_a];
+    }
+
+    calculate_contact_pushes(separation);
+
+    overlapping = false;
+    for (ii = 0; ii < separation->num_contacts; ii++)
+    {
+      if ((0.0f == separation->contact_push_x[ii]) &&
+          (0.0f == separation->contact_push_y[ii]))
+      {
+        continue;
+      }
+
+      overlapping = true;
+      player_a = separation->contact_a[ii];
+      player_b = separation->contact_b[ii];
+      separation->push_x[player_a] -= separation->contact_push_x[ii];
+      separation->push_y[player_a] -= separation->contact_push_y[ii];
+      separation->num_pushes[player_a] += 1.0f;
+      separation->push_x[player_b] += separation->contact_push_x[ii];
+      separation->push_y[player_b] += separation->contact_push_y[ii];
+      separation->num_pushes[player_b] += 1.0f;
+    }
+
+    if (!overlapping)
+    {
+      break;
+    }
+
+    apply_player_pushes(separation, num_players);
+  }
+}
@@ -0,0 +1,91 @@
+/*
+ * player_separation.h
+ *
+ * Pushes players who are overlapping apart. Each player is treated as a
+ * circle on the ground and each pair which overlaps is pushed apart along the
+ * line between their centres, a fixed number of times, so that a crowd of
+ * players in a stack or a pile up is sorted out in a bounded time.
+ *
+ *  Created on: 16 Oct 2026
+ *      Author: David Tyler
+ */
+
+#ifndef PLAYER_SEPARATION_H_
+#define PLAYER_SEPARATION_H_
+
+/*
+ * The number of times every contact is resolved in an update. Anything left
+ * over is carried on to the next update.
+ */
+#define PLAYER_SEPARATION_ITERATIONS 8
+
+/*
+ * Two players whose centres are closer than this (m) are pushed apart along
+ * the x axis as the line between them can't be relied on.
+ */
+#define PLAYER_SEPARATION_MIN_DISTANCE 0.0001f
+
+/*
+ * Room is kept for this many contacts per player rather than one for every
+ * pair, so that the solver's memory grows with the number of players rather
+ * than its square. A crowd that needs more than this in one update has the
+ * extra contacts sorted out on a later update.
+ */
+#define PLAYER_SEPARATION_CONTACTS_PER_PLAYER 8
+
+/*
+ * PLAYER_SEPARATION
+ *
+ * Players are identified by an index from 0 to max_players - 1 chosen by the
+ * caller, who fills in the position and radius of each before calling
+ * solve_player_separation and reads the positions back afterwards.
+ *
+ * Everything is held as a structure of arrays, and the per contact and per
+ * player parts of the solver have no branches so that gcc can vectorise them.
+ * It does with the flags in the generated make file, but not at -O2.
+ *
+ * max_players - The size of the per player arrays.
+ * x, y - The centre of each player.
+ * radius - The radius of each player.
+ * push_x, push_y - The total push on each player from the current iteration.
+ * num_pushes - The number of contacts pushing each player in the current
+ *              iteration.
+ * max_contacts - The size of the per contact arrays. The smaller of the
+ *                number of pairs of players and
+ *                PLAYER_SEPARATION_CONTACTS_PER_PLAYER for each player.
+ * num_contacts - The number of contacts added since the last clear.
+ * contact_a, contact_b - The two players in each contact.
+ * diff_x, diff_y - The offset from the centre of player a to the centre of
+ *                  player b in each contact, gathered at the start of each
+ *                  iteration.
+ * radii - The sum of the radii of the players in each contact.
+ * contact_push_x, contact_push_y - How far player b is pushed by each contact.
+ *                                  Player a is pushed the opposite way.
+ */
+typedef struct player_separation
+{
+  int max_players;
+  float *x;
+  float *y;
+  float *radius;
+  float *push_x;
+  float *push_y;
+  float *num_pushes;
+  int max_contacts;
+  int num_contacts;
+  int *contact_a;
+  int *contact_b;
+  float *diff_x;
+  float *diff_y;
+  float *radii;
+  float *contact_push_x;
+  float *contact_push_y;
+} PLAYER_SEPARATION;
+
+PLAYER_SEPARATION *create_player_separation(int);
+void destroy_player_separation(PLAYER_SEPARATION *);
+void clear_player_separation_contacts(PLAYER_SEPARATION *);
+void add_player_separation_contact(PLAYER_SEPARATION *, int, int);
+void solve_player_separation(PLAYER_SEPARATION *, int);
+
+#endif /* PLAYER_SEPARATION_H_ */
@@ -53,6 +53,30 @@ bool create_config_value_int(CONFIG_VALUE_INT_ENUM cv,
       config_value->min_value = 1;
       config_value->max_value = 2;
       break;
+    case cv_sim_ms_per_step:
+      config_value->default_value = 10;
+      strncpy(config_value->key, "SIM_MS_PER_STEP", MAX_CONFIG_VALUE_LEN);
+      config_value->min_value = 1;
+      config_value->max_value = 50;
+      break;
+    case cv_max_sim_steps_per_frame:
+      config_value->default_value = 10;
+      strncpy(config_value->key, "MAX_SIM_STEPS_PER_FRAME", MAX_CONFIG_VALUE_LEN);
+      config_value->min_value = 1;
+      config_value->max_value = 100;
+      break;
+    case cv_num_teams:
+      config_value->default_value = 2;
+      strncpy(config_value->key, "NUM_TEAMS", MAX_CONFIG_VALUE_LEN);
+      config_value->min_value = 2;
+      config_value->max_value = 64;
+      break;
+    case cv_players_per_team:
+      config_value->default_value = 7;
+      strncpy(config_value->key, "PLAYERS_PER_TEAM", MAX_CONFIG_VALUE_LEN);
+      config_value->min_value = 1;
+      config_value->max_value = 4096;
+      break;
     default:
       DT_DEBUG_LOG("Request made for config value that does not exist: %i\n",
                    cv);
@@ -109,6 +133,12 @@ bool create_config_value_str(CONFIG_VALUE_STR_ENUM cv,
               "resources//images//grass_tile.png",
               MAX_CONFIG_VALUE_LEN);
       break;
+    case cv_flight_lu_table_file:
+      strncpy(config_value->key, "FLIGHT_LU_TABLE", MAX_CONFIG_VALUE_LEN);
+      strncpy(config_value->default_value,
+              "resources//flight_lu_table.bin",
+              MAX_CONFIG_VALUE_LEN);
+      break;
     default:
       DT_DEBUG_LOG("Request made for config value that does not exist: %i\n",
                    cv);
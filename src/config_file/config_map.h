@@ -20,6 +20,12 @@
 /*
  * cv_max_fps - The desired fps.
  * cv_animation_ms_per_frame - The default ms per animation frame.
+ * cv_sim_ms_per_step - The fixed length of a single simulation step.
+ * cv_max_sim_steps_per_frame - Caps the number of simulation steps run before
+ *                              a frame is drawn so that a long stall doesn't
+ *                              cause the simulation to spiral.
+ * cv_num_teams - The number of teams in a match.
+ * cv_players_per_team - The number of players on each team.
  * TODO: Fix comment with extra config values.
  */
 typedef enum config_value_int_enum
@@ -27,15 +33,23 @@ typedef enum config_value_int_enum
   cv_max_fps,
   cv_animation_ms_per_frame,
   cv_audio_freq,
-  cv_audio_channels
+  cv_audio_channels,
+  cv_sim_ms_per_step,
+  cv_max_sim_steps_per_frame,
+  cv_num_teams,
+  cv_players_per_team
 } CONFIG_VALUE_INT_ENUM;
 
 /*
  * cv_music_directory - The location where music files for the game are found.
- * cv_o_xml_file - The location of the offensive automaton xml file.
- * cv_d_xml_file - The location of the defensive autoamton xml file.
+ * cv_o_xml_file - The location of the offensive automaton xml file, or of
+ *                 the set compiled from it by Tools/automaton_compiler.
+ * cv_d_xml_file - The location of the defensive autoamton xml file, or of
+ *                 the compiled set.
  * cv_disc_graphic - The path and filename for the disc graphic.
  * cv_grass_tile_filename - The path and filename for the grass tile graphic.
+ * cv_flight_lu_table_file - The path and filename of the flight condition
+ *                           table generated by Tools/flight_lu_table.
  */
 typedef enum config_value_str_enum
 {
@@ -43,7 +57,8 @@ typedef enum config_value_str_enum
   cv_o_xml_file,
   cv_d_xml_file,
   cv_disc_graphic,
-  cv_grass_tile_filename
+  cv_grass_tile_filename,
+  cv_flight_lu_table_file
 } CONFIG_VALUE_STR_ENUM;
 
 /*
@@ -12,74 +12,54 @@
 #include "../automaton/data_structures/automaton_event.h"
 
 /*
- * destroy_event_queue_node
- *
- * Frees the memory used by the passed in object.
+ * create_event_queue
  *
- * Parameters: event_queue_node - The object to be freed.
- */
-void destroy_event_queue_node(EVENT_QUEUE_NODE *event_queue_node)
-{
-  /*
-   * Free the object.
-   */
-  DT_FREE(event_queue_node);
-}
-
-/*
- * create_event_queue_node
+ * Allocates the memory required for a event_queue along with room for all
+ * the events it can hold.
  *
- * Allocates the memory required for a event_queue_node.
+ * Parameters: capacity - The most events that can be waiting at once. Must
+ *                        be a power of two.
+ *             overflow_policy - EVENT_QUEUE_DROP_NEWEST or
+ *                               EVENT_QUEUE_DROP_OLDEST.
+ *             coalesce - Whether to drop an event that is the same as the
+ *                        last one waiting.
  *
  * Returns: A pointer to the newly created memory
  */
-EVENT_QUEUE_NODE *create_event_queue_node()
+EVENT_QUEUE *create_event_queue(unsigned int capacity,
+                                int overflow_policy,
+                                bool coalesce)
 {
   /*
-   * Local Variables.
-   */
-  EVENT_QUEUE_NODE *node;
-
-  /*
-   * Allocate the memory required for the new node.
-   */
-  node = (EVENT_QUEUE_NODE *) DT_MALLOC(sizeof(EVENT_QUEUE_NODE));
-
-  /*
-   * Default the pointers to NULL so that we can test against them if required.
+   * Local Variables
    */
-  node->next = NULL;
-  node->prev = NULL;
-
-  return(node);
-}
+  EVENT_QUEUE *event_queue;
 
-/*
- * create_event_queue
- *
- * Allocates the memory required for a event_queue. Also sets the default NULL
- * values for all pointers in the queue object.
- *
- * Returns: A pointer to the newly created memory
- */
-EVENT_QUEUE *create_event_queue()
-{
   /*
-   * Local Variables
+   * The buffer is indexed by masking the counts so its size must be a power
+   * of two.
    */
-  EVENT_QUEUE *event_queue;
+  DT_ASSERT((0 != capacity) && (0 == (capacity & (capacity - 1))));
 
   /*
    * Allocate the required memory
    */
   event_queue = (EVENT_QUEUE *) DT_MALLOC(sizeof(EVENT_QUEUE));
+  event_queue->events = (AUTOMATON_EVENT **)
+                             DT_MALLOC(sizeof(AUTOMATON_EVENT *) * capacity);
 
   /*
-   * Defaulting the pointers and the size means that we can use this queue
-   * immediately after having called this constructor.
+   * Defaulting the counts means that we can use this queue immediately after
+   * having called this constructor.
    */
-  event_queue->top = NULL;
-  event_queue->bottom = NULL;
+  event_queue->capacity = capacity;
+  event_queue->head = 0;
+  event_queue->tail = 0;
+  event_queue->overflow_policy = overflow_policy;
+  event_queue->coalesce = coalesce;
+  event_queue->high_water_mark = 0;
+  event_queue->num_coalesced = 0;
+  event_queue->num_dropped = 0;
 
   return(event_queue);
 }
@@ -87,33 +67,17 @@ EVENT_QUEUE *create_event_queue()
 /*
  * destroy_event_queue
  *
- * Frees the memory used by the passed in object.
+ * Frees the memory used by the passed in object. Any events still on the
+ * queue are simply discarded.
  *
  * Parameters: event_queue - The object to be freed.
  */
 void destroy_event_queue(EVENT_QUEUE *event_queue)
 {
-  /*
-   * Local Variables.
-   */
-  EVENT_QUEUE_NODE *curr;
-  EVENT_QUEUE_NODE *next;
-
-  /*
-   * If we are destroying the queue object then we want to destroy all the
-   * nodes so we set the size to zero and clear the queue.
-   */
-  curr = event_queue->top;
-  while (NULL != curr)
-  {
-    next = curr->next;
-    destroy_event_queue_node(curr);
-    curr = next;
-  }
-
   /*
    * Free the object.
    */
+  DT_FREE(event_queue->events);
   DT_FREE(event_queue);
 }
 
@@ -124,51 +88,59 @@ void destroy_event_queue(EVENT_QUEUE *event_queue)
  *
  * Parameters: event - The event to be added.
  *             queue - Must be created but can be an empty queue.
+ *
+ * Returns: EVENT_QUEUE_ADDED, EVENT_QUEUE_COALESCED or EVENT_QUEUE_OVERFLOW.
+ *          On overflow the event has only been added if the queue drops its
+ *          oldest event.
  */
-void add_event_to_queue(AUTOMATON_EVENT *event, EVENT_QUEUE *queue)
+int add_event_to_queue(AUTOMATON_EVENT *event, EVENT_QUEUE *queue)
 {
   /*
    * Local Variables.
    */
-  EVENT_QUEUE_NODE *node = create_event_queue_node();
+  unsigned int mask = queue->capacity - 1;
+  int rc = EVENT_QUEUE_ADDED;
 
   /*
-   * Set the nodes event.
+   * The same event can come from different automatons so events are
+   * compared by id. Only the newest waiting event is checked so that the
+   * order of different events is never changed: A, B, A is kept as it is
+   * but A, A is queued as A.
    */
-  node->event = event;
+  if ((queue->coalesce) &&
+      (queue->tail != queue->head) &&
+      (queue->events[(queue->tail - 1) & mask]->id == event->id))
+  {
+    queue->num_coalesced++;
+    return(EVENT_QUEUE_COALESCED);
+  }
 
-  /*
-   * If the queue is empty then the top will be null. Otherwise,
-   * the top will be a pointer to a queue event.
-   */
-  if (NULL == queue->top)
+  if (queue->tail - queue->head == queue->capacity)
   {
-    /*
-     * Queue was empty so point both the top and bottom
-     * at this event.
-     */
-    queue->bottom = node;
-    queue->top = node;
-    node->next = NULL;
-    node->prev = NULL;
+    queue->num_dropped++;
+    if (EVENT_QUEUE_DROP_NEWEST == queue->overflow_policy)
+    {
+      return(EVENT_QUEUE_OVERFLOW);
+    }
+    queue->head++;
+    rc = EVENT_QUEUE_OVERFLOW;
   }
-  else
+
+  queue->events[queue->tail & mask] = event;
+  queue->tail++;
+
+  if (queue->tail - queue->head > queue->high_water_mark)
   {
-    /*
-     * There is an element on the top of the queue already. Add this element
-     * to the top and push the others down 1.
-     */
-    queue->top->prev = node;
-    node->next = queue->top;
-    node->prev = NULL;
-    queue->top = node;
+    queue->high_water_mark = queue->tail - queue->head;
   }
+
+  return(rc);
 }
 
 /*
  * get_event_from_queue
  *
- * Retrieve (and delete) the last element on the queue.
+ * Retrieve (and remove) the oldest event on the queue.
  *
  * Parameters: queue - The queue object to retrieve from.
  *             event - Will contain the event returned. Set to NULL if the
@@ -178,48 +150,14 @@ void add_event_to_queue(AUTOMATON_EVENT *event, EVENT_QUEUE *queue)
  */
 bool get_event_from_queue(EVENT_QUEUE *queue, AUTOMATON_EVENT **event)
 {
-  /*
-   * Local Variables.
-   */
-  bool is_empty = false;
-
-  /*
-   * The queue is empty if the bottom of the queue is a NULL pointer.
-   * In that case we return a NULL event.
-   */
-  if (NULL == queue->bottom)
+  if (queue->head == queue->tail)
   {
     *event = NULL;
-    is_empty = true;
+    return(false);
   }
-  else
-  {
-    /*
-     * If the queue is not empty then remove the bottom event and return it.
-     */
-    *event = queue->bottom->event;
-    queue->bottom = queue->bottom->prev;
-    destroy_event_queue_node(queue->bottom);
-
-    /*
-     * If there was more than one element in the queue prior to the removal of
-     * the bottom element then we need to adjust the next pointer of the new
-     * bottom element so that it points to NULL rather than the now deleted
-     * element.
-     */
-    if (NULL != queue->bottom)
-    {
-      queue->bottom->next = NULL;
-    }
-    else
-    {
-      /*
-       * We have just taken the last element off the queue. This element was 
-       * referenced by the top of the queue as well so we set that to NULL.
-       */
-      queue->top = NULL;
-    }
-  }
-  
-  return(!is_empty);
+
+  *event = queue->events[queue->head & (queue->capacity - 1)];
+  queue->head++;
+
+  return(true);
 }
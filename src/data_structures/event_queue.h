@@ -17,22 +17,27 @@
 struct automaton_event;
 
 /*
- * EVENT_QUEUE_NODE
+ * What happens to an event added to a full queue.
  *
- * A node in the event queue. Has previous and next pointers as the event
- * queue is essentially a doubly linked list. All pointers default to NULL in
- * the constructor method.
+ * EVENT_QUEUE_DROP_NEWEST - The event is not added.
+ * EVENT_QUEUE_DROP_OLDEST - The oldest event on the queue is removed to make
+ *                           room for it.
+ */
+#define EVENT_QUEUE_DROP_NEWEST 0
+#define EVENT_QUEUE_DROP_OLDEST 1
+
+/*
+ * Return codes for adding an event to the queue.
  *
- * event - The AI_EVENT enum value that caused this to be added to the queue.
- * next - The next element (towards the end we retrieve elements from).
- * prev - The previous element (towards the end we add elements to).
+ * EVENT_QUEUE_ADDED - The event was added.
+ * EVENT_QUEUE_COALESCED - The same event was the last one waiting on the
+ *                         queue so this one was not added.
+ * EVENT_QUEUE_OVERFLOW - The queue was full so an event was dropped according
+ *                        to the queue's overflow policy.
  */
-typedef struct event_queue_node
-{
-  struct automaton_event *event;
-  struct event_queue_node *next;
-  struct event_queue_node *prev;
-} EVENT_QUEUE_NODE;
+#define EVENT_QUEUE_ADDED     0
+#define EVENT_QUEUE_COALESCED 1
+#define EVENT_QUEUE_OVERFLOW  2
 
 /*
  * EVENT_QUEUE
@@ -41,20 +46,39 @@ typedef struct event_queue_node
  * events to the AI players. Each AI player has their own event queue and all
  * access should be done through the designated functions.
  *
- * top and bottom pointers default to NULL.
+ * The queue is a ring buffer of fixed size allocated with the queue, so
+ * nothing is allocated or freed as events are added and taken. head and tail
+ * count every event ever taken and added, and only wrap into the buffer when
+ * it is indexed, so the number of events on the queue is always tail - head.
  *
- * top - This is where elements are added.
- * bottom - This is where elements are taken.
+ * events - The buffer.
+ * capacity - The size of events. Always a power of two.
+ * head - Where the next event is taken from.
+ * tail - Where the next event is added.
+ * overflow_policy - EVENT_QUEUE_DROP_NEWEST or EVENT_QUEUE_DROP_OLDEST.
+ * coalesce - If true an event isn't added when the same event is the last
+ *            one waiting on the queue. Earlier events are not checked as
+ *            dropping the new event would then change the order of events.
+ * high_water_mark - The most events that have been on the queue at once.
+ * num_coalesced - The number of events not added because of coalescing.
+ * num_dropped - The number of events lost because the queue was full.
  */
 typedef struct event_queue
 {
-  struct event_queue_node *top;
-  struct event_queue_node *bottom;
+  struct automaton_event **events;
+  unsigned int capacity;
+  unsigned int head;
+  unsigned int tail;
+  int overflow_policy;
+  bool coalesce;
+  unsigned int high_water_mark;
+  unsigned int num_coalesced;
+  unsigned int num_dropped;
 } EVENT_QUEUE;
 
-EVENT_QUEUE *create_event_queue();
+EVENT_QUEUE *create_event_queue(unsigned int, int, bool);
 void destroy_event_queue(EVENT_QUEUE *);
-void add_event_to_queue(struct automaton_event *, EVENT_QUEUE *);
+int add_event_to_queue(struct automaton_event *, EVENT_QUEUE *);
 bool get_event_from_queue(EVENT_QUEUE *, struct automaton_event **);
 
 #endif /* EVENT_QUEUE_H_ */
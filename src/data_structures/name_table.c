@@ -0,0 +1,183 @@
+/*
+ * name_table.c
+ *
+ *  Created on: 16 Oct 2026
+ *      Author: David Tyler
+ */
+
+#include "../dt_logger.h"
+
+#include <stddef.h>
+#include <string.h>
+#include "name_table.h"
+
+/*
+ * hash_name
+ *
+ * INTERNAL: The FNV-1a hash of a name.
+ *
+ * Parameters: name - The name to hash.
+ *
+ * Returns: The hash.
+ */
+unsigned int hash_name(const char *name)
+{
+  /*
+   * Local Variables.
+   */
+  unsigned int hash = 2166136261u;
+
+  while ('\0' != *name)
+  {
+    hash ^= (unsigned char) *name;
+    hash *= 16777619u;
+    name++;
+  }
+
+  return(hash);
+}
+
+/*
+ * find_name_slot
+ *
+ * INTERNAL: Finds the slot that holds a name or, if the name isn't in the
+ * table, the empty slot where it would go.
+ *
+ * Parameters: table - The table to search.
+ *             name - The name to search for.
+ *             hash - The hash of the name.
+ *
+ * Returns: The index of the slot.
+ */
+int find_name_slot(NAME_TABLE *table, const char *name, unsigned int hash)
+{
+  /*
+   * Local Variables.
+   */
+  unsigned int mask = (unsigned int) table->num_slots - 1;
+  unsigned int slot = hash & mask;
+
+  /*
+   * The table is never more than half full so there is always an empty slot
+   * to stop at.
+   */
+  while (NULL != table->names[slot])
+  {
+    if ((table->hashes[slot] == hash) &&
+        (0 == strcmp(table->names[slot], name)))
+    {
+      break;
+    }
+    slot = (slot + 1) & mask;
+  }
+
+  return((int) slot);
+}
+
+/*
+ * create_name_table
+ *
+ * Allocates an empty table.
+ *
+ * Parameters: max_names - The number of names that the table can hold.
+ *
+ * Returns: A pointer to the newly created memory.
+ */
+NAME_TABLE *create_name_table(int max_names)
+{
+  /*
+   * Local Variables.
+   */
+  NAME_TABLE *table;
+  int ii;
+
+  table = (NAME_TABLE *) DT_MALLOC(sizeof(NAME_TABLE));
+
+  table->num_slots = 4;
+  while (table->num_slots < 2 * max_names)
+  {
+    table->num_slots *= 2;
+  }
+  table->max_names = max_names;
+  table->num_names = 0;
+  table->hashes = (unsigned int *) DT_MALLOC(sizeof(unsigned int) *
+                                             table->num_slots);
+  table->names = (const char **) DT_MALLOC(sizeof(const char *) *
+                                           table->num_slots);
+  table->values = (int *) DT_MALLOC(sizeof(int) * table->num_slots);
+  for (ii = 0; ii < table->num_slots; ii++)
+  {
+    table->hashes[ii] = 0;
+    table->names[ii] = NULL;
+    table->values[ii] = NAME_TABLE_NOT_FOUND;
+  }
+
+  return(table);
+}
+
+/*
+ * destroy_name_table
+ *
+ * Frees the memory used by the passed in object. The names are not freed.
+ *
+ * Parameters: table - The object to be freed.
+ */
+void destroy_name_table(NAME_TABLE *table)
+{
+  DT_FREE(table->values);
+  DT_FREE(table->names);
+  DT_FREE(table->hashes);
+  DT_FREE(table);
+}
+
+/*
+ * add_name_to_table
+ *
+ * Adds a name to the table.
+ *
+ * Parameters: table - The table to add to.
+ *             name - The name. Not copied, so must outlive the table.
+ *             value - The value to return when the name is searched for.
+ *
+ * Returns: False if the name is already in the table or the table is full.
+ */
+bool add_name_to_table(NAME_TABLE *table, const char *name, int value)
+{
+  /*
+   * Local Variables.
+   */
+  unsigned int hash;
+  int slot;
+
+  if (table->num_names >= table->max_names)
+  {
+    return(false);
+  }
+
+  hash = hash_name(name);
+  slot = find_name_slot(table, name, hash);
+  if (NULL != table->names[slot])
+  {
+    return(false);
+  }
+
+  table->hashes[slot] = hash;
+  table->names[slot] = name;
+  table->values[slot] = value;
+  table->num_names++;
+
+  return(true);
+}
+
+/*
+ * find_name_in_table
+ *
+ * Parameters: table - The table to search.
+ *             name - The name to search for.
+ *
+ * Returns: The value added with the name or NAME_TABLE_NOT_FOUND.
+ */
+int find_name_in_table(NAME_TABLE *table, const char *name)
+{
+  return(table->values[find_name_slot(table, name, hash_name(name))]);
+}
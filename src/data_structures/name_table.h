@@ -0,0 +1,56 @@
+/*
+ * name_table.h
+ *
+ * A hash table from names to integers, used to turn the names of things read
+ * from files into the index of the thing once when they are loaded rather
+ * than searching for them every time they are used.
+ *
+ *  Created on: 16 Oct 2026
+ *      Author: David Tyler
+ */
+
+#ifndef NAME_TABLE_H_
+#define NAME_TABLE_H_
+
+#include <stdbool.h>
+
+/*
+ * Returned by find_name_in_table when the name isn't in the table.
+ */
+#define NAME_TABLE_NOT_FOUND -1
+
+/*
+ * NAME_TABLE
+ *
+ * An open addressed hash table. The table never holds more than half as many
+ * names as it has slots so that a search only looks at a couple of slots, and
+ * the hash of each name is kept so that the name itself is only compared when
+ * the hashes match.
+ *
+ * The names are not copied. They must not change or be freed while they are
+ * in the table, which is the case for the names held in the objects that the
+ * table indexes.
+ *
+ * num_slots - The size of the arrays. Always a power of two.
+ * max_names - The number of names that the table can hold.
+ * num_names - The number of names in the table.
+ * hashes - The hash of the name in each slot.
+ * names - The name in each slot. NULL if the slot is empty.
+ * values - The value for the name in each slot.
+ */
+typedef struct name_table
+{
+  int num_slots;
+  int max_names;
+  int num_names;
+  unsigned int *hashes;
+  const char **names;
+  int *values;
+} NAME_TABLE;
+
+NAME_TABLE *create_name_table(int);
+void destroy_name_table(NAME_TABLE *);
+bool add_name_to_table(NAME_TABLE *, const char *, int);
+int find_name_in_table(NAME_TABLE *, const char *);
+
+#endif /* NAME_TABLE_H_ */
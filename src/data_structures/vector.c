@@ -341,3 +341,29 @@ bool vectors_equal(VECTOR3 *vector1, VECTOR3 *vector2)
           vector1->y == vector2->y && 
           vector1->z == vector2->z);
 }
+
+/*
+ * vector_interpolate
+ *
+ * Linearly interpolates between two vectors. Used by the renderer to draw
+ * objects part way between the last two simulation steps.
+ *
+ * Parameters: vector1 - The vector returned when t is 0.
+ *             vector2 - The vector returned when t is 1.
+ *             t - The interpolation factor. Expected to be in [0, 1].
+ *
+ * Returns: vector1 + (vector2 - vector1) * t
+ */
+VECTOR3 vector_interpolate(VECTOR3 *vector1, VECTOR3 *vector2, float t)
+{
+  /*
+   * Local Variables.
+   */
+  VECTOR3 ret_vector;
+
+  ret_vector.x = vector1->x + (vector2->x - vector1->x) * t;
+  ret_vector.y = vector1->y + (vector2->y - vector1->y) * t;
+  ret_vector.z = vector1->z + (vector2->z - vector1->z) * t;
+
+  return(ret_vector);
+}
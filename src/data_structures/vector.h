@@ -38,5 +38,6 @@ float smallest_angle_between_vectors(VECTOR3 *, VECTOR3 *);
 VECTOR3 rotate_vector_around_vector(VECTOR3 *, float, VECTOR3 *);
 float dist_between_vectors_2d(VECTOR3 *, VECTOR3 *);
 bool vectors_equal(VECTOR3 *, VECTOR3 *);
+VECTOR3 vector_interpolate(VECTOR3 *, VECTOR3 *, float);
 
 #endif /* VECTOR_H_ */
@@ -1,6 +1,10 @@
 /*
  * disc.c
  *
+ * Building with DT_HEADLESS leaves out the graphics and the user throw so that
+ * discs can be created and thrown without the rest of the game (see
+ * Tools/flight_sim). Headless discs must be created with no graphic.
+ *
  *  Created on: 21 Oct 2009
  *      Author: David
  */
@@ -8,15 +12,21 @@
 #include "dt_logger.h"
 
 #include <stddef.h>
+#include <math.h>
 
 #include "data_structures/vector.h"
 #include "disc.h"
+#include "flight_mechanics/disc_dimensions.h"
+#include "flight_mechanics/disc_flight.h"
+#include "throw_init_condition.h"
+#ifndef DT_HEADLESS
 #include "entity_graphic.h"
+#include "flight_condition_lu_table.h"
 #include "mouse_click_state.h"
-#include "flight_mechanics/disc_dimensions.h"
 #include "rendering/texture_loader.h"
 #include "throw.h"
 #include "throw_constants.h"
+#endif
 
 /*
  * create_disc
@@ -29,7 +39,9 @@
 DISC *create_disc(char *graphic_filename)
 {
   DISC *disc;
+#ifndef DT_HEADLESS
   int rc;
+#endif
 
   /*
    * Allocate the required memory for the disc object.
@@ -48,6 +60,7 @@ DISC *create_disc(char *graphic_filename)
    */
   vector_set_values(&(disc->d3), 0.0f, 0.0f, 1.0f);
   vector_set_values(&(disc->position), 0.0f, 0.0f, 0.0f);
+  vector_set_values(&(disc->previous_position), 0.0f, 0.0f, 0.0f);
   vector_set_values(&(disc->new_position), 0.0f, 0.0f, 0.0f);
   vector_set_values(&(disc->velocity), 0.0f, 0.0f, 0.0f);
   vector_set_values(&(disc->angular_velocity), 0.0f, 0.0f, 0.0f);
@@ -58,6 +71,11 @@ DISC *create_disc(char *graphic_filename)
   disc->thrower = NULL;
   disc->holder = NULL;
 
+  /*
+   * The disc is flown by this once it is thrown.
+   */
+  disc->flight = (DISC_FLIGHT *) DT_MALLOC(sizeof(DISC_FLIGHT));
+
   /*
    * The disc graphic is created in this function so that it can be released
    * when the disc is destroyed.
@@ -65,8 +83,12 @@ DISC *create_disc(char *graphic_filename)
    * Don't try and recover if the disc graphic could not be found.
    *
    * Special case code exists if the filename is NULL so that we can create a
-   * disc with no graphic.
+   * disc with no graphic. A headless build has no graphics at all so the
+   * filename is ignored.
    */
+#ifdef DT_HEADLESS
+  (void) graphic_filename;
+#else
   if (NULL != graphic_filename)
   {
     rc = create_entity_graphic(graphic_filename, &(disc->graphic), false);
@@ -77,6 +99,7 @@ DISC *create_disc(char *graphic_filename)
     }
   }
   else
+#endif
   {
     disc->graphic = NULL;
   }
@@ -98,14 +121,17 @@ void destroy_disc(DISC *disc)
    * free up the resource used in creating the texture provided that the disc
    * is the only object using the sprite.
    */
+#ifndef DT_HEADLESS
   if (NULL != disc->graphic)
   {
     remove_reference_to_graphic(disc->graphic);
   }
+#endif
 
   /*
    * Then free the memory used for the disc object itself.
    */
+  DT_FREE(disc->flight);
   DT_FREE(disc);
 }
 
@@ -123,6 +149,8 @@ void create_disc_replica(DISC *replica, DISC *old_disc)
   vector_copy_values(&(replica->new_position), &(old_disc->new_position));
   vector_copy_values(&(replica->d3), &(old_disc->d3));
   vector_copy_values(&(replica->position), &(old_disc->position));
+  vector_copy_values(&(replica->previous_position),
+                     &(old_disc->previous_position));
   vector_copy_values(&(replica->velocity), &(old_disc->velocity));
   replica->diameter_m = old_disc->diameter_m;
   replica->disc_state = old_disc->disc_state;
@@ -130,6 +158,7 @@ void create_disc_replica(DISC *replica, DISC *old_disc)
   replica->thickness_m = old_disc->thickness_m;
 }
 
+#ifndef DT_HEADLESS
 /*
  * set_init_disc_conditions
  *
@@ -174,14 +203,110 @@ void set_init_disc_conditions(DISC *disc, DISC_THROW *disc_throw)
    * Calculate the initial speed of the disc.
    * @@@DAT - Dummy function.
    */
-  disc->angular_velocity.x = -13.94f;
-  disc->angular_velocity.y = -1.48f;
-  disc->angular_velocity.z = -54.25f;
-  disc->position.z = 1.5f;
+  disc->angular_velocity.x = DISC_THROW_ANGULAR_VELOCITY_X;
+  disc->angular_velocity.y = DISC_THROW_ANGULAR_VELOCITY_Y;
+  disc->angular_velocity.z = DISC_THROW_ANGULAR_VELOCITY_Z;
+  disc->position.z = DISC_THROW_RELEASE_HEIGHT_M;
   disc->d3.x = 0.0f;
   disc->d3.y = 0.0f;
   disc->d3.z = 1.0f;
   vector_copy_values(&(disc->new_position), &(disc->position));
+  vector_copy_values(&(disc->previous_position), &(disc->position));
+
+  disc->disc_state = disc_in_air;
+  start_disc_flight(disc->flight, disc);
+}
+#endif
+
+/*
+ * set_init_disc_conditions_from_throw
+ *
+ * Sets the disc up to be thrown from where it is now with a throw worked out
+ * by the flight condition table or the throw solver.
+ *
+ * Parameters: disc - The disc object.
+ *             condition - The velocity and up vector of the throw in world
+ *                         coordinates.
+ */
+void set_init_disc_conditions_from_throw(DISC *disc,
+                                         THROW_INIT_CONDITION *condition)
+{
+  vector_copy_values(&(disc->velocity), &(condition->velocity));
+  vector_copy_values(&(disc->d3), &(condition->up));
+  disc->angular_velocity.x = DISC_THROW_ANGULAR_VELOCITY_X;
+  disc->angular_velocity.y = DISC_THROW_ANGULAR_VELOCITY_Y;
+  disc->angular_velocity.z = DISC_THROW_ANGULAR_VELOCITY_Z;
+  disc->position.z = DISC_THROW_RELEASE_HEIGHT_M;
+  vector_copy_values(&(disc->new_position), &(disc->position));
+  vector_copy_values(&(disc->previous_position), &(disc->position));
 
   disc->disc_state = disc_in_air;
+  start_disc_flight(disc->flight, disc);
+}
+
+#ifndef DT_HEADLESS
+/*
+ * set_init_disc_conditions_from_table
+ *
+ * Sets the disc up to be thrown from where it is now so that it lands at the
+ * target, using the flight condition table rather than working out the throw
+ * from scratch. Only targets inside the table are thrown at, as the table
+ * can't say how to throw any further (or shorter) than it covers.
+ *
+ * Parameters: disc - The disc object.
+ *             table - A loaded flight condition table.
+ *             target - Where the disc should land. Only x and y are used.
+ *             roll - The roll to give the throw (see
+ *                    FLIGHT_CONDITION_LU_TABLE).
+ *
+ * Returns: false if the table is empty or the target is where the disc is or
+ *          is outside the table, in which case the disc is unchanged. true
+ *          otherwise.
+ */
+bool set_init_disc_conditions_from_table(DISC *disc,
+                                         FLIGHT_CONDITION_LU_TABLE *table,
+                                         VECTOR3 *target,
+                                         float roll)
+{
+  /*
+   * Local Variables.
+   */
+  THROW_INIT_CONDITION condition;
+  VECTOR3 velocity;
+  VECTOR3 up;
+  float x_diff = target->x - disc->position.x;
+  float y_diff = target->y - disc->position.y;
+  float distance = sqrtf(x_diff * x_diff + y_diff * y_diff);
+  float cos_heading;
+  float sin_heading;
+
+  if ((distance <= 0.0f) ||
+      (FLIGHT_LU_LOOKUP_OK != get_throw_init_condition(table,
+                                                       distance,
+                                                       roll,
+                                                       &condition)))
+  {
+    return(false);
+  }
+
+  /*
+   * The table conditions are for a throw landing on the x axis so turn them
+   * to face the target.
+   */
+  cos_heading = x_diff / distance;
+  sin_heading = y_diff / distance;
+  velocity = condition.velocity;
+  up = condition.up;
+  vector_set_values(&(condition.velocity),
+                    velocity.x * cos_heading - velocity.y * sin_heading,
+                    velocity.x * sin_heading + velocity.y * cos_heading,
+                    velocity.z);
+  vector_set_values(&(condition.up),
+                    up.x * cos_heading - up.y * sin_heading,
+                    up.x * sin_heading + up.y * cos_heading,
+                    up.z);
+  set_init_disc_conditions_from_throw(disc, &condition);
+
+  return(true);
 }
+#endif
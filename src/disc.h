@@ -13,6 +13,19 @@
 struct player;
 struct disc_throw;
 struct entity_graphic;
+struct flight_condition_lu_table;
+struct disc_throw_init_condition;
+struct disc_flight;
+
+/*
+ * The spin and release height given to the disc by every throw. The flight
+ * condition tables are generated with these so they must be regenerated if
+ * they change.
+ */
+#define DISC_THROW_ANGULAR_VELOCITY_X -13.94f
+#define DISC_THROW_ANGULAR_VELOCITY_Y -1.48f
+#define DISC_THROW_ANGULAR_VELOCITY_Z -54.25f
+#define DISC_THROW_RELEASE_HEIGHT_M 1.5f
 
 /*
  * These are the different states that the disc can be in.
@@ -32,6 +45,8 @@ typedef enum disc_states
  *
  * graphic - The graphical representation of the disc on screen.
  * position - The current position of the disc.
+ * previous_position - The position of the disc at the end of the previous
+ *                     simulation step. Only used to interpolate when drawing.
  * new_position - The next position of the disc post update completion.
  * velocity - The velocity of the disc in the world frame of reference.
  * angular_rotation - The rotation around each of the principal disc axis
@@ -43,11 +58,14 @@ typedef enum disc_states
  *              state of the disc is.
  * thrower - Keeps track of the last player to throw the disc.
  * holder - Keeps track of the player holding the disc.
+ * flight - Flies the disc while it is in the air. Started whenever the disc is
+ *          thrown.
  */
 typedef struct disc
 {
   struct entity_graphic *graphic;
   VECTOR3 position;
+  VECTOR3 previous_position;
   VECTOR3 new_position;
   VECTOR3 velocity;
   VECTOR3 angular_velocity;
@@ -58,11 +76,18 @@ typedef struct disc
   DISC_STATES disc_state;
   struct player *thrower;
   struct player *holder;
+  struct disc_flight *flight;
 } DISC;
 
 DISC *create_disc(char *);
 void destroy_disc(DISC *);
 void create_disc_replica(DISC *, DISC *);
 void set_init_disc_conditions(DISC *, struct disc_throw *);
+void set_init_disc_conditions_from_throw(DISC *,
+                                         struct disc_throw_init_condition *);
+bool set_init_disc_conditions_from_table(DISC *,
+                                         struct flight_condition_lu_table *,
+                                         VECTOR3 *,
+                                         float);
 
 #endif /* DISC_H_ */
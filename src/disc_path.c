@@ -8,16 +8,56 @@
 #include "dt_logger.h"
 
 #include <stdbool.h>
+#include <math.h>
 #include <stddef.h>
 #include "disc_path.h"
 #include "disc.h"
+#include "flight_mechanics/disc_flight.h"
+#include "conversion_constants.h"
 #include "data_structures/vector.h"
-#include "physics.h"
+
+/*
+ * init_disc_path_views
+ *
+ * INTERNAL: Sets up the view for each skill level so that it reads the
+ * positions of the master path closest to the interval for that level.
+ *
+ * Parameters: disc_path - The master path. Its interval must already be set.
+ */
+void init_disc_path_views(DISC_PATH *disc_path)
+{
+  /*
+   * Local Variables.
+   */
+  DISC_PATH_VIEW *view;
+  float skill_interval;
+  int skill;
+
+  for (skill = 0; skill < DISC_PATH_NUM_SKILL_LEVELS; skill++)
+  {
+    view = &(disc_path->views[skill]);
+    skill_interval = DISC_PATH_INTERVAL_MAX * ((float) (skill + 1)) /
+                     ((float) DISC_PATH_NUM_SKILL_LEVELS);
+
+    /*
+     * A view can never be finer than the path it is reading.
+     */
+    view->master = disc_path;
+    view->stride = (int) (skill_interval / disc_path->interval + 0.5f);
+    if (view->stride < 1)
+    {
+      view->stride = 1;
+    }
+    view->interval = disc_path->interval * ((float) view->stride);
+    view->num_master_positions = 0;
+  }
+}
 
 /*
  * create_disc_path
  *
- * Allocates the memory required for a disc_path
+ * Allocates the memory required for a disc_path. This includes the array of
+ * positions which is sized so that it can hold the longest path allowed.
  *
  * Returns: A pointer to the newly created memory
  */
@@ -33,209 +73,555 @@ DISC_PATH *create_disc_path()
    */
   disc_path = (DISC_PATH *) DT_MALLOC(sizeof(DISC_PATH));
 
+  /*
+   * All the positions for a path live in a single block so that the path can
+   * be indexed by time and reused for each throw.
+   */
+  disc_path->positions = (DISC_POSITION *)
+                 DT_MALLOC(sizeof(DISC_POSITION) * MAX_DISC_PATH_ELEMENTS);
+  disc_path->num_positions = 0;
+  disc_path->end_position = NULL;
+  disc_path->max_ground_speed = 0.0f;
+  disc_path->interval = DISC_PATH_INTERVAL_MAX;
+  disc_path->time_created = 0;
+  disc_path->time_to_stop = 0;
+  disc_path->is_complete = false;
+  disc_path->cancel_requested = false;
+  init_disc_path_views(disc_path);
+
+  /*
+   * The worker thread flies its own copy of the disc so that the game disc can
+   * carry on moving while the path is calculated.
+   */
+  disc_path->flight = (DISC_FLIGHT *) DT_MALLOC(sizeof(DISC_FLIGHT));
+  disc_path->worker_thread = NULL;
+  disc_path->lock = SDL_CreateMutex();
+  if (NULL == disc_path->lock)
+  {
+    game_exit("Could not create the disc path mutex.");
+  }
+
   return(disc_path);
 }
 
 /*
  * destroy_disc_path
  *
- * Frees the memory used by the passed in object.
+ * Frees the memory used by the passed in object. Any calculation still running
+ * on the worker thread is stopped first.
  *
  * Parameters: disc_path - The object to be freed.
  */
 void destroy_disc_path(DISC_PATH *disc_path)
 {
+  stop_disc_path_calculation(disc_path);
+
   /*
-   * Free the object.
+   * Free the positions array and then the object.
    */
+  SDL_DestroyMutex(disc_path->lock);
+  DT_FREE(disc_path->flight);
+  DT_FREE(disc_path->positions);
   DT_FREE(disc_path);
 }
 
 /*
- * init_disc_path
+ * publish_disc_path_positions
  *
- * Takes a disc object (which knows where the disc is), a new disc path object
- * and an interval in seconds and fills in the path of the discs flight using
- * a time stepped path.
+ * INTERNAL: Makes the first num_positions positions of the path visible to
+ * readers on other threads.
  *
- * This can then be used to guess where the disc will be at each given moment
- * along the path.
+ * Parameters: disc_path - The path being calculated.
+ *             num_positions - The number of valid positions. Must be > 0.
+ *             is_complete - True if this is the whole of the path. The
+ *                           landing position must have been filled in.
+ */
+void publish_disc_path_positions(DISC_PATH *disc_path,
+                                 int num_positions,
+                                 bool is_complete)
+{
+  /*
+   * Local Variables.
+   */
+  float max_ground_speed = disc_path->max_ground_speed;
+  float x_diff;
+  float y_diff;
+  float speed;
+  int ii;
+
+  /*
+   * Only this thread writes the positions and max_ground_speed so the new
+   * positions can be read without the lock.
+   */
+  for (ii = disc_path->num_positions; ii < num_positions; ii++)
+  {
+    x_diff = disc_path->positions[ii].position.x -
+             disc_path->positions[ii - 1].position.x;
+    y_diff = disc_path->positions[ii].position.y -
+             disc_path->positions[ii - 1].position.y;
+    speed = sqrtf(x_diff * x_diff + y_diff * y_diff) / disc_path->interval;
+    if (speed > max_ground_speed)
+    {
+      max_ground_speed = speed;
+    }
+  }
+
+  SDL_LockMutex(disc_path->lock);
+  disc_path->num_positions = num_positions;
+  disc_path->end_position = &(disc_path->positions[num_positions - 1]);
+  disc_path->max_ground_speed = max_ground_speed;
+  if (is_complete)
+  {
+    disc_path->time_to_stop = disc_path->time_created +
+          (Uint32) (disc_path->landing_position.t * MILLISECONDS_PER_SECOND);
+    disc_path->is_complete = true;
+  }
+  SDL_UnlockMutex(disc_path->lock);
+}
+
+/*
+ * prepare_disc_path
  *
- * It is expensive as it creates a new disc position for each step along the
- * path (calling malloc once per position). This must also be freed.
+ * INTERNAL: Stops any calculation in progress and resets the path ready to
+ * calculate the flight of the disc passed in.
  *
- * Parameters: disc - The game disc.
- *             disc_path - If this already contains a disc path then it will
- *                         leak memory as this function will not free it.
+ * Parameters: disc - The game disc. Copied so it is safe to move afterwards.
+ *             disc_path - The path to reset.
  *             interval - Interval between path positions in seconds.
+ *             time_created - The simulation time in ms at which the disc
+ *                            starts its flight.
  */
-void init_disc_path(DISC *disc, DISC_PATH *disc_path, float interval)
+void prepare_disc_path(DISC *disc,
+                       DISC_PATH *disc_path,
+                       float interval,
+                       Uint32 time_created)
 {
+  stop_disc_path_calculation(disc_path);
+
   /*
-   * Local Variables.
+   * The flight takes its own copy of the disc so the game disc is left alone.
    */
-  DISC temp_disc;
-  DISC_POSITION *curr_position = NULL;
-  DISC_POSITION *prev_position = NULL;
-  int num_positions = 0;
+  start_disc_flight(disc_path->flight, disc);
+
+  disc_path->interval = interval;
+  disc_path->time_created = time_created;
+  disc_path->time_to_stop = disc_path->time_created;
+  disc_path->is_complete = false;
+  disc_path->cancel_requested = false;
+  init_disc_path_views(disc_path);
 
   /*
-   * Copy the disc object so that we can modify it using the standard disc
-   * physics functions.
-   *
-   * We can't just memcpy the whole structure here or we would end up using
-   * the same vector positions (copying pointers).
+   * The release point is always the first position on the path. It is
+   * published straight away so readers always have somewhere to aim for.
+   */
+  disc_path->positions[0].t = 0.0f;
+  vector_copy_values(&(disc_path->positions[0].position), &(disc->position));
+  disc_path->num_positions = 1;
+  disc_path->end_position = &(disc_path->positions[0]);
+  disc_path->max_ground_speed = 0.0f;
+}
+
+/*
+ * calculate_disc_path_positions
+ *
+ * INTERNAL: Flies the copy of the disc held in the path and fills in a disc
+ * position for each interval until the disc hits the floor, followed by the
+ * exact landing position. Positions are published every
+ * DISC_PATH_PUBLISH_STEPS intervals so that readers can use the start of the
+ * path while the rest is calculated.
+ *
+ * Parameters: disc_path - Must have been through prepare_disc_path.
+ */
+void calculate_disc_path_positions(DISC_PATH *disc_path)
+{
+  /*
+   * Local Variables.
    */
-  create_disc_replica(&temp_disc, disc);
+  DISC_FLIGHT *flight = disc_path->flight;
+  DISC_POSITION *curr_position;
+  float interval = disc_path->interval;
+  int num_positions = 1;
+  bool in_air = true;
 
   /*
-   * Create new disc positions for each interval until the disc hits the floor.
-   *
-   * There is fail safe code in here which stops once a maximum number of path
-   * steps have been allocated.
+   * The first position was filled in by prepare_disc_path.
    *
-   * !!!NOTE THAT MEMORY IS ALLOCATED IN THIS LOOP!!!
+   * There is fail safe code in here which stops once the positions array is
+   * full.
    */
-  while (temp_disc.position.z > 0.0f &&
-         num_positions <= MAX_DISC_PATH_ELEMENTS)
+  while (in_air && num_positions < MAX_DISC_PATH_ELEMENTS)
   {
     /*
-     * Create a new disc position (allocates memory) and set the values to be
-     * equal to the temporary disc objects current position.
+     * The main thread may have moved on to a new throw in which case the rest
+     * of this path is of no use to anyone.
      */
-    curr_position = create_disc_position();
-    curr_position->t = ((float) num_positions) * interval;
-    vector_copy_values(&(curr_position->position), &(temp_disc.position));
-
-    /*
-     * If this isn't the first time through then set the previous position to
-     * point to this new one.
-     */
-    if (prev_position != NULL)
+    if (disc_path->cancel_requested)
     {
-      prev_position->next = curr_position;
-    }
-    else
-    {
-      /*
-       * If the previous position is NULL then this is the first node so set
-       * the start position.
-       */
-      disc_path->start_position = curr_position;
+      return;
     }
 
     /*
-     * Update the temporary disc objects position (and other vectors associated
-     * with the flight path calculation).
+     * No path positions are recorded once the disc has gone through the
+     * floor.
      */
-    calculate_disc_position(&temp_disc, interval, false);
+    curr_position = &(disc_path->positions[num_positions]);
+    curr_position->t = ((float) num_positions) * interval;
+    in_air = fly_disc_flight(flight,
+                             curr_position->t,
+                             &(curr_position->position),
+                             NULL);
+    if (in_air)
+    {
+      num_positions++;
+      if (0 == num_positions % DISC_PATH_PUBLISH_STEPS)
+      {
+        publish_disc_path_positions(disc_path, num_positions, false);
+      }
+    }
+  }
 
-    prev_position = curr_position;
-    num_positions++;
+  /*
+   * If we ran out of room before the disc landed then the best we can do is
+   * treat the last position as the landing position.
+   */
+  if (flight->landed)
+  {
+    vector_copy_values(&(disc_path->landing_position.position),
+                       &(flight->landing));
+    disc_path->landing_position.t = flight->landing_t;
+  }
+  else
+  {
+    disc_path->landing_position = disc_path->positions[num_positions - 1];
   }
 
   /*
    * Fill in the end of the disc path so that we can quickly find where it
    * ends. This will be the last position BEFORE the disc hits the floor.
    */
-  disc_path->end_position = curr_position;
+  publish_disc_path_positions(disc_path, num_positions, true);
 }
 
 /*
- * create_disc_position
+ * disc_path_worker
  *
- * Allocates the memory required for a disc_position
+ * INTERNAL: Entry point for the thread started by start_disc_path_calculation.
  *
- * Returns: A pointer to the newly created memory
+ * Parameters: data - The DISC_PATH to fill in.
+ *
+ * Returns: 0 always.
+ */
+int disc_path_worker(void *data)
+{
+  calculate_disc_path_positions((DISC_PATH *) data);
+
+  return(0);
+}
+
+/*
+ * init_disc_path
+ *
+ * Takes a disc object (which knows where the disc is), a disc path object
+ * and an interval in seconds and fills in the path of the discs flight using
+ * a time stepped path.
+ *
+ * This can then be used to guess where the disc will be at each given moment
+ * along the path.
+ *
+ * The whole path is calculated before this returns. Use
+ * start_disc_path_calculation to do the same thing on a worker thread. No
+ * memory is allocated here. Any previous path stored in the object is
+ * overwritten.
+ *
+ * Parameters: disc - The game disc.
+ *             disc_path - Created with create_disc_path. May have been used
+ *                         for a previous throw.
+ *             interval - Interval between path positions in seconds.
+ *             time_created - The simulation time in ms at which the disc
+ *                            starts its flight (see MATCH_STATE
+ *                            sim_time_ms). The path's times are all read
+ *                            against this.
+ */
+void init_disc_path(DISC *disc,
+                    DISC_PATH *disc_path,
+                    float interval,
+                    Uint32 time_created)
+{
+  prepare_disc_path(disc, disc_path, interval, time_created);
+  calculate_disc_path_positions(disc_path);
+}
+
+/*
+ * start_disc_path_calculation
+ *
+ * As init_disc_path but the flight is calculated on a worker thread so that
+ * the caller doesn't have to wait for it. Until the path is complete readers
+ * only see the part of the path that has been published so far.
+ *
+ * If a thread can't be created then the path is calculated immediately
+ * instead.
+ *
+ * Parameters: disc - The game disc.
+ *             disc_path - Created with create_disc_path. May have been used
+ *                         for a previous throw, in which case any calculation
+ *                         still running for that throw is abandoned.
+ *             interval - Interval between path positions in seconds.
+ *             time_created - As init_disc_path.
  */
-DISC_POSITION *create_disc_position()
+void start_disc_path_calculation(DISC *disc,
+                                 DISC_PATH *disc_path,
+                                 float interval,
+                                 Uint32 time_created)
+{
+  prepare_disc_path(disc, disc_path, interval, time_created);
+
+  disc_path->worker_thread = SDL_CreateThread(disc_path_worker, disc_path);
+  if (NULL == disc_path->worker_thread)
+  {
+    DT_DEBUG_LOG("Could not create disc path thread: %s\n", SDL_GetError());
+    calculate_disc_path_positions(disc_path);
+  }
+}
+
+/*
+ * stop_disc_path_calculation
+ *
+ * Stops the worker thread for a path (if there is one) and waits for it to
+ * exit. The path is left incomplete if the thread had not yet finished.
+ *
+ * Parameters: disc_path - The path whose thread is to be stopped.
+ */
+void stop_disc_path_calculation(DISC_PATH *disc_path)
+{
+  if (NULL != disc_path->worker_thread)
+  {
+    disc_path->cancel_requested = true;
+    SDL_WaitThread(disc_path->worker_thread, NULL);
+    disc_path->worker_thread = NULL;
+  }
+}
+
+/*
+ * get_disc_path_progress
+ *
+ * Finds out how much of a disc path can be read. Positions 0 to
+ * num_positions - 1 may be read without further locking until the path is
+ * next restarted.
+ *
+ * Parameters: disc_path - The path to check.
+ *             num_positions - Will contain the number of valid positions.
+ *                             This is at least 1 once a calculation has
+ *                             been started.
+ *
+ * Returns: True if the whole path has been calculated.
+ */
+bool get_disc_path_progress(DISC_PATH *disc_path, int *num_positions)
 {
   /*
-   * Local Variables
+   * Local Variables.
    */
-  DISC_POSITION *disc_position;
+  bool is_complete;
+
+  SDL_LockMutex(disc_path->lock);
+  *num_positions = disc_path->num_positions;
+  is_complete = disc_path->is_complete;
+  SDL_UnlockMutex(disc_path->lock);
+
+  return(is_complete);
+}
 
+/*
+ * get_disc_path_final_position
+ *
+ * Retrieves where the disc will come to rest. Once the path is complete this
+ * is the exact point at which the disc meets the ground. If the path is still
+ * being calculated then this is the furthest point calculated so far.
+ *
+ * Parameters: disc_path - The path to use.
+ *             result - Will contain the position.
+ *
+ * Returns: True if the position is the real final position and false if the
+ *          path is not yet complete.
+ */
+bool get_disc_path_final_position(DISC_PATH *disc_path, VECTOR3 *result)
+{
   /*
-   * Allocate the required memory
+   * Local Variables.
    */
-  disc_position = (DISC_POSITION *) DT_MALLOC(sizeof(DISC_POSITION));
-  disc_position->next = NULL;
+  bool is_complete;
+
+  DT_ASSERT(disc_path->end_position != NULL);
 
-  return(disc_position);
+  SDL_LockMutex(disc_path->lock);
+  is_complete = disc_path->is_complete;
+  if (is_complete)
+  {
+    vector_copy_values(result, &(disc_path->landing_position.position));
+  }
+  else
+  {
+    vector_copy_values(result, &(disc_path->end_position->position));
+  }
+  SDL_UnlockMutex(disc_path->lock);
+
+  return(is_complete);
 }
 
 /*
- * destroy_disc_position
+ * get_disc_path_view
+ *
+ * Retrieves the view onto a disc path used by players of a given skill level.
+ * The view stays valid for as long as the path does.
  *
- * Frees the memory used by the passed in object.
+ * Parameters: disc_path - The master path.
+ *             skill - 0 to DISC_PATH_NUM_SKILL_LEVELS - 1. 0 is the best.
+ *                     Values outside the range are clamped.
  *
- * Parameters: disc_position - The object to be freed.
+ * Returns: A pointer to the view.
  */
-void destroy_disc_position(DISC_POSITION *disc_position)
+DISC_PATH_VIEW *get_disc_path_view(DISC_PATH *disc_path, int skill)
+{
+  if (skill < 0)
+  {
+    skill = 0;
+  }
+  else if (skill >= DISC_PATH_NUM_SKILL_LEVELS)
+  {
+    skill = DISC_PATH_NUM_SKILL_LEVELS - 1;
+  }
+
+  return(&(disc_path->views[skill]));
+}
+
+/*
+ * get_disc_path_view_progress
+ *
+ * As get_disc_path_progress but counts positions in the view rather than in
+ * the master path. Once the path is complete this includes the master's last
+ * position even if it isn't a whole number of strides along.
+ *
+ * Parameters: view - The view to check.
+ *             num_positions - Will contain the number of valid positions in
+ *                             the view.
+ *
+ * Returns: True if the whole path has been calculated.
+ */
+bool get_disc_path_view_progress(DISC_PATH_VIEW *view, int *num_positions)
 {
   /*
-   * Free the object.
+   * Local Variables.
    */
-  DT_FREE(disc_position);
+  bool is_complete;
+  int num_master_positions;
+
+  is_complete = get_disc_path_progress(view->master, &num_master_positions);
+  view->num_master_positions = num_master_positions;
+  *num_positions = (num_master_positions + view->stride - 1) / view->stride;
+  if (is_complete && (0 != (num_master_positions - 1) % view->stride))
+  {
+    (*num_positions)++;
+  }
+
+  return(is_complete);
 }
 
 /*
- * destroy_disc_position_list
+ * get_disc_path_view_position
+ *
+ * Retrieves a position from a view. This is a position in the master path so
+ * its time is relative to the creation of the master path as normal.
  *
- * Free the entire of a linked list of disc positions.
+ * Parameters: view - The view to read.
+ *             index - Must be less than the number of positions returned by
+ *                     get_disc_path_view_progress.
  *
- * Parameters: start_position - The beginning of the list. May be null.
+ * Returns: A pointer to the position.
  */
-void destroy_disc_position_list(DISC_POSITION *start_position)
+DISC_POSITION *get_disc_path_view_position(DISC_PATH_VIEW *view, int index)
 {
   /*
    * Local Variables.
    */
-  DISC_POSITION *curr_position = start_position;
-  DISC_POSITION *next_position;
+  int master_index = index * view->stride;
 
   /*
-   * Iterate over the linked list of disc positions freeing them all.
+   * Only the last position of a complete path can be past the end of the
+   * master, and that is the master's last position.
    */
-  while (curr_position != NULL)
+  if (master_index >= view->num_master_positions)
   {
-    next_position = curr_position->next;
-    destroy_disc_position(curr_position);
+    master_index = view->num_master_positions - 1;
   }
+
+  return(&(view->master->positions[master_index]));
 }
 
 /*
- * disc_position_at_time_nearest
+ * get_disc_path_elapsed_time
  *
- * Given a disc path and a time t we want to find which of the pre calculated
- * intervals is the nearest to the desired.
+ * Parameters: disc_path - The path.
+ *             now - The time now in ms, on the same clock as time_created.
  *
- * If t goes beyond the amount of time the disc path exists for then we return
- * the last position calculated.
+ * Returns: The time in s since the path was started, on the same clock as the
+ *          t of each position in the path.
+ */
+float get_disc_path_elapsed_time(DISC_PATH *disc_path, Uint32 now)
+{
+  if (now <= disc_path->time_created)
+  {
+    return(0.0f);
+  }
+
+  return(((float) (now - disc_path->time_created)) / MILLISECONDS_PER_SECOND);
+}
+
+/*
+ * get_disc_path_max_ground_speed
+ *
+ * Parameters: disc_path - The path.
+ *
+ * Returns: The fastest the disc moves across the ground along the published
+ *          part of the path (see DISC_PATH). Covers at least the positions
+ *          given by any earlier call to get_disc_path_progress.
+ */
+float get_disc_path_max_ground_speed(DISC_PATH *disc_path)
+{
+  /*
+   * Local Variables.
+   */
+  float max_ground_speed;
+
+  SDL_LockMutex(disc_path->lock);
+  max_ground_speed = disc_path->max_ground_speed;
+  SDL_UnlockMutex(disc_path->lock);
+
+  return(max_ground_speed);
+}
+
+/*
+ * disc_path_find_nearest_pos
+ *
+ * Given two adjacent positions in a disc path and the fraction of an interval
+ * that has passed since the first, pick whichever is closest in time.
  *
  * DO NOT CALL DIRECTLY - This is called by the general disc_position_at_time
  * function and does not include any error checking on variables.
  *
- * Parameters: disc_path - The path of the disc. Must be non null.
- *             before - The last pre calculated interval before the time t.
+ * Parameters: before - The last pre calculated interval before the time t.
  *             after - The next pre calculated point in the path after the
  *                     before variable.
- *             t - The time that we want to know the position for.
- *             time_at_position_before - The absolute time in ms at the
- *                                       pre calculated value before.
+ *             fraction - The fraction of the interval elapsed since before.
  *             result - Will contain the nearest position as a vector.
  */
-void disc_path_find_nearest_pos(DISC_PATH *disc_path,
-                                DISC_POSITION *before,
+void disc_path_find_nearest_pos(DISC_POSITION *before,
                                 DISC_POSITION *after,
-                                Uint32 t,
-                                Uint32 time_at_position_before,
+                                float fraction,
                                 VECTOR3 *result)
 {
   /*
    * Determine which of two positions is the closest to the required time.
    */
-  if (t - time_at_position_before < (Uint32) (disc_path->interval / 2))
+  if (fraction < 0.5f)
   {
     vector_copy_values(result, &(before->position));
   }
@@ -248,56 +634,47 @@ void disc_path_find_nearest_pos(DISC_PATH *disc_path,
 /*
  * disc_path_find_interp_distance
  *
- * Given two adjacent position in a disc path, and a time that is somewhere
- * between them this function can be used to give a linearly interpolated
- * guess of where the disc will be in x,y,z coordinates at the time t.
+ * Given two adjacent position in a disc path, and the fraction of an interval
+ * that has passed since the first, this function gives a linearly
+ * interpolated guess of where the disc will be in x,y,z coordinates.
  *
  * IMPORTANT - This function has no error checking and should NEVER be called
  * directly. Always use the generic function disc_position_at_time instead.
  *
- * Parameters: disc_path - Contains the information like interval time.
- *             before - The last pre calculated interval before the time t.
+ * Parameters: before - The last pre calculated interval before the time t.
  *             after - The next pre calculated point in the path after the
  *                     before variable.
- *             t - The time in milliseconds. Must be between before and after.
- *             time_at_position_before - The absolute time in ms at the
- *                                       pre calculated value before.
- *             x, y, z - Will contain the interpolated position.
+ *             fraction - The fraction of the interval elapsed since before.
+ *             result - Will contain the interpolated position.
  */
-void disc_path_find_interp_distance(DISC_PATH *disc_path,
-                                    DISC_POSITION *before,
+void disc_path_find_interp_distance(DISC_POSITION *before,
                                     DISC_POSITION *after,
-                                    Uint32 t,
-                                    Uint32 time_at_position_before,
+                                    float fraction,
                                     VECTOR3 *result)
 {
-  /*
-   * Local Variables
-   */
-  float scaling_factor = (float) (disc_path->interval / 
-                                  (t - time_at_position_before));
-
-  /*
-   * Calculate the linear interpolated value of x,y and z using the ratio of
-   * the distances.
-   */
-  result->x = before->position.x +
-                    (after->position.x - before->position.x) * scaling_factor;
-  result->y = before->position.y +
-                    (after->position.y - before->position.y) * scaling_factor;
-  result->z = before->position.z +
-                    (after->position.z - before->position.z) * scaling_factor;
+  *result = vector_interpolate(&(before->position),
+                               &(after->position),
+                               fraction);
 }
 
 /*
  * disc_position_at_time
  *
- * Finds where the disc will be at time t where t is a millisecond value as
- * returned by SDL_GetTicks.
+ * Finds where the disc will be at time t where t is a millisecond value on
+ * the simulation clock that the path was created on (see MATCH_STATE
+ * sim_time_ms).
+ *
+ * The positions are evenly spaced in time so the pair of positions either
+ * side of t are found by index rather than by searching.
+ *
+ * If the path is still being calculated and hasn't reached t then
+ * DISC_POSITION_CALC_PATH_INCOMPLETE is returned along with the furthest
+ * position calculated so far.
  *
  * Parameters: disc_path - The path of the disc that we want to use.
  *             t - The number of milliseconds.
- *             pos_x, pos_y, pos_z - Will be filled in with the return values.
+ *             calc_type - Which of the positions around t to return.
+ *             result - Will be filled in with the position.
  *
  * Returns: One of DISC_POSITION_CALC_RET_CODES.
  */
@@ -309,58 +686,81 @@ int disc_position_at_time(DISC_PATH *disc_path,
   /*
    * Local Variables.
    */
-  DISC_POSITION *curr_position;
   DISC_POSITION *position_before;
   DISC_POSITION *position_after;
   int ret_code = DISC_POSITION_CALC_OK;
-  Uint32 delta_t;
-  int num_intervals;
-  int ii;
+  float delta_t;
+  float fraction;
+  int index;
+  int num_positions;
+  bool is_complete;
 
   /*
    * Check the input variables.
    */
   DT_ASSERT(disc_path != NULL);
-  DT_ASSERT(disc_path->start_position != NULL);
   if (t < disc_path->time_created)
   {
     ret_code = DISC_POSITION_CALC_INPUT_TIME_BEFORE;
     goto EXIT_LABEL;
   }
 
+  is_complete = get_disc_path_progress(disc_path, &num_positions);
+
   /*
    * If the time entered is after the disc will have stopped then we just return
    * the finish position for the path and set a return code so that the calling
    * function can handle it. This is NOT an error.
    */
-  if (t >= disc_path->time_to_stop)
+  if (is_complete && t >= disc_path->time_to_stop)
   {
-    vector_copy_values(result, &(disc_path->end_position->position));
+    vector_copy_values(result, &(disc_path->landing_position.position));
     ret_code = DISC_POSITION_CALC_DISC_STOPPED;
+    goto EXIT_LABEL;
   }
 
   /*
-   * Find the number of intervals between the start of the disc path and the
-   * end.
-   *
-   * The division below is integer division.
+   * Find the number of whole intervals between the start of the disc path and
+   * t.
    */
-  delta_t = t - disc_path->time_created;
-  num_intervals = delta_t / disc_path->interval;
+  delta_t = ((float) (t - disc_path->time_created)) / MILLISECONDS_PER_SECOND;
+  index = (int) (delta_t / disc_path->interval);
 
   /*
-     * Find the position that the disc is in after that number of intervals. We
-     * know that this should exist because we have already checked that the time
-     * Inputed lies between the start time and the end time of the disc path.
-     */
-    curr_position = disc_path->start_position;
-    for (ii = 0; ii < num_intervals; ii++)
-    {
-      curr_position = curr_position->next;
-      DT_ASSERT(curr_position != NULL);
-    }
-    position_before = curr_position;
-    position_after = curr_position->next;
+   * If the worker thread hasn't got as far as t yet then the best we can do
+   * is return the furthest position known so far.
+   */
+  if (!is_complete && index + 1 >= num_positions)
+  {
+    get_disc_path_final_position(disc_path, result);
+    ret_code = DISC_POSITION_CALC_PATH_INCOMPLETE;
+    goto EXIT_LABEL;
+  }
+
+  /*
+   * Since t is before the disc lands the position before it is always valid.
+   * The one after it is either the next position or, after the last position
+   * in the path, the landing position.
+   */
+  if (index >= num_positions - 1)
+  {
+    position_before = &(disc_path->positions[num_positions - 1]);
+    position_after = &(disc_path->landing_position);
+  }
+  else
+  {
+    position_before = &(disc_path->positions[index]);
+    position_after = &(disc_path->positions[index + 1]);
+  }
+  if (position_after->t > position_before->t)
+  {
+    fraction = (delta_t - position_before->t) /
+               (position_after->t - position_before->t);
+  }
+  else
+  {
+    fraction = 0.0f;
+  }
 
   /*
    * There are various methods that we can use for determining what positions
@@ -376,20 +776,16 @@ int disc_position_at_time(DISC_PATH *disc_path,
   switch(calc_type)
   {
     case INTERPOLATE:
-      disc_path_find_interp_distance(disc_path,
-                                     position_before,
+      disc_path_find_interp_distance(position_before,
                                      position_after,
-                                     t,
-                                     num_intervals * disc_path->interval,
+                                     fraction,
                                      result);
       break;
 
     case NEAREST:
-      disc_path_find_nearest_pos(disc_path,
-                                 position_before,
+      disc_path_find_nearest_pos(position_before,
                                  position_after,
-                                 t,
-                                 num_intervals * disc_path->interval,
+                                 fraction,
                                  result);
       break;
 
@@ -409,4 +805,4 @@ int disc_position_at_time(DISC_PATH *disc_path,
   EXIT_LABEL:
 
   return(ret_code);
-}
\ No newline at end of file
+}
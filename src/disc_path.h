@@ -26,17 +26,20 @@
 #ifndef DISC_PATH_H_
 #define DISC_PATH_H_
 
+#include <stdbool.h>
 #include "SDL/SDL.h"
+#include "SDL/SDL_thread.h"
 #include "data_structures/vector.h"
 
 struct disc;
+struct disc_flight;
 
 /*
  * MAX_DISC_PATH_ELEMENTS is the maximum number of steps in a disc path object.
  * It is used to prevent a bug in the disc path generation causing the game to
- * fall over in a heap.
+ * fall over in a heap. At DISC_PATH_INTERVAL_MIN this allows for a 20s flight.
  */
-#define MAX_DISC_PATH_ELEMENTS 10000
+#define MAX_DISC_PATH_ELEMENTS 20000
 
 /*
  * DISC_POSITION_CALC_RET_CODES
@@ -53,11 +56,15 @@ struct disc;
  * be handled as such. It indicates that the enum value passed in to determine
  * which algorithm the calling function requires was not one that is currently
  * handled.
+ * DISC_POSITION_CALC_PATH_INCOMPLETE - The path is still being calculated on
+ * the worker thread and has not yet reached the time inputed. Try again on a
+ * later frame.
  */
 #define DISC_POSITION_CALC_OK                0
 #define DISC_POSITION_CALC_INPUT_TIME_BEFORE 1
 #define DISC_POSITION_CALC_DISC_STOPPED      2
 #define DISC_POSITION_CALC_BAD_CALC_TYPE     3
+#define DISC_POSITION_CALC_PATH_INCOMPLETE   4
 
 typedef enum disc_pos_calc_type
 {
@@ -74,65 +81,166 @@ typedef enum disc_pos_calc_type
 #define DISC_PATH_INTERVAL_MIN 0.001f
 #define DISC_PATH_INTERVAL_MAX 0.020f
 
+/*
+ * The flight is not integrated at the path interval itself. It is flown with
+ * a DISC_FLIGHT (see disc_flight.h), exactly as the disc is flown in the
+ * match, and the position at each path interval is read from that. The
+ * flight takes long steps in a stable glide and short ones where it bends
+ * sharply.
+ *
+ * The exact point at which the disc meets the ground is found by solving the
+ * cubic for the last step rather than using the last step that was still in
+ * the air.
+ */
+
+/*
+ * When a path is calculated on the worker thread the positions are made
+ * visible to the rest of the game in blocks of this many steps. The start of
+ * the flight is therefore available almost immediately after the throw.
+ */
+#define DISC_PATH_PUBLISH_STEPS 32
+
+/*
+ * Players read the disc with differing skill. Skill level 0 is the best and
+ * reads the path at the finest interval. Each level above that reads it at a
+ * coarser interval, up to DISC_PATH_INTERVAL_MAX for the worst level. The
+ * interval for a skill level is
+ *
+ *   DISC_PATH_INTERVAL_MAX * (skill + 1) / DISC_PATH_NUM_SKILL_LEVELS
+ *
+ * DISC_PATH_SKILL_DEFAULT is the level given to a player unless they are set
+ * up otherwise.
+ */
+#define DISC_PATH_NUM_SKILL_LEVELS 4
+#define DISC_PATH_SKILL_DEFAULT (DISC_PATH_NUM_SKILL_LEVELS - 1)
+
 /*
  * DISC_POSITION
  *
- * A linked list node that holds the position of the disc. A disc path object
- * has a list of these and an interval value that determines the amount of time
- * that elapses between each position.
+ * A single step in a disc path. A disc path object holds a contiguous array of
+ * these and an interval value that determines the amount of time that elapses
+ * between each position, so the step for a given time can be found directly.
  *
  * position - The position of the disc at this point along the path.
- * next - The next position in the path.
  * t - The relative time (s)(from creation) for this point. We need this so that
  *     a position can be passed around without referring to the original path.
  */
 typedef struct disc_position
 {
   VECTOR3 position;
-  struct disc_position *next;
   float t;
 } DISC_POSITION;
 
+/*
+ * DISC_PATH_VIEW
+ *
+ * A coarser view onto a disc path. Rather than calculating the flight again at
+ * a larger interval a view just reads every stride'th position of the master
+ * path, so it costs nothing to create and is always exactly as complete as
+ * the master path. Once the master path is complete its last position is
+ * always in the view as well, so every view ends where the master does. The
+ * last segment of a view can therefore be shorter than interval.
+ *
+ * master - The path that this is a view onto.
+ * stride - The number of master positions between each position in the view.
+ * interval - The amount of seconds between each position in the view.
+ * num_master_positions - The number of master positions seen by the last
+ *                        call to get_disc_path_view_progress. Only used on
+ *                        the main thread.
+ */
+typedef struct disc_path_view
+{
+  struct disc_path *master;
+  int stride;
+  float interval;
+  int num_master_positions;
+} DISC_PATH_VIEW;
+
 /*
  * DISC_PATH
  *
- * Each ai player creates one of these whenever a new throw is made. The better
- * the ai the smaller the interval value and so the better they will read the
- * disc. The reason for this is that the smaller the interval value the more
- * accurate the path model will be. As it tends towards 0 the path will tend
- * towards a smooth curve showing the disc flight.
+ * One of these is created for the match and filled in whenever a new throw is
+ * made. The smaller the interval value the more accurate the path model will
+ * be. As it tends towards 0 the path will tend towards a smooth curve showing
+ * the disc flight.
+ *
+ * The better the ai the better they read the disc. Rather than each ai
+ * calculating a path of their own at an interval suited to them the path is
+ * calculated once at a fine interval and each ai reads it through the view for
+ * their skill level (see get_disc_path_view).
  *
  * It is used by the ai players to determine where they need to run in order to
  * intercept the disc.
  *
  * We can also use this to debug the disc flight.
  *
- * interval - The amount of milliseconds between each of the calculations of
- * disc position.
- * time_created - The number of milliseconds that had elapsed when the
- * structure was created.
- * time_to_stop - The value of SDL_GetTicks at the end of the path.
- * start_position - The head of a singly linked list that contains the path for
- * the disc. The last element in the list is the last calculated point before
- * the disc hits the floor.
- * end_position - The final resting point of the disc. This is required as it
- * is unlikely that the disc stopping point corresponds exactly with an
- * interval boundary.
+ * The positions array is allocated once when the path is created and is large
+ * enough for the longest possible path so a path object can be reused for
+ * every throw without allocating again.
+ *
+ * The path can be calculated on a worker thread (see
+ * start_disc_path_calculation). In that case positions are published in
+ * blocks as they are calculated, so any reader on the main thread must use
+ * get_disc_path_progress to find out how much of the path is valid rather
+ * than reading num_positions directly.
+ *
+ * interval - The amount of seconds between each of the calculations of disc
+ * position.
+ * time_created - The simulation time in ms (see MATCH_STATE sim_time_ms) at
+ * which the disc started the flight that the path follows.
+ * time_to_stop - The simulation time in ms at which the disc lands. Only
+ * valid once the path is complete.
+ * positions - The path of the disc. positions[ii] is the position of the disc
+ * ii intervals after the path was created.
+ * num_positions - The number of valid entries in the positions array. Guarded
+ * by lock.
+ * end_position - The last published element of the positions array. Once the
+ * path is complete this is the last calculated point before the disc hits the
+ * floor. Guarded by lock.
+ * landing_position - Exactly where and when the disc meets the ground. Only
+ * valid once the path is complete.
+ * max_ground_speed - The fastest the disc moves across the ground (ignoring
+ * height) between any two published positions in m/s. Because the path is
+ * read as straight lines between positions this bounds how fast the disc
+ * moves in any view as well. Guarded by lock.
+ * is_complete - Set once the whole flight has been calculated. Guarded by lock.
+ * cancel_requested - Set by the main thread to stop the worker early.
+ * flight - Flies a copy of the disc taken when the calculation was started.
+ *          The worker thread flies this rather than the game disc.
+ * worker_thread - The thread calculating the path. NULL if there isn't one.
+ * lock - Protects the fields written by the worker thread.
+ * views - A view onto this path for each of the skill levels.
  */
 typedef struct disc_path
 {
-  int interval;
+  float interval;
   Uint32 time_created;
   Uint32 time_to_stop;
-  DISC_POSITION *start_position;
+  DISC_POSITION *positions;
+  int num_positions;
   DISC_POSITION *end_position;
+  DISC_POSITION landing_position;
+  float max_ground_speed;
+  bool is_complete;
+  volatile bool cancel_requested;
+  struct disc_flight *flight;
+  SDL_Thread *worker_thread;
+  SDL_mutex *lock;
+  DISC_PATH_VIEW views[DISC_PATH_NUM_SKILL_LEVELS];
 } DISC_PATH;
 
 DISC_PATH *create_disc_path();
 void destroy_disc_path(DISC_PATH *);
-void init_disc_path(struct disc *, DISC_PATH *, float);
-DISC_POSITION *create_disc_position();
-void destroy_disc_position_list(DISC_POSITION *);
+void init_disc_path(struct disc *, DISC_PATH *, float, Uint32);
+void start_disc_path_calculation(struct disc *, DISC_PATH *, float, Uint32);
+void stop_disc_path_calculation(DISC_PATH *);
+bool get_disc_path_progress(DISC_PATH *, int *);
+bool get_disc_path_final_position(DISC_PATH *, VECTOR3 *);
+DISC_PATH_VIEW *get_disc_path_view(DISC_PATH *, int);
+bool get_disc_path_view_progress(DISC_PATH_VIEW *, int *);
+DISC_POSITION *get_disc_path_view_position(DISC_PATH_VIEW *, int);
+float get_disc_path_elapsed_time(DISC_PATH *, Uint32);
+float get_disc_path_max_ground_speed(DISC_PATH *);
 int disc_position_at_time(DISC_PATH *,
                           Uint32,
                           DISC_POS_CALC_TYPE,
@@ -46,10 +46,20 @@ FILE *g_ai_log_file;
  * Long term perhaps replacing all of this with a proper logging library that
  * I didn't write is the solution to aim for.
  */
+#ifdef DT_NO_DEBUG_LOG
+/*
+ * Tools which only use the flight model (benchmarks etc.) build with
+ * DT_NO_DEBUG_LOG so that the per step debug logging doesn't swamp them. They
+ * don't open the log files so memory logging is turned off as well.
+ */
+#define DT_DEBUG_LOG(fmt, ...)
+#define DT_MEM_LOG(fmt, ...)
+#else
 #define DT_DEBUG_LOG(fmt, ...) fprintf(g_log_file, fmt, ## __VA_ARGS__); \
                            fflush(g_log_file);
 #define DT_MEM_LOG(fmt, ...) fprintf(g_mem_log_file, fmt, ## __VA_ARGS__); \
                          fflush(g_mem_log_file);
+#endif
 #define DT_AI_LOG(fmt, ...) fprintf(g_ai_log_file, fmt, ## __VA_ARGS__); \
                         fflush(g_ai_log_file);
 #define DT_KILL_LOG kill_logger(g_log_file); \
@@ -7,12 +7,26 @@
 
 #include "dt_logger.h"
 
+#include <limits.h>
+#include <stdio.h>
+#include <math.h>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
 #include "flight_condition_lu_table.h"
+#include "throw_init_condition.h"
+#include "data_structures/vector.h"
 
 /*
  * create_flight_condition_lu_table
  *
- * Allocates the memory required for a flight_condition_lu_table
+ * Allocates the memory required for a flight_condition_lu_table. The table is
+ * empty until it is either initialised or loaded from file.
  *
  * Returns: A pointer to the newly created memory
  */
@@ -28,20 +42,493 @@ FLIGHT_CONDITION_LU_TABLE *create_flight_condition_lu_table()
    */
   flight_condition_lu_table = (FLIGHT_CONDITION_LU_TABLE *) DT_MALLOC(sizeof(FLIGHT_CONDITION_LU_TABLE));
 
+  flight_condition_lu_table->num_distances = 0;
+  flight_condition_lu_table->num_rolls = 0;
+  flight_condition_lu_table->conditions = NULL;
+  flight_condition_lu_table->mapped_data = NULL;
+  flight_condition_lu_table->mapped_size = 0;
+  flight_condition_lu_table->mapping_handle = NULL;
+
   return(flight_condition_lu_table);
 }
 
+/*
+ * release_flight_condition_lu_data
+ *
+ * INTERNAL: Frees or unmaps the conditions held by a table, leaving it empty.
+ *
+ * Parameters: table - The table to empty.
+ */
+void release_flight_condition_lu_data(FLIGHT_CONDITION_LU_TABLE *table)
+{
+  if (NULL != table->mapped_data)
+  {
+#ifdef _WIN32
+    UnmapViewOfFile(table->mapped_data);
+    CloseHandle((HANDLE) table->mapping_handle);
+#else
+    munmap(table->mapped_data, table->mapped_size);
+#endif
+  }
+  else if (NULL != table->conditions)
+  {
+    DT_FREE(table->conditions);
+  }
+
+  table->num_distances = 0;
+  table->num_rolls = 0;
+  table->conditions = NULL;
+  table->mapped_data = NULL;
+  table->mapped_size = 0;
+  table->mapping_handle = NULL;
+}
+
 /*
  * destroy_flight_condition_lu_table
  *
- * Frees the memory used by the passed in object.
+ * Frees the memory used by the passed in object, including unmapping the
+ * table file if it was loaded from one.
  *
  * Parameters: flight_condition_lu_table - The object to be freed.
  */
 void destroy_flight_condition_lu_table(FLIGHT_CONDITION_LU_TABLE *flight_condition_lu_table)
 {
+  release_flight_condition_lu_data(flight_condition_lu_table);
+
   /*
    * Free the object.
    */
   DT_FREE(flight_condition_lu_table);
 }
+
+/*
+ * init_flight_condition_lu_table
+ *
+ * Sets up the grid of a table and allocates the conditions for it. Each
+ * condition has its distance and roll filled in but the velocity and up vector
+ * are left for the caller (the table generator) to calculate.
+ *
+ * Parameters: table - The table to set up. Any existing data is released.
+ *             min_distance, max_distance, distance_delta - The distances.
+ *             min_roll, max_roll, roll_delta - The amounts of roll.
+ *
+ * Returns: FLIGHT_LU_TABLE_OK or FLIGHT_LU_TABLE_BAD_GRID if the ranges or
+ *          deltas don't describe a grid.
+ */
+int init_flight_condition_lu_table(FLIGHT_CONDITION_LU_TABLE *table,
+                                   float min_distance,
+                                   float max_distance,
+                                   float distance_delta,
+                                   float min_roll,
+                                   float max_roll,
+                                   float roll_delta)
+{
+  /*
+   * Local Variables.
+   */
+  THROW_INIT_CONDITION *condition;
+  int ii;
+  int jj;
+
+  if ((distance_delta <= 0.0f) || (roll_delta <= 0.0f) ||
+      (max_distance < min_distance) || (max_roll < min_roll))
+  {
+    return(FLIGHT_LU_TABLE_BAD_GRID);
+  }
+
+  release_flight_condition_lu_data(table);
+
+  /*
+   * The maximum values are rounded to the nearest grid point so that every
+   * row and column is evenly spaced.
+   */
+  table->num_distances =
+              (int) floorf((max_distance - min_distance) / distance_delta + 0.5f) + 1;
+  table->num_rolls = (int) floorf((max_roll - min_roll) / roll_delta + 0.5f) + 1;
+  table->min_distance = min_distance;
+  table->distance_delta = distance_delta;
+  table->max_distance = min_distance + (table->num_distances - 1) * distance_delta;
+  table->min_roll = min_roll;
+  table->roll_delta = roll_delta;
+  table->max_roll = min_roll + (table->num_rolls - 1) * roll_delta;
+  table->conditions = (THROW_INIT_CONDITION *) DT_MALLOC(
+                                           sizeof(THROW_INIT_CONDITION) *
+                                           table->num_distances *
+                                           table->num_rolls);
+
+  for (ii = 0; ii < table->num_distances; ii++)
+  {
+    for (jj = 0; jj < table->num_rolls; jj++)
+    {
+      condition = get_flight_condition_lu_entry(table, ii, jj);
+      vector_set_values(&(condition->velocity), 0.0f, 0.0f, 0.0f);
+      vector_set_values(&(condition->up), 0.0f, 0.0f, 1.0f);
+      condition->distance = min_distance + ii * distance_delta;
+      condition->roll = min_roll + jj * roll_delta;
+    }
+  }
+
+  return(FLIGHT_LU_TABLE_OK);
+}
+
+/*
+ * get_flight_condition_lu_entry
+ *
+ * Parameters: table - The table.
+ *             distance_index - The row of the entry.
+ *             roll_index - The column of the entry.
+ *
+ * Returns: A pointer to the condition stored at that grid point.
+ */
+THROW_INIT_CONDITION *get_flight_condition_lu_entry(
+                                      FLIGHT_CONDITION_LU_TABLE *table,
+                                      int distance_index,
+                                      int roll_index)
+{
+  return(&(table->conditions[distance_index * table->num_rolls + roll_index]));
+}
+
+/*
+ * save_flight_condition_lu_table
+ *
+ * Writes a table to file in the format read by
+ * load_flight_condition_lu_table. See FLIGHT_CONDITION_LU_TABLE_HEADER.
+ *
+ * Parameters: table - The table to save.
+ *             filename - The file to write. Overwritten if it exists.
+ *
+ * Returns: FLIGHT_LU_TABLE_OK or FLIGHT_LU_TABLE_FILE_ERROR.
+ */
+int save_flight_condition_lu_table(FLIGHT_CONDITION_LU_TABLE *table,
+                                   char *filename)
+{
+  /*
+   * Local Variables.
+   */
+  FLIGHT_CONDITION_LU_TABLE_HEADER header;
+  FILE *file;
+  size_t num_conditions;
+  int rc = FLIGHT_LU_TABLE_OK;
+
+  header.magic = FLIGHT_LU_TABLE_MAGIC;
+  header.version = FLIGHT_LU_TABLE_VERSION;
+  header.num_distances = (unsigned int) table->num_distances;
+  header.num_rolls = (unsigned int) table->num_rolls;
+  header.min_distance = table->min_distance;
+  header.max_distance = table->max_distance;
+  header.min_roll = table->min_roll;
+  header.max_roll = table->max_roll;
+  header.distance_delta = table->distance_delta;
+  header.roll_delta = table->roll_delta;
+  num_conditions = (size_t) table->num_distances * table->num_rolls;
+
+  file = fopen(filename, "wb");
+  if (NULL == file)
+  {
+    DT_DEBUG_LOG("Could not open flight table file %s for writing\n", filename);
+    return(FLIGHT_LU_TABLE_FILE_ERROR);
+  }
+
+  if ((1 != fwrite(&header, sizeof(header), 1, file)) ||
+      (num_conditions != fwrite(table->conditions,
+                                sizeof(THROW_INIT_CONDITION),
+                                num_conditions,
+                                file)))
+  {
+    DT_DEBUG_LOG("Failed writing flight table file %s\n", filename);
+    rc = FLIGHT_LU_TABLE_FILE_ERROR;
+  }
+
+  if (0 != fclose(file))
+  {
+    rc = FLIGHT_LU_TABLE_FILE_ERROR;
+  }
+
+  return(rc);
+}
+
+/*
+ * load_flight_condition_lu_table
+ *
+ * Maps a table file written by save_flight_condition_lu_table into memory.
+ * The conditions are used in place so loading costs no more than checking the
+ * header, and the pages are shared with any other process using the file.
+ *
+ * Parameters: table - The table to fill in. Any existing data is released.
+ *             filename - The file to load.
+ *
+ * Returns: FLIGHT_LU_TABLE_OK, FLIGHT_LU_TABLE_FILE_ERROR if the file can't be
+ *          mapped or FLIGHT_LU_TABLE_BAD_FORMAT if it isn't a valid table, in
+ *          which case the table is left empty.
+ */
+int load_flight_condition_lu_table(FLIGHT_CONDITION_LU_TABLE *table,
+                                   char *filename)
+{
+  /*
+   * Local Variables.
+   */
+  FLIGHT_CONDITION_LU_TABLE_HEADER *header;
+  void *mapped_data;
+  size_t mapped_size;
+  size_t data_size;
+  void *mapping_handle = NULL;
+#ifdef _WIN32
+  HANDLE file;
+  HANDLE mapping;
+  LARGE_INTEGER file_size;
+#else
+  int fd;
+  struct stat file_stat;
+#endif
+
+  release_flight_condition_lu_data(table);
+
+  /*
+   * Map the whole file read only.
+   */
+#ifdef _WIN32
+  file = CreateFileA(filename,
+                     GENERIC_READ,
+                     FILE_SHARE_READ,
+                     NULL,
+                     OPEN_EXISTING,
+                     FILE_ATTRIBUTE_NORMAL,
+                     NULL);
+  if (INVALID_HANDLE_VALUE == file)
+  {
+    DT_DEBUG_LOG("Could not open flight table file %s\n", filename);
+    return(FLIGHT_LU_TABLE_FILE_ERROR);
+  }
+  if ((!GetFileSizeEx(file, &file_size)) ||
+      (file_size.QuadPart < (LONGLONG) sizeof(FLIGHT_CONDITION_LU_TABLE_HEADER)))
+  {
+    CloseHandle(file);
+    return(FLIGHT_LU_TABLE_BAD_FORMAT);
+  }
+  mapped_size = (size_t) file_size.QuadPart;
+  mapping = CreateFileMapping(file, NULL, PAGE_READONLY, 0, 0, NULL);
+  CloseHandle(file);
+  if (NULL == mapping)
+  {
+    return(FLIGHT_LU_TABLE_FILE_ERROR);
+  }
+  mapped_data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+  if (NULL == mapped_data)
+  {
+    CloseHandle(mapping);
+    return(FLIGHT_LU_TABLE_FILE_ERROR);
+  }
+  mapping_handle = (void *) mapping;
+#else
+  fd = open(filename, O_RDONLY);
+  if (-1 == fd)
+  {
+    DT_DEBUG_LOG("Could not open flight table file %s\n", filename);
+    return(FLIGHT_LU_TABLE_FILE_ERROR);
+  }
+  if ((0 != fstat(fd, &file_stat)) ||
+      (file_stat.st_size < (off_t) sizeof(FLIGHT_CONDITION_LU_TABLE_HEADER)))
+  {
+    close(fd);
+    return(FLIGHT_LU_TABLE_BAD_FORMAT);
+  }
+  mapped_size = (size_t) file_stat.st_size;
+  mapped_data = mmap(NULL, mapped_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (MAP_FAILED == mapped_data)
+  {
+    return(FLIGHT_LU_TABLE_FILE_ERROR);
+  }
+#endif
+
+  table->mapped_data = mapped_data;
+  table->mapped_size = mapped_size;
+  table->mapping_handle = mapping_handle;
+
+  /*
+   * Check the header describes a table of exactly the size of the file before
+   * pointing the conditions into it. The number of entries is bounded before
+   * it is multiplied out so that a bad header can't overflow the sizes, and
+   * it has to fit in an int as the entries are indexed by int.
+   */
+  header = (FLIGHT_CONDITION_LU_TABLE_HEADER *) mapped_data;
+  data_size = mapped_size - sizeof(FLIGHT_CONDITION_LU_TABLE_HEADER);
+  if ((FLIGHT_LU_TABLE_MAGIC != header->magic) ||
+      (FLIGHT_LU_TABLE_VERSION != header->version) ||
+      (0 == header->num_distances) ||
+      (0 == header->num_rolls) ||
+      (header->num_distances > INT_MAX / header->num_rolls) ||
+      (header->distance_delta <= 0.0f) ||
+      (header->roll_delta <= 0.0f) ||
+      (0 != data_size % sizeof(THROW_INIT_CONDITION)) ||
+      (data_size / sizeof(THROW_INIT_CONDITION) !=
+                              header->num_distances * header->num_rolls))
+  {
+    DT_DEBUG_LOG("Flight table file %s is not a valid table\n", filename);
+    release_flight_condition_lu_data(table);
+    return(FLIGHT_LU_TABLE_BAD_FORMAT);
+  }
+
+  table->num_distances = (int) header->num_distances;
+  table->num_rolls = (int) header->num_rolls;
+  table->min_distance = header->min_distance;
+  table->max_distance = header->max_distance;
+  table->min_roll = header->min_roll;
+  table->max_roll = header->max_roll;
+  table->distance_delta = header->distance_delta;
+  table->roll_delta = header->roll_delta;
+  table->conditions = (THROW_INIT_CONDITION *) (header + 1);
+
+  return(FLIGHT_LU_TABLE_OK);
+}
+
+/*
+ * find_flight_condition_lu_cell
+ *
+ * INTERNAL: Works out which two rows (or columns) of the table a value lies
+ * between and how far between them it is. Values outside the table are
+ * clamped to its edge.
+ *
+ * Parameters: value - The distance or roll to find.
+ *             min_value - The value of the first row.
+ *             delta - The spacing of the rows.
+ *             num_values - The number of rows.
+ *             lower_index - Filled in with the row at or below the value.
+ *             upper_index - Filled in with the row above the value.
+ *             fraction - Filled in with how far the value is from the lower
+ *                        row to the upper row (0 to 1).
+ *
+ * Returns: true if the value had to be clamped, false otherwise.
+ */
+bool find_flight_condition_lu_cell(float value,
+                                   float min_value,
+                                   float delta,
+                                   int num_values,
+                                   int *lower_index,
+                                   int *upper_index,
+                                   float *fraction)
+{
+  /*
+   * Local Variables.
+   */
+  float position = (value - min_value) / delta;
+  bool clamped = false;
+
+  if (position < 0.0f)
+  {
+    position = 0.0f;
+    clamped = true;
+  }
+  else if (position > (float) (num_values - 1))
+  {
+    position = (float) (num_values - 1);
+    clamped = true;
+  }
+
+  *lower_index = (int) position;
+  if (*lower_index >= num_values - 1)
+  {
+    *lower_index = (num_values > 1) ? (num_values - 2) : 0;
+  }
+  *upper_index = (num_values > 1) ? (*lower_index + 1) : 0;
+  *fraction = position - (float) *lower_index;
+
+  return(clamped);
+}
+
+/*
+ * get_throw_init_condition
+ *
+ * Finds the throw conditions needed to move the disc a given distance with a
+ * given amount of roll by bilinear interpolation between the four nearest
+ * entries in the table.
+ *
+ * The result is for a throw along the +x axis (see FLIGHT_CONDITION_LU_TABLE)
+ * and must be rotated to the actual direction of the throw by the caller.
+ *
+ * Parameters: table - The table to look in.
+ *             distance - The distance the disc should travel.
+ *             roll - The roll of the disc.
+ *             result - Filled in with the conditions. The distance and roll
+ *                      are those actually used after clamping to the table.
+ *
+ * Returns: FLIGHT_LU_LOOKUP_OK, FLIGHT_LU_LOOKUP_CLAMPED if the distance or
+ *          roll were outside the table or FLIGHT_LU_LOOKUP_EMPTY if the table
+ *          has no data, in which case result is unchanged.
+ */
+int get_throw_init_condition(FLIGHT_CONDITION_LU_TABLE *table,
+                             float distance,
+                             float roll,
+                             THROW_INIT_CONDITION *result)
+{
+  /*
+   * Local Variables.
+   */
+  THROW_INIT_CONDITION *c00;
+  THROW_INIT_CONDITION *c01;
+  THROW_INIT_CONDITION *c10;
+  THROW_INIT_CONDITION *c11;
+  int d0;
+  int d1;
+  int r0;
+  int r1;
+  float d_frac;
+  float r_frac;
+  float w00;
+  float w01;
+  float w10;
+  float w11;
+  bool clamped;
+
+  if (NULL == table->conditions)
+  {
+    return(FLIGHT_LU_LOOKUP_EMPTY);
+  }
+
+  clamped = find_flight_condition_lu_cell(distance,
+                                          table->min_distance,
+                                          table->distance_delta,
+                                          table->num_distances,
+                                          &d0,
+                                          &d1,
+                                          &d_frac);
+  clamped |= find_flight_condition_lu_cell(roll,
+                                           table->min_roll,
+                                           table->roll_delta,
+                                           table->num_rolls,
+                                           &r0,
+                                           &r1,
+                                           &r_frac);
+
+  c00 = get_flight_condition_lu_entry(table, d0, r0);
+  c01 = get_flight_condition_lu_entry(table, d0, r1);
+  c10 = get_flight_condition_lu_entry(table, d1, r0);
+  c11 = get_flight_condition_lu_entry(table, d1, r1);
+  w00 = (1.0f - d_frac) * (1.0f - r_frac);
+  w01 = (1.0f - d_frac) * r_frac;
+  w10 = d_frac * (1.0f - r_frac);
+  w11 = d_frac * r_frac;
+
+  result->velocity.x = w00 * c00->velocity.x + w01 * c01->velocity.x +
+                       w10 * c10->velocity.x + w11 * c11->velocity.x;
+  result->velocity.y = w00 * c00->velocity.y + w01 * c01->velocity.y +
+                       w10 * c10->velocity.y + w11 * c11->velocity.y;
+  result->velocity.z = w00 * c00->velocity.z + w01 * c01->velocity.z +
+                       w10 * c10->velocity.z + w11 * c11->velocity.z;
+  result->up.x = w00 * c00->up.x + w01 * c01->up.x +
+                 w10 * c10->up.x + w11 * c11->up.x;
+  result->up.y = w00 * c00->up.y + w01 * c01->up.y +
+                 w10 * c10->up.y + w11 * c11->up.y;
+  result->up.z = w00 * c00->up.z + w01 * c01->up.z +
+                 w10 * c10->up.z + w11 * c11->up.z;
+
+  /*
+   * Blending unit vectors shortens them so put the up vector back to unit
+   * length.
+   */
+  result->up = unit_vector(&(result->up));
+  result->distance = c00->distance + d_frac * (c10->distance - c00->distance);
+  result->roll = c00->roll + r_frac * (c01->roll - c00->roll);
+
+  return(clamped ? FLIGHT_LU_LOOKUP_CLAMPED : FLIGHT_LU_LOOKUP_OK);
+}
@@ -8,8 +8,57 @@
 #ifndef FLIGHT_CONDITION_LU_TABLE_H_
 #define FLIGHT_CONDITION_LU_TABLE_H_
 
+#include <stddef.h>
+
 struct disc_throw_init_condition;
 
+/*
+ * Return codes for loading and saving a table.
+ */
+#define FLIGHT_LU_TABLE_OK 0
+#define FLIGHT_LU_TABLE_FILE_ERROR 1
+#define FLIGHT_LU_TABLE_BAD_FORMAT 2
+#define FLIGHT_LU_TABLE_BAD_GRID 3
+
+/*
+ * Return codes for get_throw_init_condition.
+ */
+#define FLIGHT_LU_LOOKUP_OK 0
+#define FLIGHT_LU_LOOKUP_CLAMPED 1
+#define FLIGHT_LU_LOOKUP_EMPTY 2
+
+/*
+ * Identifies a flight condition table file ("FCLU" when read as bytes on a
+ * little endian machine) and the version of the layout below.
+ */
+#define FLIGHT_LU_TABLE_MAGIC 0x554C4346
+#define FLIGHT_LU_TABLE_VERSION 2
+
+/*
+ * FLIGHT_CONDITION_LU_TABLE_HEADER
+ *
+ * The start of a flight condition table file. It is followed directly by
+ * num_distances * num_rolls THROW_INIT_CONDITIONs laid out in the same order
+ * as the conditions array of the table, so that the file can be mapped into
+ * memory and used without any parsing.
+ *
+ * The file is written in the byte order of the machine that generated it. A
+ * file with the wrong byte order fails the magic number check.
+ */
+typedef struct flight_condition_lu_table_header
+{
+  unsigned int magic;
+  unsigned int version;
+  unsigned int num_distances;
+  unsigned int num_rolls;
+  float min_distance;
+  float max_distance;
+  float min_roll;
+  float max_roll;
+  float distance_delta;
+  float roll_delta;
+} FLIGHT_CONDITION_LU_TABLE_HEADER;
+
 /*
  * FLIGHT_CONDITION_LU_TABLE
  *
@@ -25,6 +74,15 @@ struct disc_throw_init_condition;
  * Perfection is not required and therefore not achieved with this method.
  * Accuracy can be increased by making distance_delta, roll_delta smaller.
  *
+ * Every condition is for a throw released from the origin at
+ * DISC_THROW_RELEASE_HEIGHT_M with the standard throw spin that lands on the
+ * +x axis at the distance. Roll turns the up vector about the direction of
+ * travel, positive roll tilting it towards -y, and curves the flight, so a
+ * rolled throw is aimed off the axis by however much it curves.
+ *
+ * The tables are generated by Tools/flight_lu_table (make game does this) and
+ * loaded by the game with load_flight_condition_lu_table.
+ *
  * min_distance - The smallest distance this lookup table works for.
  * max_distance - The largest distance this table works for.
  * min_roll - The smallest amount of roll (negative) allowed.
@@ -33,8 +91,15 @@ struct disc_throw_init_condition;
  *                  and x + distance_delta.
  * roll_delta - Two adjacent conditions in the table are for roll r and
  *              r + roll_delta.
+ * num_distances - The number of rows in the table.
+ * num_rolls - The number of columns in the table.
  * conditions - The table of throw conditions. Each column corresponds to a
- *              certain amount of roll and each row to a certain distance.
+ *              certain amount of roll and each row to a certain distance. The
+ *              condition for row ii, column jj is at ii * num_rolls + jj.
+ * mapped_data - The start of the file mapping if the table was loaded from
+ *               file, otherwise NULL and conditions was allocated.
+ * mapped_size - The size of the file mapping.
+ * mapping_handle - Platform handle for the mapping (Windows only).
  */
 typedef struct flight_condition_lu_table
 {
@@ -44,10 +109,32 @@ typedef struct flight_condition_lu_table
   float max_roll;
   float distance_delta;
   float roll_delta;
-  struct disc_throw_init_condition ***conditions;
+  int num_distances;
+  int num_rolls;
+  struct disc_throw_init_condition *conditions;
+  void *mapped_data;
+  size_t mapped_size;
+  void *mapping_handle;
 } FLIGHT_CONDITION_LU_TABLE;
 
 FLIGHT_CONDITION_LU_TABLE *create_flight_condition_lu_table();
 void destroy_flight_condition_lu_table(FLIGHT_CONDITION_LU_TABLE *);
+int init_flight_condition_lu_table(FLIGHT_CONDITION_LU_TABLE *,
+                                   float,
+                                   float,
+                                   float,
+                                   float,
+                                   float,
+                                   float);
+struct disc_throw_init_condition *get_flight_condition_lu_entry(
+                                               FLIGHT_CONDITION_LU_TABLE *,
+                                               int,
+                                               int);
+int save_flight_condition_lu_table(FLIGHT_CONDITION_LU_TABLE *, char *);
+int load_flight_condition_lu_table(FLIGHT_CONDITION_LU_TABLE *, char *);
+int get_throw_init_condition(FLIGHT_CONDITION_LU_TABLE *,
+                             float,
+                             float,
+                             struct disc_throw_init_condition *);
 
 #endif /* FLIGHT_CONDITION_LU_TABLE_H_ */
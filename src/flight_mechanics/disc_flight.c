@@ -12,6 +12,7 @@
 
 #include <math.h>
 #include "../disc.h"
+#include "disc_flight.h"
 #include "disc_forces.h"
 #include "../physics.h"
 #include "disc_flight_constants.h"
@@ -276,3 +277,600 @@ DISC_FORCES calc_disc_forces(VECTOR3 *disc_velocity,
 
   return(output_forces);
 }
+
+/*
+ * calc_disc_acceleration
+ *
+ * Works out the acceleration of the disc if it were travelling at the given
+ * velocity. The disc orientation and angular velocities are taken from the
+ * disc object. Since the disc orientation is not changed during a step this
+ * is the only thing that the integrators need to evaluate at each stage.
+ *
+ * Parameters: disc - The disc. Not modified.
+ *             velocity - The velocity to evaluate the acceleration at.
+ *             disc_forces - Filled in with the forces on the disc at that
+ *                           velocity.
+ *
+ * Returns: The acceleration vector.
+ */
+VECTOR3 calc_disc_acceleration(DISC *disc,
+                               VECTOR3 *velocity,
+                               DISC_FORCES *disc_forces)
+{
+  /*
+   * Local Variables.
+   */
+  VECTOR3 d1;
+  VECTOR3 acceleration;
+  float alpha;
+
+  d1 = find_disc_plane_axis(velocity, &(disc->d3));
+  alpha = smallest_angle_between_vectors(velocity, &d1);
+  if (vector_dot_product(velocity, &(disc->d3)) >= 0)
+  {
+    alpha = -1.0f * alpha;
+  }
+  *disc_forces = calc_disc_forces(velocity, &(disc->angular_velocity), alpha);
+  get_disc_acc_from_forces(disc_forces,
+                           velocity,
+                           &acceleration,
+                           &d1,
+                           &(disc->d3));
+
+  return(acceleration);
+}
+
+/*
+ * integrate_disc_flight
+ *
+ * Steps the flight of the disc forward by a single time step using the
+ * integrator asked for. The velocity and angular velocities on the disc are
+ * updated along with the position vector passed in.
+ *
+ * The pitch and roll velocities are always set from the forces at the start
+ * of the step whichever integrator is used.
+ *
+ * Parameters: disc - The disc being moved.
+ *             position - The position vector to move. This is normally either
+ *                        the position or new_position of the disc.
+ *             time_step_s - The length of the step in s.
+ *             integrator - Which numerical method to use.
+ */
+void integrate_disc_flight(DISC *disc,
+                           VECTOR3 *position,
+                           float time_step_s,
+                           DISC_INTEGRATOR integrator)
+{
+  /*
+   * Local Variables.
+   */
+  DISC_FORCES disc_forces;
+  DISC_FORCES stage_forces;
+  VECTOR3 start_velocity = disc->velocity;
+  VECTOR3 acc_1;
+  VECTOR3 acc_2;
+  VECTOR3 acc_3;
+  VECTOR3 acc_4;
+  VECTOR3 vel_2;
+  VECTOR3 vel_3;
+  VECTOR3 vel_4;
+  VECTOR3 delta;
+  float half_step_s = time_step_s / 2.0f;
+  float sixth_step_s = time_step_s / 6.0f;
+
+  acc_1 = calc_disc_acceleration(disc, &start_velocity, &disc_forces);
+
+  switch(integrator)
+  {
+    case disc_integrator_euler:
+      /*
+       * Move using the velocity at the start of the step and only then update
+       * the velocity.
+       */
+      delta = mult_vector_by_scalar(&start_velocity, time_step_s);
+      *position = vector_add(position, &delta);
+      delta = mult_vector_by_scalar(&acc_1, time_step_s);
+      disc->velocity = vector_add(&start_velocity, &delta);
+      break;
+
+    case disc_integrator_rk4:
+      /*
+       * The acceleration only depends on the velocity (the orientation is
+       * fixed over the step) so each stage only needs the stage velocity.
+       */
+      delta = mult_vector_by_scalar(&acc_1, half_step_s);
+      vel_2 = vector_add(&start_velocity, &delta);
+      acc_2 = calc_disc_acceleration(disc, &vel_2, &stage_forces);
+
+      delta = mult_vector_by_scalar(&acc_2, half_step_s);
+      vel_3 = vector_add(&start_velocity, &delta);
+      acc_3 = calc_disc_acceleration(disc, &vel_3, &stage_forces);
+
+      delta = mult_vector_by_scalar(&acc_3, time_step_s);
+      vel_4 = vector_add(&start_velocity, &delta);
+      acc_4 = calc_disc_acceleration(disc, &vel_4, &stage_forces);
+
+      /*
+       * position += h/6 * (v1 + 2v2 + 2v3 + v4)
+       * velocity += h/6 * (a1 + 2a2 + 2a3 + a4)
+       */
+      delta = vector_add(&vel_2, &vel_3);
+      delta = mult_vector_by_scalar(&delta, 2.0f);
+      delta = vector_add(&delta, &start_velocity);
+      delta = vector_add(&delta, &vel_4);
+      delta = mult_vector_by_scalar(&delta, sixth_step_s);
+      *position = vector_add(position, &delta);
+
+      delta = vector_add(&acc_2, &acc_3);
+      delta = mult_vector_by_scalar(&delta, 2.0f);
+      delta = vector_add(&delta, &acc_1);
+      delta = vector_add(&delta, &acc_4);
+      delta = mult_vector_by_scalar(&delta, sixth_step_s);
+      disc->velocity = vector_add(&start_velocity, &delta);
+      break;
+
+    case disc_integrator_semi_implicit_euler:
+    default:
+      /*
+       * Update the velocity first and then move using the new velocity.
+       */
+      delta = mult_vector_by_scalar(&acc_1, time_step_s);
+      disc->velocity = vector_add(&start_velocity, &delta);
+      delta = mult_vector_by_scalar(&(disc->velocity), time_step_s);
+      *position = vector_add(position, &delta);
+      break;
+  }
+
+  update_extra_vels_from_disc_forces(disc, &disc_forces, time_step_s);
+}
+
+/*
+ * Coefficients of the Dormand-Prince 5(4) embedded Runge-Kutta pair. The 5th
+ * order weights are the last row of the stage matrix. The error weights are
+ * the difference between the 5th and 4th order weights.
+ */
+#define DOPRI_STAGES 7
+static const float dopri_a[DOPRI_STAGES][DOPRI_STAGES - 1] = {
+  {0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f},
+  {1.0f / 5.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f},
+  {3.0f / 40.0f, 9.0f / 40.0f, 0.0f, 0.0f, 0.0f, 0.0f},
+  {44.0f / 45.0f, -56.0f / 15.0f, 32.0f / 9.0f, 0.0f, 0.0f, 0.0f},
+  {19372.0f / 6561.0f, -25360.0f / 2187.0f, 64448.0f / 6561.0f,
+   -212.0f / 729.0f, 0.0f, 0.0f},
+  {9017.0f / 3168.0f, -355.0f / 33.0f, 46732.0f / 5247.0f, 49.0f / 176.0f,
+   -5103.0f / 18656.0f, 0.0f},
+  {35.0f / 384.0f, 0.0f, 500.0f / 1113.0f, 125.0f / 192.0f,
+   -2187.0f / 6784.0f, 11.0f / 84.0f}};
+static const float dopri_b[DOPRI_STAGES] = {
+  35.0f / 384.0f, 0.0f, 500.0f / 1113.0f, 125.0f / 192.0f,
+  -2187.0f / 6784.0f, 11.0f / 84.0f, 0.0f};
+static const float dopri_e[DOPRI_STAGES] = {
+  71.0f / 57600.0f, 0.0f, -71.0f / 16695.0f, 71.0f / 1920.0f,
+  -17253.0f / 339200.0f, 22.0f / 525.0f, -1.0f / 40.0f};
+
+/*
+ * integrate_disc_flight_adaptive
+ *
+ * Steps the flight of the disc forward using the Dormand-Prince 5(4) pair,
+ * choosing the length of the step so that the estimated position error of the
+ * step is within the tolerance. Steps that fail the tolerance are retried
+ * with a smaller step so this always moves the disc on by the step returned.
+ *
+ * In a stable glide the steps grow large. Where the flight bends sharply (at
+ * the apex or as the disc stalls near the ground) they shrink.
+ *
+ * Parameters: disc - The disc being moved.
+ *             position - The position vector to move.
+ *             step_s - The step to try first.
+ *             tolerance_m - The largest error in position allowed for a step.
+ *             next_step_s - Will contain the step to try next time.
+ *
+ * Returns: The length of the step actually taken in s.
+ */
+float integrate_disc_flight_adaptive(DISC *disc,
+                                     VECTOR3 *position,
+                                     float step_s,
+                                     float tolerance_m,
+                                     float *next_step_s)
+{
+  /*
+   * Local Variables.
+   */
+  DISC_FORCES disc_forces;
+  DISC_FORCES stage_forces;
+  VECTOR3 start_velocity = disc->velocity;
+  VECTOR3 stage_vel[DOPRI_STAGES];
+  VECTOR3 stage_acc[DOPRI_STAGES];
+  VECTOR3 pos_delta;
+  VECTOR3 vel_delta;
+  VECTOR3 pos_error;
+  VECTOR3 vel_error;
+  VECTOR3 term;
+  float error;
+  float scale;
+  bool accepted = false;
+  int ii;
+  int jj;
+
+  /*
+   * The first stage doesn't depend on the step so only needs working out
+   * once however many times the step is retried.
+   */
+  stage_vel[0] = start_velocity;
+  stage_acc[0] = calc_disc_acceleration(disc, &start_velocity, &disc_forces);
+
+  while (!accepted)
+  {
+    /*
+     * As in the fixed step integrators the acceleration only depends on the
+     * velocity so each stage only needs the stage velocity.
+     */
+    for (ii = 1; ii < DOPRI_STAGES; ii++)
+    {
+      stage_vel[ii] = start_velocity;
+      for (jj = 0; jj < ii; jj++)
+      {
+        term = mult_vector_by_scalar(&(stage_acc[jj]),
+                                     step_s * dopri_a[ii][jj]);
+        stage_vel[ii] = vector_add(&(stage_vel[ii]), &term);
+      }
+      stage_acc[ii] = calc_disc_acceleration(disc,
+                                             &(stage_vel[ii]),
+                                             &stage_forces);
+    }
+
+    /*
+     * Combine the stages into the 5th order step and the estimate of its
+     * error.
+     */
+    vector_set_values(&pos_delta, 0.0f, 0.0f, 0.0f);
+    vector_set_values(&vel_delta, 0.0f, 0.0f, 0.0f);
+    vector_set_values(&pos_error, 0.0f, 0.0f, 0.0f);
+    vector_set_values(&vel_error, 0.0f, 0.0f, 0.0f);
+    for (ii = 0; ii < DOPRI_STAGES; ii++)
+    {
+      term = mult_vector_by_scalar(&(stage_vel[ii]), step_s * dopri_b[ii]);
+      pos_delta = vector_add(&pos_delta, &term);
+      term = mult_vector_by_scalar(&(stage_acc[ii]), step_s * dopri_b[ii]);
+      vel_delta = vector_add(&vel_delta, &term);
+      term = mult_vector_by_scalar(&(stage_vel[ii]), step_s * dopri_e[ii]);
+      pos_error = vector_add(&pos_error, &term);
+      term = mult_vector_by_scalar(&(stage_acc[ii]), step_s * dopri_e[ii]);
+      vel_error = vector_add(&vel_error, &term);
+    }
+
+    /*
+     * A velocity error grows into a position error over the next step so it
+     * is scaled by the step before being compared.
+     */
+    error = vector_length(&pos_error);
+    if (vector_length(&vel_error) * step_s > error)
+    {
+      error = vector_length(&vel_error) * step_s;
+    }
+
+    /*
+     * Standard step size control. The new step is scaled by the 5th root of
+     * the ratio between the tolerance and the error with a safety factor,
+     * but is not allowed to change too much in one go.
+     */
+    if (error > 0.0f)
+    {
+      scale = 0.9f * powf(tolerance_m / error, 0.2f);
+    }
+    else
+    {
+      scale = DISC_FLIGHT_MAX_STEP_GROWTH;
+    }
+    if (scale > DISC_FLIGHT_MAX_STEP_GROWTH)
+    {
+      scale = DISC_FLIGHT_MAX_STEP_GROWTH;
+    }
+    else if (scale < DISC_FLIGHT_MIN_STEP_SHRINK)
+    {
+      scale = DISC_FLIGHT_MIN_STEP_SHRINK;
+    }
+
+    if (error <= tolerance_m || step_s <= DISC_FLIGHT_MIN_STEP_S)
+    {
+      accepted = true;
+      *position = vector_add(position, &pos_delta);
+      disc->velocity = vector_add(&start_velocity, &vel_delta);
+      *next_step_s = step_s * scale;
+    }
+    else
+    {
+      step_s = step_s * scale;
+      if (step_s < DISC_FLIGHT_MIN_STEP_S)
+      {
+        step_s = DISC_FLIGHT_MIN_STEP_S;
+      }
+    }
+  }
+
+  update_extra_vels_from_disc_forces(disc, &disc_forces, step_s);
+
+  return(step_s);
+}
+
+/*
+ * interpolate_disc_flight_step
+ *
+ * Finds a position part way through an integration step using the cubic
+ * Hermite curve through the positions and velocities at each end of the step.
+ * This is far more accurate than a straight line when the steps are long.
+ *
+ * Parameters: start_pos, start_vel - Position and velocity at the start.
+ *             end_pos, end_vel - Position and velocity at the end.
+ *             step_s - The length of the step in s.
+ *             fraction - How far through the step (0 to 1).
+ *             result - Will contain the position.
+ */
+void interpolate_disc_flight_step(VECTOR3 *start_pos,
+                                  VECTOR3 *start_vel,
+                                  VECTOR3 *end_pos,
+                                  VECTOR3 *end_vel,
+                                  float step_s,
+                                  float fraction,
+                                  VECTOR3 *result)
+{
+  /*
+   * Local Variables.
+   */
+  float f2 = fraction * fraction;
+  float f3 = f2 * fraction;
+  float h00 = 2.0f * f3 - 3.0f * f2 + 1.0f;
+  float h10 = (f3 - 2.0f * f2 + fraction) * step_s;
+  float h01 = -2.0f * f3 + 3.0f * f2;
+  float h11 = (f3 - f2) * step_s;
+
+  result->x = h00 * start_pos->x + h10 * start_vel->x +
+              h01 * end_pos->x + h11 * end_vel->x;
+  result->y = h00 * start_pos->y + h10 * start_vel->y +
+              h01 * end_pos->y + h11 * end_vel->y;
+  result->z = h00 * start_pos->z + h10 * start_vel->z +
+              h01 * end_pos->z + h11 * end_vel->z;
+}
+
+/*
+ * interpolate_disc_flight_velocity
+ *
+ * Finds the velocity part way through an integration step from the same cubic
+ * as interpolate_disc_flight_step.
+ *
+ * Parameters: start_pos, start_vel - Position and velocity at the start.
+ *             end_pos, end_vel - Position and velocity at the end.
+ *             step_s - The length of the step in s.
+ *             fraction - How far through the step (0 to 1).
+ *             result - Will contain the velocity.
+ */
+void interpolate_disc_flight_velocity(VECTOR3 *start_pos,
+                                      VECTOR3 *start_vel,
+                                      VECTOR3 *end_pos,
+                                      VECTOR3 *end_vel,
+                                      float step_s,
+                                      float fraction,
+                                      VECTOR3 *result)
+{
+  /*
+   * Local Variables.
+   */
+  float f2 = fraction * fraction;
+  float d00 = (6.0f * f2 - 6.0f * fraction) / step_s;
+  float d10 = 3.0f * f2 - 4.0f * fraction + 1.0f;
+  float d11 = 3.0f * f2 - 2.0f * fraction;
+
+  result->x = d00 * (start_pos->x - end_pos->x) + d10 * start_vel->x +
+              d11 * end_vel->x;
+  result->y = d00 * (start_pos->y - end_pos->y) + d10 * start_vel->y +
+              d11 * end_vel->y;
+  result->z = d00 * (start_pos->z - end_pos->z) + d10 * start_vel->z +
+              d11 * end_vel->z;
+}
+
+/*
+ * find_disc_flight_landing
+ *
+ * Finds where during an integration step the disc meets the ground. The
+ * height along the step is given by the cubic used by
+ * interpolate_disc_flight_step and the root is found by bisection.
+ *
+ * Parameters: start_pos, start_vel - Position and velocity at the start. The
+ *                                    start must be above the ground.
+ *             end_pos, end_vel - Position and velocity at the end. The end
+ *                                must be on or below the ground.
+ *             step_s - The length of the step in s.
+ *             result - Will contain the landing position (z = 0).
+ *
+ * Returns: The fraction of the way through the step at which the disc lands.
+ */
+float find_disc_flight_landing(VECTOR3 *start_pos,
+                               VECTOR3 *start_vel,
+                               VECTOR3 *end_pos,
+                               VECTOR3 *end_vel,
+                               float step_s,
+                               VECTOR3 *result)
+{
+  /*
+   * Local Variables.
+   */
+  float lower = 0.0f;
+  float upper = 1.0f;
+  float fraction = 1.0f;
+  int ii;
+
+  for (ii = 0; ii < DISC_FLIGHT_LANDING_ITERATIONS; ii++)
+  {
+    fraction = (lower + upper) / 2.0f;
+    interpolate_disc_flight_step(start_pos,
+                                 start_vel,
+                                 end_pos,
+                                 end_vel,
+                                 step_s,
+                                 fraction,
+                                 result);
+    if (result->z > 0.0f)
+    {
+      lower = fraction;
+    }
+    else
+    {
+      upper = fraction;
+    }
+  }
+
+  fraction = upper;
+  interpolate_disc_flight_step(start_pos,
+                               start_vel,
+                               end_pos,
+                               end_vel,
+                               step_s,
+                               fraction,
+                               result);
+  result->z = 0.0f;
+
+  return(fraction);
+}
+
+/*
+ * step_disc_flight
+ *
+ * INTERNAL: Moves a flight on by one adaptive step. If the disc goes through
+ * the ground during the step then the exact landing point is found.
+ *
+ * Parameters: flight - A flight that has not landed.
+ */
+void step_disc_flight(DISC_FLIGHT *flight)
+{
+  /*
+   * Local Variables.
+   */
+  DISC *disc = &(flight->disc);
+
+  vector_copy_values(&(flight->start_pos), &(disc->position));
+  vector_copy_values(&(flight->start_vel), &(disc->velocity));
+  flight->start_t = flight->end_t;
+  flight->step_s = integrate_disc_flight_adaptive(disc,
+                                                  &(disc->position),
+                                                  flight->next_step_s,
+                                                  DISC_FLIGHT_TOLERANCE_M,
+                                                  &(flight->next_step_s));
+  flight->end_t = flight->start_t + flight->step_s;
+
+  if (disc->position.z <= 0.0f)
+  {
+    flight->landing_t = flight->start_t + flight->step_s *
+                        find_disc_flight_landing(&(flight->start_pos),
+                                                 &(flight->start_vel),
+                                                 &(disc->position),
+                                                 &(disc->velocity),
+                                                 flight->step_s,
+                                                 &(flight->landing));
+    flight->landed = true;
+  }
+}
+
+/*
+ * start_disc_flight
+ *
+ * Sets a flight up to fly the disc from where it is now. A disc that starts
+ * on the ground has landed straight away.
+ *
+ * Parameters: flight - The flight to set up. May have been used before.
+ *             disc - The disc at the moment of release.
+ */
+void start_disc_flight(DISC_FLIGHT *flight, DISC *disc)
+{
+  flight->disc = *disc;
+  flight->disc.flight = NULL;
+  vector_copy_values(&(flight->start_pos), &(disc->position));
+  vector_copy_values(&(flight->start_vel), &(disc->velocity));
+  flight->start_t = 0.0f;
+  flight->end_t = 0.0f;
+  flight->step_s = 0.0f;
+  flight->next_step_s = DISC_FLIGHT_FIRST_STEP_S;
+  flight->t = 0.0f;
+  flight->landed = (disc->position.z <= 0.0f);
+  vector_copy_values(&(flight->landing), &(disc->position));
+  flight->landing_t = 0.0f;
+}
+
+/*
+ * fly_disc_flight
+ *
+ * Moves a flight on to a given time and finds where the disc is then. Times
+ * must not go backwards from one call to the next.
+ *
+ * Parameters: flight - Set up with start_disc_flight.
+ *             t - The time (s) since release.
+ *             position - Will contain the position at t, or the landing
+ *                        point if the disc has landed by then.
+ *             velocity - If not NULL will contain the velocity at t, or at
+ *                        the moment of landing.
+ *
+ * Returns: true if the disc is still in the air at t.
+ */
+bool fly_disc_flight(DISC_FLIGHT *flight,
+                     float t,
+                     VECTOR3 *position,
+                     VECTOR3 *velocity)
+{
+  /*
+   * Local Variables.
+   */
+  bool in_air = true;
+  float fraction;
+
+  while (!flight->landed && flight->end_t <= t)
+  {
+    step_disc_flight(flight);
+  }
+  flight->t = t;
+
+  if (flight->landed && t >= flight->landing_t)
+  {
+    in_air = false;
+    t = flight->landing_t;
+  }
+
+  /*
+   * A disc that never left the ground has no step to look in.
+   */
+  if (flight->step_s <= 0.0f)
+  {
+    vector_copy_values(position, &(flight->landing));
+    if (NULL != velocity)
+    {
+      vector_copy_values(velocity, &(flight->start_vel));
+    }
+    return(in_air);
+  }
+
+  fraction = (t - flight->start_t) / flight->step_s;
+  if (in_air)
+  {
+    interpolate_disc_flight_step(&(flight->start_pos),
+                                 &(flight->start_vel),
+                                 &(flight->disc.position),
+                                 &(flight->disc.velocity),
+                                 flight->step_s,
+                                 fraction,
+                                 position);
+  }
+  else
+  {
+    vector_copy_values(position, &(flight->landing));
+  }
+  if (NULL != velocity)
+  {
+    interpolate_disc_flight_velocity(&(flight->start_pos),
+                                     &(flight->start_vel),
+                                     &(flight->disc.position),
+                                     &(flight->disc.velocity),
+                                     flight->step_s,
+                                     fraction,
+                                     velocity);
+  }
+
+  return(in_air);
+}
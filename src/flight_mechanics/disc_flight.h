@@ -8,9 +8,68 @@
 #ifndef DISC_FLIGHT_H_
 #define DISC_FLIGHT_H_
 
+#include <stdbool.h>
 #include "disc_forces.h"
+#include "../disc.h"
+#include "../physics.h"
 #include "../data_structures/vector.h"
 
+/*
+ * Limits on the step taken by integrate_disc_flight_adaptive. The step is
+ * never shrunk below DISC_FLIGHT_MIN_STEP_S even if the error is still too
+ * large, so that a badly behaved flight can't stall the integration.
+ */
+#define DISC_FLIGHT_MIN_STEP_S 0.00001f
+#define DISC_FLIGHT_MAX_STEP_GROWTH 5.0f
+#define DISC_FLIGHT_MIN_STEP_SHRINK 0.2f
+
+/*
+ * The number of bisections used to find where the disc lands during a step.
+ */
+#define DISC_FLIGHT_LANDING_ITERATIONS 24
+
+/*
+ * The error allowed in each step of a DISC_FLIGHT and the step it tries
+ * first. Over the tolerances that are any use the error at any point of the
+ * flight follows the tolerance (see Tools/flight_benchmark).
+ */
+#define DISC_FLIGHT_TOLERANCE_M 0.00001f
+#define DISC_FLIGHT_FIRST_STEP_S 0.010f
+
+/*
+ * DISC_FLIGHT
+ *
+ * Flies a copy of a disc with integrate_disc_flight_adaptive and gives the
+ * position at any time during the flight from the cubic through the step that
+ * covers it. The match disc and disc paths are both flown this way so that
+ * the disc takes exactly the steps that its predicted path did.
+ *
+ * disc - The copy being flown. Its position and velocity are those at the end
+ *        of the current step.
+ * start_pos, start_vel - The position and velocity at the start of the
+ *                        current step.
+ * start_t, end_t - The time (s) since release at each end of the current step.
+ * step_s - The length of the current step.
+ * next_step_s - The step to try next.
+ * t - The time (s) since release that the flight was last moved on to.
+ * landed - Whether the disc has hit the ground. If so then landing is where
+ *          and landing_t is when.
+ */
+typedef struct disc_flight
+{
+  DISC disc;
+  VECTOR3 start_pos;
+  VECTOR3 start_vel;
+  float start_t;
+  float end_t;
+  float step_s;
+  float next_step_s;
+  float t;
+  bool landed;
+  VECTOR3 landing;
+  float landing_t;
+} DISC_FLIGHT;
+
 VECTOR3 update_disc_up_axis(VECTOR3 *, VECTOR3 *, float, float, float);
 VECTOR3 find_disc_plane_axis(VECTOR3 *, VECTOR3 *);
 void get_disc_acc_from_forces(DISC_FORCES *,
@@ -20,5 +79,30 @@ void get_disc_acc_from_forces(DISC_FORCES *,
                               VECTOR3 *);
 void update_extra_vels_from_disc_forces(DISC *, DISC_FORCES *, float);
 DISC_FORCES calc_disc_forces(VECTOR3 *, VECTOR3 *, float);
+VECTOR3 calc_disc_acceleration(DISC *, VECTOR3 *, DISC_FORCES *);
+void integrate_disc_flight(DISC *, VECTOR3 *, float, DISC_INTEGRATOR);
+float integrate_disc_flight_adaptive(DISC *, VECTOR3 *, float, float, float *);
+void interpolate_disc_flight_step(VECTOR3 *,
+                                  VECTOR3 *,
+                                  VECTOR3 *,
+                                  VECTOR3 *,
+                                  float,
+                                  float,
+                                  VECTOR3 *);
+void interpolate_disc_flight_velocity(VECTOR3 *,
+                                      VECTOR3 *,
+                                      VECTOR3 *,
+                                      VECTOR3 *,
+                                      float,
+                                      float,
+                                      VECTOR3 *);
+float find_disc_flight_landing(VECTOR3 *,
+                               VECTOR3 *,
+                               VECTOR3 *,
+                               VECTOR3 *,
+                               float,
+                               VECTOR3 *);
+void start_disc_flight(DISC_FLIGHT *, DISC *);
+bool fly_disc_flight(DISC_FLIGHT *, float, VECTOR3 *, VECTOR3 *);
 
 #endif /* DISC_FLIGHT_H_ */
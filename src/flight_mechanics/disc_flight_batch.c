@@ -0,0 +1,544 @@
+/*
+ * disc_flight_batch.c
+ *
+ * The batched disc flight model. See disc_flight_batch.h.
+ *
+ * Every loop over the discs in a batch is kept free of branches, function
+ * calls and dependencies between entries so that the compiler can vectorise
+ * it. Conditions are written as ?: selects between values that have both
+ * been calculated, and never choose between a new value and the one already
+ * in the batch. gcc turns that into a conditional store, which it will not
+ * vectorise.
+ *
+ * With the flags in the generated make file (-O3 -fno-math-errno
+ * -fno-trapping-math) gcc 12 vectorises every loop over the discs in this
+ * file. Check with -fopt-info-vec-missed after changing any of them.
+ *
+ *  Created on: 16 Oct 2026
+ *      Author: David Tyler
+ */
+
+#include "../dt_logger.h"
+
+#include <math.h>
+#include "../disc.h"
+#include "../physics.h"
+#include "disc_flight_batch.h"
+#include "disc_flight_constants.h"
+#include "disc_dimensions.h"
+#include "../data_structures/vector.h"
+
+/*
+ * Added to lengths before dividing by them so that unused entries (which have
+ * no velocity) don't produce infinities.
+ */
+#define DISC_BATCH_EPSILON 1.0e-12f
+
+#define DISC_BATCH_HALF_PI 1.57079632679f
+
+/*
+ * DISC_BATCH_STAGE
+ *
+ * INTERNAL: The velocity of every disc in a batch at one stage of a step and
+ * what calc_disc_batch_acceleration works out from it. Keeping these in their
+ * own structure rather than in separate arrays lets the compiler see that
+ * they can't overlap the batch, which it needs to before it will vectorise
+ * calc_disc_batch_acceleration.
+ *
+ * vel_* - The velocity of each disc.
+ * acc_* - The acceleration of each disc at that velocity.
+ * pitch_moment, roll_moment - The moments on each disc at that velocity.
+ */
+typedef struct disc_batch_stage
+{
+  float vel_x[DISC_BATCH_SIZE];
+  float vel_y[DISC_BATCH_SIZE];
+  float vel_z[DISC_BATCH_SIZE];
+  float acc_x[DISC_BATCH_SIZE];
+  float acc_y[DISC_BATCH_SIZE];
+  float acc_z[DISC_BATCH_SIZE];
+  float pitch_moment[DISC_BATCH_SIZE];
+  float roll_moment[DISC_BATCH_SIZE];
+} DISC_BATCH_STAGE;
+
+/*
+ * calc_disc_batch_acceleration
+ *
+ * INTERNAL: The batched equivalent of find_disc_plane_axis, calc_disc_forces
+ * and get_disc_acc_from_forces. Works out the acceleration of every disc in
+ * the batch if it were travelling at the velocity given for it in the stage,
+ * along with the pitch and roll moments.
+ *
+ * Parameters: batch - Supplies the orientation and angular velocities.
+ *             stage - Supplies the velocity of each disc and is filled in
+ *                     with the acceleration and moments.
+ */
+void calc_disc_batch_acceleration(DISC_BATCH *batch, DISC_BATCH_STAGE *stage)
+{
+  /*
+   * Local Variables.
+   */
+  float vel_on_d3;
+  float perp_x;
+  float perp_y;
+  float perp_z;
+  float perp_len;
+  float abs_vel_on_d3;
+  float len_sum;
+  float len_diff;
+  float spd_sqrd;
+  float inv_speed;
+  float inv_perp_len;
+  float ratio;
+  float ratio2;
+  float abs_alpha;
+  float alpha;
+  float alpha2;
+  float sin_alpha;
+  float cos_alpha;
+  float coefficient;
+  float diam_coeff;
+  float lift_force;
+  float drag_force;
+  float along_d1;
+  float along_d3;
+  int ii;
+
+  for (ii = 0; ii < DISC_BATCH_SIZE; ii++)
+  {
+    /*
+     * d1 is the velocity with its component along d3 removed, normalised (see
+     * find_disc_plane_axis).
+     */
+    vel_on_d3 = stage->vel_x[ii] * batch->d3_x[ii] +
+                stage->vel_y[ii] * batch->d3_y[ii] +
+                stage->vel_z[ii] * batch->d3_z[ii];
+    perp_x = stage->vel_x[ii] - vel_on_d3 * batch->d3_x[ii];
+    perp_y = stage->vel_y[ii] - vel_on_d3 * batch->d3_y[ii];
+    perp_z = stage->vel_z[ii] - vel_on_d3 * batch->d3_z[ii];
+    perp_len = sqrtf(perp_x * perp_x + perp_y * perp_y + perp_z * perp_z);
+    inv_perp_len = 1.0f / (perp_len + DISC_BATCH_EPSILON);
+    spd_sqrd = stage->vel_x[ii] * stage->vel_x[ii] +
+               stage->vel_y[ii] * stage->vel_y[ii] +
+               stage->vel_z[ii] * stage->vel_z[ii];
+    inv_speed = 1.0f / (sqrtf(spd_sqrd) + DISC_BATCH_EPSILON);
+
+    /*
+     * The angle of attack is the angle between the velocity and d1, which is
+     * atan(|v.d3| / |v - (v.d3)d3|). The ratio is kept in [0, 1] by taking
+     * whichever way round is smaller and the polynomial approximation to atan
+     * on [0, 1] is used. The smaller over the larger is worked out as
+     * (sum - |difference|) / (sum + |difference|) rather than by choosing
+     * between two divisions, which gcc will not vectorise. As in
+     * calculate_disc_position the angle is negative when the velocity has a
+     * component along d3.
+     */
+    abs_vel_on_d3 = fabsf(vel_on_d3);
+    len_sum = abs_vel_on_d3 + perp_len;
+    len_diff = fabsf(abs_vel_on_d3 - perp_len);
+    ratio = (len_sum - len_diff) / (len_sum + len_diff + DISC_BATCH_EPSILON);
+    ratio2 = ratio * ratio;
+    abs_alpha = ratio * (0.99997726f + ratio2 * (-0.33262347f +
+                         ratio2 * (0.19354346f + ratio2 * (-0.11643287f +
+                         ratio2 * (0.05265332f + ratio2 * -0.01172120f)))));
+    abs_alpha = (abs_vel_on_d3 <= perp_len) ? abs_alpha :
+                                              DISC_BATCH_HALF_PI - abs_alpha;
+    alpha = copysignf(abs_alpha, -vel_on_d3);
+    sin_alpha = abs_vel_on_d3 * inv_speed;
+    cos_alpha = perp_len * inv_speed;
+
+    /*
+     * The forces and moments are as in calc_disc_forces.
+     */
+    coefficient = (ATMOSPHERIC_DENSITY_KG_PER_M3 * DISC_AREA_M2 * spd_sqrd) /
+                  2;
+    diam_coeff = coefficient * DISC_DIAMETER_M;
+    alpha2 = alpha + CONST_L_ZERO / CONST_L_ALPHA;
+    lift_force = (CONST_L_ZERO + CONST_L_ALPHA * alpha) * coefficient;
+    drag_force = (CONST_D_ZERO + CONST_D_ALPHA * alpha2 * alpha2) *
+                 coefficient;
+    stage->roll_moment[ii] = (CONST_R_R * batch->ang_z[ii] +
+                              CONST_R_P * batch->ang_y[ii]) * diam_coeff;
+    stage->pitch_moment[ii] = (CONST_M_ZERO + CONST_M_ALPHA * alpha +
+                               CONST_M_Q * batch->ang_x[ii]) * diam_coeff;
+
+    /*
+     * And the acceleration is as in get_disc_acc_from_forces.
+     */
+    along_d1 = (lift_force * sin_alpha - drag_force * cos_alpha) /
+               DISC_MASS_KG;
+    along_d3 = (drag_force * sin_alpha + lift_force * cos_alpha) /
+               DISC_MASS_KG;
+    stage->acc_x[ii] = perp_x * inv_perp_len * along_d1 +
+                       batch->d3_x[ii] * along_d3;
+    stage->acc_y[ii] = perp_y * inv_perp_len * along_d1 +
+                       batch->d3_y[ii] * along_d3;
+    stage->acc_z[ii] = perp_z * inv_perp_len * along_d1 +
+                       batch->d3_z[ii] * along_d3 +
+                       GRAVITY_ACC_M_PER_S2;
+  }
+}
+
+/*
+ * clear_disc_batch
+ *
+ * Empties a batch. Every entry is put on the ground with no velocity.
+ *
+ * Parameters: batch - The batch to clear.
+ */
+void clear_disc_batch(DISC_BATCH *batch)
+{
+  /*
+   * Local Variables.
+   */
+  int ii;
+
+  for (ii = 0; ii < DISC_BATCH_SIZE; ii++)
+  {
+    batch->pos_x[ii] = 0.0f;
+    batch->pos_y[ii] = 0.0f;
+    batch->pos_z[ii] = 0.0f;
+    batch->vel_x[ii] = 0.0f;
+    batch->vel_y[ii] = 0.0f;
+    batch->vel_z[ii] = 0.0f;
+    batch->ang_x[ii] = 0.0f;
+    batch->ang_y[ii] = 0.0f;
+    batch->ang_z[ii] = 1.0f;
+    batch->d3_x[ii] = 0.0f;
+    batch->d3_y[ii] = 0.0f;
+    batch->d3_z[ii] = 1.0f;
+  }
+  batch->num_discs = 0;
+}
+
+/*
+ * set_disc_batch_entry
+ *
+ * Copies the flight state of a disc into a batch. If the entry is beyond the
+ * discs already in the batch then the batch grows to include it.
+ *
+ * Parameters: batch - The batch.
+ *             index - The entry to fill in. 0 to DISC_BATCH_SIZE - 1.
+ *             disc - The disc to copy.
+ */
+void set_disc_batch_entry(DISC_BATCH *batch, int index, DISC *disc)
+{
+  DT_ASSERT(index >= 0 && index < DISC_BATCH_SIZE);
+
+  batch->pos_x[index] = disc->position.x;
+  batch->pos_y[index] = disc->position.y;
+  batch->pos_z[index] = disc->position.z;
+  batch->vel_x[index] = disc->velocity.x;
+  batch->vel_y[index] = disc->velocity.y;
+  batch->vel_z[index] = disc->velocity.z;
+  batch->ang_x[index] = disc->angular_velocity.x;
+  batch->ang_y[index] = disc->angular_velocity.y;
+  batch->ang_z[index] = disc->angular_velocity.z;
+  batch->d3_x[index] = disc->d3.x;
+  batch->d3_y[index] = disc->d3.y;
+  batch->d3_z[index] = disc->d3.z;
+
+  if (index >= batch->num_discs)
+  {
+    batch->num_discs = index + 1;
+  }
+}
+
+/*
+ * get_disc_batch_entry
+ *
+ * Copies the flight state of one entry in a batch back into a disc. Only the
+ * position, velocity, angular velocity and up axis of the disc are changed.
+ *
+ * Parameters: batch - The batch.
+ *             index - The entry to copy. 0 to DISC_BATCH_SIZE - 1.
+ *             disc - The disc to fill in.
+ */
+void get_disc_batch_entry(DISC_BATCH *batch, int index, DISC *disc)
+{
+  DT_ASSERT(index >= 0 && index < DISC_BATCH_SIZE);
+
+  vector_set_values(&(disc->position),
+                    batch->pos_x[index],
+                    batch->pos_y[index],
+                    batch->pos_z[index]);
+  vector_set_values(&(disc->velocity),
+                    batch->vel_x[index],
+                    batch->vel_y[index],
+                    batch->vel_z[index]);
+  vector_set_values(&(disc->angular_velocity),
+                    batch->ang_x[index],
+                    batch->ang_y[index],
+                    batch->ang_z[index]);
+  vector_set_values(&(disc->d3),
+                    batch->d3_x[index],
+                    batch->d3_y[index],
+                    batch->d3_z[index]);
+}
+
+/*
+ * step_disc_batch
+ *
+ * Moves every disc in the batch that is still in the air on by one time step
+ * using the integrator asked for. This is the batched equivalent of
+ * integrate_disc_flight.
+ *
+ * Parameters: batch - The discs to move.
+ *             time_step_s - The length of the step in s.
+ *             integrator - Which numerical method to use.
+ *
+ * Returns: The number of discs in the batch still in the air after the step.
+ */
+int step_disc_batch(DISC_BATCH *batch,
+                    float time_step_s,
+                    DISC_INTEGRATOR integrator)
+{
+  /*
+   * Local Variables.
+   */
+  DISC_BATCH_STAGE stage[4];
+  float pos_change_x[DISC_BATCH_SIZE];
+  float pos_change_y[DISC_BATCH_SIZE];
+  float pos_change_z[DISC_BATCH_SIZE];
+  float vel_change_x[DISC_BATCH_SIZE];
+  float vel_change_y[DISC_BATCH_SIZE];
+  float vel_change_z[DISC_BATCH_SIZE];
+  float old_ang_x[DISC_BATCH_SIZE];
+  float old_ang_y[DISC_BATCH_SIZE];
+  float half_step_s = time_step_s / 2.0f;
+  float sixth_step_s = time_step_s / 6.0f;
+  float inv_spin_inertia;
+  float new_ang_x;
+  float new_ang_y;
+  bool in_air;
+  int num_in_air = 0;
+  int ii;
+
+  for (ii = 0; ii < DISC_BATCH_SIZE; ii++)
+  {
+    stage[0].vel_x[ii] = batch->vel_x[ii];
+    stage[0].vel_y[ii] = batch->vel_y[ii];
+    stage[0].vel_z[ii] = batch->vel_z[ii];
+    old_ang_x[ii] = batch->ang_x[ii];
+    old_ang_y[ii] = batch->ang_y[ii];
+  }
+  calc_disc_batch_acceleration(batch, &(stage[0]));
+
+  /*
+   * Each integrator works out how far every disc moves and how much its
+   * velocity changes over the step.
+   */
+  switch(integrator)
+  {
+    case disc_integrator_euler:
+      for (ii = 0; ii < DISC_BATCH_SIZE; ii++)
+      {
+        pos_change_x[ii] = stage[0].vel_x[ii] * time_step_s;
+        pos_change_y[ii] = stage[0].vel_y[ii] * time_step_s;
+        pos_change_z[ii] = stage[0].vel_z[ii] * time_step_s;
+        vel_change_x[ii] = stage[0].acc_x[ii] * time_step_s;
+        vel_change_y[ii] = stage[0].acc_y[ii] * time_step_s;
+        vel_change_z[ii] = stage[0].acc_z[ii] * time_step_s;
+      }
+      break;
+
+    case disc_integrator_rk4:
+      for (ii = 0; ii < DISC_BATCH_SIZE; ii++)
+      {
+        stage[1].vel_x[ii] = stage[0].vel_x[ii] +
+                             stage[0].acc_x[ii] * half_step_s;
+        stage[1].vel_y[ii] = stage[0].vel_y[ii] +
+                             stage[0].acc_y[ii] * half_step_s;
+        stage[1].vel_z[ii] = stage[0].vel_z[ii] +
+                             stage[0].acc_z[ii] * half_step_s;
+      }
+      calc_disc_batch_acceleration(batch, &(stage[1]));
+      for (ii = 0; ii < DISC_BATCH_SIZE; ii++)
+      {
+        stage[2].vel_x[ii] = stage[0].vel_x[ii] +
+                             stage[1].acc_x[ii] * half_step_s;
+        stage[2].vel_y[ii] = stage[0].vel_y[ii] +
+                             stage[1].acc_y[ii] * half_step_s;
+        stage[2].vel_z[ii] = stage[0].vel_z[ii] +
+                             stage[1].acc_z[ii] * half_step_s;
+      }
+      calc_disc_batch_acceleration(batch, &(stage[2]));
+      for (ii = 0; ii < DISC_BATCH_SIZE; ii++)
+      {
+        stage[3].vel_x[ii] = stage[0].vel_x[ii] +
+                             stage[2].acc_x[ii] * time_step_s;
+        stage[3].vel_y[ii] = stage[0].vel_y[ii] +
+                             stage[2].acc_y[ii] * time_step_s;
+        stage[3].vel_z[ii] = stage[0].vel_z[ii] +
+                             stage[2].acc_z[ii] * time_step_s;
+      }
+      calc_disc_batch_acceleration(batch, &(stage[3]));
+      for (ii = 0; ii < DISC_BATCH_SIZE; ii++)
+      {
+        pos_change_x[ii] = sixth_step_s *
+                           (stage[0].vel_x[ii] +
+                            2.0f * (stage[1].vel_x[ii] + stage[2].vel_x[ii]) +
+                            stage[3].vel_x[ii]);
+        pos_change_y[ii] = sixth_step_s *
+                           (stage[0].vel_y[ii] +
+                            2.0f * (stage[1].vel_y[ii] + stage[2].vel_y[ii]) +
+                            stage[3].vel_y[ii]);
+        pos_change_z[ii] = sixth_step_s *
+                           (stage[0].vel_z[ii] +
+                            2.0f * (stage[1].vel_z[ii] + stage[2].vel_z[ii]) +
+                            stage[3].vel_z[ii]);
+        vel_change_x[ii] = sixth_step_s *
+                           (stage[0].acc_x[ii] +
+                            2.0f * (stage[1].acc_x[ii] + stage[2].acc_x[ii]) +
+                            stage[3].acc_x[ii]);
+        vel_change_y[ii] = sixth_step_s *
+                           (stage[0].acc_y[ii] +
+                            2.0f * (stage[1].acc_y[ii] + stage[2].acc_y[ii]) +
+                            stage[3].acc_y[ii]);
+        vel_change_z[ii] = sixth_step_s *
+                           (stage[0].acc_z[ii] +
+                            2.0f * (stage[1].acc_z[ii] + stage[2].acc_z[ii]) +
+                            stage[3].acc_z[ii]);
+      }
+      break;
+
+    case disc_integrator_semi_implicit_euler:
+    default:
+      for (ii = 0; ii < DISC_BATCH_SIZE; ii++)
+      {
+        vel_change_x[ii] = stage[0].acc_x[ii] * time_step_s;
+        vel_change_y[ii] = stage[0].acc_y[ii] * time_step_s;
+        vel_change_z[ii] = stage[0].acc_z[ii] * time_step_s;
+        pos_change_x[ii] = (stage[0].vel_x[ii] + vel_change_x[ii]) *
+                           time_step_s;
+        pos_change_y[ii] = (stage[0].vel_y[ii] + vel_change_y[ii]) *
+                           time_step_s;
+        pos_change_z[ii] = (stage[0].vel_z[ii] + vel_change_z[ii]) *
+                           time_step_s;
+      }
+      break;
+  }
+
+  /*
+   * Only discs that were in the air at the start of the step take the new
+   * values. The pitch and roll velocities come from the moments at the start
+   * of the step as in update_extra_vels_from_disc_forces.
+   *
+   * Every entry is written whether it moves or not. The positions and
+   * velocities have the change added, or 0, and the old pitch and roll
+   * velocities come from local copies (see the top of this file).
+   */
+  for (ii = 0; ii < DISC_BATCH_SIZE; ii++)
+  {
+    in_air = (batch->pos_z[ii] > 0.0f);
+    inv_spin_inertia = 2.0f / (batch->ang_z[ii] * DISC_AXIAL_INERTIA);
+    new_ang_x = stage[0].pitch_moment[ii] * inv_spin_inertia;
+    new_ang_y = stage[0].roll_moment[ii] * inv_spin_inertia;
+    batch->pos_x[ii] += in_air ? pos_change_x[ii] : 0.0f;
+    batch->pos_y[ii] += in_air ? pos_change_y[ii] : 0.0f;
+    batch->pos_z[ii] += in_air ? pos_change_z[ii] : 0.0f;
+    batch->vel_x[ii] += in_air ? vel_change_x[ii] : 0.0f;
+    batch->vel_y[ii] += in_air ? vel_change_y[ii] : 0.0f;
+    batch->vel_z[ii] += in_air ? vel_change_z[ii] : 0.0f;
+    batch->ang_x[ii] = in_air ? new_ang_x : old_ang_x[ii];
+    batch->ang_y[ii] = in_air ? new_ang_y : old_ang_y[ii];
+  }
+
+  for (ii = 0; ii < DISC_BATCH_SIZE; ii++)
+  {
+    num_in_air += (batch->pos_z[ii] > 0.0f) ? 1 : 0;
+  }
+
+  return(num_in_air);
+}
+
+/*
+ * fly_disc_batch_to_ground
+ *
+ * Steps a batch until every disc in it has landed and works out where and
+ * when each one crossed the ground. The crossing is found on the straight line
+ * between the positions either side of it, so is accurate to a few mm at the
+ * step sizes used for RK4.
+ *
+ * Parameters: batch - The batch. Left with every disc on or below the ground.
+ *             time_step_s - The step to use.
+ *             integrator - The integrator to use.
+ *             max_steps - Give up after this many steps.
+ *             landing - Filled in for each disc in the batch. Discs that
+ *                       don't land are given their last position and time.
+ *
+ * Returns: The number of discs still in the air (0 unless max_steps ran out).
+ */
+int fly_disc_batch_to_ground(DISC_BATCH *batch,
+                             float time_step_s,
+                             DISC_INTEGRATOR integrator,
+                             int max_steps,
+                             DISC_BATCH_LANDING *landing)
+{
+  /*
+   * Local Variables.
+   */
+  float prev_x[DISC_BATCH_SIZE];
+  float prev_y[DISC_BATCH_SIZE];
+  float prev_z[DISC_BATCH_SIZE];
+  float drop;
+  float fraction;
+  float step_x;
+  float step_y;
+  float step_time_s;
+  float weight;
+  float time_s = 0.0f;
+  int num_in_air = batch->num_discs;
+  int steps = 0;
+  int ii;
+
+  for (ii = 0; ii < DISC_BATCH_SIZE; ii++)
+  {
+    landing->x[ii] = batch->pos_x[ii];
+    landing->y[ii] = batch->pos_y[ii];
+    landing->time_s[ii] = 0.0f;
+    landing->apex_z[ii] = batch->pos_z[ii];
+    prev_x[ii] = batch->pos_x[ii];
+    prev_y[ii] = batch->pos_y[ii];
+    prev_z[ii] = batch->pos_z[ii];
+  }
+
+  while ((num_in_air > 0) && (steps < max_steps))
+  {
+    num_in_air = step_disc_batch(batch, time_step_s, integrator);
+    steps++;
+    time_s += time_step_s;
+
+    /*
+     * Discs that were already down before the step keep their landing. The
+     * unused entries are on the ground so are never changed. The positions
+     * are then kept for the next step.
+     *
+     * The new landing is weighted in by 1 or 0 rather than chosen with ?:,
+     * which gcc turns into a conditional store that it will not vectorise.
+     * Both values are always finite so the result is exactly one or the
+     * other.
+     */
+    for (ii = 0; ii < DISC_BATCH_SIZE; ii++)
+    {
+      weight = (prev_z[ii] > 0.0f) ? 1.0f : 0.0f;
+      landing->apex_z[ii] = (batch->pos_z[ii] > landing->apex_z[ii]) ?
+                            batch->pos_z[ii] : landing->apex_z[ii];
+      drop = prev_z[ii] - batch->pos_z[ii];
+      fraction = prev_z[ii] / ((drop > 0.0f) ? drop : 1.0f);
+      fraction = (batch->pos_z[ii] <= 0.0f) ? fraction : 1.0f;
+      step_x = prev_x[ii] + fraction * (batch->pos_x[ii] - prev_x[ii]);
+      step_y = prev_y[ii] + fraction * (batch->pos_y[ii] - prev_y[ii]);
+      step_time_s = time_s - (1.0f - fraction) * time_step_s;
+      landing->x[ii] = weight * step_x + (1.0f - weight) * landing->x[ii];
+      landing->y[ii] = weight * step_y + (1.0f - weight) * landing->y[ii];
+      landing->time_s[ii] = weight * step_time_s +
+                            (1.0f - weight) * landing->time_s[ii];
+      prev_x[ii] = batch->pos_x[ii];
+      prev_y[ii] = batch->pos_y[ii];
+      prev_z[ii] = batch->pos_z[ii];
+    }
+  }
+
+  return(num_in_air);
+}
@@ -12,7 +12,9 @@
 
 #include "ai_general/ai_event_handler.h"
 #include "automaton_handler.h"
+#include "collisions/intercept_table.h"
 #include "disc.h"
+#include "disc_path.h"
 #include "impl_automatons/generic_o_d_files/event_names.h"
 #include "match_state.h"
 #include "player.h"
@@ -33,6 +35,11 @@
  */
 void catch_disc(PLAYER *player, DISC *disc)
 {
+  /*
+   * Local Variables.
+   */
+  VECTOR3 stopped;
+
   DT_DEBUG_LOG("Player (%i:%i) catching disc\n",
                player->team_id,
                player->player_id);
@@ -44,8 +51,8 @@ void catch_disc(PLAYER *player, DISC *disc)
    * Stop the player immediately.
    * TODO: Graceful deceleration.
    */
-  player->velocity.x = 0.0f;
-  player->velocity.y = 0.0f;
+  vector_set_values(&stopped, 0.0f, 0.0f, 0.0f);
+  set_player_velocity(player, &stopped);
 
   /*
    * Set up the booleans that determine the disc state.
@@ -56,6 +63,57 @@ void catch_disc(PLAYER *player, DISC *disc)
   disc->holder = player;
 }
 
+/*
+ * release_disc
+ *
+ * Called whenever the disc is thrown, once the disc has been given its
+ * starting conditions. The holder of the disc becomes the thrower.
+ *
+ * Parameters: match_state - Required to have access to all the match
+ *                           information.
+ */
+void release_disc(MATCH_STATE *match_state)
+{
+  /*
+   * Fill in the disc path for the current throw. This disc path has the
+   * smallest interval allowed. Players read it through coarser views
+   * depending on their skill so it is only calculated once.
+   *
+   * The path object is only created for the first throw and is then
+   * overwritten by each subsequent throw. The flight is calculated on a
+   * worker thread so that releasing a throw doesn't stall this frame.
+   * Intercepts worked out for the last throw are thrown away.
+   *
+   * The path is timed on the simulation clock, which is what the match disc
+   * is flown on, so the path always agrees with where the disc is.
+   */
+  if (NULL == match_state->disc_path)
+  {
+    match_state->disc_path = create_disc_path();
+  }
+  start_disc_path_calculation(match_state->disc,
+                              match_state->disc_path,
+                              DISC_PATH_INTERVAL_MIN,
+                              match_state->sim_time_ms);
+  invalidate_intercept_table(match_state->intercept_table);
+
+  /*
+   * Set the information on who the thrower was.
+   */
+  match_state->disc->thrower = match_state->disc->holder;
+
+  /*
+   * Throw an event to all players to indicate that the disc is now in the air
+   * again.
+   */
+  throw_multi_player_ai_event_by_id(
+                match_state->teams,
+                match_state->num_teams,
+                match_state->players_per_team,
+                match_state->automaton_handler->offensive_set->start_automaton,
+                AUTOMATON_EVENT_ID_DISC_RELEASED);
+}
+
 /*
  * disc_lands
  *
@@ -79,11 +137,12 @@ void disc_lands(MATCH_STATE *match_state)
    * Throw a multi player event to let everyone know that the disc has hit the
    * floor.
    */
-  throw_multi_player_ai_event_by_name(
+  throw_multi_player_ai_event_by_id(
                 match_state->teams,
+                match_state->num_teams,
                 match_state->players_per_team,
                 match_state->automaton_handler->offensive_set->start_automaton,
-                AUTOMATON_EVENT_DISC_HIT_FLOOR);
+                AUTOMATON_EVENT_ID_DISC_HIT_FLOOR);
 }
 
 /*
@@ -98,13 +157,30 @@ void disc_lands(MATCH_STATE *match_state)
  */
 void turnover(MATCH_STATE *match_state)
 {
+  /*
+   * Local Variables.
+   */
+  int offense = 0;
+  int ii;
+
   DT_DEBUG_LOG("Turnover\n");
 
   /*
-   * Swap over which team is on offence and which is on defence.
+   * Swap over which team is on offence and which is on defence. With more
+   * than two teams the disc goes to the next team round.
    */
-  match_state->teams[0]->is_offense = !(match_state->teams[0]->is_offense);
-  match_state->teams[1]->is_offense = !(match_state->teams[1]->is_offense);
+  for (ii = 0; ii < match_state->num_teams; ii++)
+  {
+    if (match_state->teams[ii]->is_offense)
+    {
+      offense = ii;
+    }
+  }
+  for (ii = 0; ii < match_state->num_teams; ii++)
+  {
+    match_state->teams[ii]->is_offense =
+                     (ii == (offense + 1) % match_state->num_teams);
+  }
 
   /*
    * TODO: Move from O to D automatons.
@@ -13,6 +13,7 @@ struct disc;
 struct match_state;
 
 void catch_disc(struct player *, struct disc *);
+void release_disc(struct match_state *);
 void disc_lands(struct match_state *);
 void turnover(struct match_state *);
 
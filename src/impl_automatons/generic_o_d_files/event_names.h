@@ -25,4 +25,18 @@
 #define AUTOMATON_EVENT_ARRIVED_AT_LOCATION "event_arrived_at_location"
 #define AUTOMATON_EVENT_DISC_HIT_FLOOR "event_disc_hit_floor"
 
+/*
+ * The id of each event above. Every automaton is given the same events in the
+ * same order so these index the events array of any automaton, letting code
+ * throw events without looking them up by name.
+ */
+#define AUTOMATON_EVENT_ID_PULL_THROWN 0
+#define AUTOMATON_EVENT_ID_PULL_DROPPED 1
+#define AUTOMATON_EVENT_ID_PULL_CAUGHT 2
+#define AUTOMATON_EVENT_ID_DISC_PICKED_UP 3
+#define AUTOMATON_EVENT_ID_ARRIVED_AT_LOCATION 4
+#define AUTOMATON_EVENT_ID_DISC_HIT_FLOOR 5
+#define AUTOMATON_EVENT_ID_DISC_RELEASED 6
+#define AUTOMATON_EVENT_ID_DISC_CAUGHT 7
+
 #endif /* EVENT_NAMES_H_ */
@@ -45,49 +45,49 @@ int create_automaton_events(AUTOMATON_EVENT ***event_array)
 
     switch(ii)
     {
-      case 0:
+      case AUTOMATON_EVENT_ID_PULL_THROWN:
         strncpy((*event_array)[ii]->name,
                 AUTOMATON_EVENT_PULL_THROWN,
                 MAX_EVENT_NAME_LEN);
         (*event_array)[ii]->name[strlen(AUTOMATON_EVENT_PULL_THROWN)] = '\0';
         break;
-      case 1:
+      case AUTOMATON_EVENT_ID_PULL_DROPPED:
         strncpy((*event_array)[ii]->name,
                 AUTOMATON_EVENT_PULL_DROPPED,
                 MAX_EVENT_NAME_LEN);
         (*event_array)[ii]->name[strlen(AUTOMATON_EVENT_PULL_DROPPED)] = '\0';
         break;
-      case 2:
+      case AUTOMATON_EVENT_ID_PULL_CAUGHT:
         strncpy((*event_array)[ii]->name,
                 AUTOMATON_EVENT_PULL_CAUGHT,
                 MAX_EVENT_NAME_LEN);
         (*event_array)[ii]->name[strlen(AUTOMATON_EVENT_PULL_CAUGHT)] = '\0';
         break;
-      case 3:
+      case AUTOMATON_EVENT_ID_DISC_PICKED_UP:
         strncpy((*event_array)[ii]->name,
                 AUTOMATON_EVENT_DISC_PICKED_UP,
                 MAX_EVENT_NAME_LEN);
         (*event_array)[ii]->name[strlen(AUTOMATON_EVENT_DISC_PICKED_UP)] = '\0';
         break;
-      case 4:
+      case AUTOMATON_EVENT_ID_ARRIVED_AT_LOCATION:
         strncpy((*event_array)[ii]->name,
                 AUTOMATON_EVENT_ARRIVED_AT_LOCATION,
                 MAX_EVENT_NAME_LEN);
         (*event_array)[ii]->name[strlen(AUTOMATON_EVENT_ARRIVED_AT_LOCATION)] = '\0';
         break;
-      case 5:
+      case AUTOMATON_EVENT_ID_DISC_HIT_FLOOR:
         strncpy((*event_array)[ii]->name,
                 AUTOMATON_EVENT_DISC_HIT_FLOOR,
                 MAX_EVENT_NAME_LEN);
         (*event_array)[ii]->name[strlen(AUTOMATON_EVENT_DISC_HIT_FLOOR)] = '\0';
         break;
-      case 6:
+      case AUTOMATON_EVENT_ID_DISC_RELEASED:
         strncpy((*event_array)[ii]->name,
                 AUTOMATON_EVENT_DISC_RELEASED,
                 MAX_EVENT_NAME_LEN);
         (*event_array)[ii]->name[strlen(AUTOMATON_EVENT_DISC_RELEASED)] = '\0';
         break;
-      case 7:
+      case AUTOMATON_EVENT_ID_DISC_CAUGHT:
         strncpy((*event_array)[ii]->name,
                 AUTOMATON_EVENT_DISC_CAUGHT,
                 MAX_EVENT_NAME_LEN);
@@ -13,13 +13,22 @@
 #include "lua_callback_globals.h"
 
 #include "../../collisions/intercept.h"
+#include "../../collisions/intercept_table.h"
 #include "../../data_structures/vector.h"
 #include "../../disc.h"
 #include "../../disc_path.h"
+#include "../../game_functions.h"
 #include "../../match_state.h"
 #include "../../player.h"
 #include "../../pitch.h"
 #include "../../team.h"
+#include "../../throw_init_condition.h"
+#include "../../throw_solver.h"
+
+/*
+ * Throws made by the AI are not rolled.
+ */
+#define LUA_THROW_ROLL_RAD 0.0f
 
 /*
  * These are global variables defined in the lua_callback_globals.h file.
@@ -280,14 +289,18 @@ int lua_callback_set_player_speed(lua_State *lua_state)
  * Parameters: None.
  *
  * Returns: A table with x,y as the keys and the values being floating point
- * representations of the final position of the disc.
+ * representations of the final position of the disc. The key is_final is
+ * false if the disc path is still being calculated, in which case x,y is the
+ * furthest point along the path calculated so far.
  */
 int lua_callback_get_disc_final_pos(lua_State *lua_state)
 {
   /*
    * Local Variables.
    */
-  VECTOR3 *final_disc_pos;
+  VECTOR3 disc_pos;
+  VECTOR3 *final_disc_pos = &disc_pos;
+  bool is_final = true;
   PLAYER *player = g_match_state->teams[g_curr_team]->players[g_curr_player];
 
   /*
@@ -300,7 +313,8 @@ int lua_callback_get_disc_final_pos(lua_State *lua_state)
   }
   else
   {
-    final_disc_pos = &(g_match_state->disc_path->end_position->position);
+    is_final = get_disc_path_final_position(g_match_state->disc_path,
+                                            &disc_pos);
   }
 
   /*
@@ -316,9 +330,14 @@ int lua_callback_get_disc_final_pos(lua_State *lua_state)
   lua_pushnumber(lua_state, final_disc_pos->y);
   lua_settable(lua_state, -3);
 
-  DT_AI_LOG("(%i:%i) callback_get_disc_final_pos called. Returned (%f, %f)\n",
+  lua_pushstring(lua_state, "is_final");
+  lua_pushboolean(lua_state, is_final);
+  lua_settable(lua_state, -3);
+
+  DT_AI_LOG("(%i:%i) callback_get_disc_final_pos called. Returned (%f, %f)%s\n",
             player->team_id, player->player_id,
-            final_disc_pos->x, final_disc_pos->y);
+            final_disc_pos->x, final_disc_pos->y,
+            is_final ? "" : " (path incomplete)");
 
   return 1;
 }
@@ -372,6 +391,7 @@ int lua_callback_get_team_positions(lua_State *lua_state)
    * Local Variables.
    */
   int ii;
+  PLAYER *player;
   VECTOR3 position;
 
   /*
@@ -386,9 +406,8 @@ int lua_callback_get_team_positions(lua_State *lua_state)
    */
   for (ii = 0; ii < g_match_state->players_per_team; ii++)
   {
-     vector_copy_values(
-                  &(position), 
-                  &(g_match_state->teams[g_curr_team]->players[ii]->position));
+    player = g_match_state->teams[g_curr_team]->players[ii];
+    position = get_player_position(player);
 
     /*
      * Use the player index as the key into the main table. The values will be
@@ -482,24 +501,33 @@ int lua_callback_get_team_desired_positions(lua_State *lua_state)
  *
  * Called when the disc in the air. Calculates all the intercept times for all
  * players on the field. Notably this includes the player who threw the disc.
+ * Each player reads the disc path at their own skill level.
  *
- * Returns: One table keyed on player_index + num_players *[01] based on team.
+ * Returns: One table keyed on player_index + players_per_team * team_index.
  *          The rows in this table contain the player index, team index, time
  *          to intercept and the intercept coordinates. These are in meters and
  *          seconds.
  *
  *          Only players who will intercept the disc are in the table.
+ *
+ *          The second return value is false if the disc path is still being
+ *          calculated. Players who can't reach the part of the path known so
+ *          far are left out until it is complete.
  */
 int lua_callback_calculate_all_intercept_times(lua_State *lua_state)
 {
   /*
    * Local Variables.
    */
-  PLAYER *player;
-  DISC_PATH *disc_path = g_match_state->disc_path;
+  INTERCEPT_TABLE *intercept_table = g_match_state->intercept_table;
   INTERCEPT intercept;
+  int num_players = g_match_state->num_teams *
+                    g_match_state->players_per_team;
+  int ret_code;
+  bool path_complete = true;
   int ii;
   int jj;
+  int index;
 
   /*
    * If the disc is not in the air then this function returns nothing.
@@ -509,61 +537,78 @@ int lua_callback_calculate_all_intercept_times(lua_State *lua_state)
     return 0;
   }
 
+  /*
+   * The intercepts are shared with the state functions and are only worked
+   * out again if the path or a player's speed has changed since the last
+   * caller.
+   */
+  update_intercept_table(intercept_table,
+                         g_match_state->teams,
+                         g_match_state->num_teams,
+                         g_match_state->players_per_team,
+                         g_match_state->disc_path,
+                         g_match_state->sim_time_ms);
+
   /*
    * Create a new table to hold the intercept locations for each player. This
    * will be passed back to the calling lua.
    */
   lua_newtable(lua_state);
 
-  for (ii = 0; ii < g_match_state->players_per_team; ii++)
+  /*
+   * The index into the main lua table is the player_index + num players *
+   * team_index.
+   */
+  for (index = 0; index < num_players; index++)
   {
-    for (jj = 0; jj < 2; jj++)
+    ii = index % g_match_state->players_per_team;
+    jj = index / g_match_state->players_per_team;
+    ret_code = get_intercept_table_entry(intercept_table,
+                                         g_match_state->teams[jj]->players[ii],
+                                         g_match_state->players_per_team,
+                                         &intercept);
+
+    if (INTERCEPT_CALC_PATH_INCOMPLETE == ret_code)
     {
-      player = g_match_state->teams[jj]->players[ii];
+      path_complete = false;
+    }
+    else if (INTERCEPT_CALC_FOUND == ret_code)
+    {
+      lua_pushinteger(lua_state, index);
+
+      /*
+       * The player can catch the disc so we add a new row into the table.
+       * The row is actually another table containing the team index, player
+       * index, time of intercept (from now in seconds) and the x,y coords at
+       * which the intercept can take place.
+       */
+      lua_newtable(lua_state);
+      lua_pushstring(lua_state, "player_index");
+      lua_pushinteger(lua_state, ii);
+      lua_settable(lua_state, -3);
+      lua_pushstring(lua_state, "team_index");
+      lua_pushinteger(lua_state, jj);
+      lua_settable(lua_state, -3);
+      lua_pushstring(lua_state, "time_to_intercept");
+      lua_pushnumber(lua_state, intercept.t);
+      lua_settable(lua_state, -3);
+      lua_pushstring(lua_state, "x");
+      lua_pushnumber(lua_state, intercept.intercept.x);
+      lua_settable(lua_state, -3);
+      lua_pushstring(lua_state, "y");
+      lua_pushnumber(lua_state, intercept.intercept.y);
+      lua_settable(lua_state, -3);
 
       /*
-       * Calculate the intercept point for that player.
+       * This sets the player/team index to point to the table created above.
        */
-      if (calculate_player_disc_path_intercept(player, disc_path, &intercept))
-      {
-        /*
-         * The index into the main lua table is the player_index + num players *
-         * team_index
-         */
-        lua_pushinteger(lua_state, ii + g_match_state->players_per_team * jj);
-
-        /*
-         * The player can catch the disc so we add a new row into the table.
-         * The row is actually another table containing the team index, player
-         * index, time of intercept (from now in seconds) and the x,y coords at
-         * which the intercept can take place.
-         */
-        lua_newtable(lua_state);
-        lua_pushstring(lua_state, "player_index");
-        lua_pushinteger(lua_state, ii);
-        lua_settable(lua_state, -3);
-        lua_pushstring(lua_state, "team_index");
-        lua_pushinteger(lua_state, jj);
-        lua_settable(lua_state, -3);
-        lua_pushstring(lua_state, "time_to_intercept");
-        lua_pushnumber(lua_state, intercept.t);
-        lua_settable(lua_state, -3);
-        lua_pushstring(lua_state, "x");
-        lua_pushnumber(lua_state, intercept.intercept.x);
-        lua_settable(lua_state, -3);
-        lua_pushstring(lua_state, "y");
-        lua_pushnumber(lua_state, intercept.intercept.y);
-        lua_settable(lua_state, -3);
-
-        /*
-         * This sets the player/team index to point to the table created above.
-         */
-        lua_settable(lua_state, -3);
-      }
+      lua_settable(lua_state, -3);
     }
   }
 
-  return 1;
+  lua_pushboolean(lua_state, path_complete);
+
+  return 2;
 }
 
 /*
@@ -583,7 +628,7 @@ int lua_callback_get_all_team_marks(lua_State *lua_state)
    */
   PLAYER *player;
   int ii;
-  int other_team_index = (0 == g_curr_team ? 1 : 0);
+  int other_team_index = (g_curr_team + 1) % g_match_state->num_teams;
 
   DT_AI_LOG("(%i:%i) Player requested all team marks",
             g_curr_player,
@@ -698,6 +743,7 @@ int lua_callback_get_current_position(lua_State *lua_state)
    * Local Variables.
    */
   PLAYER *player = g_match_state->teams[g_curr_team]->players[g_curr_player];
+  VECTOR3 position = get_player_position(player);
 
   DT_AI_LOG("(%i:%i) Current position requested",
             g_curr_player,
@@ -713,13 +759,13 @@ int lua_callback_get_current_position(lua_State *lua_state)
     * team_index
     */
   lua_pushstring(lua_state, "x");
-  lua_pushnumber(lua_state, (lua_Number) player->position.x);
+  lua_pushnumber(lua_state, (lua_Number) position.x);
   lua_settable(lua_state, -3);
   lua_pushstring(lua_state, "y");
-  lua_pushnumber(lua_state, (lua_Number) player->position.y);
+  lua_pushnumber(lua_state, (lua_Number) position.y);
   lua_settable(lua_state, -3);
   lua_pushstring(lua_state, "z");
-  lua_pushnumber(lua_state, (lua_Number) player->position.z);
+  lua_pushnumber(lua_state, (lua_Number) position.z);
   lua_settable(lua_state, -3);
 
   return 1;
@@ -743,7 +789,7 @@ int lua_callback_stop_running(lua_State *lua_state)
    * hit the arrived at location event and will not move anywhere even if that
    * is not handled.
    */
-  vector_copy_values(&(player->desired_position), &(player->position));
+  player->desired_position = get_player_position(player);
 
   return 0;
 }
@@ -767,6 +813,138 @@ int lua_callback_is_attacking_left_to_right(lua_State *lua_state)
   return 1;
 }
 
+/*
+ * lua_callback_throw_disc
+ *
+ * Throws the disc so that it lands at the given position, provided that the
+ * current player is holding it. A flat throw to a target that the flight
+ * condition table covers is looked up in the table. Any other throw (or any
+ * throw if the table didn't load) is worked out by the throw solver which
+ * remembers its recent solutions, so repeated throws to similar distances
+ * take very little working out.
+ *
+ * If the solver can't find a throw that lands exactly on the target then the
+ * closest throw it found is made anyway.
+ *
+ * Parameters Order: {top}[flight_time], y_pos, x_pos{bottom}
+ *
+ * Parameters: [[Note: Although these are not strictly parameters they are put
+ *                     onto the stack by lua and are pulled off here so we
+ *                     treat them as parameters anyway.]]
+ *             x_pos - The x coordinate of the target.
+ *             y_pos - The y coordinate of the target.
+ *             flight_time - Optional. How long (s) the disc should be in the
+ *                           air for.
+ *
+ * Returns: true if the disc was thrown and false otherwise.
+ */
+int lua_callback_throw_disc(lua_State *lua_state)
+{
+  /*
+   * Local Variables.
+   */
+  PLAYER *player = g_match_state->teams[g_curr_team]->players[g_curr_player];
+  DISC *disc = g_match_state->disc;
+  THROW_INIT_CONDITION condition;
+  THROW_CONSTRAINT constraint = throw_constraint_none;
+  VECTOR3 target;
+  float flight_time = 0.0f;
+  int num_params = lua_gettop(lua_state);
+  int rc;
+  bool thrown = false;
+
+  /*
+   * Lua stack verification to check that there are the right number of
+   * parameters and that they are the right variable type.
+   */
+  if ((num_params < 2) || (num_params > 3))
+  {
+    DT_AI_LOG("(%i:%i) callback_throw_disc called with wrong number of " \
+              "parameters (%i)\n",
+              player->team_id, player->player_id,
+              num_params);
+    lua_pushboolean(lua_state, false);
+    return 1;
+  }
+  else if ((!lua_isnumber(lua_state, 1)) ||
+           (!lua_isnumber(lua_state, 2)) ||
+           ((3 == num_params) && (!lua_isnumber(lua_state, 3))))
+  {
+    DT_AI_LOG("(%i:%i) callback_throw_disc called with a parameter that " \
+              "is not a number\n",
+              player->team_id, player->player_id);
+    lua_pushboolean(lua_state, false);
+    return 1;
+  }
+
+  vector_set_values(&target,
+                    (float) lua_tonumber(lua_state, 1),
+                    (float) lua_tonumber(lua_state, 2),
+                    0.0f);
+  if (3 == num_params)
+  {
+    constraint = throw_constraint_flight_time;
+    flight_time = (float) lua_tonumber(lua_state, 3);
+  }
+
+  /*
+   * Only the player holding the disc can throw it.
+   */
+  if ((disc_with_player != disc->disc_state) || (player != disc->holder))
+  {
+    DT_AI_LOG("(%i:%i) callback_throw_disc called without the disc\n",
+              player->team_id, player->player_id);
+    lua_pushboolean(lua_state, false);
+    return 1;
+  }
+
+  /*
+   * A flat throw is taken straight from the flight condition table if the
+   * target is inside it. Otherwise, or if a flight time was asked for, the
+   * throw is solved for.
+   */
+  if ((throw_constraint_none == constraint) &&
+      (set_init_disc_conditions_from_table(disc,
+                                           g_match_state->flight_lu_table,
+                                           &target,
+                                           LUA_THROW_ROLL_RAD)))
+  {
+    release_disc(g_match_state);
+    DT_AI_LOG("(%i:%i) callback_throw_disc called with x=%f,y=%f. Throw " \
+              "taken from the flight table\n",
+              player->team_id, player->player_id,
+              target.x, target.y);
+    lua_pushboolean(lua_state, true);
+    return 1;
+  }
+
+  rc = solve_throw(g_match_state->throw_solver,
+                   &(disc->position),
+                   &target,
+                   LUA_THROW_ROLL_RAD,
+                   constraint,
+                   flight_time,
+                   &condition);
+  if ((THROW_SOLVER_OK == rc) || (THROW_SOLVER_NOT_CONVERGED == rc))
+  {
+    set_init_disc_conditions_from_throw(disc, &condition);
+    release_disc(g_match_state);
+    thrown = true;
+  }
+
+  DT_AI_LOG("(%i:%i) callback_throw_disc called with x=%f,y=%f. Solver " \
+            "returned %i after %i iterations%s\n",
+            player->team_id, player->player_id,
+            target.x, target.y,
+            rc,
+            g_match_state->throw_solver->last_num_iterations,
+            thrown ? "" : ", disc not thrown");
+
+  lua_pushboolean(lua_state, thrown);
+
+  return 1;
+}
+
 /*
  * register_lua_callback_functions
  *
@@ -782,6 +960,9 @@ void register_lua_callback_functions(lua_State *lua_state)
    * Register each of the above functions. The names are arbitrary but if they
    * are changed then any current lua scripts will need changing as well.
    */
+  lua_register(lua_state,
+               "callback_throw_disc",
+               lua_callback_throw_disc);
   lua_register(lua_state,
                "callback_is_attacking_left_to_right",
                lua_callback_is_attacking_left_to_right);
@@ -36,5 +36,6 @@ int lua_callback_set_desired_mark(lua_State *);
 int lua_callback_get_current_position(lua_State *);
 int lua_callback_stop_running(lua_State *);
 int lua_callback_is_attacking_left_to_right(lua_State *);
+int lua_callback_throw_disc(lua_State *);
 
 #endif /* LUA_CALL_BACK_FUNCTIONS_H_ */
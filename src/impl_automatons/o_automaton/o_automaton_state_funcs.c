@@ -15,6 +15,7 @@
 #include "../../ai_general/ai_event_handler.h"
 #include "../../collisions/collision_handler.h"
 #include "../../collisions/intercept.h"
+#include "../../collisions/intercept_table.h"
 #include "../../data_structures/vector.h"
 #include "../../disc.h"
 #include "../../disc_path.h"
@@ -81,6 +82,11 @@ int state_move_disc_to_sideline_function(PLAYER *player, Uint32 dt)
  */
 void state_running_entrance_function(PLAYER *player)
 {
+  /*
+   * Local Variables.
+   */
+  VECTOR3 position = get_player_position(player);
+
   DT_AI_LOG("(%i:%i) Entering state running\n",
             player->team_id, 
             player->player_id);
@@ -95,7 +101,7 @@ void state_running_entrance_function(PLAYER *player)
    * Determine the direction in which to play the animation based on where the
    * player is going to run to compared to where they are.
    */
-  player->direction = calculate_animation_direction(&(player->position),
+  player->direction = calculate_animation_direction(&position,
                                                     &(player->desired_position));
 }
 
@@ -115,24 +121,25 @@ int state_running_function(PLAYER *player, Uint32 dt)
    * Local Variables.
    */
   VECTOR3 player_velocity;
+  VECTOR3 position = get_player_position(player);
 
   /*
    * If the player is within a small delta of the desired location then 
    * throw the arrived at location event so that the ai can handle it.
    */
   if (dist_between_vectors_2d(&(player->desired_position), 
-                              &(player->position)) <= DISTANCE_TO_INTERACT)
+                              &position) <= DISTANCE_TO_INTERACT)
   {
-    throw_single_player_ai_event_by_name(player, 
-                                         player->automaton, 
-                                         AUTOMATON_EVENT_ARRIVED_AT_LOCATION);
+    throw_single_player_ai_event_by_id(player,
+                                       player->automaton,
+                                       AUTOMATON_EVENT_ID_ARRIVED_AT_LOCATION);
   }
 
   /*
    * Set the player velocity using the desired position from above.
    */
   player_velocity = calc_velocity_towards_position(
-                                                 &(player->position),
+                                                 &position,
                                                  &(player->desired_position),
                                                  player->max_speed,
                                                  player->current_speed_percent);
@@ -151,6 +158,11 @@ int state_running_function(PLAYER *player, Uint32 dt)
  */
 void state_running_exit_function(PLAYER *player)
 {
+  /*
+   * Local Variables.
+   */
+  VECTOR3 player_velocity;
+
   DT_AI_LOG("(%i:%i) Exiting state running\n",
             player->team_id, 
             player->player_id);
@@ -158,14 +170,13 @@ void state_running_exit_function(PLAYER *player)
   /*
    * When leaving the running state we set the velocity to 0.
    */
-  player->velocity.x = 0.0f;
-  player->velocity.y = 0.0f;
-  player->velocity.z = 0.0f;
+  vector_set_values(&player_velocity, 0.0f, 0.0f, 0.0f);
+  set_player_velocity(player, &player_velocity);
 
   /*
    * Set the desired run location to be the position of the player.
    */
-  vector_copy_values(&(player->desired_position), &(player->position));
+  player->desired_position = get_player_position(player);
 }
 
 /*
@@ -185,6 +196,7 @@ int state_intercept_disc_function(PLAYER *player, Uint32 dt)
    */
   INTERCEPT intercept;
   VECTOR3 player_velocity;
+  VECTOR3 position = get_player_position(player);
 
   /*
    * If the disc is not in the air then the intercept point will be the 
@@ -201,18 +213,31 @@ int state_intercept_disc_function(PLAYER *player, Uint32 dt)
      * Calculate the position at which the player will intercept the disc.
      *
      * If the player cannot intercept the disc and they are in this state then
-     * just go to where the disc will stop.
+     * just go to where the disc will stop. If the path is still being
+     * calculated then that is the furthest point known so far and will be
+     * refined on later updates.
+     *
+     * The intercept is read from the match's intercept table which is only
+     * recalculated when the path or a player's speed changes.
      */
-    if (calculate_player_disc_path_intercept(player,
-                                             g_match_state->disc_path,
-                                             &intercept))
+    update_intercept_table(g_match_state->intercept_table,
+                           g_match_state->teams,
+                           g_match_state->num_teams,
+                           g_match_state->players_per_team,
+                           g_match_state->disc_path,
+                           g_match_state->sim_time_ms);
+    if (INTERCEPT_CALC_FOUND ==
+            get_intercept_table_entry(g_match_state->intercept_table,
+                                      player,
+                                      g_match_state->players_per_team,
+                                      &intercept))
     {
       vector_copy_values(&(player->desired_position), &(intercept.intercept));
     }
     else
     {
-      vector_copy_values(&(player->desired_position),
-                         &(g_match_state->disc_path->end_position->position));
+      get_disc_path_final_position(g_match_state->disc_path,
+                                   &(player->desired_position));
     }
   }
 
@@ -220,7 +245,7 @@ int state_intercept_disc_function(PLAYER *player, Uint32 dt)
    * Set the player velocity using the desired position from above.
    */
   player_velocity = calc_velocity_towards_position(
-                                                 &(player->position),
+                                                 &position,
                                                  &(player->desired_position),
                                                  player->max_speed,
                                                  player->current_speed_percent);
@@ -239,6 +264,11 @@ int state_intercept_disc_function(PLAYER *player, Uint32 dt)
  */
 void state_intercept_disc_exit_function(PLAYER *player)
 {
+  /*
+   * Local Variables.
+   */
+  VECTOR3 player_velocity;
+
   DT_AI_LOG("(%i:%i) Exiting state intercept disc\n",
             player->team_id, 
             player->player_id);
@@ -246,14 +276,13 @@ void state_intercept_disc_exit_function(PLAYER *player)
   /*
    * When leaving the running state we set the velocity to 0.
    */
-  player->velocity.x = 0.0f;
-  player->velocity.y = 0.0f;
-  player->velocity.z = 0.0f;
+  vector_set_values(&player_velocity, 0.0f, 0.0f, 0.0f);
+  set_player_velocity(player, &player_velocity);
 
   /*
    * Set the desired run location to be the position of the player.
    */
-  vector_copy_values(&(player->desired_position), &(player->position));
+  player->desired_position = get_player_position(player);
 }
 
 /*
@@ -273,7 +302,9 @@ int state_follow_player_function(PLAYER *player, Uint32 dt)
    * Local Variables.
    */
   VECTOR3 player_velocity;
-  TEAM *other_team = g_match_state->teams[g_curr_team == 0 ? 1 : 0];
+  VECTOR3 position = get_player_position(player);
+  TEAM *other_team =
+            g_match_state->teams[(g_curr_team + 1) % g_match_state->num_teams];
   int mark_index = player->marked_player_index;
 
   
@@ -284,7 +315,7 @@ int state_follow_player_function(PLAYER *player, Uint32 dt)
      * If the player does not have a valid mark then this state will not do 
      * anything.
      */
-    vector_copy_values(&(player->desired_position), &(player->position));
+    vector_copy_values(&(player->desired_position), &position);
   }
   else
   {
@@ -294,15 +325,15 @@ int state_follow_player_function(PLAYER *player, Uint32 dt)
      *
      * TODO: More sensible positioning for marker.
      */
-    vector_copy_values(&(player->desired_position),
-                       &(other_team->players[mark_index]->position));
+    player->desired_position =
+                          get_player_position(other_team->players[mark_index]);
   }
 
   /*
    * Set the player velocity using the desired position from above.
    */
   player_velocity = calc_velocity_towards_position(
-                                                 &(player->position),
+                                                 &position,
                                                  &(player->desired_position),
                                                  player->max_speed,
                                                  player->current_speed_percent);
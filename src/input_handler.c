@@ -9,12 +9,9 @@
 
 #include "SDL/SDL.h"
 
-#include "ai_general/ai_event_handler.h"
-#include "automaton_handler.h"
 #include "camera_handler.h"
 #include "disc.h"
-#include "disc_path.h"
-#include "impl_automatons/generic_o_d_files/event_names.h"
+#include "game_functions.h"
 #include "input_handler.h"
 #include "match_state.h"
 #include "mouse_click_state.h"
@@ -219,39 +216,11 @@ void handle_mousebutton_event(SDL_MouseButtonEvent *event,
             &(match_state->match_throw->end_state->world_y));
 
         /*
-         * Set disc state using the throw object that has just been created.
+         * Set disc state using the throw object that has just been created and
+         * let everyone know that the disc is in the air.
          */
         set_init_disc_conditions(match_state->disc, match_state->match_throw);
-
-        /*
-         * Create a disc path to associate with the current throw. This disc
-         * path has a very low interval so that we can use it to plot parts of
-         * the path if required.
-         *
-         * If there was already a disc path object then free it up.
-         */
-        if (NULL != match_state->disc_path)
-        {
-          destroy_disc_path(match_state->disc_path);
-        }
-        match_state->disc_path = create_disc_path();
-        init_disc_path(match_state->disc,
-                       match_state->disc_path,
-                       DISC_PATH_INTERVAL_MAX);
-
-        /*
-         * Set the information on who the thrower was.
-         */ 
-        match_state->disc->thrower = match_state->disc->holder;
-
-        /*
-         * Throw an event to all players to indicate that the disc is now in 
-         * the air again.
-         */ 
-        throw_multi_player_ai_event_by_name(match_state->teams,
-                                            match_state->players_per_team,
-                                            match_state->automaton_handler->offensive_set->start_automaton,
-                                            AUTOMATON_EVENT_DISC_RELEASED);
+        release_disc(match_state);
 
         /*
          * Set the throw in progress flag to false for next time.
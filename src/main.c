@@ -29,6 +29,7 @@
 #include "config_file/config_loader.h"
 #include "conversion_constants.h"
 #include "disc.h"
+#include "flight_condition_lu_table.h"
 #include "gl_window_handler.h"
 #include "impl_automatons/generic_o_d_files/event_names.h"
 #include "impl_automatons/generic_o_d_files/init_automaton_events.h"
@@ -64,12 +65,14 @@
  *
  * Parameters: automaton - Required to have access to the events.
  *             teams - All the players.
+ *             num_teams - The number of teams.
  *             players_per_team - Numbers of players in each team.
  *             ms_per_frame - Used to find how far each player will travel in
  *                            the next frame.
  */
 void detect_players_arrived_at_location(AUTOMATON *automaton,
                                         TEAM **teams,
+                                        int num_teams,
                                         int players_per_team,
                                         Uint32 ms_per_frame)
 {
@@ -77,18 +80,20 @@ void detect_players_arrived_at_location(AUTOMATON *automaton,
    * Local Variables.
    */
   PLAYER *player;
+  VECTOR3 position;
   float dist_per_frame;
   float s_per_frame = ((float) ms_per_frame) / MILLISECONDS_PER_SECOND;
   int ii;
   int jj;
 
-  for (ii = 0; ii < players_per_team; ii++)
+  for (jj = 0; jj < num_teams; jj++)
   {
-    for (jj = 0; jj < 2; jj++)
+    for (ii = 0; ii < players_per_team; ii++)
     {
       player = teams[jj]->players[ii];
+      position = get_player_position(player);
 
-      if (vectors_equal(&(player->position), &(player->desired_position)))
+      if (vectors_equal(&position, &(player->desired_position)))
       {
         /*
          * Calculate the distance that the player travels per update based on
@@ -102,15 +107,15 @@ void detect_players_arrived_at_location(AUTOMATON *automaton,
          * then throw a new event to inform the ai and let it decide what to do
          * next.
          *
-         * TODO: If the AI doesn't handle an arrived at desired position event
-         * then it could get thrown multiple times. How should this be handled?
+         * This is thrown every update until the ai picks a new position. The
+         * player's queue coalesces it so at most one is waiting at a time.
          */
         if (dist_between_vectors_2d(&(player->desired_position),
-                                    &(player->position)) < dist_per_frame)
+                                    &position) < dist_per_frame)
         {
-          throw_single_player_ai_event_by_name(player,
-                                       automaton,
-                                       AUTOMATON_EVENT_ARRIVED_AT_LOCATION);
+          throw_single_player_ai_event_by_id(player,
+                                      automaton,
+                                      AUTOMATON_EVENT_ID_ARRIVED_AT_LOCATION);
         }
       }
     }
@@ -180,23 +185,31 @@ void convert_score_to_text(unsigned int score_a,
  * Draw the players on the screen.
  *
  * Parameters: teams - Contains a link to all the players on the pitch.
+ *             num_teams - The number of teams.
  *             players_per_team - Used to iterate over the player array.
  *             animation_handler - Contains information on the animations used
  *                                 for the players.
+ *             interpolation - Fraction of a simulation step elapsed since the
+ *                             last step completed.
  */
 void draw_players(TEAM *teams[],
+                  int num_teams,
                   int players_per_team,
-                  ANIMATION_HANDLER *animation_handler)
+                  ANIMATION_HANDLER *animation_handler,
+                  float interpolation)
 {
   /*
    * Local Variables.
    */
   int ii;
+  int jj;
 
-  for (ii = 0; ii < players_per_team; ii++)
+  for (jj = 0; jj < num_teams; jj++)
   {
-    draw_player(teams[0]->players[ii], animation_handler);
-    draw_player(teams[1]->players[ii], animation_handler);
+    for (ii = 0; ii < players_per_team; ii++)
+    {
+      draw_player(teams[jj]->players[ii], animation_handler, interpolation);
+    }
   }
 }
 
@@ -235,10 +248,15 @@ void game_exit(char *message)
  *
  * Parameters: screen - The screen object on which we are drawing.
  *             match_state - The unique objects in a match.
+ *             font - The font used for the score and timer.
+ *             interpolation - Fraction of a simulation step elapsed since the
+ *                             last step completed. Moving objects are drawn
+ *                             this far between their last two positions.
  */
 void redraw_screen(SCREEN *screen,
                    MATCH_STATE *match_state,
-                   FONT *font)
+                   FONT *font,
+                   float interpolation)
 {
   /*
    * Local Variables.
@@ -264,13 +282,15 @@ void redraw_screen(SCREEN *screen,
    * and if they have new positions then update them.
    */
   draw_players(match_state->teams,
+               match_state->num_teams,
                match_state->players_per_team,
-               match_state->animation_handler);
+               match_state->animation_handler,
+               interpolation);
 
   /*
    * Draw the disc on top of the players.
    */
-  draw_disc(match_state->disc, 50.0f);
+  draw_disc(match_state->disc, 50.0f, interpolation);
 
   /*
    * Put the score on the screen as text. We make this independent of scaling
@@ -301,6 +321,69 @@ void redraw_screen(SCREEN *screen,
   SDL_GL_SwapBuffers();
 }
 
+/*
+ * simulate_step
+ *
+ * Advances the whole match by exactly one fixed simulation step. The ai,
+ * timed events, physics and collisions are always processed with the same
+ * time delta so that the disc flight model behaves identically regardless of
+ * the frame rate.
+ *
+ * Timed events are popped against the simulation clock rather than the wall
+ * clock so that they happen on the same step whatever the frame rate. The
+ * match's copy of the clock (sim_time_ms) is at the start of the step while
+ * the step runs, so a disc thrown during it is timed from where this step's
+ * physics starts flying it, and at the end of the step afterwards.
+ *
+ * Parameters: match_state - The unique objects in a match.
+ *             sim_time_ms - The simulation time at the start of the step,
+ *                           i.e. the number of steps already taken times the
+ *                           step length.
+ *             sim_ms_per_step - The length of the step in ms.
+ */
+void simulate_step(MATCH_STATE *match_state,
+                   Uint32 sim_time_ms,
+                   Uint32 sim_ms_per_step)
+{
+  match_state->sim_time_ms = sim_time_ms;
+
+  /*
+   * Perform an update on all the ai objects.
+   */
+  process_all_player_ai(match_state->teams,
+                        match_state->num_teams,
+                        match_state->players_per_team,
+                        sim_ms_per_step);
+
+  /*
+   * Process the automaton timed event queue to see if any events need to be
+   * popped.
+   */
+  pop_all_timed_events(match_state->automaton_handler->timed_event_queue,
+                       sim_time_ms,
+                       match_state);
+
+  /*
+   * Do physics processing. This updates the positions of all moving entities
+   * in the game.
+   */
+  calculate_positions(match_state, sim_ms_per_step);
+
+  /*
+   * Having moved all of the objects to their new positions we need to
+   * detect collisions and verify the new locations.
+   *
+   * At the end of this function the positions of all objects will have been
+   * updated and their old positions kept for interpolation.
+   */
+  detect_and_handle_collisions(match_state->collision_grid,
+                               match_state->player_separation,
+                               match_state->player_kinematics,
+                               match_state->disc);
+
+  match_state->sim_time_ms = sim_time_ms + sim_ms_per_step;
+}
+
 /**
  * main
  *
@@ -316,22 +399,31 @@ int main(int argc, char** argv)
   MATCH_STATE *match_state;
   Uint32 frame_start_time;
   Uint32 frame_time_taken_ms;
-  Uint32 physics_time_delta;
-  Uint32 last_physics_update;
-  Uint32 ai_time_delta;
-  Uint32 last_ai_update;
+  Uint32 last_frame_start_time;
+  Uint32 sim_time_accumulator = 0;
+  Uint32 num_sim_steps = 0;
+  Uint32 sim_ms_per_step;
+  int sim_ms_per_step_cfg;
+  Uint32 max_sim_ms_per_frame;
+  int max_sim_steps_per_frame;
+  float interpolation;
+  VECTOR3 camera_target;
   Uint32 ms_per_frame;
   int rc;
   StrMap *config_table;
   Uint32 last_animation_update = 0;
   Uint32 animation_ms_per_frame;
   int max_fps;
+  int num_teams;
+  int players_per_team;
   FONT *font;
   char disc_graphic_file[MAX_CONFIG_VALUE_LEN + 1];
   char grass_tile_file[MAX_CONFIG_VALUE_LEN + 1];
   char o_xml_file[MAX_CONFIG_VALUE_LEN + 1];
   char d_xml_file[MAX_CONFIG_VALUE_LEN + 1];
+  char flight_lu_table_file[MAX_CONFIG_VALUE_LEN + 1];
   int ii;
+  int jj;
   SDL_Color white = {0xFF, 0xFF, 0xFF, 0x00};
 
   /*
@@ -355,6 +447,34 @@ int main(int argc, char** argv)
     game_exit("Programmer error: max fps not handled in cfg.");
   }
   ms_per_frame = (int) MILLISECONDS_PER_SECOND / max_fps;
+  if (!get_config_value_int(config_table,
+                            cv_sim_ms_per_step,
+                            &sim_ms_per_step_cfg))
+  {
+    game_exit("Programmer error: sim ms per step not handled in cfg.");
+  }
+  if (sim_ms_per_step_cfg <= 0)
+  {
+    game_exit("The simulation step length in the config must be positive.");
+  }
+  sim_ms_per_step = (Uint32) sim_ms_per_step_cfg;
+  if (!get_config_value_int(config_table,
+                            cv_max_sim_steps_per_frame,
+                            &max_sim_steps_per_frame))
+  {
+    game_exit("Programmer error: max sim steps per frame not handled in cfg.");
+  }
+  max_sim_ms_per_frame = sim_ms_per_step * max_sim_steps_per_frame;
+  if (!get_config_value_int(config_table, cv_num_teams, &num_teams))
+  {
+    game_exit("Programmer error: number of teams not handled in cfg.");
+  }
+  if (!get_config_value_int(config_table,
+                            cv_players_per_team,
+                            &players_per_team))
+  {
+    game_exit("Programmer error: players per team not handled in cfg.");
+  }
   if (!get_config_value_str(config_table, cv_disc_graphic, (char *)disc_graphic_file))
   {
     game_exit("Programmer error: disc graphic not handled in cfg.");
@@ -371,6 +491,12 @@ int main(int argc, char** argv)
   {
     game_exit("Programmer error: D XML file not handled in cfg.");
   }
+  if (!get_config_value_str(config_table,
+                            cv_flight_lu_table_file,
+                            (char *)flight_lu_table_file))
+  {
+    game_exit("Programmer error: flight table file not handled in cfg.");
+  }
   DT_DEBUG_LOG("Config file loaded\n");
 
   /*
@@ -435,6 +561,8 @@ int main(int argc, char** argv)
    */
   match_state = create_match_state(15,
                                    60 * 60,
+                                   num_teams,
+                                   players_per_team,
                                    disc_graphic_file,
                                    grass_tile_file,
                                    o_xml_file,
@@ -448,6 +576,23 @@ int main(int argc, char** argv)
   init_pitch(match_state->pitch);
   DT_DEBUG_LOG("Match state created and initialized\n");
 
+  /*
+   * Map in the flight condition table (make game generates it). The game
+   * still runs without it but every throw then has to be solved for.
+   */
+  rc = load_flight_condition_lu_table(match_state->flight_lu_table,
+                                      flight_lu_table_file);
+  if (FLIGHT_LU_TABLE_OK != rc)
+  {
+    DT_DEBUG_LOG("Flight condition table %s could not be loaded: %i\n",
+                 flight_lu_table_file,
+                 rc);
+  }
+  else
+  {
+    DT_DEBUG_LOG("Flight condition table loaded\n");
+  }
+
   /*
    * Scale the pitch by an arbitrary amount to account for the otherwise small
    * scaling.
@@ -467,8 +612,7 @@ int main(int argc, char** argv)
   /*
    * Initialise the timings
    */
-  last_physics_update = SDL_GetTicks();
-  last_ai_update = SDL_GetTicks();
+  last_frame_start_time = SDL_GetTicks();
 
   /*
    * Initialise and start a new match.
@@ -476,10 +620,11 @@ int main(int argc, char** argv)
   start_match(match_state);
 
   // @@@DAT testing
-  throw_multi_player_ai_event_by_name(match_state->teams,
-                                      match_state->players_per_team,
-                                      match_state->teams[0]->players[0]->automaton,
-                                      AUTOMATON_EVENT_PULL_THROWN);
+  throw_multi_player_ai_event_by_id(match_state->teams,
+                                    match_state->num_teams,
+                                    match_state->players_per_team,
+                                    match_state->teams[0]->players[0]->automaton,
+                                    AUTOMATON_EVENT_ID_PULL_THROWN);
 
   /*
    * Game loop
@@ -492,14 +637,6 @@ int main(int argc, char** argv)
      */
     frame_start_time = SDL_GetTicks();
 
-    /*
-     * Look at disc
-     */
-    look_at_location(match_state->camera_handler,
-                     match_state->disc->position.x,
-                     match_state->disc->position.y,
-                     screen);
-
     /*
      * While there are events to process, do so.
      */
@@ -539,44 +676,49 @@ int main(int argc, char** argv)
     }
 
     /*
-     * Perform an update on all the ai objects.
+     * The simulation runs in fixed steps. Bank the real time that has passed
+     * since the last frame and then run as many whole steps as it pays for.
+     *
+     * If the frame took a very long time (e.g. the window was dragged) then
+     * we drop the excess rather than trying to catch up. Otherwise each slow
+     * frame would schedule more steps for the next and the game would never
+     * recover.
      */
-    ai_time_delta = SDL_GetTicks() - last_ai_update;
-    process_all_player_ai(match_state->teams,
-                          match_state->players_per_team,
-                          ai_time_delta);
-    last_ai_update = SDL_GetTicks();
+    sim_time_accumulator += frame_start_time - last_frame_start_time;
+    last_frame_start_time = frame_start_time;
+    if (sim_time_accumulator > max_sim_ms_per_frame)
+    {
+      DT_DEBUG_LOG("Dropping %i ms of simulation time\n",
+                   sim_time_accumulator - max_sim_ms_per_frame);
+      sim_time_accumulator = max_sim_ms_per_frame;
+    }
 
-    /*
-     * Process the automaton timed event queue to see if any events need to be
-     * popped.
-     */
-    pop_all_timed_events(match_state->automaton_handler->timed_event_queue,
-                         SDL_GetTicks(),
-                         match_state);
+    while (sim_time_accumulator >= sim_ms_per_step)
+    {
+      simulate_step(match_state,
+                    num_sim_steps * sim_ms_per_step,
+                    sim_ms_per_step);
+      num_sim_steps++;
+      sim_time_accumulator -= sim_ms_per_step;
+    }
 
     /*
-     * Do physics processing. This updates the positions of all moving entities
-     * in the game.
-     *
-     * WARNING - If this takes longer than the amount of time allocated per
-     * frame then there might be 'interesting' problems in the frame refresh.
+     * Whatever is left in the accumulator is the fraction of a step that the
+     * simulation is behind real time. Objects are drawn that far between their
+     * previous and current positions.
      */
-    physics_time_delta = SDL_GetTicks() - last_physics_update;
-    calculate_positions(match_state,
-                        physics_time_delta);
-    last_physics_update = SDL_GetTicks();
+    interpolation = ((float) sim_time_accumulator) / ((float) sim_ms_per_step);
 
     /*
-     * Having moved all of the objects to their new positions we need to
-     * detect collisions and verify the new locations.
-     *
-     * At the end of this function the positions of all objects will have been
-     * updated.
+     * Look at disc
      */
-    detect_and_handle_collisions(match_state->teams,
-                                 match_state->players_per_team,
-                                 match_state->disc);
+    camera_target = vector_interpolate(&(match_state->disc->previous_position),
+                                       &(match_state->disc->position),
+                                       interpolation);
+    look_at_location(match_state->camera_handler,
+                     camera_target.x,
+                     camera_target.y,
+                     screen);
 
     /*
      * Update the camera object.
@@ -591,12 +733,13 @@ int main(int argc, char** argv)
     if (SDL_GetTicks() - last_animation_update >= animation_ms_per_frame)
     {
       last_animation_update = SDL_GetTicks();
-      for (ii = 0; ii < match_state->players_per_team; ii++)
+      for (jj = 0; jj < match_state->num_teams; jj++)
       {
-        increment_animation_frame_counter(match_state->teams[0]->players[ii],
-                                          match_state->animation_handler);
-        increment_animation_frame_counter(match_state->teams[1]->players[ii],
-                                          match_state->animation_handler);
+        for (ii = 0; ii < match_state->players_per_team; ii++)
+        {
+          increment_animation_frame_counter(match_state->teams[jj]->players[ii],
+                                            match_state->animation_handler);
+        }
       }
     }
 
@@ -613,7 +756,7 @@ int main(int argc, char** argv)
     /*
      * Redraw the screen.
      */
-    redraw_screen(screen, match_state, font);
+    redraw_screen(screen, match_state, font, interpolation);
   }
 
   return(0);
@@ -23,44 +23,60 @@
  * At the start of a point we put the players evenly spaced along the endzone
  * line.
  *
+ * Teams with an even index start on the same side as team 0 and the rest on
+ * the other. Where there are more than two teams each pair after the first
+ * lines up a little further forwards, and a team too big to fit across the
+ * pitch carries on in another line in front of the first.
+ *
  * Parameters: match_state - Must have the player objects already created.
+ *             team_0_left - Whether team 0 starts at the left end.
  */
 void put_players_on_line(MATCH_STATE *match_state, bool team_0_left)
 {
   /*
    * Local Variables.
    */
+  float x_pos;
   float y_pos;
-  int ls;
-  int rs;
+  float forwards;
+  bool left;
+  int per_line;
+  int ii;
   int jj;
 
-  /*
-   * Set which team is one which side of the pitch.
-   */
-  ls = team_0_left ? 0 : 1;
-  rs = team_0_left ? 1 : 0;
+  per_line = (match_state->pitch->width_m - 7) / 5 + 1;
+  if (per_line < 1)
+  {
+    per_line = 1;
+  }
 
-  /*
-   * Loop through both teams at the same time placing the players on the pitch.
-   */
-  for (jj = 0; jj < match_state->players_per_team; jj++)
+  for (jj = 0; jj < match_state->num_teams; jj++)
   {
-    y_pos = 7.0f + ((float) jj) * 5.0f;
+    /*
+     * Set which side of the pitch the team is on.
+     */
+    left = ((0 == jj % 2) == team_0_left);
+
+    for (ii = 0; ii < match_state->players_per_team; ii++)
+    {
+      forwards = ((float) (jj / 2 + ii / per_line)) * 2.0f;
+      if (left)
+      {
+        x_pos = (float) match_state->pitch->endzone_depth_m + forwards;
+      }
+      else
+      {
+        x_pos = (float) match_state->pitch->length_m -
+                (float) match_state->pitch->endzone_depth_m - forwards;
+      }
+      y_pos = 7.0f + ((float) (ii % per_line)) * 5.0f;
 
-    vector_set_values(&(match_state->teams[ls]->players[jj]->position),
-                      (float) match_state->pitch->endzone_depth_m,
-                      y_pos,
-                      0.0f);
-    vector_set_values(&(match_state->teams[rs]->players[jj]->position),
-                      (float) match_state->pitch->length_m -
-                      (float) match_state->pitch->endzone_depth_m,
-                      y_pos,
-                      0.0f);
-    vector_copy_values(&(match_state->teams[ls]->players[jj]->new_position),
-                       &(match_state->teams[ls]->players[jj]->position));
-    vector_copy_values(&(match_state->teams[rs]->players[jj]->new_position),
-                       &(match_state->teams[rs]->players[jj]->position));
+      /*
+       * The players are placed rather than moved so that they aren't drawn
+       * sliding in from wherever they were before.
+       */
+      place_player(match_state->teams[jj]->players[ii], x_pos, y_pos);
+    }
   }
 }
 
@@ -74,6 +90,8 @@ void put_disc_in_default_pos(MATCH_STATE *match_state)
   match_state->disc->position.z = 1.5f;
   vector_copy_values(&(match_state->disc->new_position),
                      &(match_state->disc->position));
+  vector_copy_values(&(match_state->disc->previous_position),
+                     &(match_state->disc->position));
   match_state->disc->disc_state = disc_on_ground;
 }
 
@@ -88,6 +106,11 @@ void put_disc_in_default_pos(MATCH_STATE *match_state)
  */
 void start_match(MATCH_STATE *match_state)
 {
+  /*
+   * Local Variables.
+   */
+  int ii;
+
   /*
    * Start the game timer running.
    */
@@ -106,8 +129,9 @@ void start_match(MATCH_STATE *match_state)
   /*
    * TODO: Better handling of who starts on offense and which end.
    */
-  match_state->teams[0]->is_offense = true;
-  match_state->teams[1]->is_offense = false;
-  match_state->teams[0]->attacking_left_to_right = true;
-  match_state->teams[1]->attacking_left_to_right = true;
+  for (ii = 0; ii < match_state->num_teams; ii++)
+  {
+    match_state->teams[ii]->is_offense = (0 == ii);
+    match_state->teams[ii]->attacking_left_to_right = true;
+  }
 }
@@ -14,77 +14,85 @@
 #include "automaton/data_structures/automaton_state.h"
 #include "automaton/data_structures/automaton_event.h"
 #include "camera_handler.h"
+#include "collisions/collision_grid.h"
+#include "collisions/intercept_table.h"
+#include "collisions/player_separation.h"
 #include "disc.h"
+#include "disc_path.h"
+#include "flight_condition_lu_table.h"
 #include "input_handler.h"
 #include "match_state.h"
 #include "match_stats.h"
 #include "pitch.h"
 #include "player.h"
+#include "player_kinematics.h"
 #include "team.h"
 #include "throw.h"
+#include "throw_solver.h"
 
 /*
  * create_players
  *
  * INTERNAL: This function should only be called from the create_match_state
  * function and is used to create the players for use in a match.
+ *
+ * The players are added to the kinematics store a team at a time, so the
+ * index of each player in the store is player_id + players_per_team * team_id.
  */
 void create_players(TEAM **teams,
+                    int num_teams,
                     int players_per_team,
-                    AUTOMATON_HANDLER *automaton_handler)
+                    AUTOMATON_HANDLER *automaton_handler,
+                    PLAYER_KINEMATICS *kinematics)
 {
   /*
    * Local Variables.
    */
-  AUTOMATON *team_0_start_automaton;
-  AUTOMATON *team_1_start_automaton;
-  AUTOMATON_STATE *team_0_start_state;
-  AUTOMATON_STATE *team_1_start_state;
+  AUTOMATON *start_automaton;
+  AUTOMATON_STATE *start_state;
+  PLAYER *player;
   int ii;
+  int jj;
 
-  /*
-   * Based on which team is on offence set up the two teams starting automaton.
-   * This also defines the starting state for the players inside the automaton.
-   */
-  if (teams[0]->is_offense)
-  {
-    team_0_start_automaton = automaton_handler->offensive_set->start_automaton;
-    team_1_start_automaton = automaton_handler->defensive_set->start_automaton;
-  }
-  else
-  {
-    team_0_start_automaton = automaton_handler->defensive_set->start_automaton;
-    team_1_start_automaton = automaton_handler->offensive_set->start_automaton;
-  }
-  team_0_start_state = team_0_start_automaton->start_state;
-  team_1_start_state = team_1_start_automaton->start_state;
-
-  for (ii = 0; ii < players_per_team; ii++)
+  for (jj = 0; jj < num_teams; jj++)
   {
     /*
-     * Create the player object with the player id and team id.
+     * Based on whether the team is on offence set up the team's starting
+     * automaton. This also defines the starting state for the players inside
+     * the automaton.
      */
-    teams[0]->players[ii] = create_player(ii, 0);
-    teams[1]->players[ii] = create_player(ii, 1);
+    if (teams[jj]->is_offense)
+    {
+      start_automaton = automaton_handler->offensive_set->start_automaton;
+    }
+    else
+    {
+      start_automaton = automaton_handler->defensive_set->start_automaton;
+    }
+    start_state = start_automaton->start_state;
 
-    /*
-     * TODO: Sort out proper width for players.
-     */
-    teams[0]->players[ii]->width_x = 2.0f;
-    teams[1]->players[ii]->width_x = 2.0f;
-    teams[0]->players[ii]->width_y = 2.0f;
-    teams[1]->players[ii]->width_y = 2.0f;
-    teams[0]->players[ii]->height = 2.0f;
-    teams[1]->players[ii]->height = 2.0f;
+    for (ii = 0; ii < players_per_team; ii++)
+    {
+      /*
+       * Create the player object with the player id and team id.
+       */
+      player = create_player(ii, jj, kinematics);
+      teams[jj]->players[ii] = player;
 
-    /*
-     * The player has a reference to the starting automaton for their team. We
-     * also fill in the initial automaton state here.
-     */
-    teams[0]->players[ii]->automaton = team_0_start_automaton;
-    teams[1]->players[ii]->automaton = team_1_start_automaton;
-    teams[0]->players[ii]->automaton_state = team_0_start_state;
-    teams[1]->players[ii]->automaton_state = team_1_start_state;
+      /*
+       * TODO: Sort out proper width for players.
+       */
+      player->width_x = 2.0f;
+      player->width_y = 2.0f;
+      player->height = 2.0f;
+
+      /*
+       * The player has a reference to the starting automaton for their team.
+       * We also fill in the initial automaton state here.
+       */
+      player->automaton = start_automaton;
+      player->automaton_state = start_state;
+    }
   }
 }
 
@@ -93,10 +101,15 @@ void create_players(TEAM **teams,
  *
  * TODO: Fill this function block in once we tie down what this actually does.
  *
+ * Everything sized by the number of players is allocated here, once, so that
+ * nothing needs to grow during the match however many players there are.
+ *
  * Returns: A pointer to the new object or NULL on failure.
  */
 MATCH_STATE *create_match_state(unsigned int hard_cap,
                                 unsigned int game_length_s,
+                                int num_teams,
+                                int players_per_team,
                                 char *disc_graphic_filename,
                                 char *grass_tile_filename,
                                 char *offensive_xml_file,
@@ -105,11 +118,16 @@ MATCH_STATE *create_match_state(unsigned int hard_cap,
                                 int (*event_callback)(AUTOMATON_EVENT ***))
 {
   MATCH_STATE *state;
+  int num_players = num_teams * players_per_team;
+  int ii;
 
   /*
    * Allocate the memory for the new object.
    */
   state = (MATCH_STATE *) DT_MALLOC(sizeof(MATCH_STATE));
+  state->num_teams = num_teams;
+  state->players_per_team = players_per_team;
+  state->teams = NULL;
 
   /*
    * Set the throw to null to start, this will be created when the user starts
@@ -127,6 +145,29 @@ MATCH_STATE *create_match_state(unsigned int hard_cap,
    * been created.
    */
   state->disc_path = NULL;
+  state->sim_time_ms = 0;
+
+  /*
+   * The flight condition table is filled in from file by the caller.
+   */
+  state->flight_lu_table = create_flight_condition_lu_table();
+  state->throw_solver = create_throw_solver(state->flight_lu_table);
+  state->intercept_table = create_intercept_table(num_players);
+
+  /*
+   * The collision grid covers the largest pitch allowed and a margin around
+   * it for players who run off the pitch.
+   */
+  state->collision_grid = create_collision_grid(-COLLISION_GRID_MARGIN_M,
+                                                -COLLISION_GRID_MARGIN_M,
+                                                PITCH_LENGTH_MAX +
+                                                      COLLISION_GRID_MARGIN_M,
+                                                PITCH_WIDTH_MAX +
+                                                      COLLISION_GRID_MARGIN_M,
+                                                COLLISION_GRID_CELL_M,
+                                                num_players);
+  state->player_separation = create_player_separation(num_players);
+  state->player_kinematics = create_player_kinematics(num_players);
 
   /*
    * Initialise the pitch objects associated with the match.
@@ -174,14 +215,20 @@ MATCH_STATE *create_match_state(unsigned int hard_cap,
   }
 
   /*
-   * Create the teams.
+   * Create the teams. The first team starts on offence and every other team
+   * on defence.
    */
-  state->teams[0] = create_team();
-  state->teams[1] = create_team();
-  state->players_per_team = PLAYERS_PER_TEAM;
+  state->teams = (TEAM **) DT_MALLOC(sizeof(TEAM *) * num_teams);
+  for (ii = 0; ii < num_teams; ii++)
+  {
+    state->teams[ii] = create_team(players_per_team);
+  }
+  state->teams[0]->is_offense = true;
   create_players(state->teams,
+                 state->num_teams,
                  state->players_per_team,
-                 state->automaton_handler);
+                 state->automaton_handler,
+                 state->player_kinematics);
 
 EXIT_LABEL:
 
@@ -197,6 +244,29 @@ EXIT_LABEL:
  */
 void destroy_match_state(MATCH_STATE *state)
 {
+  /*
+   * Local Variables.
+   */
+  int ii;
+  int jj;
+
+  /*
+   * The teams are only created once the automaton handler has been, so may
+   * not exist yet.
+   */
+  if (NULL != state->teams)
+  {
+    for (jj = 0; jj < state->num_teams; jj++)
+    {
+      for (ii = 0; ii < state->players_per_team; ii++)
+      {
+        destroy_player(state->teams[jj]->players[ii]);
+      }
+      destroy_team(state->teams[jj]);
+    }
+    DT_FREE(state->teams);
+  }
+
   /*
    * The below objects were created in the create function and so are destroyed
    * in the destroy function. This gives us a single cleanup point for the
@@ -205,6 +275,16 @@ void destroy_match_state(MATCH_STATE *state)
   destroy_match_stats(state->match_stats);
   destroy_camera_handler(state->camera_handler);
   destroy_disc(state->disc);
+  if (NULL != state->disc_path)
+  {
+    destroy_disc_path(state->disc_path);
+  }
+  destroy_player_kinematics(state->player_kinematics);
+  destroy_player_separation(state->player_separation);
+  destroy_collision_grid(state->collision_grid);
+  destroy_intercept_table(state->intercept_table);
+  destroy_throw_solver(state->throw_solver);
+  destroy_flight_condition_lu_table(state->flight_lu_table);
   destroy_pitch(state->pitch);
   destroy_throw(state->match_throw);
   destroy_key_input_state(state->key_input_state);
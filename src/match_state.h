@@ -10,6 +10,8 @@
 #ifndef MATCH_STATE_H_
 #define MATCH_STATE_H_
 
+#include "SDL/SDL.h"
+
 struct automaton_state;
 struct automaton_event;
 struct automaton_handler;
@@ -19,6 +21,12 @@ struct disc;
 struct pitch;
 struct disc_throw;
 struct disc_path;
+struct flight_condition_lu_table;
+struct throw_solver;
+struct intercept_table;
+struct collision_grid;
+struct player_separation;
+struct player_kinematics;
 struct team;
 struct camera_handler;
 struct animation_handler;
@@ -38,8 +46,22 @@ struct match_stats;
  *        null after the match has been started.
  * disc_path - The path of the disc object with a small interval. This path is
  *             used to generate debugging information.
+ * flight_lu_table - The throw conditions needed to land the disc at a given
+ *                   distance. Empty until a table file is loaded into it.
+ * throw_solver - Works out throws to land the disc at a given point, keeping
+ *                previous solutions to speed up later ones.
+ * intercept_table - Where each player can intercept the current disc path.
+ *                   Shared by everything that needs it so that it is only
+ *                   calculated when the path or a player changes.
+ * collision_grid - The broadphase grid used to find collisions between the
+ *                  players and with the disc.
+ * player_separation - Pushes apart players who run into each other.
+ * player_kinematics - Where every player is and how fast they are moving.
  * teams - Contains all the player objects along with team specific info.
- * players_per_team - Saves calculating on the fly.
+ * num_teams - The number of teams in the match.
+ * players_per_team - The number of players on every team. A player's index
+ *                    across the whole match is player_id +
+ *                    players_per_team * team_id.
  * camera_handler - Information on where the camera is currently pointing.
  * mouse_input_state - The current state of mouse buttons.
  * key_input_state - The current state of keys, which are pushed down.
@@ -47,6 +69,10 @@ struct match_stats;
  * automaton_handler - Contains all the information on ai automatons used in the
  *                     game.
  * match_stats - Statistics relevant to the game. Score, timers etc.
+ * sim_time_ms - The simulation clock. The number of ms of simulation that
+ *               have been run, which is where the disc and players have got
+ *               to. Disc paths are timed on this clock rather than the wall
+ *               clock so that they agree with where the disc really is.
  */
 typedef struct match_state
 {
@@ -54,7 +80,14 @@ typedef struct match_state
   struct disc_throw *match_throw;
   struct disc *disc;
   struct disc_path *disc_path;
-  struct team *teams[2];
+  struct flight_condition_lu_table *flight_lu_table;
+  struct throw_solver *throw_solver;
+  struct intercept_table *intercept_table;
+  struct collision_grid *collision_grid;
+  struct player_separation *player_separation;
+  struct player_kinematics *player_kinematics;
+  struct team **teams;
+  int num_teams;
   int players_per_team;
   struct camera_handler *camera_handler;
   struct mouse_input_state *mouse_input_state;
@@ -62,10 +95,13 @@ typedef struct match_state
   struct animation_handler *animation_handler;
   struct automaton_handler *automaton_handler;
   struct match_stats *match_stats;
+  Uint32 sim_time_ms;
 } MATCH_STATE;
 
 MATCH_STATE *create_match_state(unsigned int,
                                 unsigned int,
+                                int,
+                                int,
                                 char *,
                                 char *,
                                 char *,
@@ -4,6 +4,9 @@
  * This file contains all the physics processing functions that recalculate
  * positions.
  *
+ * Building with DT_HEADLESS leaves out the parts that need a match so that
+ * the flight model can be used on its own (see Tools/flight_sim).
+ *
  *  Created on: 26 Oct 2009
  *      Author: David
  */
@@ -14,13 +17,16 @@
 #include "conversion_constants.h"
 #include "data_structures/vector.h"
 #include "disc.h"
-#include "disc_path.h"
 #include "flight_mechanics/disc_flight.h"
 #include "flight_mechanics/disc_forces.h"
+#ifndef DT_HEADLESS
+#include "disc_path.h"
 #include "game_functions.h"
 #include "match_state.h"
 #include "player.h"
+#include "player_kinematics.h"
 #include "team.h"
+#endif
 
 /*
  * update_vector_from_differential
@@ -113,39 +119,17 @@ VECTOR3 calc_velocity_towards_position(VECTOR3 *position,
  *                                If false it allows the position to be updated
  *                                directly (bypassing collision detection) and
  *                                this is used for creating flight paths.
+ *             integrator - The numerical method used to take the step.
  */
 void calculate_disc_position(DISC *disc,
                              float time_step_s,
-                             bool use_new_position)
+                             bool use_new_position,
+                             DISC_INTEGRATOR integrator)
 {
   /*
    * Local Variables.
    */
-  VECTOR3 d1;
-  VECTOR3 acceleration;
-  DISC_FORCES disc_forces;
-  float alpha;
-
-  d1 = find_disc_plane_axis(&(disc->velocity), &(disc->d3));
-  alpha = smallest_angle_between_vectors(&(disc->velocity), &d1);
-  if (vector_dot_product(&(disc->velocity), &(disc->d3)) >= 0)
-  {
-    alpha = -1.0f * alpha;
-  }
-  disc_forces = calc_disc_forces(&(disc->velocity),
-                                 &(disc->angular_velocity),
-                                 alpha);
-  get_disc_acc_from_forces(&disc_forces,
-                           &(disc->velocity),
-                           &acceleration,
-                           &d1,
-                           &(disc->d3));
-  update_extra_vels_from_disc_forces(disc, &disc_forces, time_step_s);
-  /**(disc->d3) = update_disc_up_axis(disc->d3,
-                                    disc->velocity,
-                                    disc->angular_velocity->y,
-                                    disc->angular_velocity->x,
-                                    time_step_s);*/
+  VECTOR3 *position;
 
   DT_DEBUG_LOG("Disc velocity pre update: (%f, %f, %f)\n",
                disc->velocity.x,
@@ -157,40 +141,36 @@ void calculate_disc_position(DISC *disc,
                  disc->position.z);
 
   /*
-   * Having done all the complex calculations update the velocity and new
-   * position vectors.
-   *
-   * Note that we update the new position vector rather than the position
-   * vector itself as that is done by the collision handler after it has
-   * verified that no collisions have taken place.
+   * Note that we normally update the new position vector rather than the
+   * position vector itself as that is done by the collision handler after it
+   * has verified that no collisions have taken place.
    */
-  update_vector_from_differential(&(disc->velocity), &acceleration, time_step_s);
-  DT_DEBUG_LOG("Disc velocity post update: (%f, %f, %f)\n",
-               disc->velocity.x,
-               disc->velocity.y,
-               disc->velocity.z);
   if (use_new_position)
   {
-    update_vector_from_differential(&(disc->new_position),
-                                    &(disc->velocity),
-                                    time_step_s);
-    DT_DEBUG_LOG("Disc position post update: (%f, %f, %f)\n",
-                   disc->new_position.x,
-                   disc->new_position.y,
-                   disc->new_position.z);
+    position = &(disc->new_position);
   }
   else
   {
-    update_vector_from_differential(&(disc->position),
-                                    &(disc->velocity),
-                                    time_step_s);
-    DT_DEBUG_LOG("Disc position post update: (%f, %f, %f)\n",
-                   disc->position.x,
-                   disc->position.y,
-                   disc->position.z);
+    position = &(disc->position);
   }
+
+  /*
+   * Having done all the complex calculations update the velocity and position
+   * vectors.
+   */
+  integrate_disc_flight(disc, position, time_step_s, integrator);
+
+  DT_DEBUG_LOG("Disc velocity post update: (%f, %f, %f)\n",
+               disc->velocity.x,
+               disc->velocity.y,
+               disc->velocity.z);
+  DT_DEBUG_LOG("Disc position post update: (%f, %f, %f)\n",
+               position->x,
+               position->y,
+               position->z);
 }
 
+#ifndef DT_HEADLESS
 /*
  * calculate_positions
  *
@@ -207,14 +187,20 @@ void calculate_positions(MATCH_STATE *match_state,
    * Local Variables.
    */
   float time_step_s = time_step / MILLISECONDS_PER_SECOND;
-  int ii;
+  DISC_FLIGHT *flight;
 
   /*
-   * Only move the disc if it is in flight.
+   * Only move the disc if it is in flight. It is flown in the same way as the
+   * disc path worked out when it was thrown so it goes exactly where the
+   * players expect it to. A disc that has landed stays at the landing point.
    */
   if (match_state->disc->disc_state == disc_in_air)
   {
-    calculate_disc_position(match_state->disc, time_step_s, true);
+    flight = match_state->disc->flight;
+    fly_disc_flight(flight,
+                    flight->t + time_step_s,
+                    &(match_state->disc->new_position),
+                    &(match_state->disc->velocity));
 
     /*
      * Check if the disc is in contact with the ground and if so then register
@@ -227,29 +213,11 @@ void calculate_positions(MATCH_STATE *match_state,
   }
 
   /*
-   * The players have only moved if the velocity vector is non-zero. If this is
-   * the case then we want to update their NEW position vector not the current
-   * one.
+   * We want to update the players' NEW positions not the current ones.
    *
    * The collision handler deals with checking the positions are valid and
-   * setting the current position vector.
+   * setting the current positions.
    */
-  for (ii = 0; ii < match_state->players_per_team; ii++)
-  {
-    /*
-     * Update the new player position on team a.
-     */
-    update_vector_from_differential(
-                            &(match_state->teams[0]->players[ii]->new_position),
-                            &(match_state->teams[0]->players[ii]->velocity),
-                            time_step_s);
-
-    /*
-     * Do the same thing for the corresponding player on the other team.
-     */
-    update_vector_from_differential(
-                            &(match_state->teams[1]->players[ii]->new_position),
-                            &(match_state->teams[1]->players[ii]->velocity),
-                            time_step_s);
-  }
+  integrate_player_kinematics(match_state->player_kinematics, time_step_s);
 }
+#endif
@@ -11,7 +11,9 @@
 #include <stdbool.h>
 #include <stddef.h>
 #include "player.h"
+#include "player_kinematics.h"
 #include "disc.h"
+#include "disc_path.h"
 #include "animation/animation_handler.h"
 #include "data_structures/vector.h"
 #include "data_structures/event_queue.h"
@@ -23,10 +25,12 @@
  *
  * Parameters: index - Must be unique only across players in the current team
  *             team - Either 0 or 1, corresponds to the index in the team array.
+ *             kinematics - The store to hold the player's position and
+ *                          velocity. Must have room for them.
  *
  * Returns: A pointer to the new object.
  */
-PLAYER *create_player(int id, int team)
+PLAYER *create_player(int id, int team, PLAYER_KINEMATICS *kinematics)
 {
   PLAYER *new_player;
 
@@ -49,17 +53,20 @@ PLAYER *create_player(int id, int team)
   new_player->automaton_state = NULL;
 
   /*
-   * Create the vectors used for the player.
+   * The player starts standing still at the origin.
    */
-  vector_set_values(&(new_player->position), 0.0f, 0.0f, 0.0f);
-  vector_set_values(&(new_player->new_position), 0.0f, 0.0f, 0.0f);
-  vector_set_values(&(new_player->velocity), 0.0f, 0.0f, 0.0f);
+  new_player->kinematics = kinematics;
+  new_player->kinematics_index = add_player_kinematics(kinematics, new_player);
+  DT_ASSERT(-1 != new_player->kinematics_index);
   vector_set_values(&(new_player->desired_position), 0.0f, 0.0f, 0.0f);
 
   /*
    * Create an event queue for this player.
    */
-  new_player->event_queue = create_event_queue();
+  new_player->event_queue = create_event_queue(
+                                        PLAYER_EVENT_QUEUE_CAPACITY,
+                                        PLAYER_EVENT_QUEUE_OVERFLOW_POLICY,
+                                        PLAYER_EVENT_QUEUE_COALESCE);
 
   /*
    * The default animation for a player is standing still.
@@ -73,6 +80,7 @@ PLAYER *create_player(int id, int team)
    */
   new_player->max_speed = 10.0f;
   new_player->current_speed_percent = 100.0f;
+  new_player->disc_reading_skill = DISC_PATH_SKILL_DEFAULT;
 
   /*
    * Default is for players to start off managed by the ai.
@@ -96,6 +104,20 @@ PLAYER *create_player(int id, int team)
  */
 void destroy_player(PLAYER *player)
 {
+  /*
+   * Report how full the event queue got over the match so that its capacity
+   * can be tuned.
+   */
+  DT_AI_LOG("(%i:%i) Event queue high water mark %u of %u, %u coalesced, " \
+            "%u dropped\n",
+            player->team_id,
+            player->player_id,
+            player->event_queue->high_water_mark,
+            player->event_queue->capacity,
+            player->event_queue->num_coalesced,
+            player->event_queue->num_dropped);
+  destroy_event_queue(player->event_queue);
+
   /*
    * Free the player object itself.
    */
@@ -103,33 +125,75 @@ void destroy_player(PLAYER *player)
 }
 
 /*
- * set_player_velocity
+ * get_player_position
  *
- * This is the setter function for the player velocity.
+ * Parameters: player - The player.
  *
- * Parameters: player - The player whose velocity is being changed.
- *             new_velocity - The new velocity vector.
+ * Returns: Where the player is. Players are always on the ground so z is 0.
  */
-void set_player_velocity(PLAYER *player, VECTOR3 *new_velocity)
+VECTOR3 get_player_position(PLAYER *player)
 {
-  vector_set_values(&(player->velocity),
-                    new_velocity->x,
-                    new_velocity->y,
-                    new_velocity->z);
+  /*
+   * Local Variables.
+   */
+  VECTOR3 position;
+
+  vector_set_values(&position,
+                    player->kinematics->x[player->kinematics_index],
+                    player->kinematics->y[player->kinematics_index],
+                    0.0f);
+
+  return(position);
 }
 
 /*
- * complete_player_coords_update
+ * get_player_previous_position
  *
- * At the end of the collision detection phase this routine is called for each
- * player. It completes the update phase for the players so that the next time
- * that they are drawn they are in the new position.
+ * Parameters: player - The player.
  *
- * Parameters: player - The player object to complete the move for.
+ * Returns: Where the player was at the end of the previous simulation step.
  */
-void complete_player_coords_update(PLAYER *player)
+VECTOR3 get_player_previous_position(PLAYER *player)
+{
+  /*
+   * Local Variables.
+   */
+  VECTOR3 position;
+
+  vector_set_values(&position,
+                    player->kinematics->previous_x[player->kinematics_index],
+                    player->kinematics->previous_y[player->kinematics_index],
+                    0.0f);
+
+  return(position);
+}
+
+/*
+ * place_player
+ *
+ * Puts a player somewhere on the pitch rather than moving them there.
+ *
+ * Parameters: player - The player to place.
+ *             x, y - Where to put them.
+ */
+void place_player(PLAYER *player, float x, float y)
+{
+  place_player_kinematics(player->kinematics, player->kinematics_index, x, y);
+}
+
+/*
+ * set_player_velocity
+ *
+ * This is the setter function for the player velocity. Players run along the
+ * ground so the z component is ignored.
+ *
+ * Parameters: player - The player whose velocity is being changed.
+ *             new_velocity - The new velocity vector.
+ */
+void set_player_velocity(PLAYER *player, VECTOR3 *new_velocity)
 {
-  vector_copy_values(&(player->position), &(player->new_position));
+  player->kinematics->velocity_x[player->kinematics_index] = new_velocity->x;
+  player->kinematics->velocity_y[player->kinematics_index] = new_velocity->y;
 }
 
 /*
@@ -143,7 +207,10 @@ void complete_player_coords_update(PLAYER *player)
  */
 void revert_player_coords_update(PLAYER *player)
 {
-  vector_copy_values(&(player->new_position), &(player->position));
+  player->kinematics->new_x[player->kinematics_index] =
+                            player->kinematics->x[player->kinematics_index];
+  player->kinematics->new_y[player->kinematics_index] =
+                            player->kinematics->y[player->kinematics_index];
 }
 
 /*
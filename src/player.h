@@ -16,25 +16,34 @@
 
 struct disc;
 struct event_queue;
+struct player_kinematics;
+
+/*
+ * Each player's event queue. Everything thrown to a player in an update is
+ * handled at the start of the next one, which is rarely more than a handful
+ * of events. An event is not queued again straight after itself (the arrived
+ * at location event is thrown every update), and if the queue does fill up
+ * the oldest events are dropped as the newest describe the match as it is
+ * now.
+ */
+#define PLAYER_EVENT_QUEUE_CAPACITY 32
+#define PLAYER_EVENT_QUEUE_OVERFLOW_POLICY EVENT_QUEUE_DROP_OLDEST
+#define PLAYER_EVENT_QUEUE_COALESCE true
 
 /*
  * PLAYER
  *
  * A structure containing the data specific to a given player object.
  *
- * The position vectors are only accessed by the main thread.
- *
- * The velocity vector is set by the player thread and accessed by the main
- * thread. As such it must not be accessed directly but only by using the
- * wrapper functions in player.c get/set_player_velocity.
+ * The player's position and velocity are held in the match's kinematics store
+ * (see player_kinematics.h). Code dealing with a single player uses the
+ * wrapper functions in player.c, while the loops over every player in the
+ * physics and collision handling work on the store directly.
  *
  * player_id - A unique id which also acts as an array index.
- * team_id - Either 0 or 1. Corresponds to the team array index.
- * position - A 3d vector giving the position of the player.
- * new_position - A 3d vector giving the new position of the player after the
- *                update.
- * velocity - The velocity vector tells us how to update the player position
- *            each time the location update loop runs.
+ * team_id - Corresponds to the team array index.
+ * kinematics - The store holding the player's position and velocity.
+ * kinematics_index - The index of the player in the store.
  * desired_position - Set by the ai. Tells us where the player wants to get to.
  * width_x - The width of the player in m (x direction).
  * width_y - The width of the player in m (y direction).
@@ -46,8 +55,8 @@ struct event_queue;
  * animation_choice - A value that determines which animation is playing
  * curr_frame - The current frame in the animation.
  * direction - The direction to display the animation in.
- * event_queue - A thread safe queue containing game events that the player has
- *               not yet processed.
+ * event_queue - A queue containing game events that the player has not yet
+ *               processed.
  * automaton - The automaton currently being used.
  * automaton_state - A state in the currently used automaton.
  * has_disc - Set to true if the player is holding the disc. False otherwise.
@@ -55,14 +64,16 @@ struct event_queue;
  *                 the user is managing them.
  * marked_player_index - The index of the player in the other team that this 
  *                       player is marking.
+ * disc_reading_skill - How well the player reads the flight of the disc. 0 is
+ *                      the best. Selects the disc path view that the player
+ *                      uses (see disc_path.h).
  */
 typedef struct player
 {
   int player_id;
   int team_id;
-  VECTOR3 position;
-  VECTOR3 new_position;
-  VECTOR3 velocity;
+  struct player_kinematics *kinematics;
+  int kinematics_index;
   VECTOR3 desired_position;
   float width_x;
   float width_y;
@@ -78,12 +89,15 @@ typedef struct player
   bool has_disc;
   bool is_ai_managed;
   int marked_player_index;
+  int disc_reading_skill;
 } PLAYER;
 
-PLAYER *create_player(int, int);
+PLAYER *create_player(int, int, struct player_kinematics *);
 void destroy_player(PLAYER *);
+VECTOR3 get_player_position(PLAYER *);
+VECTOR3 get_player_previous_position(PLAYER *);
+void place_player(PLAYER *, float, float);
 void set_player_velocity(PLAYER *, struct vector3 *);
-void complete_player_coords_update(PLAYER *);
 void revert_player_coords_update(PLAYER *);
 bool can_catch_disc(PLAYER *player, struct disc *);
 
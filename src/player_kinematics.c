@@ -0,0 +1,178 @@
+/*
+ * player_kinematics.c
+ *
+ *  Created on: 16 Oct 2026
+ *      Author: David Tyler
+ */
+
+#include "dt_logger.h"
+
+#include <stddef.h>
+#include "player_kinematics.h"
+
+/*
+ * create_player_kinematics
+ *
+ * Allocates an empty store.
+ *
+ * Parameters: max_players - The number of players that the store can hold.
+ *
+ * Returns: A pointer to the newly created memory.
+ */
+PLAYER_KINEMATICS *create_player_kinematics(int max_players)
+{
+  /*
+   * Local Variables.
+   */
+  PLAYER_KINEMATICS *kinematics;
+
+  kinematics = (PLAYER_KINEMATICS *) DT_MALLOC(sizeof(PLAYER_KINEMATICS));
+
+  kinematics->max_players = max_players;
+  kinematics->num_players = 0;
+  kinematics->players = (struct player **) DT_MALLOC(sizeof(struct player *) *
+                                                     max_players);
+  kinematics->previous_x = (float *) DT_MALLOC(sizeof(float) * max_players);
+  kinematics->previous_y = (float *) DT_MALLOC(sizeof(float) * max_players);
+  kinematics->x = (float *) DT_MALLOC(sizeof(float) * max_players);
+  kinematics->y = (float *) DT_MALLOC(sizeof(float) * max_players);
+  kinematics->new_x = (float *) DT_MALLOC(sizeof(float) * max_players);
+  kinematics->new_y = (float *) DT_MALLOC(sizeof(float) * max_players);
+  kinematics->velocity_x = (float *) DT_MALLOC(sizeof(float) * max_players);
+  kinematics->velocity_y = (float *) DT_MALLOC(sizeof(float) * max_players);
+
+  return(kinematics);
+}
+
+/*
+ * destroy_player_kinematics
+ *
+ * Frees the memory used by the passed in object. The players are not freed.
+ *
+ * Parameters: kinematics - The object to be freed.
+ */
+void destroy_player_kinematics(PLAYER_KINEMATICS *kinematics)
+{
+  DT_FREE(kinematics->velocity_y);
+  DT_FREE(kinematics->velocity_x);
+  DT_FREE(kinematics->new_y);
+  DT_FREE(kinematics->new_x);
+  DT_FREE(kinematics->y);
+  DT_FREE(kinematics->x);
+  DT_FREE(kinematics->previous_y);
+  DT_FREE(kinematics->previous_x);
+  DT_FREE(kinematics->players);
+  DT_FREE(kinematics);
+}
+
+/*
+ * add_player_kinematics
+ *
+ * Adds a player to the store, standing still at the origin.
+ *
+ * Parameters: kinematics - The store.
+ *             player - The player being added.
+ *
+ * Returns: The index of the player in the store, or -1 if it is full.
+ */
+int add_player_kinematics(PLAYER_KINEMATICS *kinematics,
+                          struct player *player)
+{
+  /*
+   * Local Variables.
+   */
+  int index = kinematics->num_players;
+
+  if (index >= kinematics->max_players)
+  {
+    return(-1);
+  }
+
+  kinematics->players[index] = player;
+  kinematics->velocity_x[index] = 0.0f;
+  kinematics->velocity_y[index] = 0.0f;
+  place_player_kinematics(kinematics, index, 0.0f, 0.0f);
+  kinematics->num_players++;
+
+  return(index);
+}
+
+/*
+ * place_player_kinematics
+ *
+ * Puts a player somewhere rather than moving them there, so they aren't
+ * drawn sliding in from wherever they were before.
+ *
+ * Parameters: kinematics - The store.
+ *             index - The index of the player.
+ *             x, y - Where to put them.
+ */
+void place_player_kinematics(PLAYER_KINEMATICS *kinematics,
+                             int index,
+                             float x,
+                             float y)
+{
+  kinematics->previous_x[index] = x;
+  kinematics->previous_y[index] = y;
+  kinematics->x[index] = x;
+  kinematics->y[index] = y;
+  kinematics->new_x[index] = x;
+  kinematics->new_y[index] = y;
+}
+
+/*
+ * integrate_player_kinematics
+ *
+ * Works out where every player will be at the end of a step if they keep
+ * running at their current velocity. The result is in new_x and new_y, ready
+ * for the collision handler to check and move.
+ *
+ * Parameters: kinematics - The store.
+ *             time_step_s - The length of the step (s).
+ */
+void integrate_player_kinematics(PLAYER_KINEMATICS *kinematics,
+                                 float time_step_s)
+{
+  /*
+   * Local Variables.
+   */
+  float *x = kinematics->x;
+  float *y = kinematics->y;
+  float *new_x = kinematics->new_x;
+  float *new_y = kinematics->new_y;
+  float *velocity_x = kinematics->velocity_x;
+  float *velocity_y = kinematics->velocity_y;
+  int num_players = kinematics->num_players;
+  int ii;
+
+  for (ii = 0; ii < num_players; ii++)
+  {
+    new_x[ii] = x[ii] + velocity_x[ii] * time_step_s;
+    new_y[ii] = y[ii] + velocity_y[ii] * time_step_s;
+  }
+}
+
+/*
+ * complete_player_kinematics_update
+ *
+ * At the end of the collision detection phase this makes the new positions
+ * the current ones, keeping the current ones as the previous positions so
+ * that the renderer can interpolate between the last two steps.
+ *
+ * Parameters: kinematics - The store.
+ */
+void complete_player_kinematics_update(PLAYER_KINEMATICS *kinematics)
+{
+  /*
+   * Local Variables.
+   */
+  float *spare_x = kinematics->previous_x;
+  float *spare_y = kinematics->previous_y;
+
+  kinematics->previous_x = kinematics->x;
+  kinematics->previous_y = kinematics->y;
+  kinematics->x = kinematics->new_x;
+  kinematics->y = kinematics->new_y;
+  kinematics->new_x = spare_x;
+  kinematics->new_y = spare_y;
+}
@@ -0,0 +1,61 @@
+/*
+ * player_kinematics.h
+ *
+ * Holds where every player is and how fast they are moving as one array per
+ * coordinate rather than inside each player, so that the loops that move the
+ * players and check them for collisions run straight through memory.
+ *
+ *  Created on: 16 Oct 2026
+ *      Author: David Tyler
+ */
+
+#ifndef PLAYER_KINEMATICS_H_
+#define PLAYER_KINEMATICS_H_
+
+struct player;
+
+/*
+ * PLAYER_KINEMATICS
+ *
+ * Players are added in turn and each keeps the index they were given (see
+ * kinematics_index in player.h). Players run along the ground so only x and
+ * y are held.
+ *
+ * The positions at the end of the previous step, now and at the end of the
+ * step being calculated are held in three sets of arrays. Finishing a step
+ * just moves the pointers round rather than copying anything, so the new
+ * positions are only meaningful between integrate_player_kinematics and
+ * complete_player_kinematics_update.
+ *
+ * max_players - The size of the arrays.
+ * num_players - The number of players added.
+ * players - The player at each index.
+ * previous_x, previous_y - Where each player was at the end of the previous
+ *                          step. Only used to interpolate when drawing.
+ * x, y - Where each player is.
+ * new_x, new_y - Where each player will be at the end of the step.
+ * velocity_x, velocity_y - How fast each player is moving (m/s).
+ */
+typedef struct player_kinematics
+{
+  int max_players;
+  int num_players;
+  struct player **players;
+  float *previous_x;
+  float *previous_y;
+  float *x;
+  float *y;
+  float *new_x;
+  float *new_y;
+  float *velocity_x;
+  float *velocity_y;
+} PLAYER_KINEMATICS;
+
+PLAYER_KINEMATICS *create_player_kinematics(int);
+void destroy_player_kinematics(PLAYER_KINEMATICS *);
+int add_player_kinematics(PLAYER_KINEMATICS *, struct player *);
+void place_player_kinematics(PLAYER_KINEMATICS *, int, float, float);
+void integrate_player_kinematics(PLAYER_KINEMATICS *, float);
+void complete_player_kinematics_update(PLAYER_KINEMATICS *);
+
+#endif /* PLAYER_KINEMATICS_H_ */
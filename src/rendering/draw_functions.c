@@ -350,13 +350,30 @@ float adjust_diameter_for_height(float diameter, float height, float eye_height)
 
 /*
  * draw_disc
+ *
+ * Draws the disc sprite somewhere between its position at the end of the last
+ * two simulation steps.
+ *
+ * Parameters: disc - The disc to draw.
+ *             camera_height - Used to scale the disc based on its height.
+ *             interpolation - The fraction of a simulation step that has
+ *                             elapsed since the last step completed [0, 1].
  */
-void draw_disc(DISC *disc, float camera_height)
+void draw_disc(DISC *disc, float camera_height, float interpolation)
 {
   /*
    * Local Variables.
    */
   float adj_diameter;
+  VECTOR3 draw_position;
+
+  /*
+   * The simulation runs at a fixed step which is not in sync with the frame
+   * rate so draw the disc where it would be part way through the current step.
+   */
+  draw_position = vector_interpolate(&(disc->previous_position),
+                                     &(disc->position),
+                                     interpolation);
 
   /*
    * To draw the disc on the screen we need to use a slightly ugly hack. This
@@ -365,13 +382,13 @@ void draw_disc(DISC *disc, float camera_height)
    * appear larger the higher it is. See the function comments for details.
    */
   adj_diameter = adjust_diameter_for_height(disc->diameter_m,
-                                            disc->position.z,
+                                            draw_position.z,
                                             camera_height);
 
-  draw_sprite(disc->position.x,
-              disc->position.y,
-              disc->position.x + adj_diameter,
-              disc->position.y + adj_diameter,
+  draw_sprite(draw_position.x,
+              draw_position.y,
+              draw_position.x + adj_diameter,
+              draw_position.y + adj_diameter,
               disc->graphic->sprite,
               0.0f, 0.0f, 1.0f, 1.0f);
 }
@@ -388,13 +405,20 @@ void draw_disc(DISC *disc, float camera_height)
  * Parameters: player - Has the coordinates and the current frame/direction.
  *             animation_handler - Has links to all the animations that can be
  *                                 drawn.
+ *             interpolation - The fraction of a simulation step that has
+ *                             elapsed since the last step completed [0, 1].
  */
-void draw_player(PLAYER *player, ANIMATION_HANDLER *animation_handler)
+void draw_player(PLAYER *player,
+                 ANIMATION_HANDLER *animation_handler,
+                 float interpolation)
 {
   /*
    * Local Variables.
    */
   ANIMATION *animation;
+  VECTOR3 previous_position;
+  VECTOR3 position;
+  VECTOR3 draw_position;
 
   /*
    * Use the animation handler to retrieve the animation that is to be drawn.
@@ -402,13 +426,22 @@ void draw_player(PLAYER *player, ANIMATION_HANDLER *animation_handler)
   animation = handler_get_animation(animation_handler,
                                     player->animation_choice);
 
+  /*
+   * Find where the player is between the last two simulation steps.
+   */
+  previous_position = get_player_previous_position(player);
+  position = get_player_position(player);
+  draw_position = vector_interpolate(&previous_position,
+                                     &position,
+                                     interpolation);
+
   /*
    * Draw the current frame onto the screen at the players location. Use the
    * direction of the player to determine which direction sprite to use.
    */
-  draw_animation_frame(player->position.x, player->position.y,
-                       player->position.x + player->width_x,
-                       player->position.y + player->width_y,
+  draw_animation_frame(draw_position.x, draw_position.y,
+                       draw_position.x + player->width_x,
+                       draw_position.y + player->width_y,
                        animation,
                        player->curr_frame,
                        player->direction);
@@ -38,8 +38,8 @@ struct font;
  */
 #define RGBA_ALPHA_DEFAULT 1.0
 
-void draw_disc(struct disc *, float);
-void draw_player(struct player *, struct animation_handler *);
+void draw_disc(struct disc *, float, float);
+void draw_player(struct player *, struct animation_handler *, float);
 void draw_pitch_background(struct screen *, struct pitch *);
 void draw_pitch_lines(struct screen *, struct pitch *);
 void draw_text(char *, int, int, struct font *);
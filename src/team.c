@@ -6,26 +6,40 @@
  */
 #include "dt_logger.h"
 
+#include <stddef.h>
 #include "team.h"
 
 /*
  * create_team
  *
- * Allocates the memory required for a team
+ * Allocates the memory required for a team. The players themselves are
+ * created separately and put into the players array.
+ *
+ * Parameters: num_players - The number of players in the team.
  *
  * Returns: A pointer to the newly created memory
  */
-TEAM *create_team()
+TEAM *create_team(int num_players)
 {
   /*
    * Local Variables
    */
   TEAM *team;
+  int ii;
 
   /*
    * Allocate the required memory
    */
   team = (TEAM *) DT_MALLOC(sizeof(TEAM));
+  team->num_players = num_players;
+  team->players = (struct player **) DT_MALLOC(sizeof(struct player *) *
+                                               num_players);
+  for (ii = 0; ii < num_players; ii++)
+  {
+    team->players[ii] = NULL;
+  }
+  team->is_offense = false;
+  team->attacking_left_to_right = true;
 
   return(team);
 }
@@ -33,7 +47,7 @@ TEAM *create_team()
 /*
  * destroy_team
  *
- * Frees the memory used by the passed in object.
+ * Frees the memory used by the passed in object. The players are not freed.
  *
  * Parameters: team - The object to be freed.
  */
@@ -42,5 +56,6 @@ void destroy_team(TEAM *team)
   /*
    * Free the object.
    */
+  DT_FREE(team->players);
   DT_FREE(team);
 }
@@ -12,29 +12,25 @@
 
 struct player;
 
-/*
- * This is not currently in a config file so that we don't have to code around
- * it containing stupid values
- */
-#define PLAYERS_PER_TEAM 7
-
 /*
  * TEAM
  *
  * A structure used to hold the team details.
  *
- * players - Array of players in the team.
+ * players - Array of players in the team. Sized when the team is created.
+ * num_players - The number of players in the team.
  * is_offense - Set to true when that team is on offence and false otherwise.
  * attacking_left_to_right - Set to true or false at the start of each point.
  */
 typedef struct team
 {
-  struct player *players[PLAYERS_PER_TEAM];
+  struct player **players;
+  int num_players;
   bool is_offense;
   bool attacking_left_to_right;
 } TEAM;
 
-TEAM *create_team();
+TEAM *create_team(int);
 void destroy_team(TEAM *);
 
 #endif /* TEAM_H_ */
@@ -0,0 +1,877 @@
+/*
+ * throw_solver.c
+ *
+ * The throw is flown in a frame where the release point is at the origin and
+ * the target is on the +x axis. The unknowns are the speed of the throw, the
+ * heading offset (the angle to the left of the target it is aimed) and, when
+ * a flight time or apex is asked for, the elevation. The residuals are how far
+ * the landing point is from the target along and across the line of the throw
+ * and how far the flight time or apex is from the value asked for.
+ *
+ * Every Newton iteration flies the current guess along with one copy for each
+ * unknown nudged by a small amount in a single DISC_BATCH. This gives the
+ * residuals and a finite difference Jacobian for about the cost of one flight.
+ *
+ * The match flies the disc with a DISC_FLIGHT rather than the batch, so a
+ * guess is only accepted once it has been flown that way as well and is
+ * within the tolerances. If it isn't, the difference between the two flights
+ * is added to the batch residuals from then on and the iteration carries on.
+ *
+ *  Created on: 16 Oct 2026
+ *      Author: David Tyler
+ */
+
+#include "dt_logger.h"
+
+#include <math.h>
+#include <stddef.h>
+#include "disc.h"
+#include "flight_condition_lu_table.h"
+#include "physics.h"
+#include "throw_constants.h"
+#include "throw_init_condition.h"
+#include "throw_solver.h"
+#include "data_structures/vector.h"
+#include "flight_mechanics/disc_flight.h"
+#include "flight_mechanics/disc_flight_batch.h"
+
+/*
+ * Solver flights are RK4 at this step which is accurate to under 1mm.
+ */
+#define THROW_SOLVER_STEP_S 0.010f
+#define THROW_SOLVER_MAX_STEPS 1000
+#define THROW_SOLVER_MAX_FLIGHT_S (THROW_SOLVER_STEP_S * THROW_SOLVER_MAX_STEPS)
+
+/*
+ * The amounts by which the unknowns are nudged to find the Jacobian.
+ */
+#define THROW_SOLVER_SPEED_DELTA 0.01f
+#define THROW_SOLVER_ANGLE_DELTA 0.001f
+
+/*
+ * Newton steps are limited to this size so that a poor first guess can't
+ * throw the iteration far out.
+ */
+#define THROW_SOLVER_MAX_SPEED_STEP 5.0f
+#define THROW_SOLVER_MAX_ANGLE_STEP 0.2f
+
+#define THROW_SOLVER_MIN_ELEVATION_RAD -0.5f
+#define THROW_SOLVER_MAX_ELEVATION_RAD 1.2f
+#define THROW_SOLVER_MAX_HEADING_RAD 1.0f
+
+/*
+ * The first guess at the speed when there is no table or cache to use. This
+ * is roughly what the flight model needs for a flat throw.
+ */
+#define THROW_SOLVER_SPEED_PER_ROOT_M 3.0f
+#define THROW_SOLVER_FIRST_ELEVATION_RAD 0.1f
+
+/*
+ * A cached solution is used as the first guess if it is within
+ * THROW_SOLVER_CACHE_RANGE by the measure in throw_solver_cache_distance. A
+ * new solution within THROW_SOLVER_CACHE_SAME of an existing one replaces it.
+ */
+#define THROW_SOLVER_CACHE_RANGE 10.0f
+#define THROW_SOLVER_CACHE_SAME 0.05f
+#define THROW_SOLVER_CACHE_ROLL_WEIGHT 20.0f
+#define THROW_SOLVER_CACHE_VALUE_WEIGHT 5.0f
+
+/*
+ * The position of each unknown in the unknowns arrays.
+ */
+#define THROW_SOLVER_SPEED 0
+#define THROW_SOLVER_HEADING 1
+#define THROW_SOLVER_ELEVATION 2
+
+/*
+ * create_throw_solver
+ *
+ * Parameters: flight_lu_table - Table used for first guesses. May be NULL.
+ *
+ * Returns: A new solver with an empty cache.
+ */
+THROW_SOLVER *create_throw_solver(FLIGHT_CONDITION_LU_TABLE *flight_lu_table)
+{
+  /*
+   * Local Variables.
+   */
+  THROW_SOLVER *solver;
+
+  solver = (THROW_SOLVER *) DT_MALLOC(sizeof(THROW_SOLVER));
+  solver->flight_lu_table = flight_lu_table;
+  solver->last_num_iterations = 0;
+  clear_throw_solver_cache(solver);
+
+  return(solver);
+}
+
+/*
+ * destroy_throw_solver
+ *
+ * Parameters: solver - The object to be freed.
+ */
+void destroy_throw_solver(THROW_SOLVER *solver)
+{
+  DT_FREE(solver);
+}
+
+/*
+ * clear_throw_solver_cache
+ *
+ * Forgets all previous solutions. Must be called if the flight model changes.
+ *
+ * Parameters: solver - The solver.
+ */
+void clear_throw_solver_cache(THROW_SOLVER *solver)
+{
+  /*
+   * Local Variables.
+   */
+  int ii;
+
+  for (ii = 0; ii < THROW_SOLVER_CACHE_SIZE; ii++)
+  {
+    solver->cache[ii].in_use = false;
+  }
+  solver->next_cache_entry = 0;
+}
+
+/*
+ * throw_solver_cache_distance
+ *
+ * INTERNAL: How different a cached solve is from a new one. Roughly in meters
+ * of throw distance.
+ *
+ * Parameters: entry - The cached solve.
+ *             distance, roll, constraint, constraint_value - The new solve.
+ *
+ * Returns: The difference, or a negative number if the cache entry can't be
+ *          used for this solve at all.
+ */
+float throw_solver_cache_distance(THROW_SOLVER_CACHE_ENTRY *entry,
+                                  float distance,
+                                  float roll,
+                                  THROW_CONSTRAINT constraint,
+                                  float constraint_value)
+{
+  if ((!entry->in_use) || (entry->constraint != constraint))
+  {
+    return(-1.0f);
+  }
+
+  return(fabsf(entry->distance - distance) +
+         THROW_SOLVER_CACHE_ROLL_WEIGHT * fabsf(entry->roll - roll) +
+         THROW_SOLVER_CACHE_VALUE_WEIGHT *
+                              fabsf(entry->constraint_value - constraint_value));
+}
+
+/*
+ * find_throw_solver_cache_entry
+ *
+ * INTERNAL: Finds the cached solution closest to a new solve.
+ *
+ * Parameters: solver - The solver.
+ *             distance, roll, constraint, constraint_value - The new solve.
+ *             difference - Filled in with the difference to the entry found.
+ *
+ * Returns: The closest entry or NULL if none can be used.
+ */
+THROW_SOLVER_CACHE_ENTRY *find_throw_solver_cache_entry(
+                                              THROW_SOLVER *solver,
+                                              float distance,
+                                              float roll,
+                                              THROW_CONSTRAINT constraint,
+                                              float constraint_value,
+                                              float *difference)
+{
+  /*
+   * Local Variables.
+   */
+  THROW_SOLVER_CACHE_ENTRY *best_entry = NULL;
+  float entry_difference;
+  int ii;
+
+  for (ii = 0; ii < THROW_SOLVER_CACHE_SIZE; ii++)
+  {
+    entry_difference = throw_solver_cache_distance(&(solver->cache[ii]),
+                                                   distance,
+                                                   roll,
+                                                   constraint,
+                                                   constraint_value);
+    if ((entry_difference >= 0.0f) &&
+        ((NULL == best_entry) || (entry_difference < *difference)))
+    {
+      best_entry = &(solver->cache[ii]);
+      *difference = entry_difference;
+    }
+  }
+
+  return(best_entry);
+}
+
+/*
+ * store_throw_solution
+ *
+ * INTERNAL: Adds a solution to the cache, replacing an existing entry for
+ * the same solve or else the oldest entry.
+ *
+ * Parameters: solver - The solver.
+ *             distance, roll, constraint, constraint_value - The solve.
+ *             unknowns - The solution.
+ */
+void store_throw_solution(THROW_SOLVER *solver,
+                          float distance,
+                          float roll,
+                          THROW_CONSTRAINT constraint,
+                          float constraint_value,
+                          float *unknowns)
+{
+  /*
+   * Local Variables.
+   */
+  THROW_SOLVER_CACHE_ENTRY *entry;
+  float difference;
+  int ii;
+
+  entry = find_throw_solver_cache_entry(solver,
+                                        distance,
+                                        roll,
+                                        constraint,
+                                        constraint_value,
+                                        &difference);
+  if ((NULL == entry) || (difference > THROW_SOLVER_CACHE_SAME))
+  {
+    entry = &(solver->cache[solver->next_cache_entry]);
+    solver->next_cache_entry = (solver->next_cache_entry + 1) %
+                               THROW_SOLVER_CACHE_SIZE;
+  }
+
+  entry->in_use = true;
+  entry->distance = distance;
+  entry->roll = roll;
+  entry->constraint = constraint;
+  entry->constraint_value = constraint_value;
+  for (ii = 0; ii < THROW_SOLVER_MAX_UNKNOWNS; ii++)
+  {
+    entry->unknowns[ii] = unknowns[ii];
+  }
+}
+
+/*
+ * make_first_throw_guess
+ *
+ * INTERNAL: Fills in the starting point for the Newton iteration. A nearby
+ * cached solution is best, then the flight condition table, then a rough
+ * formula.
+ *
+ * Parameters: solver - The solver.
+ *             distance, roll, constraint, constraint_value - The solve.
+ *             unknowns - Filled in with the guess.
+ */
+void make_first_throw_guess(THROW_SOLVER *solver,
+                            float distance,
+                            float roll,
+                            THROW_CONSTRAINT constraint,
+                            float constraint_value,
+                            float *unknowns)
+{
+  /*
+   * Local Variables.
+   */
+  THROW_SOLVER_CACHE_ENTRY *entry;
+  THROW_INIT_CONDITION condition;
+  float difference;
+  int ii;
+
+  entry = find_throw_solver_cache_entry(solver,
+                                        distance,
+                                        roll,
+                                        constraint,
+                                        constraint_value,
+                                        &difference);
+  if ((NULL != entry) && (difference <= THROW_SOLVER_CACHE_RANGE))
+  {
+    for (ii = 0; ii < THROW_SOLVER_MAX_UNKNOWNS; ii++)
+    {
+      unknowns[ii] = entry->unknowns[ii];
+    }
+    return;
+  }
+
+  unknowns[THROW_SOLVER_SPEED] = THROW_SOLVER_SPEED_PER_ROOT_M * sqrtf(distance);
+  unknowns[THROW_SOLVER_HEADING] = 0.0f;
+  unknowns[THROW_SOLVER_ELEVATION] = (throw_constraint_none == constraint) ?
+                                     0.0f : THROW_SOLVER_FIRST_ELEVATION_RAD;
+
+  if ((NULL != solver->flight_lu_table) &&
+      (FLIGHT_LU_LOOKUP_EMPTY != get_throw_init_condition(
+                                                      solver->flight_lu_table,
+                                                      distance,
+                                                      roll,
+                                                      &condition)))
+  {
+    unknowns[THROW_SOLVER_SPEED] = vector_length(&(condition.velocity));
+    unknowns[THROW_SOLVER_HEADING] = atan2f(condition.velocity.y,
+                                            condition.velocity.x);
+  }
+}
+
+/*
+ * set_solver_throw_conditions
+ *
+ * INTERNAL: Converts the unknowns into a velocity and up vector in the solver
+ * frame (target along +x).
+ *
+ * Parameters: unknowns - The speed, heading offset and elevation.
+ *             roll - The roll of the throw.
+ *             velocity - Filled in with the velocity.
+ *             up - Filled in with the up vector.
+ */
+void set_solver_throw_conditions(float *unknowns,
+                                 float roll,
+                                 VECTOR3 *velocity,
+                                 VECTOR3 *up)
+{
+  /*
+   * Local Variables.
+   */
+  float speed = unknowns[THROW_SOLVER_SPEED];
+  float heading = unknowns[THROW_SOLVER_HEADING];
+  float elevation = unknowns[THROW_SOLVER_ELEVATION];
+
+  vector_set_values(velocity,
+                    speed * cosf(elevation) * cosf(heading),
+                    speed * cosf(elevation) * sinf(heading),
+                    speed * sinf(elevation));
+
+  /*
+   * The disc is thrown flat to its direction of travel and then rolled about
+   * it, as in the flight condition table. With no elevation this is the same
+   * up vector as the table uses.
+   */
+  vector_set_values(up,
+                    -cosf(roll) * sinf(elevation) * cosf(heading) +
+                    sinf(roll) * sinf(heading),
+                    -cosf(roll) * sinf(elevation) * sinf(heading) -
+                    sinf(roll) * cosf(heading),
+                    cosf(roll) * cosf(elevation));
+}
+
+/*
+ * fly_solver_throws
+ *
+ * INTERNAL: Flies the current guess and one nudged copy per unknown, then
+ * works out the residuals of the guess and their Jacobian.
+ *
+ * Parameters: unknowns - The current guess.
+ *             num_unknowns - 2 or 3.
+ *             distance, roll, constraint, constraint_value - The solve.
+ *             residuals - Filled in with the residuals of the guess.
+ *             jacobian - Filled in with the change in residual ii for a change
+ *                        in unknown jj at [ii][jj].
+ */
+void fly_solver_throws(float *unknowns,
+                       int num_unknowns,
+                       float distance,
+                       float roll,
+                       THROW_CONSTRAINT constraint,
+                       float constraint_value,
+                       float *residuals,
+                       float jacobian[][THROW_SOLVER_MAX_UNKNOWNS])
+{
+  /*
+   * Local Variables.
+   */
+  DISC_BATCH batch;
+  DISC_BATCH_LANDING landing;
+  DISC disc;
+  float lane_unknowns[THROW_SOLVER_MAX_UNKNOWNS];
+  float deltas[THROW_SOLVER_MAX_UNKNOWNS] = {THROW_SOLVER_SPEED_DELTA,
+                                             THROW_SOLVER_ANGLE_DELTA,
+                                             THROW_SOLVER_ANGLE_DELTA};
+  float lane_residuals[THROW_SOLVER_MAX_UNKNOWNS + 1][THROW_SOLVER_MAX_UNKNOWNS];
+  int lane;
+  int ii;
+
+  clear_disc_batch(&batch);
+  vector_set_values(&(disc.position), 0.0f, 0.0f, DISC_THROW_RELEASE_HEIGHT_M);
+  vector_set_values(&(disc.angular_velocity),
+                    DISC_THROW_ANGULAR_VELOCITY_X,
+                    DISC_THROW_ANGULAR_VELOCITY_Y,
+                    DISC_THROW_ANGULAR_VELOCITY_Z);
+
+  /*
+   * Lane 0 is the guess, lane ii + 1 has unknown ii nudged.
+   */
+  for (lane = 0; lane <= num_unknowns; lane++)
+  {
+    for (ii = 0; ii < THROW_SOLVER_MAX_UNKNOWNS; ii++)
+    {
+      lane_unknowns[ii] = unknowns[ii];
+    }
+    if (lane > 0)
+    {
+      lane_unknowns[lane - 1] += deltas[lane - 1];
+    }
+    set_solver_throw_conditions(lane_unknowns,
+                                roll,
+                                &(disc.velocity),
+                                &(disc.d3));
+    set_disc_batch_entry(&batch, lane, &disc);
+  }
+
+  fly_disc_batch_to_ground(&batch,
+                           THROW_SOLVER_STEP_S,
+                           disc_integrator_rk4,
+                           THROW_SOLVER_MAX_STEPS,
+                           &landing);
+
+  for (lane = 0; lane <= num_unknowns; lane++)
+  {
+    lane_residuals[lane][0] = landing.x[lane] - distance;
+    lane_residuals[lane][1] = landing.y[lane];
+    switch(constraint)
+    {
+      case throw_constraint_flight_time:
+        lane_residuals[lane][2] = landing.time_s[lane] - constraint_value;
+        break;
+
+      case throw_constraint_apex_height:
+        lane_residuals[lane][2] = landing.apex_z[lane] - constraint_value;
+        break;
+
+      case throw_constraint_none:
+      default:
+        lane_residuals[lane][2] = 0.0f;
+        break;
+    }
+  }
+
+  for (ii = 0; ii < num_unknowns; ii++)
+  {
+    residuals[ii] = lane_residuals[0][ii];
+    for (lane = 1; lane <= num_unknowns; lane++)
+    {
+      jacobian[ii][lane - 1] = (lane_residuals[lane][ii] -
+                                lane_residuals[0][ii]) / deltas[lane - 1];
+    }
+  }
+}
+
+/*
+ * fly_match_throw
+ *
+ * INTERNAL: Flies a guess with a DISC_FLIGHT, as the match flies the disc,
+ * and works out its residuals. The apex is taken at the end of each step as
+ * it is for the batch.
+ *
+ * Parameters: unknowns - The guess.
+ *             distance, roll, constraint, constraint_value - The solve.
+ *             residuals - Filled in with the residuals of the guess.
+ *
+ * Returns: false if the disc hadn't landed after THROW_SOLVER_MAX_FLIGHT_S,
+ *          true otherwise.
+ */
+bool fly_match_throw(float *unknowns,
+                     float distance,
+                     float roll,
+                     THROW_CONSTRAINT constraint,
+                     float constraint_value,
+                     float *residuals)
+{
+  /*
+   * Local Variables.
+   */
+  DISC disc;
+  DISC_FLIGHT flight;
+  VECTOR3 position;
+  float apex_z;
+
+  vector_set_values(&(disc.position), 0.0f, 0.0f, DISC_THROW_RELEASE_HEIGHT_M);
+  vector_set_values(&(disc.angular_velocity),
+                    DISC_THROW_ANGULAR_VELOCITY_X,
+                    DISC_THROW_ANGULAR_VELOCITY_Y,
+                    DISC_THROW_ANGULAR_VELOCITY_Z);
+  set_solver_throw_conditions(unknowns, roll, &(disc.velocity), &(disc.d3));
+  start_disc_flight(&flight, &disc);
+
+  /*
+   * Asking for the end of the current step moves the flight on one step.
+   */
+  apex_z = disc.position.z;
+  while ((!flight.landed) && (flight.end_t < THROW_SOLVER_MAX_FLIGHT_S))
+  {
+    fly_disc_flight(&flight, flight.end_t, &position, NULL);
+    apex_z = fmaxf(apex_z, flight.disc.position.z);
+  }
+  if (!flight.landed)
+  {
+    return(false);
+  }
+
+  residuals[0] = flight.landing.x - distance;
+  residuals[1] = flight.landing.y;
+  switch(constraint)
+  {
+    case throw_constraint_flight_time:
+      residuals[2] = flight.landing_t - constraint_value;
+      break;
+
+    case throw_constraint_apex_height:
+      residuals[2] = apex_z - constraint_value;
+      break;
+
+    case throw_constraint_none:
+    default:
+      residuals[2] = 0.0f;
+      break;
+  }
+
+  return(true);
+}
+
+/*
+ * solve_small_linear_system
+ *
+ * INTERNAL: Solves a x = b by Gaussian elimination with partial pivoting.
+ *
+ * Parameters: a - The matrix. Overwritten.
+ *             b - The right hand side. Overwritten.
+ *             n - The size of the system (at most THROW_SOLVER_MAX_UNKNOWNS).
+ *             x - Filled in with the solution.
+ *
+ * Returns: false if the matrix is singular, true otherwise.
+ */
+bool solve_small_linear_system(float a[][THROW_SOLVER_MAX_UNKNOWNS],
+                               float *b,
+                               int n,
+                               float *x)
+{
+  /*
+   * Local Variables.
+   */
+  float factor;
+  float temp;
+  int pivot;
+  int ii;
+  int jj;
+  int kk;
+
+  for (kk = 0; kk < n; kk++)
+  {
+    pivot = kk;
+    for (ii = kk + 1; ii < n; ii++)
+    {
+      if (fabsf(a[ii][kk]) > fabsf(a[pivot][kk]))
+      {
+        pivot = ii;
+      }
+    }
+    if (fabsf(a[pivot][kk]) < 1.0e-9f)
+    {
+      return(false);
+    }
+    if (pivot != kk)
+    {
+      for (jj = 0; jj < n; jj++)
+      {
+        temp = a[kk][jj];
+        a[kk][jj] = a[pivot][jj];
+        a[pivot][jj] = temp;
+      }
+      temp = b[kk];
+      b[kk] = b[pivot];
+      b[pivot] = temp;
+    }
+    for (ii = kk + 1; ii < n; ii++)
+    {
+      factor = a[ii][kk] / a[kk][kk];
+      for (jj = kk; jj < n; jj++)
+      {
+        a[ii][jj] -= factor * a[kk][jj];
+      }
+      b[ii] -= factor * b[kk];
+    }
+  }
+
+  for (ii = n - 1; ii >= 0; ii--)
+  {
+    x[ii] = b[ii];
+    for (jj = ii + 1; jj < n; jj++)
+    {
+      x[ii] -= a[ii][jj] * x[jj];
+    }
+    x[ii] /= a[ii][ii];
+  }
+
+  return(true);
+}
+
+/*
+ * throw_residuals_converged
+ *
+ * INTERNAL: Whether a set of residuals is within the solver tolerances.
+ *
+ * Parameters: residuals - The residuals.
+ *             constraint - What the third residual (if any) measures.
+ *
+ * Returns: true if the guess is good enough.
+ */
+bool throw_residuals_converged(float *residuals, THROW_CONSTRAINT constraint)
+{
+  if (sqrtf(residuals[0] * residuals[0] + residuals[1] * residuals[1]) >
+      THROW_SOLVER_TOLERANCE_M)
+  {
+    return(false);
+  }
+
+  switch(constraint)
+  {
+    case throw_constraint_flight_time:
+      return(fabsf(residuals[2]) <= THROW_SOLVER_TIME_TOLERANCE_S);
+
+    case throw_constraint_apex_height:
+      return(fabsf(residuals[2]) <= THROW_SOLVER_TOLERANCE_M);
+
+    case throw_constraint_none:
+    default:
+      return(true);
+  }
+}
+
+/*
+ * clamp_throw_unknowns
+ *
+ * INTERNAL: Keeps the unknowns to throws that can actually be made.
+ *
+ * Parameters: unknowns - The unknowns to clamp.
+ */
+void clamp_throw_unknowns(float *unknowns)
+{
+  unknowns[THROW_SOLVER_SPEED] = fmaxf(MIN_DISC_SPEED,
+                                       fminf(MAX_DISC_SPEED,
+                                             unknowns[THROW_SOLVER_SPEED]));
+  unknowns[THROW_SOLVER_HEADING] = fmaxf(-THROW_SOLVER_MAX_HEADING_RAD,
+                                         fminf(THROW_SOLVER_MAX_HEADING_RAD,
+                                               unknowns[THROW_SOLVER_HEADING]));
+  unknowns[THROW_SOLVER_ELEVATION] = fmaxf(THROW_SOLVER_MIN_ELEVATION_RAD,
+                                           fminf(THROW_SOLVER_MAX_ELEVATION_RAD,
+                                                 unknowns[THROW_SOLVER_ELEVATION]));
+}
+
+/*
+ * solve_throw
+ *
+ * Finds a throw from the release point that lands at the target, optionally
+ * also with a given flight time or apex height. The spin and release height
+ * are those of every throw (see disc.h).
+ *
+ * Solutions are cached and used to start later solves for similar targets, so
+ * repeated queries converge in one or two iterations. A throw is only
+ * THROW_SOLVER_OK once it has also been flown with a DISC_FLIGHT, as the match
+ * flies the disc, and found to be within the tolerances.
+ *
+ * Parameters: solver - The solver.
+ *             release - Where the disc is thrown from. Only x and y are used.
+ *             target - Where the disc should land. Only x and y are used.
+ *             roll - The roll of the throw (see FLIGHT_CONDITION_LU_TABLE).
+ *             constraint - What else to solve for, if anything.
+ *             constraint_value - The flight time (s) or apex height (m).
+ *             result - Filled in with the velocity and up vector of the throw
+ *                      in world coordinates. On THROW_SOLVER_NOT_CONVERGED or
+ *                      THROW_SOLVER_UNSTABLE it holds the closest throw found,
+ *                      which is the first guess if no flight was any good.
+ *
+ * Returns: THROW_SOLVER_OK, THROW_SOLVER_NOT_CONVERGED if the target can't be
+ *          reached (or not with the constraint), THROW_SOLVER_UNSTABLE if the
+ *          flight model gave no answer for a guess or THROW_SOLVER_BAD_TARGET
+ *          if the target is the release point or the constraint value is not
+ *          positive, in which case result is unchanged.
+ */
+int solve_throw(THROW_SOLVER *solver,
+                VECTOR3 *release,
+                VECTOR3 *target,
+                float roll,
+                THROW_CONSTRAINT constraint,
+                float constraint_value,
+                THROW_INIT_CONDITION *result)
+{
+  /*
+   * Local Variables.
+   */
+  float x_diff = target->x - release->x;
+  float y_diff = target->y - release->y;
+  float distance = sqrtf(x_diff * x_diff + y_diff * y_diff);
+  float unknowns[THROW_SOLVER_MAX_UNKNOWNS];
+  float best_unknowns[THROW_SOLVER_MAX_UNKNOWNS];
+  float residuals[THROW_SOLVER_MAX_UNKNOWNS];
+  float match_residuals[THROW_SOLVER_MAX_UNKNOWNS];
+  float match_offsets[THROW_SOLVER_MAX_UNKNOWNS] = {0.0f, 0.0f, 0.0f};
+  float jacobian[THROW_SOLVER_MAX_UNKNOWNS][THROW_SOLVER_MAX_UNKNOWNS];
+  float step[THROW_SOLVER_MAX_UNKNOWNS];
+  float max_steps[THROW_SOLVER_MAX_UNKNOWNS] = {THROW_SOLVER_MAX_SPEED_STEP,
+                                                THROW_SOLVER_MAX_ANGLE_STEP,
+                                                THROW_SOLVER_MAX_ANGLE_STEP};
+  float error;
+  float best_error = -1.0f;
+  float scale;
+  float cos_bearing;
+  float sin_bearing;
+  VECTOR3 velocity;
+  VECTOR3 up;
+  int num_unknowns = (throw_constraint_none == constraint) ? 2 : 3;
+  int rc = THROW_SOLVER_NOT_CONVERGED;
+  int iteration;
+  int ii;
+
+  if ((distance <= 0.0f) ||
+      ((throw_constraint_none != constraint) && (constraint_value <= 0.0f)))
+  {
+    return(THROW_SOLVER_BAD_TARGET);
+  }
+
+  make_first_throw_guess(solver,
+                         distance,
+                         roll,
+                         constraint,
+                         constraint_value,
+                         unknowns);
+  if (throw_constraint_none == constraint)
+  {
+    unknowns[THROW_SOLVER_ELEVATION] = 0.0f;
+  }
+  clamp_throw_unknowns(unknowns);
+  for (ii = 0; ii < THROW_SOLVER_MAX_UNKNOWNS; ii++)
+  {
+    best_unknowns[ii] = unknowns[ii];
+  }
+
+  for (iteration = 1; iteration <= THROW_SOLVER_MAX_ITERATIONS; iteration++)
+  {
+    fly_solver_throws(unknowns,
+                      num_unknowns,
+                      distance,
+                      roll,
+                      constraint,
+                      constraint_value,
+                      residuals,
+                      jacobian);
+    for (ii = 0; ii < num_unknowns; ii++)
+    {
+      residuals[ii] += match_offsets[ii];
+    }
+
+    /*
+     * Keep hold of the best guess in case the iteration doesn't converge. If
+     * the flight model has gone unstable there is no way on from here.
+     */
+    error = 0.0f;
+    for (ii = 0; ii < num_unknowns; ii++)
+    {
+      error += residuals[ii] * residuals[ii];
+    }
+    if (error != error)
+    {
+      rc = THROW_SOLVER_UNSTABLE;
+      break;
+    }
+    if ((best_error < 0.0f) || (error < best_error))
+    {
+      best_error = error;
+      for (ii = 0; ii < THROW_SOLVER_MAX_UNKNOWNS; ii++)
+      {
+        best_unknowns[ii] = unknowns[ii];
+      }
+    }
+
+    /*
+     * Check a guess that looks good as the match will fly it. If it misses
+     * then carry on from the match's residuals and correct the batch by the
+     * difference from now on.
+     */
+    if (throw_residuals_converged(residuals, constraint))
+    {
+      if (!fly_match_throw(unknowns,
+                           distance,
+                           roll,
+                           constraint,
+                           constraint_value,
+                           match_residuals))
+      {
+        rc = THROW_SOLVER_UNSTABLE;
+        break;
+      }
+      if (throw_residuals_converged(match_residuals, constraint))
+      {
+        for (ii = 0; ii < THROW_SOLVER_MAX_UNKNOWNS; ii++)
+        {
+          best_unknowns[ii] = unknowns[ii];
+        }
+        rc = THROW_SOLVER_OK;
+        break;
+      }
+      for (ii = 0; ii < num_unknowns; ii++)
+      {
+        match_offsets[ii] += match_residuals[ii] - residuals[ii];
+        residuals[ii] = match_residuals[ii];
+      }
+    }
+
+    /*
+     * Newton step J.step = -residuals, shortened if any part of it is too
+     * large.
+     */
+    for (ii = 0; ii < num_unknowns; ii++)
+    {
+      residuals[ii] = -residuals[ii];
+    }
+    if (!solve_small_linear_system(jacobian, residuals, num_unknowns, step))
+    {
+      break;
+    }
+    scale = 1.0f;
+    for (ii = 0; ii < num_unknowns; ii++)
+    {
+      if (fabsf(step[ii]) * scale > max_steps[ii])
+      {
+        scale = max_steps[ii] / fabsf(step[ii]);
+      }
+    }
+    for (ii = 0; ii < num_unknowns; ii++)
+    {
+      unknowns[ii] += scale * step[ii];
+    }
+    clamp_throw_unknowns(unknowns);
+  }
+  solver->last_num_iterations = (iteration > THROW_SOLVER_MAX_ITERATIONS) ?
+                                THROW_SOLVER_MAX_ITERATIONS : iteration;
+
+  if (THROW_SOLVER_OK == rc)
+  {
+    store_throw_solution(solver,
+                         distance,
+                         roll,
+                         constraint,
+                         constraint_value,
+                         best_unknowns);
+  }
+
+  /*
+   * Turn the solution from the solver frame to face the target.
+   */
+  set_solver_throw_conditions(best_unknowns, roll, &velocity, &up);
+  cos_bearing = x_diff / distance;
+  sin_bearing = y_diff / distance;
+  vector_set_values(&(result->velocity),
+                    velocity.x * cos_bearing - velocity.y * sin_bearing,
+                    velocity.x * sin_bearing + velocity.y * cos_bearing,
+                    velocity.z);
+  vector_set_values(&(result->up),
+                    up.x * cos_bearing - up.y * sin_bearing,
+                    up.x * sin_bearing + up.y * cos_bearing,
+                    up.z);
+  result->distance = distance;
+  result->roll = roll;
+
+  return(rc);
+}
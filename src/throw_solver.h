@@ -0,0 +1,118 @@
+/*
+ * throw_solver.h
+ *
+ * Works out how to throw the disc so that it lands at a given point, by
+ * Newton iteration over the flight model. Used for AI throws where the target
+ * is known and the throw has to be found.
+ *
+ *  Created on: 16 Oct 2026
+ *      Author: David Tyler
+ */
+
+#ifndef THROW_SOLVER_H_
+#define THROW_SOLVER_H_
+
+#include "data_structures/vector.h"
+
+struct flight_condition_lu_table;
+struct disc_throw_init_condition;
+
+/*
+ * Return codes for solve_throw.
+ */
+#define THROW_SOLVER_OK 0
+#define THROW_SOLVER_NOT_CONVERGED 1
+#define THROW_SOLVER_BAD_TARGET 2
+#define THROW_SOLVER_UNSTABLE 3
+
+/*
+ * A solution is accepted when the landing point is within
+ * THROW_SOLVER_TOLERANCE_M of the target and the flight time or apex (if one
+ * was asked for) is within THROW_SOLVER_TIME_TOLERANCE_S or
+ * THROW_SOLVER_TOLERANCE_M.
+ */
+#define THROW_SOLVER_TOLERANCE_M 0.05f
+#define THROW_SOLVER_TIME_TOLERANCE_S 0.01f
+#define THROW_SOLVER_MAX_ITERATIONS 12
+
+/*
+ * The number of previous solutions kept to start new solves from.
+ */
+#define THROW_SOLVER_CACHE_SIZE 16
+
+/*
+ * The largest number of unknowns: speed, heading and elevation.
+ */
+#define THROW_SOLVER_MAX_UNKNOWNS 3
+
+/*
+ * What, if anything, is asked of the throw as well as where it lands.
+ *
+ * throw_constraint_none - A flat throw. Only the speed and heading are solved
+ *                         for.
+ * throw_constraint_flight_time - The disc must land after the given time (s).
+ * throw_constraint_apex_height - The highest point of the flight must be at
+ *                                the given height (m).
+ *
+ * The constrained throws solve for the elevation of the throw as well.
+ */
+typedef enum throw_constraint
+{
+  throw_constraint_none,
+  throw_constraint_flight_time,
+  throw_constraint_apex_height
+} THROW_CONSTRAINT;
+
+/*
+ * THROW_SOLVER_CACHE_ENTRY
+ *
+ * A previous solution. Throws are the same in every direction so solutions are
+ * stored relative to the direction of the target and reused for any target at
+ * a similar distance.
+ *
+ * in_use - Whether this entry holds a solution.
+ * distance - The distance to the target.
+ * roll - The roll of the throw.
+ * constraint - The constraint solved for.
+ * constraint_value - The flight time or apex height solved for.
+ * unknowns - The speed, heading offset and elevation of the solution.
+ */
+typedef struct throw_solver_cache_entry
+{
+  bool in_use;
+  float distance;
+  float roll;
+  THROW_CONSTRAINT constraint;
+  float constraint_value;
+  float unknowns[THROW_SOLVER_MAX_UNKNOWNS];
+} THROW_SOLVER_CACHE_ENTRY;
+
+/*
+ * THROW_SOLVER
+ *
+ * flight_lu_table - Used for the first guess when there is nothing suitable in
+ *                   the cache. May be NULL or empty.
+ * cache - Previous solutions.
+ * next_cache_entry - The entry to replace when a new solution is stored.
+ * last_num_iterations - The Newton iterations used by the last solve.
+ */
+typedef struct throw_solver
+{
+  struct flight_condition_lu_table *flight_lu_table;
+  THROW_SOLVER_CACHE_ENTRY cache[THROW_SOLVER_CACHE_SIZE];
+  int next_cache_entry;
+  int last_num_iterations;
+} THROW_SOLVER;
+
+THROW_SOLVER *create_throw_solver(struct flight_condition_lu_table *);
+void destroy_throw_solver(THROW_SOLVER *);
+void clear_throw_solver_cache(THROW_SOLVER *);
+int solve_throw(THROW_SOLVER *,
+                VECTOR3 *,
+                VECTOR3 *,
+                float,
+                THROW_CONSTRAINT,
+                float,
+                struct disc_throw_init_condition *);
+
+#endif /* THROW_SOLVER_H_ */